@@ -10,13 +10,28 @@ class CClassifierMultiPlatform {
       bool enableOclProfiling,
       bool enableMemBankCrossing,
       bool enableCpuUtilization,
-      bool enableTensorDumps);
+      bool enableTensorDumps,
+      bool enableBatchNormFolding=false,
+      bool enableBatchNormFoldingCheck=false,
+      bool enableStreaming=false);
   ~CClassifierMultiPlatform();
   double GetTimestamp();
+  bool IsSucceeded() const;
 
  private:
-  void CalculateAccuracy(CTensorPtr<float> scores, CTensorPtr<unsigned> labels, unsigned batchSize, unsigned classCount);
+  void CreateModel(bool enableBatchNormFolding);
+  float RunModel(bool enableBatchNormFolding, CTensorPtr<float> &classScoresTn);
+  void RunStreaming(bool enableBatchNormFolding);
+  float CalculateAccuracy(CTensorPtr<float> scores, CTensorPtr<unsigned> labels, unsigned batchSize, unsigned classCount, bool logResults=true);
+
+  // The maximum accuracy drop of the folded batch-norms that the regression check accepts.
+  static constexpr float kBatchNormFoldingAccuracyTolerance = 0.02f;
+  // The number of the point clouds of the synthetic mode, the same as the datasets.
+  static constexpr unsigned kSyntheticDatasetSize = 2048;
 
   CModel1 *m_ptrClassifierModel;
+  double m_dModelCreationTime; // Of the last CreateModel(), the first part of the time to first inference.
   bool m_bUseShapeNet;
+  bool m_bEnableOclProfiling, m_bEnableMemBankCrossing, m_bEnableCpuUtilization, m_bEnableTensorDumps;
+  bool m_bSucceeded;
 };
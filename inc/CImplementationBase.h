@@ -20,10 +20,13 @@ class CImplementationBase {
   virtual CTensorBasePtr Reduce       (CTensorBasePtr inputTn, REDUCTION_OPS mode, unsigned powY, const std::vector<unsigned> &combination)=0;
   virtual CTensorBasePtr Mean         (CTensorBasePtr inputTn, const std::vector<unsigned> &combination)=0;
   virtual CTensorBasePtr Variance     (CTensorBasePtr inputTn, const std::vector<unsigned> &combination)=0;
+  virtual std::vector<CTensorBasePtr> MeanVariance (CTensorBasePtr inputTn, const std::vector<unsigned> &combination)=0;
   virtual CTensorBasePtr PadLastDim   (CTensorBasePtr inputTn, unsigned lastDimPadded)=0;
   virtual CTensorBasePtr UnpadLastDim (CTensorBasePtr inputTn, unsigned lastDimUnpadded)=0;
   virtual CTensorBasePtr TopK         (CTensorBasePtr inputTn, unsigned axis, unsigned k)=0;
   virtual CTensorBasePtr Conv2D       (CTensorBasePtr inputTn, CTensorBasePtr weightTn, CTensorBasePtr biasTn)=0;
+  virtual CTensorBasePtr KNN          (CTensorBasePtr inputTn, unsigned k)=0;
+  virtual CTensorBasePtr EdgeConv     (CTensorBasePtr inputTn, CTensorBasePtr knnTn, CTensorBasePtr weightTn, CTensorBasePtr biasTn)=0;
 
  protected:
   unsigned GenerateLayerId();
@@ -31,6 +34,9 @@ class CImplementationBase {
   PLATFORMS GetPlatform() const;
   void ResetLayerIdCounter(unsigned offset);
   void ValidateTensorPlatforms(const std::vector<CTensorBasePtr> &tensors, PLATFORMS requiredPlatform);
+  void ValidateKnnIndices(const unsigned *ptrBuffKnnTn, size_t len, unsigned N);
+  CTensorBasePtr KnnByPairwiseDistance(CTensorBasePtr inputTn, unsigned k);
+  CTensorBasePtr EdgeConvByEdgeFeatures(CTensorBasePtr inputTn, CTensorBasePtr knnTn, CTensorBasePtr weightTn, CTensorBasePtr biasTn);
 
   std::atomic_uint m_uAtomicCounter;
   PLATFORMS m_ePlatform;
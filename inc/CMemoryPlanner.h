@@ -0,0 +1,164 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <vector>
+#include "GlobalHelpers.h"
+#include "CTensorBase.h"
+
+/**
+ * @brief The static liveness analysis and the buffer reuse planner of the forward pass.
+ *
+ * The first pass of a model is recorded layer by layer through CPlatformSelection: the buffer produced by each layer,
+ * the layers (and the dumps) that read it, and the step at which its last reference is actually dropped. The liveness
+ * is tracked per buffer, not per tensor: a read of any tensor whose buffer overlaps a recorded buffer (the aliases of
+ * CPlatformSelection::ShareBuffer(), the views and the sub-buffers of the device tensors) is a read of that buffer.
+ * At the end of the pass the elementwise layers (ReLU, Sqrt, Square and BasicOps) on the CPU whose first input buffer
+ * is not read by any later layer are marked to run in-place.
+ *
+ * The later passes replay the plan: the marked layers of the CPU implementation write their results into their
+ * inputs and the measured peak is reported again, so the peaks before and after the planning could be compared.
+ * The peak of the lifetimes is reported as the lower bound of any reuse of the buffers, no allocation follows it.
+ * The tensors that are not produced by a recorded layer (the weights and the input data) are never planned.
+ * A replayed pass that diverges from the recorded graph drops the plan.
+ */
+class CMemoryPlanner {
+ public:
+  explicit CMemoryPlanner(bool enabled);
+
+  /**
+   * @brief      Enables or disables the recording. Either way, the current plan is dropped.
+   */
+  void SetEnabled(bool enabled);
+  bool IsEnabled() const;
+
+  /**
+   * @brief      Starts recording a forward pass. The plan of the previous passes (if any) is kept for the replay.
+   */
+  void BeginPass();
+
+  /**
+   * @brief      Finishes the pass, builds the plan if this is the first recorded pass and reports the peaks.
+   *
+   * @param[in]  outputTn  The output of the model, which is alive after the pass.
+   */
+  void EndPass(CTensorBasePtr outputTn);
+
+  /**
+   * @brief      Records the start of a layer and the reads of its inputs.
+   *
+   * @param[in]  layerName      The name of the layer, used to validate the replayed passes.
+   * @param[in]  destPlatform   The platform that the layer runs on
+   * @param[in]  inputTns       The inputs of the layer. For the elementwise layers, the first one is the candidate
+   *                            of the in-place execution.
+   * @param[in]  isElementwise  True if the layer could write its result into its first input.
+   *
+   * @return     True if the layer should run in-place (only on the CPU and only while replaying a valid plan). The
+   *             decision is passed to the layer call of the CPU implementation.
+   */
+  bool BeginLayer(const std::string &layerName,
+                  PLATFORMS destPlatform,
+                  const std::vector<CTensorBasePtr> &inputTns,
+                  bool isElementwise=false);
+
+  /**
+   * @brief      Records the output of the layer started by the last BeginLayer().
+   *
+   * @return     outputTn itself.
+   */
+  CTensorBasePtr EndLayer(CTensorBasePtr outputTn);
+
+  /**
+   * @brief      Records the outputs of a layer with more than one output (MeanVariance), started by the last
+   *             BeginLayer().
+   *
+   * @return     outputTns itself.
+   */
+  std::vector<CTensorBasePtr> EndLayer(const std::vector<CTensorBasePtr> &outputTns);
+
+  /**
+   * @brief      Records a read of the tensor outside of the layers (dumps, comparisons, platform crossings).
+   */
+  void RecordUse(CTensorBasePtr tn);
+
+  bool HasPlan() const;
+  unsigned GetInPlaceLayerCount() const;
+
+  /**
+   * @brief      The peak of the live buffers of the last pass.
+   */
+  size_t GetMeasuredPeakBytes() const;
+
+  /**
+   * @brief      The peak of the live buffers of the recorded pass (before the in-place execution).
+   */
+  size_t GetRecordedPeakBytes() const;
+
+  /**
+   * @brief      The lower bound of the peak of any reuse of the buffers of the recorded pass, with the in-place layers.
+   */
+  size_t GetLifetimePeakBytes() const;
+
+ private:
+  // The host buffers are ranges of the host address space (root is null), the device buffers are ranges of the device
+  // buffer of their root tensor.
+  struct BufferRange{
+    const void *root;
+    uintptr_t begin;
+    uintptr_t end;
+  };
+  struct TensorRecord{
+    std::weak_ptr<CTensorBase> tensor;
+    BufferRange buffer;
+    PLATFORMS platform;
+    size_t bytes;
+    int defStep;
+    int lastUseStep;
+    int releaseStep;
+  };
+  struct LayerRecord{
+    std::string name;
+    bool isElementwise;
+    int inPlaceCandidate;
+    int outputRecord; // The first output of the layer
+  };
+  struct BufferGroup{
+    PLATFORMS platform;
+    size_t bytes;
+    int defStep;
+    int lastUseStep;
+  };
+
+  int RecordOutput(CTensorBasePtr outputTn);
+  void RecordUse(const BufferRange &buffer, int step);
+  int FindLiveRecord(const BufferRange &buffer) const;
+  void SweepReleased(int releaseStep);
+  void BuildPlan();
+  void Report() const;
+  static int PlatformIndex(PLATFORMS platform);
+  static BufferRange GetBufferRange(CTensorBasePtr tn);
+  static bool IsOverlapping(const BufferRange &buffer1, const BufferRange &buffer2);
+
+  bool m_bEnabled;
+  bool m_bPassStarted;
+  bool m_bInLayer;
+  int m_iStep;
+  unsigned m_uPassCount;
+
+  // The current pass
+  std::vector<TensorRecord> m_vTensors;
+  std::vector<LayerRecord> m_vLayers;
+  std::vector<int> m_vLiveTensors; // The records of the buffers that are not released yet
+  size_t m_uLiveBytes[2];
+  size_t m_uMeasuredPeakBytes[2];
+
+  // The plan, built at the end of the first pass
+  bool m_bHasPlan;
+  bool m_bPlanIsValid;
+  std::vector<std::string> m_vPlannedLayerNames;
+  std::vector<bool> m_vInPlaceLayers;
+  unsigned m_uInPlaceLayerCount;
+  size_t m_uRecordedPeakBytes[2];
+  size_t m_uLifetimePeakBytes[2];
+};
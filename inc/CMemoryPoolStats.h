@@ -0,0 +1,94 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include "GlobalHelpers.h"
+
+/**
+ * @brief The size classes and the counters shared by the host-side (CHostMemoryPool) and the device-side
+ * (CXilinxBufferPool) buffer pools. The methods are not thread-safe, the owner pool should hold its lock.
+ *
+ * The size classes are the multiples of a quarter of the largest power of two that fits in the requested size
+ * (with a minimum of one page), so the internal fragmentation of a buffer is always less than 25%.
+ */
+class CMemoryPoolStats {
+ public:
+  static constexpr size_t kMinSizeClass = 4096;
+
+  static size_t GetSizeClass(size_t sizeBytes){
+    if(sizeBytes<=kMinSizeClass) return kMinSizeClass;
+    size_t msb = kMinSizeClass;
+    while((msb<<1) <= sizeBytes) msb <<= 1;
+    const size_t step = msb/4;
+    return (sizeBytes+step-1)/step*step;
+  }
+
+  void OnAcquire(size_t sizeClass, bool isPoolHit){
+    m_uRequests++;
+    if(isPoolHit){
+      m_uPoolHits++;
+      m_uBytesCached -= sizeClass;
+    }else{
+      m_uSystemAllocations++;
+      m_uBytesReserved += sizeClass;
+      m_uPeakBytesReserved = std::max(m_uPeakBytesReserved, m_uBytesReserved);
+    }
+    m_uBytesInUse += sizeClass;
+    m_uPeakBytesInUse = std::max(m_uPeakBytesInUse, m_uBytesInUse);
+  }
+
+  void OnRelease(size_t sizeClass, bool isCached){
+    m_uBytesInUse -= sizeClass;
+    if(isCached){
+      m_uBytesCached += sizeClass;
+    }else{
+      m_uSystemFrees++;
+      m_uBytesReserved -= sizeClass;
+    }
+  }
+
+  void OnTrim(size_t sizeClass){
+    m_uSystemFrees++;
+    m_uBytesCached -= sizeClass;
+    m_uBytesReserved -= sizeClass;
+  }
+
+  void OnEvict(size_t sizeClass){
+    OnTrim(sizeClass);
+    m_uEvictions++;
+  }
+
+  size_t GetBytesCached() const{
+    return m_uBytesCached;
+  }
+
+  void Report(const std::string &poolName) const{
+    SPDLOG_LOGGER_INFO(logger, "{}: Requests: {}, Pool Hits: {}, System Allocations: {}, System Frees: {}, Evictions: {}",
+                       poolName, m_uRequests, m_uPoolHits, m_uSystemAllocations, m_uSystemFrees, m_uEvictions);
+    SPDLOG_LOGGER_INFO(logger, "{}: In Use: {} MB (Peak: {} MB), Reserved: {} MB (Peak: {} MB), Cached: {} MB",
+                       poolName,
+                       m_uBytesInUse/1048576.0, m_uPeakBytesInUse/1048576.0,
+                       m_uBytesReserved/1048576.0, m_uPeakBytesReserved/1048576.0,
+                       m_uBytesCached/1048576.0);
+  }
+
+  void ResetCounters(){
+    m_uRequests = m_uPoolHits = m_uSystemAllocations = m_uSystemFrees = m_uEvictions = 0;
+    m_uPeakBytesInUse = m_uBytesInUse;
+    m_uPeakBytesReserved = m_uBytesReserved;
+  }
+
+ private:
+  unsigned long m_uRequests=0;
+  unsigned long m_uPoolHits=0;
+  unsigned long m_uSystemAllocations=0;
+  unsigned long m_uSystemFrees=0;
+  unsigned long m_uEvictions=0;
+  size_t m_uBytesInUse=0;
+  size_t m_uPeakBytesInUse=0;
+  size_t m_uBytesCached=0;
+  size_t m_uBytesReserved=0;
+  size_t m_uPeakBytesReserved=0;
+};
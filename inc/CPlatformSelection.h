@@ -6,11 +6,15 @@
 #include "fpga/xilinx/CImplementationXilinx.h"
 #include "CWeightLoader.h"
 #include "CProfiler.h"
+#include "CMemoryPlanner.h"
 #include "GlobalHelpers.h"
 
 
 class CPlatformSelection {
  public:
+  // The seed of the random weights and point clouds of the synthetic mode (globalSyntheticData).
+  static constexpr unsigned kSyntheticSeed = 5;
+
   CPlatformSelection(
       PLATFORMS targetPlatform,
       bool useShapeNetInstead,
@@ -19,7 +23,8 @@ class CPlatformSelection {
       bool enableMemBankCrossing,
       bool enableCpuUtilization,
       bool enableTensorDumps,
-      std::string profilerOutputPath="profiler.json");
+      bool enableBatchNormFolding=false,
+      std::string profilerOutputPath="profiler.trace");
   ~CPlatformSelection();
 
   CTensorBasePtr Concat2      (PLATFORMS destPlatform, CTensorBasePtr inputTn1, CTensorBasePtr inputTn2, unsigned concatAxis);
@@ -35,27 +40,39 @@ class CPlatformSelection {
   CTensorBasePtr Reduce       (PLATFORMS destPlatform, CTensorBasePtr inputTn, REDUCTION_OPS mode, unsigned powY, const std::vector<unsigned> &combination);
   CTensorBasePtr Mean         (PLATFORMS destPlatform, CTensorBasePtr inputTn, const std::vector<unsigned> &combination);
   CTensorBasePtr Variance     (PLATFORMS destPlatform, CTensorBasePtr inputTn, const std::vector<unsigned> &combination);
+  std::vector<CTensorBasePtr> MeanVariance (PLATFORMS destPlatform, CTensorBasePtr inputTn, const std::vector<unsigned> &combination);
   CTensorBasePtr PadLastDim   (PLATFORMS destPlatform, CTensorBasePtr inputTn, unsigned lastDimPadded);
   CTensorBasePtr UnpadLastDim (PLATFORMS destPlatform, CTensorBasePtr inputTn, unsigned lastDimUnpadded);
   CTensorBasePtr TopK         (PLATFORMS destPlatform, CTensorBasePtr inputTn, unsigned axis, unsigned k);
   CTensorBasePtr Conv2D       (PLATFORMS destPlatform, CTensorBasePtr inputTn, CTensorBasePtr weightTn, CTensorBasePtr biasTn);
+  CTensorBasePtr KNN          (PLATFORMS destPlatform, CTensorBasePtr inputTn, unsigned k);
+  CTensorBasePtr EdgeConv     (PLATFORMS destPlatform, CTensorBasePtr inputTn, CTensorBasePtr knnTn, CTensorBasePtr weightTn, CTensorBasePtr biasTn);
 
   void DumpToNumpyFile(PLATFORMS platform, std::string npyFileName, CTensorBasePtr inputTn, std::string npyDumpDir=REPO_DIR"/data/matrix_dumps/");
   bool CompareTensors(PLATFORMS platform, CTensorBasePtr inputTn1, CTensorBasePtr inputTn2);
 
   CTensorBasePtr CrossThePlatformIfNeeded(PLATFORMS destPlatform, CTensorBasePtr srcTn);
+  CTensorBasePtr UploadAsync(CTensorBasePtr srcTn);
+  CTensorBasePtr ShareBuffer(CTensorBasePtr srcTn);
+  CImplementationCpu* GetClassPtrImplementationCpu();
   CImplementationXilinx* GetClassPtrImplementationXilinx();
   CProfiler* GetClassPtrProfiler();
   CWeightLoader* GetClassPtrWeightLoader();
+  CMemoryPlanner* GetClassPtrMemoryPlanner();
+  CBankPlanner* GetClassPtrBankPlanner();
+  void ReportMemoryPoolStats();
+  void ResetMemoryPoolStats();
 
  private:
   template<typename T> CTensorXilPtr<T> CrossThePlatform(PLATFORMS destPlatform, CTensorPtr<T> srcTn);
   template<typename T> CTensorPtr<T> CrossThePlatform(PLATFORMS destPlatform, CTensorXilPtr<T> srcTn);
+  template<typename T> CTensorXilPtr<T> UploadAsync(CTensorPtr<T> srcTn);
 
   CImplementationCpu *m_ptrImplCpu;
   CImplementationXilinx *m_ptrImplXil;
   CWeightLoader *m_ptrWeightsLoader;
   CProfiler *m_ptrProfiler;
+  CMemoryPlanner *m_ptrMemoryPlanner;
   std::string m_strProfilerOutputPath;
   bool m_bEnableOclProfiling, m_bUseShapeNet, m_bLoadWeights, m_bLogMemBankCrossings, m_bEnableCpuUsageSampling, m_bEnableTensorDumps;
 
@@ -65,7 +82,19 @@ class CPlatformSelection {
 template<typename T>
 CTensorXilPtr<T> CPlatformSelection::CrossThePlatform(PLATFORMS destPlatform, CTensorPtr<T> srcTn) {
   assert(destPlatform==PLATFORMS::XIL);
-  auto *dstTn = new CTensorXil<T>(m_ptrImplXil->GetXilInfo(), *(srcTn.get())); // The default bank and AXI width.
+  // The planned bank of the upload, or the default bank. The default AXI width.
+  auto *bankPlanner = m_ptrImplXil->GetXilInfo()->GetBankPlanner();
+  const std::string site = bankPlanner->NextUploadSite();
+  auto *dstTn = new CTensorXil<T>(m_ptrImplXil->GetXilInfo(), *(srcTn.get()), bankPlanner->GetPlannedBank(site));
+  dstTn->SetPlacementSite(site);
+  return CTensorXilPtr<T>(dstTn);
+}
+template<typename T>
+CTensorXilPtr<T> CPlatformSelection::UploadAsync(CTensorPtr<T> srcTn) {
+  auto *bankPlanner = m_ptrImplXil->GetXilInfo()->GetBankPlanner();
+  const int bank = bankPlanner->GetPlannedBank(CBankPlanner::kInputUploadSite);
+  auto *dstTn = new CTensorXil<T>(m_ptrImplXil->GetXilInfo(), *(srcTn.get()), bank, CONFIG_M_AXI_WIDTH, false);
+  if(bankPlanner->IsEnabled()) dstTn->SetPlacementSite(CBankPlanner::kInputUploadSite);
   return CTensorXilPtr<T>(dstTn);
 }
 template<typename T>
@@ -4,58 +4,201 @@
 #include <fstream>
 #include <vector>
 #include <string>
-#include <unordered_map>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
 #include <thread>
-#include "rapidjson/document.h"
-#include "rapidjson/writer.h"
-#include "rapidjson/stringbuffer.h"
 #include "xilinx/config.h"
 #include "GlobalHelpers.h"
 
+/**
+ * @brief The profiler of the layers and the kernels. The events are written as fixed-size binary records
+ * (TraceRecord) into a ring buffer, which is drained into the trace file by a background flusher thread. So the memory
+ * of the profiler is bounded and a crash loses only the records of the last flush period.
+ * The trace file has a TraceFileHeader, the "info" object (JSON text) and the records. It is converted offline to the
+ * JSON trace of Report.py and to the Chrome trace-event format with scripts/ConvertTrace.py.
+ * The producers are the host threads of the layers (StartLayer(), FinishLayer()) and the OpenCL event callback threads
+ * of the runtime (StartKernel(), StartKernelDatamover()). They are serialized by a producer lock that is held only to
+ * fill a record. A producer never waits for the flusher: when the ring is full, the record is dropped and counted
+ * (GetDroppedRecordCount()), so a slow trace file does not stall the callback threads of the runtime. The ring keeps a
+ * slot for the LAYER_STOP of every recorded LAYER_START, and the LAYER_STOP of a dropped LAYER_START is dropped too, so
+ * the layers of the trace stay paired.
+ */
 class CProfiler{
  public:
-  using DictShapePtr = std::unordered_map<std::string, std::vector<unsigned>>;
-  using DictIntPtr = std::unordered_map<std::string, int>;
-  using DictFloatPtr = std::unordered_map<std::string, float>;
+  static constexpr char kMagic[8] = {'D','P','2','T','R','A','C','E'};
+  static constexpr uint32_t kVersion = 2;
+  static constexpr unsigned kMaxNameLen = 40;
+  static constexpr unsigned kMaxKeyLen = 16;
+  static constexpr unsigned kMaxShapeArgs = 4;
+  static constexpr unsigned kMaxIntArgs = 4;
+  static constexpr unsigned kMaxFloatArgs = 2;
+  static constexpr unsigned kMaxRank = 4;
+  static constexpr unsigned kRingCapacity = 8192; // Records, a power of two.
 
-  CProfiler(const std::string &fnameJson, bool enableCpuUsageSampling);
+  enum class RECORD_TYPE: uint8_t{
+    LAYER_START=1,
+    LAYER_STOP=2,
+    KERNEL=3,
+    DATAMOVER=4,
+    CLOCK_SYNC=5  // A pair of the host and the device timestamps of the same instant.
+  };
+
+  struct TraceFileHeader{
+    char magic[8];
+    uint32_t version;
+    uint32_t recordBytes;
+    uint32_t infoBytes;
+    uint32_t reserved;
+  };
+
+  struct TraceRecord{
+    RECORD_TYPE type;
+    uint8_t platform;     // 0 for CPU and 1 for XIL.
+    uint8_t shapeCount;
+    uint8_t intCount;
+    uint8_t floatCount;
+    int8_t srcBank;       // Only for the datamovers.
+    int8_t destBank;      // Only for the datamovers.
+    uint8_t reserved;
+    uint32_t id;
+    uint32_t bytes;       // Only for the datamovers.
+    int64_t timestamp;    // Microseconds, steady clock. Not set for the kernels.
+    uint64_t duration;    // Nanoseconds, only for the kernels and the datamovers.
+    float cpuUsage;
+    uint32_t thread;      // The index of the host thread, only for the layers.
+    char name[kMaxNameLen];
+    struct{
+      char key[kMaxKeyLen];
+      uint32_t rank;
+      uint32_t dims[kMaxRank];
+    } shapes[kMaxShapeArgs];
+    struct{
+      char key[kMaxKeyLen];
+      int32_t value;
+    } ints[kMaxIntArgs];
+    struct{
+      char key[kMaxKeyLen];
+      float value;
+    } floats[kMaxFloatArgs];
+    // The OpenCL profiling timestamps (nanoseconds, the clock of the device), only for the kernels, the datamovers and
+    // the clock syncs.
+    uint64_t deviceQueued;
+    uint64_t deviceSubmit;
+    uint64_t deviceStart;
+    uint64_t deviceEnd;
+  };
+
+  struct DeviceTimestamps{
+    uint64_t queued;
+    uint64_t submit;
+    uint64_t start;
+    uint64_t end;
+  };
+
+  /**
+   * @brief The arguments of a layer. The keys should be string literals, the values are copied into the record.
+   */
+  struct ShapeArg{
+    ShapeArg(const char *key, const std::vector<unsigned> &shape): key(key), shape(shape){}
+    const char *key;
+    const std::vector<unsigned> &shape;
+  };
+  struct IntArg{
+    template<typename T> IntArg(const char *key, T value): key(key), value((int)value){}
+    const char *key;
+    int value;
+  };
+  struct FloatArg{
+    FloatArg(const char *key, float value): key(key), value(value){}
+    const char *key;
+    float value;
+  };
+
+  CProfiler(const std::string &fnameTrace, bool enableCpuUsageSampling);
 
   ~CProfiler();
 
   void StartLayer(PLATFORMS platform,
                   const unsigned layerId,
-                  const std::string &name,
-                  DictShapePtr *dictShapes,
-                  DictIntPtr *dictScalarInt,
-                  DictFloatPtr *dictScalarFloat);
+                  const char *name,
+                  std::initializer_list<ShapeArg> shapes={},
+                  std::initializer_list<IntArg> scalarInts={},
+                  std::initializer_list<FloatArg> scalarFloats={});
 
   void FinishLayer();
 
   void StartKernel(PLATFORMS platform,
                    const unsigned parentLayerId,
                    const std::string &name,
-                   const unsigned long durationNanoSeconds);
+                   const DeviceTimestamps &timestamps);
 
   void StartKernelDatamover(PLATFORMS platform,
                    const unsigned parentLayerId,
                    const unsigned vecCountPadded,
+                   const int srcBank,
+                   const int destBank,
                    const std::string &name,
-                   const unsigned long durationNanoSeconds);
+                   const DeviceTimestamps &timestamps);
+
+  /**
+   * @brief      Records that the device clock read deviceNanoSeconds at the host time hostNanoSeconds (of
+   * GetHostNanoSeconds()), for the exporters to place the device timestamps on the host timeline.
+   */
+  void AddDeviceClockSync(const int64_t hostNanoSeconds, const uint64_t deviceNanoSeconds);
+
+  /**
+   * @brief      Returns the host clock of the layer timestamps in nanoseconds.
+   */
+  static int64_t GetHostNanoSeconds();
 
   void FinishKernel();
   float GetLastCpuUsage();
 
+  /**
+   * @brief      Returns the mean time spent in StartLayer() and FinishLayer() per layer, in nanoseconds.
+   */
+  double GetOverheadPerLayerNanoSeconds() const;
+
+  /**
+   * @brief      Returns the number of the records that were dropped because the ring was full.
+   */
+  uint64_t GetDroppedRecordCount() const;
+
  private:
-  long GetTimestampMicroseconds();
   float _GetCpuUsage();
   void CpuUsageThread();
+  TraceRecord* AcquireRecord(bool isReserved=false);
+  void CommitRecord();
+  std::vector<bool>& GetOpenLayers();
+  void RequestFlush();
+  void FlusherThread();
+  void Flush();
 
-  rapidjson::StringBuffer m_oStrBuffer;
-  rapidjson::Writer<rapidjson::StringBuffer> *m_ptrWriter;
-  std::ofstream *m_ptrFileStream;
+  std::ofstream m_oTraceFile;
   std::string m_strFileName;
   bool m_bEnableCpuUsageSampling;
 
+  std::unique_ptr<TraceRecord[]> m_ptrRing;
+  std::atomic<uint64_t> m_uHead;    // The next record to be written, only advanced by the producer.
+  std::atomic<uint64_t> m_uTail;    // The next record to be flushed, only advanced by the flusher.
+  std::mutex m_oProducerMutex;
+  std::mutex m_oFlushMutex;
+  std::condition_variable m_oFlushCv;
+  bool m_bStopFlusher;
+  bool m_bFlushRequested;
+  std::thread m_oFlusherThread;
+
+  // The counters of the producer, guarded by m_oProducerMutex.
+  uint64_t m_uLayerCount;
+  uint64_t m_uOverheadNanoSeconds;
+  std::atomic<uint64_t> m_uDroppedRecordCount; // Only advanced under m_oProducerMutex.
+  uint64_t m_uOpenLayerCount;                  // The recorded LAYER_STARTs without their LAYER_STOPs.
+  std::vector<std::vector<bool>> m_vOpenLayers; // Per host thread, true for the recorded LAYER_STARTs.
+
   std::atomic<float> m_fCpuUsage;
   std::atomic<bool> m_bStopThread;
   std::thread m_oThread;
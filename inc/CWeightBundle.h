@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "GlobalHelpers.h"
+
+/**
+ * @brief The packed single-file format of the weights of a model (the weight bundle).
+ * The file has a header, an index of the weights (name, shape, bank, tag and the offsets of the data) and two data
+ * sections:
+ *   - The host section: the weights as they are in the numpy files, for the CPU tensors to borrow.
+ *   - The bank sections: one per DDR bank, the weights already padded to the AXI width (the padded last dim policy of
+ *     CTensorXil), so that each bank section is uploaded with a single transfer and the weights are views of it.
+ * All of the sections and the weights in them are aligned to kAlignment bytes, which should be a multiple of the
+ * alignment of the OpenCL sub-buffers of the device (see CXilinxInfo::GetBaseAddrAlignBytes()).
+ * The bundle is written by CWeightLoader::PackWeightsBundle() (the host program with --packweights) and is read with
+ * a single memory mapping.
+ * The header holds a stamp of the source numpy files (see ComputeSourceStamp()), so a bundle that is older than the
+ * files it was packed from is detected and not used.
+ */
+class CWeightBundle {
+ public:
+  static constexpr char kMagic[8] = {'D','P','2','W','B','N','D','L'};
+  static constexpr uint32_t kVersion = 2;
+  static constexpr uint64_t kAlignment = 4096;
+  static constexpr unsigned kMaxNameLen = 128;
+  static constexpr unsigned kMaxTagLen = 32;
+  static constexpr unsigned kMaxRank = 8;
+  static constexpr uint32_t kFlagBatchNormsFolded = 1u;
+  static constexpr const char *kFileName = "weights.bundle"; // In the weights directory of the dataset.
+
+  struct Header{
+    char magic[8];
+    uint32_t version;
+    uint32_t axiWidth;
+    uint32_t flags;
+    uint32_t entryCount;
+    uint32_t bankSectionCount;
+    uint32_t reserved;
+    uint64_t hostSectionOffset;
+    uint64_t hostSectionBytes;
+    uint64_t sourceStamp;
+  };
+
+  struct BankSection{
+    int32_t bank; // -1 is the default bank of CTensorXil.
+    uint32_t reserved;
+    uint64_t offset;
+    uint64_t bytes;
+  };
+
+  struct Entry{
+    char name[kMaxNameLen];
+    char tag[kMaxTagLen];
+    uint32_t rank;
+    uint32_t shape[kMaxRank];
+    int32_t bank;
+    uint32_t bankSectionIndex;
+    uint64_t hostOffset;      // From the start of the file.
+    uint64_t deviceOffset;    // From the start of the bank section.
+    uint64_t deviceBytes;     // Padded.
+  };
+
+  /**
+   * @brief A weight to be packed.
+   */
+  struct Record{
+    std::string name;
+    std::string tag;
+    int bank;
+    std::vector<unsigned> shape;
+    const float *data;
+  };
+
+  /**
+   * @brief      Writes the bundle of the given weights.
+   *
+   * @param[in]  path               The path of the bundle file
+   * @param[in]  records            The weights
+   * @param[in]  axiWidth           The AXI width (in words) that the device copies are padded to
+   * @param[in]  batchNormsFolded   True if the batch-norms are folded into the weights
+   * @param[in]  sourceStamp        The stamp of the numpy files that the weights are read from
+   */
+  static void Write(const std::string &path, const std::vector<Record> &records, unsigned axiWidth, bool batchNormsFolded,
+                    uint64_t sourceStamp);
+
+  /**
+   * @brief      Hashes the file list and the names, the sizes and the modification times of the numpy files in it.
+   * A missing file is hashed as an empty one, so the stamp of the bundle never matches it.
+   *
+   * @param[in]  weightsBaseDir      The weights directory
+   * @param[in]  pathToTxtFnameList  The file list (filelist.txt)
+   */
+  static uint64_t ComputeSourceStamp(const std::string &weightsBaseDir, const std::string &pathToTxtFnameList);
+
+  /**
+   * @brief      Reads only the header of the bundle and checks its version and its source stamp. The reason of a
+   * mismatch is logged.
+   *
+   * @return     False if the bundle should be packed again.
+   */
+  static bool IsUpToDate(const std::string &path, uint64_t sourceStamp);
+
+  /**
+   * @brief      Maps the bundle file and validates its header and index.
+   */
+  explicit CWeightBundle(const std::string &path);
+
+  unsigned GetAxiWidth() const;
+  bool IsBatchNormFolded() const;
+  unsigned GetEntryCount() const;
+  const Entry& GetEntry(unsigned index) const;
+  std::vector<unsigned> GetShape(unsigned index) const;
+  const float* GetHostData(unsigned index) const;
+  unsigned GetBankSectionCount() const;
+  const BankSection& GetBankSection(unsigned index) const;
+  const float* GetBankSectionData(unsigned index) const;
+
+  /**
+   * @brief      Returns the owner of the mapping, for the tensors that borrow the data of the bundle.
+   */
+  std::shared_ptr<void> GetMapping() const;
+
+ private:
+  std::shared_ptr<char> m_ptrMapping;
+  size_t m_uFileBytes;
+  const Header *m_ptrHeader;
+  const Entry *m_ptrEntries;
+  const BankSection *m_ptrBankSections;
+};
@@ -4,33 +4,72 @@
 #include <string>
 #include <cassert>
 #include <vector>
+#include <cmath>
+#include <unordered_map>
 #include "GlobalHelpers.h"
 #include "CTensorBase.h"
 #include "cpu/CTensor.h"
 #include "fpga/xilinx/CTensorXil.h"
 #include "cnpy.h"
+#include "CWeightBundle.h"
 #include "fpga/xilinx/CXilinxInfo.h"
 
 class CWeightLoader {
  public:
-  CWeightLoader(CXilinxInfo *xilInfo, PLATFORMS targetPlatform);
+  /**
+   * @brief An interned weight name, resolved once with ResolveWeight() and valid for the lifetime of the loader.
+   */
+  struct Handle{
+    unsigned index;
+  };
+
+  CWeightLoader(CXilinxInfo *xilInfo, PLATFORMS targetPlatform, bool foldBatchNorms=false);
   ~CWeightLoader();
   void LoadWeightsFromDisk(
       std::string &weightsBaseDir,
       std::string &pathToTxtFnameList);
+  bool LoadWeightsFromBundle(
+      const std::string &bundlePath,
+      const std::string &weightsBaseDir,
+      const std::string &pathToTxtFnameList);
+  void LoadRandomWeights(
+      unsigned classCount,
+      unsigned seed,
+      const std::string &weightsBaseDir,
+      const std::string &pathToTxtFnameList);
+  void PackWeightsBundle(
+      std::string &weightsBaseDir,
+      std::string &pathToTxtFnameList,
+      const std::string &bundlePath);
+  Handle ResolveWeight(const std::string &name) const;
+  const std::string& GetWeightName(Handle handle) const;
+  CTensorBasePtr AccessWeights(PLATFORMS platform, Handle handle) const;
   CTensorBasePtr AccessWeights(PLATFORMS platform, std::string &&name);
+  void ApplyBankPlan();
+  bool IsBatchNormFolded() const;
 
  private:
+  void ReadNumpyFiles(std::string &weightsBaseDir, std::string &pathToTxtFnameList);
+  bool ReadNumpyShapes(
+      const std::string &weightsBaseDir,
+      const std::string &pathToTxtFnameList,
+      std::vector<std::pair<std::string, std::vector<unsigned>>> &weightShapes);
+  void CreateWeightTensors();
+  void FoldBatchNorms();
+  cnpy::NpyArray& GetNumpyArray(const std::string &name);
   int ResolveMemoryBank(PLATFORMS platform, std::string &name);
   int _ResolveMemoryBankOclXilinx(std::string &name);
   std::string _ResolveTensorTagOclXilinx(std::string &name);
 
   bool m_bIsLoaded, m_bLoadXil, m_bLoadCpu;
+  bool m_bFoldBatchNorms; // Fold the inference-time batch-norms into the weights of their preceding layers on loading.
   CXilinxInfo *m_ptrXilInfo;
   unsigned m_uWeightCount;
   std::vector<CTensorBasePtr> m_vWeightsCpu;
   std::vector<CTensorBasePtr> m_vWeightsXil;
-  std::map<std::string,int> m_mWeightNameToIndex;
+  std::unordered_map<std::string,unsigned> m_mWeightNameToIndex;
   std::vector<cnpy::NpyArray> m_vNumpyBuff;
+  std::vector<std::string> m_vWeightNames; // The names of the valid weights, in the order of their indices.
+  std::vector<unsigned> m_vWeightNumpyIndices; // The index of the numpy buffer of every valid weight.
 };
 
@@ -36,13 +36,22 @@ struct CallbackData{
   unsigned kernelBookKeeperId;
   bool profileKernel;
   unsigned optionalValue;
+  int srcBank;  // Only for the datamovers.
+  int destBank; // Only for the datamovers.
 };
 
 struct ProfiledLaunchData{
   unsigned parentLayerId;
   std::string taskName;
   unsigned optionalValue;
+  int srcBank;
+  int destBank;
   cl_ulong durationOcl;
+  // The profiling timestamps of the event (nanoseconds, the clock of the device).
+  cl_ulong timeQueued;
+  cl_ulong timeSubmit;
+  cl_ulong timeStart;
+  cl_ulong timeEnd;
 };
 
 constexpr unsigned DATAMOVER_ID = 4294967295;
@@ -58,6 +67,21 @@ extern bool globalProfileOclEnabled;
 extern bool globalCpuUsageSamplingEnabled;
 extern bool globalModelnet;
 extern bool globalShapenet;
+extern bool globalCpuNaiveKernels;
+extern bool globalFoldBatchNorms;
+extern bool globalFoldBatchNormsCheck;
+extern bool globalMemoryPoolEnabled;
+extern bool globalNpyMmapEnabled;
+extern bool globalMemoryPlannerEnabled;
+extern unsigned globalCpuThreadCount;
+extern bool globalStreamingEnabled;
+extern unsigned globalStreamBatchLimit;
+extern bool globalPipelineEnabled;
+extern bool globalWeightBundleEnabled;
+extern bool globalPackWeightBundle;
+extern bool globalCpuOnly;
+extern bool globalSyntheticData;
+extern std::string globalBankPlanPath;
 
 extern void SetupModules(int argc, const char* argv[]);
 
@@ -24,24 +24,31 @@ namespace cnpy {
 
     struct NpyArray {
         NpyArray(const std::vector<size_t>& _shape, size_t _word_size, bool _fortran_order) :
-            shape(_shape), word_size(_word_size), fortran_order(_fortran_order)
+            shape(_shape), word_size(_word_size), fortran_order(_fortran_order), is_mapped(false)
         {
             num_vals = 1;
             for(size_t i = 0;i < shape.size();i++) num_vals *= shape[i];
-            data_holder = std::shared_ptr<std::vector<char>>(
-                new std::vector<char>(num_vals * word_size));
+            data_holder = std::shared_ptr<char>(new char[num_vals * word_size], std::default_delete<char[]>());
         }
 
-        NpyArray() : shape(0), word_size(0), fortran_order(0), num_vals(0) { }
+        //the data of a memory-mapped file, data_holder points past the header and keeps the whole mapping alive
+        NpyArray(const std::vector<size_t>& _shape, size_t _word_size, bool _fortran_order, std::shared_ptr<char> mapped_data) :
+            data_holder(mapped_data), shape(_shape), word_size(_word_size), fortran_order(_fortran_order), is_mapped(true)
+        {
+            num_vals = 1;
+            for(size_t i = 0;i < shape.size();i++) num_vals *= shape[i];
+        }
+
+        NpyArray() : shape(0), word_size(0), fortran_order(0), num_vals(0), is_mapped(false) { }
 
         template<typename T>
         T* data() {
-            return reinterpret_cast<T*>(&(*data_holder)[0]);
+            return reinterpret_cast<T*>(data_holder.get());
         }
 
         template<typename T>
         const T* data() const {
-            return reinterpret_cast<T*>(&(*data_holder)[0]);
+            return reinterpret_cast<T*>(data_holder.get());
         }
 
         template<typename T>
@@ -51,14 +58,15 @@ namespace cnpy {
         }
 
         size_t num_bytes() const {
-            return data_holder->size();
+            return num_vals * word_size;
         }
 
-        std::shared_ptr<std::vector<char>> data_holder;
+        std::shared_ptr<char> data_holder;
         std::vector<size_t> shape;
         size_t word_size;
         bool fortran_order;
         size_t num_vals;
+        bool is_mapped;
     };
    
     using npz_t = std::map<std::string, NpyArray>; 
@@ -71,7 +79,7 @@ namespace cnpy {
     void parse_zip_footer(FILE* fp, uint16_t& nrecs, size_t& global_header_size, size_t& global_header_offset);
     npz_t npz_load(std::string fname);
     NpyArray npz_load(std::string fname, std::string varname);
-    NpyArray npy_load(std::string fname);
+    NpyArray npy_load(std::string fname, bool use_mmap = false);
 
     template<typename T> std::vector<char>& operator+=(std::vector<char>& lhs, const T rhs) {
         //write in little endian
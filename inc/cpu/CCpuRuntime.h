@@ -0,0 +1,47 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include "cpu/CCpuThreadPool.h"
+
+/**
+ * @brief Runtime facilities shared by the optimized kernels of the CPU implementation:
+ * the host ISA detection (used to dispatch the SIMD code paths) and the parallel-for over independent tasks.
+ * The parallel-for runs on the thread pool that is set with SetThreadPool() (owned by CImplementationCpu), and falls
+ * back to the short-lived threads when there is none.
+ */
+class CCpuRuntime {
+ public:
+  enum class ISA{
+    SCALAR,
+    AVX2,
+    AVX512
+  };
+
+  static ISA GetIsa();
+  static std::string GetIsaName();
+  static unsigned GetDefaultThreadCount();
+
+  static void SetThreadPool(CCpuThreadPool *threadPool);
+  static CCpuThreadPool* GetThreadPool();
+
+  /**
+   * @brief      Runs body(taskIndex, workerIndex) for all of the tasks in [0, taskCount) on up to threadCount threads.
+   * The calling thread is used as the worker zero, so workerIndex is always less than min(taskCount, threadCount).
+   *
+   * @param[in]  taskCount    The task count
+   * @param[in]  threadCount  The maximum number of the threads. Zero means GetDefaultThreadCount().
+   * @param[in]  body         The body
+   */
+  static void ParallelFor(unsigned taskCount, unsigned threadCount, const std::function<void(unsigned,unsigned)> &body);
+
+  /**
+   * @brief      Runs body(begin, end) over the sub-ranges of [0, len), each one of grainSize items at most, on all of the
+   * threads of the pool.
+   *
+   * @param[in]  len        The number of the items
+   * @param[in]  grainSize  The number of the items per task
+   * @param[in]  body       The body
+   */
+  static void ParallelForRange(size_t len, size_t grainSize, const std::function<void(size_t,size_t)> &body);
+};
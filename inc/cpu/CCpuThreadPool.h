@@ -0,0 +1,71 @@
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief A pool of persistent worker threads for the parallel-for of the CPU implementation.
+ * Each call splits its tasks into one contiguous range per worker. A worker runs its own range from the front and,
+ * when it is drained, steals the back half of the largest range left (work-stealing), so the uneven tasks are balanced
+ * without a shared task counter. The calling thread always takes part as the worker zero.
+ */
+class CCpuThreadPool {
+ public:
+  /**
+   * @param[in]  threadCount  The total number of the workers including the calling thread. Zero means the hardware
+   *                          concurrency.
+   */
+  explicit CCpuThreadPool(unsigned threadCount);
+  ~CCpuThreadPool();
+
+  unsigned GetThreadCount() const;
+
+  /**
+   * @brief      Runs body(taskIndex, workerIndex) for all of the tasks in [0, taskCount) on up to maxWorkers workers.
+   * The workerIndex is always less than min(taskCount, maxWorkers, GetThreadCount()). A nested call (from inside a
+   * task) runs serially on the calling worker. The first exception thrown by the body is rethrown after all of the
+   * workers are done.
+   *
+   * @param[in]  taskCount   The task count
+   * @param[in]  maxWorkers  The maximum number of the workers. Zero means GetThreadCount().
+   * @param[in]  body        The body
+   */
+  void ParallelFor(unsigned taskCount, unsigned maxWorkers, const std::function<void(unsigned,unsigned)> &body);
+
+  /**
+   * @brief      Returns true if the calling thread is running a task of a pool.
+   */
+  static bool IsInsideTask();
+
+ private:
+  struct TaskRange{
+    std::mutex mutex;
+    unsigned begin;
+    unsigned end;
+  };
+
+  void WorkerLoop(unsigned workerIndex);
+  void RunWorker(unsigned workerIndex);
+  bool PopTask(unsigned workerIndex, unsigned &task);
+  bool StealTasks(unsigned workerIndex);
+
+  unsigned m_uThreadCount;
+  std::vector<std::thread> m_vThreads;
+  std::vector<std::unique_ptr<TaskRange>> m_vRanges;
+
+  std::mutex m_oCallMutex;      // Serializes the calls from different host threads.
+  std::mutex m_oMutex;
+  std::condition_variable m_oCvStart;
+  std::condition_variable m_oCvDone;
+  unsigned long m_uGeneration;
+  unsigned m_uActiveWorkers;
+  unsigned m_uPendingWorkers;
+  bool m_bStop;
+  const std::function<void(unsigned,unsigned)> *m_ptrBody;
+  std::exception_ptr m_oException;
+};
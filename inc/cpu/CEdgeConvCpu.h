@@ -0,0 +1,35 @@
+#pragma once
+
+/**
+ * @brief Fused EdgeConv for the CPU implementation: the edge features of DGCNN followed by the 1x1 convolution.
+ * For every point i and its neighbour j = knn[i][kk], the output row (i,kk) is [x_i, x_j - x_i] x W + bias.
+ * The result is identical to Conv2D(Concat2(Tile(x), Gather(x) - Tile(x), 3), W, bias) of CModel1.
+ *
+ * The BxNxKx2D edge features are never materialized. A tile of edge rows is built on the fly in a per-worker
+ * buffer and is fed to the blocked GEMM, which writes (with the fused bias) directly into the output tensor.
+ */
+class CEdgeConvCpu {
+ public:
+  /**
+   * @brief      The fused EdgeConv.
+   *
+   * @param[in]  ptrInput     The point clouds of batchSize x pointCount x dim
+   * @param[in]  ptrIndices   The neighbour indices of batchSize x pointCount x k
+   * @param[in]  ptrWeight    The weight of (2*dim) x chOut
+   * @param[in]  ptrBias      The bias of chOut
+   * @param      ptrOutput    The output of batchSize x pointCount x k x chOut
+   * @param[in]  threadCount  The maximum number of worker threads to be used. Zero means all of the cores.
+   */
+  static void EdgeConv(
+      const float *ptrInput,
+      const unsigned *ptrIndices,
+      const float *ptrWeight,
+      const float *ptrBias,
+      float *ptrOutput,
+      unsigned batchSize,
+      unsigned pointCount,
+      unsigned dim,
+      unsigned k,
+      unsigned chOut,
+      unsigned threadCount=0);
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+/**
+ * @brief Batched single precision GEMM for the CPU implementation.
+ * All of the matrices are row-major and dense: C[b] = A[b] x B[b] (+ bias) with A[b] of MxK, B[b] of KxN and C[b] of MxN.
+ * The optional bias of length N is added to every row of C on the final write-back (used by Conv2D).
+ * The blocked path packs the panels of B (NR columns wide) and the micro-panels of A (MR rows high) into
+ * contiguous buffers and runs a register-blocked micro-kernel over them. The micro-kernel is selected at runtime
+ * based on the ISA extensions available on the host (AVX-512F, AVX2+FMA or plain scalar C++).
+ * The work is split over batch x row-tiles between the worker threads.
+ * GemmNaive() is kept as the reference implementation.
+ */
+class CGemmCpu {
+ public:
+  /**
+   * @brief      The blocked, packed and vectorized batched GEMM.
+   *
+   * @param[in]  ptrA         The pointer to A, batchSize x sizeM x sizeK
+   * @param[in]  ptrB         The pointer to B, batchSize x sizeK x sizeN
+   * @param      ptrC         The pointer to C, batchSize x sizeM x sizeN
+   * @param[in]  ptrBias      The pointer to the bias of length sizeN, or nullptr.
+   * @param[in]  threadCount  The maximum number of worker threads to be used. Zero means all of the cores.
+   */
+  static void Gemm(
+      const float *ptrA,
+      const float *ptrB,
+      float *ptrC,
+      unsigned batchSize,
+      unsigned sizeM,
+      unsigned sizeK,
+      unsigned sizeN,
+      const float *ptrBias=nullptr,
+      unsigned threadCount=0);
+
+  /**
+   * @brief      The reference implementation (the original loops of CImplementationCpu::MatMul and Conv2D).
+   */
+  static void GemmNaive(
+      const float *ptrA,
+      const float *ptrB,
+      float *ptrC,
+      unsigned batchSize,
+      unsigned sizeM,
+      unsigned sizeK,
+      unsigned sizeN,
+      const float *ptrBias=nullptr);
+};
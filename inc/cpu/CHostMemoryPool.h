@@ -0,0 +1,77 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "CMemoryPoolStats.h"
+
+/**
+ * @brief The size-classed pool of the page-aligned host buffers of CTensor.
+ * The buffers of the released tensors are kept in per-size-class free lists and are handed out again to the new
+ * tensors of the same size class, so that the forward pass does not call posix_memalign()/free() per layer.
+ * The cached bytes are capped (see SetMaxCachedBytes()), the least recently released buffers are freed first, so the
+ * cache does not grow without bound when the shapes change between the passes.
+ * There is one instance per process, it is thread-safe.
+ */
+class CHostMemoryPool {
+ public:
+  static constexpr size_t kDefaultMaxCachedBytes = 2UL*1024*1024*1024;
+
+  static CHostMemoryPool& GetInstance();
+
+  void* Allocate(size_t sizeBytes);
+  void Release(void *ptr, size_t sizeBytes);
+
+  /**
+   * @brief      Frees all of the cached buffers that are not in use.
+   */
+  void Trim();
+
+  /**
+   * @brief      Sets the cap of the bytes of the cached buffers and evicts the least recently released buffers down to
+   *             it. A buffer larger than the cap is never cached.
+   */
+  void SetMaxCachedBytes(size_t maxCachedBytes);
+  size_t GetMaxCachedBytes() const;
+  size_t GetCachedBytes() const;
+
+  /**
+   * @brief      When disabled, every allocation goes to posix_memalign() and every release to free(). The counters
+   * are kept in both modes, so that the allocator churn could be compared.
+   */
+  void SetEnabled(bool enabled);
+  bool IsEnabled() const;
+  void ReportStats() const;
+  void ResetStats();
+
+ private:
+  struct CachedBuffer{
+    void *ptr;
+    unsigned long releaseTick;
+  };
+
+  CHostMemoryPool() = default;
+  ~CHostMemoryPool() = default;
+  void EvictOverCap(std::vector<void*> &evicted);
+
+  mutable std::mutex m_oMutex;
+  bool m_bEnabled=true;
+  size_t m_uMaxCachedBytes=kDefaultMaxCachedBytes;
+  unsigned long m_uReleaseTick=0;
+  std::map<size_t, std::vector<CachedBuffer>> m_mFreeLists; // The oldest buffer of a size class is at the front.
+  CMemoryPoolStats m_oStats;
+};
+
+/**
+ * @brief The deleter of the host buffers allocated from CHostMemoryPool.
+ * A borrowed buffer (for example, a slice of a memory-mapped numpy file) is not owned by the pool, it is only kept
+ * alive by `borrowedFrom` and is never returned to the pool.
+ */
+struct CHostBufferDeleter {
+  size_t sizeBytes;
+  std::shared_ptr<void> borrowedFrom;
+  void operator()(void *ptr) const{
+    if(ptr!=nullptr && borrowedFrom==nullptr) CHostMemoryPool::GetInstance().Release(ptr, sizeBytes);
+  }
+};
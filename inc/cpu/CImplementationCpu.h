@@ -9,11 +9,13 @@
 #include "CImplementationBase.h"
 #include "CTensor.h"
 #include "CProfiler.h"
+#include "CCpuThreadPool.h"
 #include "cnpy.h"
 
 class CImplementationCpu: public CImplementationBase {
  public:
   CImplementationCpu(CProfiler *profiler, bool enableTensorDumps);
+  ~CImplementationCpu();
 
   CTensorBasePtr Concat2      (CTensorBasePtr inputTn1, CTensorBasePtr inputTn2, unsigned concatAxis) override;
   CTensorBasePtr MatMul       (CTensorBasePtr inputTn1, CTensorBasePtr inputTn2) override;
@@ -22,23 +24,47 @@ class CImplementationCpu: public CImplementationBase {
   CTensorBasePtr Square       (CTensorBasePtr inputTn) override;
   CTensorBasePtr BasicOps     (CTensorBasePtr inputTn1, CTensorBasePtr inputTn2, BASIC_OPS mode) override;
   CTensorBasePtr BasicOps     (CTensorBasePtr inputTn1, float scalar, BASIC_OPS mode) override;
+
+  /**
+   * @brief      The elementwise layers with an explicit in-place decision. With inPlace set, the results are written
+   * into the (first) input tensor instead of a new one. Used by the memory planner for the inputs whose buffers are
+   * not read after the layer.
+   */
+  CTensorBasePtr ReLU         (CTensorBasePtr inputTn, bool inPlace);
+  CTensorBasePtr Sqrt         (CTensorBasePtr inputTn, bool inPlace);
+  CTensorBasePtr Square       (CTensorBasePtr inputTn, bool inPlace);
+  CTensorBasePtr BasicOps     (CTensorBasePtr inputTn1, CTensorBasePtr inputTn2, BASIC_OPS mode, bool inPlace);
+  CTensorBasePtr BasicOps     (CTensorBasePtr inputTn1, float scalar, BASIC_OPS mode, bool inPlace);
   CTensorBasePtr Tile         (CTensorBasePtr inputTn, unsigned tileAxis, unsigned tileCount) override;
   CTensorBasePtr Transpose    (CTensorBasePtr inputTn) override;
   CTensorBasePtr Gather       (CTensorBasePtr inputTn, CTensorBasePtr indicesTn, unsigned indicesOfAxis) override;
   CTensorBasePtr Reduce       (CTensorBasePtr inputTn, REDUCTION_OPS mode, unsigned powY, const std::vector<unsigned> &combination) override ;
   CTensorBasePtr Mean         (CTensorBasePtr inputTn, const std::vector<unsigned> &combination) override;
   CTensorBasePtr Variance     (CTensorBasePtr inputTn, const std::vector<unsigned> &combination) override;
+  std::vector<CTensorBasePtr> MeanVariance (CTensorBasePtr inputTn, const std::vector<unsigned> &combination) override;
   CTensorBasePtr PadLastDim   (CTensorBasePtr inputTn, unsigned lastDimPadded) override;
   CTensorBasePtr UnpadLastDim (CTensorBasePtr inputTn, unsigned lastDimUnpadded) override;
   CTensorBasePtr TopK         (CTensorBasePtr inputTn, unsigned axis, unsigned k) override;
   CTensorBasePtr Conv2D       (CTensorBasePtr inputTn, CTensorBasePtr weightTn, CTensorBasePtr biasTn) override;
+  CTensorBasePtr KNN          (CTensorBasePtr inputTn, unsigned k) override;
+  CTensorBasePtr EdgeConv     (CTensorBasePtr inputTn, CTensorBasePtr knnTn, CTensorBasePtr weightTn, CTensorBasePtr biasTn) override;
 
   void DumpToNumpyFile(std::string npyFileName, CTensorBasePtr inputTn, std::string npyDumpDir);
   bool CompareTensors(CTensorBasePtr inputTn1, CTensorBasePtr inputTn2);
 
+  void SetUseNaiveKernels(bool useNaiveKernels);
+  bool GetUseNaiveKernels() const;
+  unsigned GetThreadCount() const;
+
  private:
   template <typename T> void DumpToNumpyFile(std::string npyFileName, CTensorPtr<T> inputTn, std::string npyDumpDir);
   template <typename T> bool CompareTensors(CTensorPtr<T> inputTn1, CTensorPtr<T> inputTn2);
+  CTensorPtr<float> CreateElementwiseResult(CTensorPtr<float> inputTn, bool inPlace);
+
+  // When true, the layers use the original loops (the reference implementations) instead of the optimized kernels.
+  bool m_bUseNaiveKernels;
+  // The workers of all of the layers and the CPU kernels (registered in CCpuRuntime).
+  CCpuThreadPool *m_ptrThreadPool;
 };
 
 template<typename T>
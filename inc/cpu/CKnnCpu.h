@@ -0,0 +1,35 @@
+#pragma once
+
+/**
+ * @brief Fused k-nearest-neighbours for the CPU implementation (pairwise distance + top-k).
+ * For every point i of every batch, the output holds the indices of the k points with the smallest
+ * |x_i|^2 + |x_j|^2 - 2 x_i.x_j in ascending order (the point itself included), with the ties broken by
+ * the lower index first. The distances are the ones of CImplementationBase::KnnByPairwiseDistance() up to the
+ * rounding of their different summation orders, so the points at nearly equal distances could be ordered differently.
+ *
+ * The BxNxN distance matrix is never materialized. The points are processed in tiles of rows: the inner products
+ * of a tile against all of the points of the cloud are computed with the blocked GEMM into a per-worker buffer,
+ * turned into distances in place, and each row is reduced to its k-selection right away.
+ */
+class CKnnCpu {
+ public:
+  /**
+   * @brief      The fused KNN.
+   *
+   * @param[in]  ptrInput     The point clouds of batchSize x pointCount x dim
+   * @param      ptrIndices   The output indices of batchSize x pointCount x k
+   * @param[in]  batchSize    The batch size
+   * @param[in]  pointCount   The point count, should be greater than k
+   * @param[in]  dim          The dimension of the points' features
+   * @param[in]  k            The k
+   * @param[in]  threadCount  The maximum number of worker threads to be used. Zero means all of the cores.
+   */
+  static void Knn(
+      const float *ptrInput,
+      unsigned *ptrIndices,
+      unsigned batchSize,
+      unsigned pointCount,
+      unsigned dim,
+      unsigned k,
+      unsigned threadCount=0);
+};
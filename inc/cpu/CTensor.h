@@ -5,6 +5,7 @@
 #include "CTensorBase.h"
 #include <memory>
 #include "CStringFormatter.h"
+#include "cpu/CHostMemoryPool.h"
 #include <typeinfo>
 #include <algorithm>
 
@@ -16,8 +17,10 @@ class CTensor: public CTensorBase {
   CTensor(const CTensor<T>& other);
   CTensor(const std::vector<unsigned> &shape);
   CTensor(const std::vector<unsigned> &shape, T* srcBuffToBeCopied);
+  CTensor(const std::vector<unsigned> &shape, T* borrowedBuff, std::shared_ptr<void> borrowedFrom);
   CTensor& operator=(const CTensor<T>& other);
   unsigned long GetSizeBytes() const override;
+  bool IsBorrowed() const;
   const std::type_info& GetType() const;
   T& operator[](std::size_t flattenedRowMajorIndex);
   T* Get();
@@ -29,9 +32,10 @@ class CTensor: public CTensorBase {
  private:
   void CloneFrom(const CTensor<T> &other);
   void SetTypeInfo();
+  void AllocateHostBuffer(unsigned long len);
 
-  //using BuffType = std::unique_ptr<T[], decltype(&free)>;
-  using BuffType = std::unique_ptr<T[]>;
+  // The page-aligned buffer is drawn from CHostMemoryPool and is returned to it when the tensor is released.
+  using BuffType = std::unique_ptr<T[], CHostBufferDeleter>;
 
   BuffType m_pHostBuffAligned;
 };
@@ -82,12 +86,9 @@ void CTensor<T>::CloneFrom(const CTensor<T> &other) {
   if (this != &other){ // not a self-assignment
     SetTypeInfo();
     SetPlatform(PLATFORMS::CPU);
-    if(other.GetLen()!=GetLen()){ // reuse already available buffer of the same size
+    if(other.GetLen()!=GetLen() || IsBorrowed()){ // reuse already available buffer of the same size, unless borrowed
       SetShape(other.GetShape());
-      void *ptr = nullptr;
-      if (posix_memalign(&ptr, 4096, other.GetLen() * sizeof(T)))
-        ThrowException("Failed to allocate aligned memory (std::bad_alloc())!");
-      m_pHostBuffAligned.reset(reinterpret_cast<T *>(ptr));
+      AllocateHostBuffer(other.GetLen());
     }
     std::copy(&other.m_pHostBuffAligned[0], &other.m_pHostBuffAligned[0] + GetLen(), &m_pHostBuffAligned[0]);
   }
@@ -107,10 +108,7 @@ CTensor<T>::CTensor(const std::vector<unsigned> &shape) {
   if(newLen<1)
     ThrowException("Bad tensor shape to create a tensor with.");
   SetShape(shape);
-  void *ptr = nullptr;
-  if (posix_memalign(&ptr, 4096, newLen * sizeof(T)))
-    ThrowException("Failed to allocate aligned memory (bad_alloc())!");
-  m_pHostBuffAligned.reset(reinterpret_cast<T *>(ptr));
+  AllocateHostBuffer(newLen);
 }
 
 template<typename T>
@@ -119,13 +117,34 @@ CTensor<T>::CTensor(const std::vector<unsigned> &shape, T *srcBuffToBeCopied) {
   SetPlatform(PLATFORMS::CPU);
   const unsigned long newLen = CheckShape(shape);
   SetShape(shape);
-  void *ptr = nullptr;
-  if (posix_memalign(&ptr, 4096, newLen * sizeof(T)))
-    ThrowException("Failed to allocate aligned memory (bad_alloc())!");
-  m_pHostBuffAligned.reset(reinterpret_cast<T *>(ptr));
+  AllocateHostBuffer(newLen);
   std::copy(&srcBuffToBeCopied[0], &srcBuffToBeCopied[0] + newLen, &m_pHostBuffAligned[0]);
 }
 
+/**
+ * @brief      Wraps an existing host buffer without copying it (zero-copy), e.g. the data of a memory-mapped numpy file.
+ * The tensor keeps `borrowedFrom` alive instead of owning the buffer, and the buffer is never returned to
+ * CHostMemoryPool. The writes to the tensor go to the borrowed buffer.
+ *
+ * @param[in]  shape         The shape
+ * @param      borrowedBuff  The buffer, at least as long as the shape
+ * @param[in]  borrowedFrom  The owner of the buffer
+ */
+template<typename T>
+CTensor<T>::CTensor(const std::vector<unsigned> &shape, T *borrowedBuff, std::shared_ptr<void> borrowedFrom) {
+  SetTypeInfo();
+  SetPlatform(PLATFORMS::CPU);
+  const unsigned long newLen = CheckShape(shape);
+  ConditionCheck(borrowedFrom!=nullptr, "The owner of the borrowed buffer is not given.");
+  SetShape(shape);
+  m_pHostBuffAligned = BuffType(borrowedBuff, CHostBufferDeleter{newLen*sizeof(T), std::move(borrowedFrom)});
+}
+
+template<typename T>
+bool CTensor<T>::IsBorrowed() const {
+  return m_pHostBuffAligned.get_deleter().borrowedFrom!=nullptr;
+}
+
 template<typename T>
 unsigned long CTensor<T>::CheckShape(const std::vector<unsigned> &shape) {
   const unsigned long newLen = accumulate(begin(shape), end(shape), 1, std::multiplies<unsigned>());
@@ -142,6 +161,13 @@ const T *CTensor<T>::GetConst() const {
   return m_pHostBuffAligned.get();
 }
 template<typename T>
+void CTensor<T>::AllocateHostBuffer(unsigned long len) {
+  const size_t sizeBytes = len * sizeof(T);
+  m_pHostBuffAligned = BuffType(
+      reinterpret_cast<T *>(CHostMemoryPool::GetInstance().Allocate(sizeBytes)),
+      CHostBufferDeleter{sizeBytes});
+}
+template<typename T>
 void CTensor<T>::SetTypeInfo() {
   m_bTypeIsFloat = std::is_floating_point<T>::value;
   m_bTypeIsUint = std::is_integral<T>::value && std::is_unsigned<T>::value;
@@ -0,0 +1,58 @@
+#pragma once
+
+/**
+ * @brief k-selection over the rows of a row-major matrix for the CPU implementation (the smallest k values).
+ * The output of each row is the indices of its k smallest elements in ascending order.
+ * The order is strict on (value, index), meaning that the ties are broken by the lower index first. This is the
+ * order of a stable sort, and the same order as the merge-sort of task_topk which picks the left element on ties.
+ *
+ * The optimized path keeps a bounded max-heap of k (value, index) pairs per row. The elements that are not less
+ * than the heap's top are skipped with a SIMD threshold filter, so that only the few candidates touch the heap.
+ * The rows are distributed between the worker threads.
+ */
+class CTopKCpu {
+ public:
+  struct Candidate{
+    float value;
+    unsigned index;
+  };
+
+  /**
+   * @brief      The bounded-heap k-selection.
+   *
+   * @param[in]  ptrInput     The input matrix of rowCount x rowLen
+   * @param      ptrIndices   The output matrix of rowCount x k
+   * @param[in]  rowCount     The row count
+   * @param[in]  rowLen       The row length, should be greater than or equal to k
+   * @param[in]  k            The k
+   * @param[in]  threadCount  The maximum number of worker threads to be used. Zero means all of the cores.
+   */
+  static void TopK(
+      const float *ptrInput,
+      unsigned *ptrIndices,
+      unsigned rowCount,
+      unsigned rowLen,
+      unsigned k,
+      unsigned threadCount=0);
+
+  /**
+   * @brief      The reference implementation, a full stable sort of every row.
+   */
+  static void TopKNaive(
+      const float *ptrInput,
+      unsigned *ptrIndices,
+      unsigned rowCount,
+      unsigned rowLen,
+      unsigned k);
+
+  /**
+   * @brief      Selects the k smallest elements of a single row into ptrIndices (k elements).
+   * The scratch should have room for k candidates, it is used as the heap storage.
+   */
+  static void SelectRow(const float *ptrRow, unsigned rowLen, unsigned k, unsigned *ptrIndices, Candidate *scratch);
+
+  /**
+   * @brief      Returns the first index in [begin, rowLen) with ptrRow[index] < threshold, or rowLen if none.
+   */
+  static unsigned FindFirstLess(const float *ptrRow, unsigned begin, unsigned rowLen, float threshold);
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+#include "GlobalHelpers.h"
+#include "CTensorBase.h"
+
+/**
+ * @brief The lifetime manager of the tensors of the asynchronous kernel launches.
+ * A launch pins its tensors (the raw inputs, their bank-crossed clones and the outputs) until the CL_COMPLETE callback
+ * of its event, whether the profiling is enabled or not, so a long running process keeps a flat memory usage.
+ * The callback records are recycled from a fixed ring: a launch that finds the ring full waits for the completion of
+ * an older launch. The records could be released from the OpenCL callbacks, so the class is thread-safe.
+ */
+class CAsyncLifetimeManager {
+ public:
+  static constexpr unsigned kDefaultRingSize = 1024;
+
+  explicit CAsyncLifetimeManager(unsigned ringSize=kDefaultRingSize);
+  ~CAsyncLifetimeManager();
+
+  /**
+   * @brief      Pins the tensors of a launch and returns its callback record, to be passed to setCallback().
+   *             Should be called before setCallback(), as the callback could be run as soon as it is set.
+   *
+   * @param[in]  tensors        The tensors to keep alive until the launch has completed (the duplicates are counted once)
+   * @param[in]  classPtr       The kernel wrapper of the launch
+   * @param[in]  parentLayerId  The layer id of the launch
+   * @param[in]  profileKernel  Whether the callback should query the profiling timestamps
+   */
+  CallbackData* Pin(const std::vector<CTensorBasePtr> &tensors, void *classPtr, unsigned parentLayerId, bool profileKernel);
+
+  /**
+   * @brief      Drops the tensors of the launch of the record and recycles the record.
+   *             The record should not be used after this call.
+   */
+  void Release(CallbackData *record);
+
+  /**
+   * @brief      Blocks until all of the pinned launches have been released.
+   */
+  void WaitForAll();
+
+  unsigned GetInFlightLaunches() const;
+  unsigned long GetLiveTensors() const;
+  unsigned long GetLiveDeviceBytes() const;
+  unsigned long GetPeakDeviceBytes() const;
+  unsigned GetRingSize() const;
+
+  void ReportStats() const;
+  void ResetStats();
+
+ private:
+  struct Record{
+    CallbackData data;
+    std::vector<CTensorBasePtr> tensors;
+    unsigned long sizeBytes;
+    bool inUse;
+  };
+
+  std::vector<Record> m_vRing;
+  unsigned m_uNextSlot;
+  unsigned m_uInFlight;
+  unsigned long m_uLiveTensors;
+  unsigned long m_uLiveBytes;
+  unsigned long m_uPeakBytes;
+  unsigned long m_uPinnedLaunches;
+  unsigned long m_uRingStalls;
+  mutable std::mutex m_oMutex;
+  std::condition_variable m_oReleasedCv;
+};
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include "GlobalHelpers.h"
+
+/**
+ * @brief The runtime placement planner of the DDR banks of the device tensors.
+ *
+ * The first forward pass is recorded through CTensorXil::CloneIfNeededToBank(): every tensor that a kernel reads from a
+ * bank other than its own is a crossing, and the bytes that the datamover kernel actually moves are counted. The
+ * tensors are grouped by their placement sites: a weight (its name) and a CPU to XIL upload (the graph node that it is
+ * made for and its ordinal in that node, or the input of the model). At the end of the pass each site is assigned the enabled bank that minimizes the bytes
+ * that its consumers would cross, with the crossings of a weight counted once per bank (see the bank replicas of
+ * CTensorXil). The later passes upload to the planned banks, the weights are moved once by CWeightLoader::ApplyBankPlan().
+ *
+ * The banks of the kernel ports are fixed when the FPGA image is linked (the `config` submodule), so the outputs of
+ * the kernels are not planned: their crossings are reported as fixed and are left to scripts/bank_optimizer_v2.py.
+ * The plan could be saved to a file and loaded by the next runs, so that the weights are uploaded to their planned
+ * banks from the start (CWeightLoader::_ResolveMemoryBankOclXilinx()).
+ */
+class CBankPlanner {
+ public:
+  static constexpr const char *kInputUploadSite = "upload.input";
+
+  /**
+   * @param[in]  enabled   Whether the passes are recorded and planned.
+   * @param[in]  planPath  The plan file. It is loaded if it exists, otherwise the plan of the first pass is saved to it.
+   *                       Could be empty.
+   */
+  CBankPlanner(bool enabled, const std::string &planPath);
+
+  bool IsEnabled() const;
+  bool HasPlan() const;
+  bool IsPlanLoaded() const;
+
+  /**
+   * @brief      Starts recording a forward pass.
+   */
+  void BeginPass();
+
+  /**
+   * @brief      Finishes the pass, builds the plan if this is the first recorded pass and reports the bytes moved.
+   *
+   * @return     True if a new plan has been built by this call.
+   */
+  bool EndPass();
+
+  /**
+   * @brief      The placement site of a weight.
+   */
+  static std::string GetWeightSite(const std::string &weightName);
+
+  /**
+   * @brief      Sets the scope of the next uploads (the graph node being executed), so their sites do not depend on the
+   *             uploads of the other nodes. An empty scope falls back to the ordinals in the pass.
+   */
+  void SetUploadScope(const std::string &scope);
+
+  /**
+   * @brief      Returns the placement site of the next CPU to XIL upload of the pass (see SetUploadScope()), or an
+   *             empty string if there is no pass being recorded.
+   */
+  std::string NextUploadSite();
+
+  /**
+   * @brief      Returns the planned bank of the site or -1 (the default bank) if the site is not planned.
+   *             Could be called concurrently, as long as no pass is being finished.
+   */
+  int GetPlannedBank(const std::string &site) const;
+
+  /**
+   * @brief      Records a read of a tensor by a kernel on destBank.
+   *
+   * @param[in]  site           The placement site of the tensor, empty for the outputs of the kernels.
+   * @param[in]  srcBank        The bank of the tensor
+   * @param[in]  destBank       The bank of the kernel port
+   * @param[in]  bytes          The bytes that a crossing would move
+   * @param[in]  hasReplicas    True if the tensor keeps its bank replicas, so it crosses once per bank.
+   */
+  void RecordRead(const std::string &site, int srcBank, unsigned destBank, unsigned long bytes, bool hasReplicas);
+
+  /**
+   * @brief      Records a launch of the datamover kernel.
+   */
+  void RecordMove(unsigned long bytes);
+
+  unsigned long GetRecordedBytes() const;
+  unsigned long GetPlannedBytes() const;
+  unsigned long GetFixedBytes() const;
+  unsigned long GetMeasuredBytes() const;
+
+  static bool IsBankEnabled(unsigned bank);
+
+ private:
+  struct SiteRecord{
+    int homeBank;
+    bool hasReplicas;
+    unsigned long readBytes[4];
+  };
+
+  static unsigned long CrossedBytes(const SiteRecord &record, int homeBank);
+  void BuildPlan();
+  bool LoadPlan();
+  void SavePlan() const;
+  void Report() const;
+
+  bool m_bEnabled;
+  bool m_bPassStarted;
+  unsigned m_uPassCount;
+  unsigned m_uUploadCount;
+  std::string m_strUploadScope;
+  unsigned m_uScopeUploadCount;
+  std::string m_strPlanPath;
+
+  // The current pass
+  std::map<std::string, SiteRecord> m_mSites;
+  unsigned long m_uFixedBytes;
+  unsigned long m_uMeasuredBytes;
+
+  // The plan, built at the end of the first pass or loaded from the plan file
+  bool m_bHasPlan;
+  bool m_bPlanIsLoaded;
+  std::map<std::string, int> m_mPlan;
+  unsigned long m_uRecordedBytes;
+  unsigned long m_uPlannedBytes;
+  unsigned long m_uRecordedFixedBytes;
+};
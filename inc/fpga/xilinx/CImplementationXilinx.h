@@ -50,10 +50,13 @@ class CImplementationXilinx: public CImplementationBase {
   CTensorBasePtr Reduce       (CTensorBasePtr inputTn, REDUCTION_OPS mode, unsigned powY, const std::vector<unsigned> &combination) override;
   CTensorBasePtr Mean         (CTensorBasePtr inputTn, const std::vector<unsigned> &combination) override ;
   CTensorBasePtr Variance     (CTensorBasePtr inputTn, const std::vector<unsigned> &combination) override ;
+  std::vector<CTensorBasePtr> MeanVariance (CTensorBasePtr inputTn, const std::vector<unsigned> &combination) override ;
   CTensorBasePtr PadLastDim   (CTensorBasePtr inputTn, unsigned lastDimPadded) override ;
   CTensorBasePtr UnpadLastDim (CTensorBasePtr inputTn, unsigned lastDimUnpadded) override ;
   CTensorBasePtr TopK         (CTensorBasePtr inputTn, unsigned axis, unsigned k) override ;
   CTensorBasePtr Conv2D       (CTensorBasePtr inputTn, CTensorBasePtr weightTn, CTensorBasePtr biasTn) override ;
+  CTensorBasePtr KNN          (CTensorBasePtr inputTn, unsigned k) override ;
+  CTensorBasePtr EdgeConv     (CTensorBasePtr inputTn, CTensorBasePtr knnTn, CTensorBasePtr weightTn, CTensorBasePtr biasTn) override ;
 
  private:
   bool m_bEnableOclProfiling, m_bLogMemBankCrossings;
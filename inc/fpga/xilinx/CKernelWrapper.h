@@ -7,6 +7,7 @@
 #include "CTensorBase.h"
 #include "GlobalHelpers.h"
 #include "fpga/xilinx/CXilinxInfo.h"
+#include "fpga/xilinx/CAsyncLifetimeManager.h"
 #include <cassert>
 #include "GlobalHelpers.h"
 
@@ -29,20 +30,17 @@ class CKernelWrapper {
   bool GetProfileOclEnabled() const;
   bool IsKernelEnabled() const;
   std::vector<ProfiledLaunchData>& GetAccumulatedProfiledKernelLaunchData();
-  void ResetBookKeeper();
-  unsigned GetTotalTensorsInBookKeeper();
-  unsigned GenerateBookKeeperId();
-  unsigned GetTheLastBookKeeperId();
-  CallbackData* GenerateAndStoreCallBackData(void* classPtr, unsigned parentLayerId);
-  void StoreBookKeepingEntry(const std::vector<CTensorBasePtr> &vecTensorsToBePreserved);
-  void ReleaseBookKeepingEntryAt(unsigned kernelBookKeepingId);
+
+  /**
+   * @brief      Pins the tensors of a launch in the lifetime manager of CXilinxInfo until its event has completed and
+   *             returns the callback data of the launch. Should be called before setting EventCallback on the event.
+   */
+  CallbackData* StoreBookKeepingEntry(unsigned parentLayerId, const std::vector<CTensorBasePtr> &vecTensorsToBePreserved);
 
  protected:
   static void EventCallback(cl_event event, cl_int execStatus, void* userData);
-  void AddProfiledKernelLaunchDetails(std::string taskName, unsigned parentLayerId, cl_ulong durationNanoSecOcl);
+  void AddProfiledKernelLaunchDetails(const ProfiledLaunchData &data);
 
-  std::vector<CallbackData*> m_vCallBackData;
-  std::vector<std::vector<CTensorBasePtr>> m_vBookKeeper;
   std::vector<std::string> m_vMemBankCrossings;
   bool m_bLogMemBankCrossings;
 
@@ -55,6 +53,6 @@ class CKernelWrapper {
   CXilinxInfo *m_oXilInfo;
   int m_iArgCounter;
   std::vector<ProfiledLaunchData> m_vProfiledKernelLaunches;
-  unsigned m_uBookKeeperCounter;
+  std::shared_ptr<CAsyncLifetimeManager> m_ptrLifetimeManager;
 };
 
@@ -26,8 +26,16 @@ class CTensorXil: public CTensorBase, public std::enable_shared_from_this<CTenso
   CTensorXil& operator=(const CTensorXil<T>& other);
   CTensorXil(CXilinxInfo *xilInfo, const std::vector<unsigned> &shape, bool fillZeros, int bank=-1, int axiWidth = CONFIG_M_AXI_WIDTH);
   CTensorXil(CXilinxInfo *xilInfo, const std::vector<unsigned> &shape, const T* hostBuff, int bank=-1, int axiWidth = CONFIG_M_AXI_WIDTH);
-  CTensorXil(CXilinxInfo *xilInfo, const CTensor<T> &hostTn, int bank=-1, int axiWidth = CONFIG_M_AXI_WIDTH);
+  CTensorXil(CXilinxInfo *xilInfo, const CTensor<T> &hostTn, int bank=-1, int axiWidth = CONFIG_M_AXI_WIDTH, bool isBlocking=true);
+  CTensorXil(CXilinxInfo *xilInfo, const std::vector<unsigned> &shape, const T* paddedHostBuff, std::shared_ptr<void> hostBuffOwner, int bank=-1, int axiWidth = CONFIG_M_AXI_WIDTH);
+  CTensorXil(std::shared_ptr<CTensorXil<T>> parentTn, size_t offsetBytes, const std::vector<unsigned> &shape);
+  ~CTensorXil();
   std::shared_ptr<CTensorXil<T>> CloneIfNeededToBank(const unsigned destBank);
+  void EnableBankReplicaCache();
+  void InvalidateBankReplicas();
+  std::shared_ptr<CTensorXil<T>> MoveToBank(const unsigned destBank);
+  void SetPlacementSite(const std::string &site);
+  const std::string& GetPlacementSite() const;
   std::string GetTensorTag() const;
   CXilinxInfo *GetXilInfo() const;
   void SetTensorTag(std::string &&tag);
@@ -36,6 +44,8 @@ class CTensorXil: public CTensorBase, public std::enable_shared_from_this<CTenso
   int GetAxiWidth() const;
   cl::Buffer& GetDeviceBuffer();
   cl::Buffer* GetDeviceBufferPtr();
+  const void* GetRootTensor() const;
+  size_t GetRootOffsetBytes() const;
   unsigned GetLenPadded() const;
   unsigned long GetSizeBytes() const override ;
   unsigned GetSizeBytesPadded() const;
@@ -47,13 +57,16 @@ class CTensorXil: public CTensorBase, public std::enable_shared_from_this<CTenso
 
  private:
   static void EventCallback(cl_event event, cl_int execStatus, void *userData);
+  static void HostBuffCallback(cl_event event, cl_int execStatus, void *userData);
+  void ReleaseOnWriteCompletion(std::shared_ptr<void> hostBuffOwner);
   void CloneFrom(const CTensorXil<T> &other);
   void CloneFrom(CXilinxInfo *xilInfo, const std::vector<unsigned> &shape, const T* unsafeHostBuff, int bank, int axiWidth, cl_bool isBlocking=CL_BLOCKING);
   void CloneFrom(CXilinxInfo *xilInfo, const std::vector<unsigned> &shape, int bank, int axiWidth);
+  void AcquireDeviceBuffer();
+  void ReleaseDeviceBuffer();
   int TranslateBankIndex(int bankIndex);
   void ValidateBankIndex(int bankIndex);
   void SetTypeInfo();
-  cl_mem_ext_ptr_t CreateExtendedPointer(void *hostPtr, cl_mem_flags memoryBank);
   T* PadHostBuffer(const std::vector<unsigned> &actualShape, const T *hostSrcBuff, int axiWidth);
   T* UnPadHostBuffer(const std::vector<unsigned> &actualShape, const T *hostSrcBuff, int axiWidth);
   std::vector<unsigned> PadShape(const std::vector<unsigned> &shape, int axiWidth) const;
@@ -79,10 +92,18 @@ class CTensorXil: public CTensorBase, public std::enable_shared_from_this<CTenso
   unsigned m_iAxiWidth;
   std::string m_strTensorTag = CStringFormatter()<<"Bank"<<m_iDramBank; // the default tn tag
   cl::Buffer m_oDeviceBuffer;
+  std::shared_ptr<CXilinxBufferPool> m_ptrBufferPool; // The pool that m_oDeviceBuffer is drawn from and returned to.
+  int m_iDeviceBufferBank = -1;
+  size_t m_uDeviceBufferBytes = 0;
   cl_int m_iOclStatus;
   cl::Event m_oEvent;
-  std::unique_ptr<T[]> m_ptrHostBuffForFillZero; // for async fill zero operation in the constructor
-  std::unique_ptr<CallbackData[]> m_ptrCallBackData;
+  mutable cl::Event m_oLastReadEvent; // The last command reading from this tensor, see CloneIfNeededToBank() and CloneFrom().
+  std::shared_ptr<void> m_ptrHostBuffForAsyncWrite; // The host buffer of a non-blocking write, only if the callback of m_oEvent could not release it.
+  std::shared_ptr<CTensorXil<T>> m_ptrParentTn; // The tensor that the device buffer is a region of, if any (never a view itself).
+  size_t m_uParentOffsetBytes = 0; // The origin of the region in the device buffer of m_ptrParentTn.
+  bool m_bBankReplicaCacheEnabled = false;
+  std::shared_ptr<CTensorXil<T>> m_ptrBankReplicas[4]; // The persistent copies on the other banks, see CloneIfNeededToBank().
+  std::string m_strPlacementSite; // The site of the tensor for CBankPlanner, empty for the outputs of the kernels.
 };
 
 template <typename T>
@@ -102,25 +123,26 @@ inline CTensorBasePtr Convert2TnBasePtr(CTensorXilPtr<T> pTn){ //ConvertTnXilPtr
 
 template <typename T>
 void CTensorXil<T>::EventCallback(cl_event event, cl_int execStatus, void *userData) {
-  // WARNING:
-  // This version of kernel execution callback is NOT responsible for book-keeping of the required tensors for
-  // the async kernel execution.
+  auto *callbackData = (CallbackData *) userData;
+  auto *classPtr = static_cast<CXilinxInfo*>(callbackData->classPtr);
 
   if( execStatus != CL_COMPLETE ) {
-    std::cout<<"ERROR IN KERNEL EXECUTION\n";
-    ///TODO REPORT ERROR WITH SPDLOGGER
-    return;
-  }
-  cl_ulong deviceTimeStart=0, deviceTimeEnd=0; //nano-seconds
-  if(((CallbackData *) userData)->profileKernel){
-    cl_int stat;
-    OclCheck(stat, stat=clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_START, sizeof(deviceTimeStart), &deviceTimeStart, nullptr));
-    OclCheck(stat, stat=clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END, sizeof(deviceTimeEnd), &deviceTimeEnd, nullptr));
-    cl_ulong durationNanoSeconds = deviceTimeEnd - deviceTimeStart;
-    //std::cout<<"DATAMOVER: ns:"<<durationNanoSeconds<<std::endl;
-    auto *classPtr = static_cast<CXilinxInfo*>(((CallbackData *)userData)->classPtr);
-    classPtr->AddProfiledDataMoverLaunchDetails("task_datamover", ((CallbackData *) userData)->parentLayerId, ((CallbackData *) userData)->optionalValue, durationNanoSeconds);
+    SPDLOG_LOGGER_ERROR(logger, "The datamover from the bank {} to the bank {} has failed with the status {}.",
+                        callbackData->srcBank, callbackData->destBank, execStatus);
+  }else if(callbackData->profileKernel){
+    ProfiledLaunchData data;
+    data.taskName = "task_datamover";
+    data.parentLayerId = callbackData->parentLayerId;
+    data.optionalValue = callbackData->optionalValue;
+    data.srcBank = callbackData->srcBank;
+    data.destBank = callbackData->destBank;
+    CXilinxInfo::QueryProfilingTimestamps(event, data);
+    classPtr->AddProfiledDataMoverLaunchDetails(data);
   }
+
+  // The source and the new tensor of the datamover (see CloneIfNeededToBank()) are released whether it has failed or
+  // not. The callback data should not be used after this.
+  classPtr->GetLifetimeManager()->Release(callbackData);
 }
 
 template <typename T>
@@ -167,15 +189,6 @@ int CTensorXil<T>::TranslateBankIndex(int bankIndex){
   };
 }
 
-template <typename T>
-cl_mem_ext_ptr_t CTensorXil<T>::CreateExtendedPointer(void *hostPtr, cl_mem_flags memoryBank){
-  cl_mem_ext_ptr_t extendedPointer;
-  extendedPointer.flags = memoryBank;
-  extendedPointer.obj = hostPtr;
-  extendedPointer.param = 0;
-  return extendedPointer;
-}
-
 template<typename T>
 int CTensorXil<T>::GetAxiWidth() const {
   return m_iAxiWidth;
@@ -186,6 +199,23 @@ cl::Buffer& CTensorXil<T>::GetDeviceBuffer() {
   return m_oDeviceBuffer;
 }
 
+/**
+ * @brief      Returns the tensor that owns the device buffer, which is this tensor unless it is a view. Two tensors of
+ *             the same root tensor share the device memory where their regions overlap.
+ */
+template<typename T>
+const void* CTensorXil<T>::GetRootTensor() const {
+  return m_ptrParentTn!=nullptr ? (const void*)m_ptrParentTn.get() : (const void*)this;
+}
+
+/**
+ * @brief      Returns the origin of this tensor in the device buffer of GetRootTensor().
+ */
+template<typename T>
+size_t CTensorXil<T>::GetRootOffsetBytes() const {
+  return m_ptrParentTn!=nullptr ? m_uParentOffsetBytes : 0;
+}
+
 /*!
  * Deep copies the content of the `other` xil tensor to the new instance.
  * @tparam T
@@ -211,8 +241,8 @@ CTensorXil<T>& CTensorXil<T>::operator=(const CTensorXil<T> &other) {
 
 /*!
  * Creates a new instance with or without having the device memory initialized to zero.
- * Please note that the zero-filling is implemented non-blocking, enforcing the class to hold on to the host buffer for
- * zero-filling process (`m_ptrHostBuffForFillZero`).
+ * Please note that the zero-filling is implemented non-blocking, its host buffer is released when the write completes
+ * (see ReleaseOnWriteCompletion()).
  * @tparam T
  * @param context
  * @param queue
@@ -234,9 +264,10 @@ CTensorXil<T>::CTensorXil(CXilinxInfo *xilInfo,
   m_ptrXilInfo = xilInfo;
   SetShape(shape);
   if(fillZeros){
-    m_ptrHostBuffForFillZero.reset(new T[GetLenPadded()]);
-    for(unsigned i=0; i<GetLenPadded(); i++){ m_ptrHostBuffForFillZero[i]=0;}
-    CloneFrom(xilInfo,shape,m_ptrHostBuffForFillZero.get(),bank,axiWidth,CL_NON_BLOCKING);
+    std::shared_ptr<T> zerosHostBuff(new T[GetLenPadded()], std::default_delete<T[]>());
+    std::fill(zerosHostBuff.get(), zerosHostBuff.get()+GetLenPadded(), 0);
+    CloneFrom(xilInfo,shape,zerosHostBuff.get(),bank,axiWidth,CL_NON_BLOCKING);
+    ReleaseOnWriteCompletion(zerosHostBuff);
   }else{
     CloneFrom(xilInfo,shape,bank,axiWidth);
   }
@@ -266,6 +297,59 @@ CTensorXil<T>::CTensorXil(CXilinxInfo *xilInfo,
   delete[](paddedHostBuff);
 }
 
+template<typename T>
+CTensorXil<T>::~CTensorXil() {
+  if(m_ptrHostBuffForAsyncWrite!=nullptr && m_oEvent()!=nullptr){
+    // The non-blocking write might still be reading from the host buffer.
+    m_oEvent.wait();
+  }
+  ReleaseDeviceBuffer();
+}
+
+template<typename T>
+void CTensorXil<T>::HostBuffCallback(cl_event event, cl_int execStatus, void *userData) {
+  // Called on the completion (or the failure) of the write, the host buffer is not read anymore.
+  delete static_cast<std::shared_ptr<void>*>(userData);
+}
+
+/*!
+ * Hands the host buffer of the non-blocking write of `m_oEvent` over to the callback of the event, so that it is
+ * released as soon as the write completes, and not with the instance. If the callback could not be set, the instance
+ * holds the buffer and the destructor waits for the write instead.
+ * @tparam T
+ * @param hostBuffOwner
+ */
+template<typename T>
+void CTensorXil<T>::ReleaseOnWriteCompletion(std::shared_ptr<void> hostBuffOwner) {
+  auto *callbackOwner = new std::shared_ptr<void>(std::move(hostBuffOwner));
+  if(m_oEvent.setCallback(CL_COMPLETE, &HostBuffCallback, callbackOwner)!=CL_SUCCESS){
+    m_ptrHostBuffForAsyncWrite = std::move(*callbackOwner);
+    delete callbackOwner;
+  }
+}
+
+/*!
+ * Draws the device buffer of the current bank and padded size from the buffer pool of CXilinxInfo.
+ * The previous device buffer of the instance (if any) is returned to the pool first.
+ * @tparam T
+ */
+template<typename T>
+void CTensorXil<T>::AcquireDeviceBuffer() {
+  ReleaseDeviceBuffer();
+  m_ptrBufferPool = m_ptrXilInfo->GetBufferPool();
+  m_iDeviceBufferBank = m_iDramBank;
+  m_uDeviceBufferBytes = GetSizeBytesPadded();
+  m_oDeviceBuffer = m_ptrBufferPool->Acquire(m_iDeviceBufferBank, TranslateBankIndex(m_iDeviceBufferBank), m_uDeviceBufferBytes);
+}
+
+template<typename T>
+void CTensorXil<T>::ReleaseDeviceBuffer() {
+  if(m_ptrBufferPool!=nullptr && m_oDeviceBuffer()!=nullptr){
+    m_ptrBufferPool->Release(m_iDeviceBufferBank, m_uDeviceBufferBytes, m_oDeviceBuffer, {m_oEvent, m_oLastReadEvent});
+    m_oDeviceBuffer = cl::Buffer();
+  }
+}
+
 template<typename T>
 int CTensorXil<T>::GetDramBank() const {
   return m_iDramBank;
@@ -308,7 +392,7 @@ template<typename T>
 void CTensorXil<T>::CloneFrom(const CTensorXil<T> &other) {
   if (this != &other) { // not a self-assignment
     SetTypeInfo();
-    m_ptrCallBackData.reset(new CallbackData());
+      InvalidateBankReplicas();
     m_ptrXilInfo = other.GetXilInfo(); // shallow-copy, there should be only one copy of CXilInfo and
     // it should be managed by Xilinx implementation class.
     m_iAxiWidth = other.GetAxiWidth();
@@ -317,26 +401,21 @@ void CTensorXil<T>::CloneFrom(const CTensorXil<T> &other) {
     SetPlatform(PLATFORMS::XIL);
     SetShape(other.GetShape());
 
-    cl_mem_ext_ptr_t extPtr = CreateExtendedPointer(nullptr, TranslateBankIndex(m_iDramBank));
-    cl_mem_flags flags = CL_MEM_READ_WRITE;
-    //flags |= CL_MEM_USE_HOST_PTR;
-    flags |= CL_MEM_EXT_PTR_XILINX;
-
-    OclCheck(m_iOclStatus,
-             m_oDeviceBuffer =
-                 cl::Buffer(*m_ptrXilInfo->GetContext(), flags, GetSizeBytesPadded(), &extPtr, &m_iOclStatus)
-    );
+    AcquireDeviceBuffer();
+    std::vector<cl::Event> dependencies;
+    if(other.m_oEvent()!=nullptr) dependencies.push_back(other.m_oEvent);
     OclCheck(m_iOclStatus,
              m_iOclStatus = m_ptrXilInfo->GetQueue()->enqueueCopyBuffer(
-                 other.GetDeviceBuffer(),
+                 other.m_oDeviceBuffer,
                  GetDeviceBuffer(),
                  0,
                  0,
                  GetSizeBytesPadded(),
-                 {other.GetEventPtr()},
+                 &dependencies,
                  GetEventPtr()
              )
     );
+    other.m_oLastReadEvent = m_oEvent;
   }
 }
 template<typename T>
@@ -350,21 +429,14 @@ void CTensorXil<T>::CloneFrom(CXilinxInfo *xilInfo,
   //   THIS METHOD IS NOT RESPONSIBLE FOR MAKING SURE THAT `hostBuff` IS NOT
   //   GOING TO GET RELEASED BEFORE NON BLOCKING OPERATION EXECUTES.
   SetTypeInfo();
-  m_ptrCallBackData.reset(new CallbackData());
+  InvalidateBankReplicas();
   ValidateBankIndex(bank);
   m_iDramBank = bank==-1? m_iDramBank : bank;
   m_iAxiWidth = axiWidth;
   m_ptrXilInfo = xilInfo;
   SetShape(shape);
 
-  cl_mem_ext_ptr_t extPtr = CreateExtendedPointer(nullptr, TranslateBankIndex(m_iDramBank));
-  cl_mem_flags  flags = CL_MEM_READ_WRITE;
-  //flags |= CL_MEM_USE_HOST_PTR;
-  flags |= CL_MEM_EXT_PTR_XILINX;
-
-  OclCheck(m_iOclStatus,
-           m_oDeviceBuffer = cl::Buffer(*m_ptrXilInfo->GetContext(), flags, GetSizeBytesPadded(), &extPtr, &m_iOclStatus)
-  );
+  AcquireDeviceBuffer();
 
   OclCheck(m_iOclStatus,
            m_iOclStatus = m_ptrXilInfo->GetQueue()->enqueueWriteBuffer(
@@ -383,51 +455,121 @@ void CTensorXil<T>::CloneFrom(CXilinxInfo *xilInfo,
                               int bank,
                               int axiWidth) {
   SetTypeInfo();
-  m_ptrCallBackData.reset(new CallbackData());
+  InvalidateBankReplicas();
   ValidateBankIndex(bank);
   m_iDramBank = bank==-1? m_iDramBank : bank;
   m_iAxiWidth = axiWidth;
   m_ptrXilInfo = xilInfo;
   SetShape(shape);
 
-  cl_mem_ext_ptr_t extPtr = CreateExtendedPointer(nullptr, TranslateBankIndex(m_iDramBank));
-  cl_mem_flags  flags = CL_MEM_READ_WRITE;
-  //flags |= CL_MEM_USE_HOST_PTR;
-  flags |= CL_MEM_EXT_PTR_XILINX;
-
-  OclCheck(m_iOclStatus,
-           m_oDeviceBuffer = cl::Buffer(*m_ptrXilInfo->GetContext(), flags, GetSizeBytesPadded(), &extPtr, &m_iOclStatus)
-  );
+  AcquireDeviceBuffer();
 }
 
 /*!
  * Pads the data of `hostTn` (not in-place) according to `axiWidth` in order for the device side buffer to
  * comply with the padded last dim policy.
- * host-device transfers are blocking.
+ * host-device transfers are blocking, unless `isBlocking` is false. In that case the padded host buffer is released
+ * when the write completes (see ReleaseOnWriteCompletion()) and the consumers of the tensor depend on its event.
  * @tparam T
  * @param context
  * @param queue
  * @param hostTn
  * @param bank
  * @param axiWidth
+ * @param isBlocking
  */
 template<typename T>
 CTensorXil<T>::CTensorXil(CXilinxInfo *xilInfo,
                           const CTensor<T> &hostTn,
                           int bank,
-                          int axiWidth) {
+                          int axiWidth,
+                          bool isBlocking) {
   SetPlatform(PLATFORMS::XIL);
   T *paddedHostBuff = PadHostBuffer(hostTn.GetShape(),hostTn.GetConst(),axiWidth);
-  CloneFrom(xilInfo,hostTn.GetShape(),paddedHostBuff,bank,axiWidth,CL_BLOCKING);
-  delete[](paddedHostBuff);
+  if(isBlocking){
+    CloneFrom(xilInfo,hostTn.GetShape(),paddedHostBuff,bank,axiWidth,CL_BLOCKING);
+    delete[](paddedHostBuff);
+  }else{
+    CloneFrom(xilInfo,hostTn.GetShape(),paddedHostBuff,bank,axiWidth,CL_NON_BLOCKING);
+    ReleaseOnWriteCompletion(std::shared_ptr<T>(paddedHostBuff, std::default_delete<T[]>()));
+  }
 }
+/*!
+ * Uploads a host buffer that is already padded according to `axiWidth` (for example a bank section of a weight bundle),
+ * without copying it. The transfer is non-blocking, `hostBuffOwner` (the owner of `paddedHostBuff`) is kept alive
+ * until the write completes and the consumers of the tensor depend on its event.
+ * @tparam T
+ * @param xilInfo
+ * @param shape
+ * @param paddedHostBuff
+ * @param hostBuffOwner
+ * @param bank
+ * @param axiWidth
+ */
+template<typename T>
+CTensorXil<T>::CTensorXil(CXilinxInfo *xilInfo,
+                          const std::vector<unsigned> &shape,
+                          const T *paddedHostBuff,
+                          std::shared_ptr<void> hostBuffOwner,
+                          int bank,
+                          int axiWidth) {
+  SetPlatform(PLATFORMS::XIL);
+  ConditionCheck(hostBuffOwner!=nullptr, "The owner of the host buffer of the non-blocking upload is not given.");
+  CloneFrom(xilInfo,shape,paddedHostBuff,bank,axiWidth,CL_NON_BLOCKING);
+  ReleaseOnWriteCompletion(std::move(hostBuffOwner));
+}
+/*!
+ * Creates a view of a region of the device buffer of `parentTn` (an OpenCL sub-buffer) without any transfer, for
+ * example a weight in the bank section of a weight bundle that is uploaded at once.
+ * The region is the padded size of `shape` and `offsetBytes` should meet the base address alignment of the device.
+ * The view keeps the parent alive, inherits its bank, AXI width, tag and placement site, and depends on its event.
+ * OpenCL does not allow the sub-buffers of the sub-buffers, so the view of a view is a region of the root buffer.
+ * @tparam T
+ * @param parentTn
+ * @param offsetBytes
+ * @param shape
+ */
+template<typename T>
+CTensorXil<T>::CTensorXil(std::shared_ptr<CTensorXil<T>> parentTn, size_t offsetBytes, const std::vector<unsigned> &shape) {
+  SetPlatform(PLATFORMS::XIL);
+  SetTypeInfo();
+  m_ptrXilInfo = parentTn->GetXilInfo();
+  m_iDramBank = parentTn->GetDramBank();
+  m_iAxiWidth = parentTn->GetAxiWidth();
+  m_strTensorTag = parentTn->GetTensorTag();
+  m_strPlacementSite = parentTn->GetPlacementSite();
+  SetShape(shape);
+  ConditionCheck(offsetBytes+GetSizeBytesPadded() <= parentTn->GetSizeBytesPadded(), "The view is out of the bounds of its parent tensor.");
+
+  auto rootTn = parentTn;
+  size_t rootOffsetBytes = offsetBytes;
+  if(parentTn->m_ptrParentTn!=nullptr){
+    rootTn = parentTn->m_ptrParentTn;
+    rootOffsetBytes += parentTn->m_uParentOffsetBytes;
+  }
+
+  cl_buffer_region region;
+  region.origin = rootOffsetBytes;
+  region.size = GetSizeBytesPadded();
+  OclCheck(m_iOclStatus,
+           m_oDeviceBuffer = rootTn->GetDeviceBuffer().createSubBuffer(CL_MEM_READ_WRITE, CL_BUFFER_CREATE_TYPE_REGION, &region, &m_iOclStatus)
+  );
+  m_oEvent = *parentTn->GetEventPtr();
+  m_ptrParentTn = rootTn;
+  m_uParentOffsetBytes = rootOffsetBytes;
+}
+/*!
+ * Reads the tensor back to the host, blocking.
+ * Only the producer of this tensor (and its own dependencies) is waited for, not the whole queue. So the commands
+ * of the other batches that are in flight on the out-of-order queue are not drained by the readback.
+ * @tparam T
+ * @return
+ */
 template<typename T>
 std::shared_ptr<CTensor<T>> CTensorXil<T>::TransferToHost() {
   T *paddedHostBuff = new T[GetLenPadded()];
   std::vector<cl::Event> dependencies;
-  dependencies.push_back(m_oEvent);
-
-  m_ptrXilInfo->GetQueue()->finish();
+  if(m_oEvent()!=nullptr) dependencies.push_back(m_oEvent);
 
   SPDLOG_LOGGER_TRACE(logger, "CTensorXil::TransferToHost(offset=0, len={}, bytes={}).", GetLenPadded(), GetSizeBytesPadded());
   OclCheck(m_iOclStatus,
@@ -441,12 +583,6 @@ std::shared_ptr<CTensor<T>> CTensorXil<T>::TransferToHost() {
                NULL)
   );
 
-  m_ptrXilInfo->GetQueue()->finish();
-
-  ///TODO enforce queue to be flushed and wait for it to happen?
-  ///     OR
-  ///     wait on the event to happen?!
-
   auto *unpaddedHostTn = UnPadHostBuffer(GetShape(), paddedHostBuff, m_iAxiWidth);
   auto *hostTn = new CTensor<T>(GetShape(),unpaddedHostTn);
   delete[](unpaddedHostTn);
@@ -502,11 +638,65 @@ T *CTensorXil<T>::UnPadHostBuffer(const std::vector<unsigned> &actualShape, cons
   return unpaddedBuff;
 }
 
+/*!
+ * Keeps the copies of the tensor that CloneIfNeededToBank() makes on the other banks, so that the later crossings to
+ * the same bank reuse them without a datamover launch. Meant for the tensors that are written once and read by every
+ * forward pass (the weights). A replica stays alive as long as the tensor and is dropped when the tensor is written
+ * again (CloneFrom()). The writes to the device buffer that bypass CTensorXil should call InvalidateBankReplicas().
+ * @tparam T
+ */
+template<typename T>
+void CTensorXil<T>::EnableBankReplicaCache() {
+  m_bBankReplicaCacheEnabled = true;
+}
+
+template<typename T>
+void CTensorXil<T>::InvalidateBankReplicas() {
+  for(auto &replicaTn:m_ptrBankReplicas){
+    replicaTn.reset();
+  }
+}
+
+/*!
+ * Returns the copy of the tensor on destBank that takes over the tensor: it keeps the bank replicas of the tensor and
+ * the tensor itself becomes its replica on the current bank. Used to move the weights to the banks of CBankPlanner.
+ * @tparam T
+ */
+template<typename T>
+CTensorXilPtr<T> CTensorXil<T>::MoveToBank(const unsigned destBank) {
+  auto movedTn = CloneIfNeededToBank(destBank);
+  if(movedTn.get()==this) return movedTn;
+  movedTn->m_strTensorTag = m_strTensorTag;
+  movedTn->m_strPlacementSite = m_strPlacementSite;
+  movedTn->m_bBankReplicaCacheEnabled = m_bBankReplicaCacheEnabled;
+  if(m_bBankReplicaCacheEnabled){
+    for(unsigned b=0; b<4; b++){
+      if(b!=destBank) movedTn->m_ptrBankReplicas[b] = m_ptrBankReplicas[b];
+    }
+    movedTn->m_ptrBankReplicas[m_iDramBank] = this->shared_from_this();
+    // The moved tensor owns the replicas now, this breaks the cycle through m_ptrBankReplicas[destBank].
+    InvalidateBankReplicas();
+  }
+  return movedTn;
+}
+
+template<typename T>
+void CTensorXil<T>::SetPlacementSite(const std::string &site) {
+  m_strPlacementSite = site;
+}
+
+template<typename T>
+const std::string& CTensorXil<T>::GetPlacementSite() const {
+  return m_strPlacementSite;
+}
+
 template<typename T>
 CTensorXilPtr<T> CTensorXil<T>::CloneIfNeededToBank(const unsigned destBank) {
-  // WARNING:
-  // The user is responsible of making sure that the tensor instance won't be released before async-datamover is executed.
-  // This is essential for prevention of data-loss and/or a fatal crash.
+  auto *bankPlanner = m_ptrXilInfo->GetBankPlanner();
+  if(bankPlanner->IsEnabled()){
+    bankPlanner->RecordRead(m_strPlacementSite, m_iDramBank, destBank, GetSizeBytesPadded(), m_bBankReplicaCacheEnabled);
+  }
+
   if(m_iDramBank==destBank) {
     // https://stackoverflow.com/questions/17853212/using-shared-from-this-in-templated-classes
     return this->shared_from_this();
@@ -523,6 +713,14 @@ CTensorXilPtr<T> CTensorXil<T>::CloneIfNeededToBank(const unsigned destBank) {
     //std::exit(1);
   }
 
+  if(m_bBankReplicaCacheEnabled && m_ptrBankReplicas[destBank]!=nullptr){
+    // The replica has the same padded layout, so it follows the reshapes of the tensor.
+    auto &replicaTn = m_ptrBankReplicas[destBank];
+    if(replicaTn->GetShape()!=GetShape()) replicaTn->Reshape(GetShape());
+    m_ptrXilInfo->OnBankReplicaHit();
+    return replicaTn;
+  }
+
   auto *newTensor = new CTensorXil(m_ptrXilInfo, GetShape(),false,destBank,GetAxiWidth());
 
   int argcnt=0;
@@ -604,15 +802,25 @@ CTensorXilPtr<T> CTensorXil<T>::CloneIfNeededToBank(const unsigned destBank) {
   OclCheck(m_iOclStatus,
       m_iOclStatus = m_ptrXilInfo->GetQueue()->enqueueTask(*(m_ptrXilInfo->GetDatamoverKernel()), &dependencies, newTensor->GetEventPtr())
   );
-
-  m_ptrCallBackData.get()->profileKernel = m_ptrXilInfo->GetProfileOclEnabled();
-  m_ptrCallBackData.get()->parentLayerId = DATAMOVER_ID;
-  m_ptrCallBackData.get()->kernelBookKeeperId = DATAMOVER_ID;
-  m_ptrCallBackData.get()->optionalValue = vecCountPadded;
-  m_ptrCallBackData.get()->classPtr = m_ptrXilInfo;
-  newTensor->GetEventPtr()->setCallback(CL_COMPLETE, &EventCallback, m_ptrCallBackData.get());
-
-  return CTensorXilPtr<T>(newTensor);
+  m_oLastReadEvent = *newTensor->GetEventPtr();
+  m_ptrXilInfo->OnDatamoverLaunch();
+  bankPlanner->RecordMove(GetSizeBytesPadded());
+
+  CTensorXilPtr<T> newTensorPtr(newTensor);
+  // Both of the tensors are pinned until the datamover has completed, so the source could be dropped right away.
+  auto *callbackData = m_ptrXilInfo->GetLifetimeManager()->Pin(
+      {Convert2TnBasePtr(this->shared_from_this()), Convert2TnBasePtr(newTensorPtr)},
+      m_ptrXilInfo,
+      DATAMOVER_ID,
+      m_ptrXilInfo->GetProfileOclEnabled());
+  callbackData->optionalValue = vecCountPadded;
+  callbackData->srcBank = m_iDramBank;
+  callbackData->destBank = destBank;
+  newTensor->GetEventPtr()->setCallback(CL_COMPLETE, &EventCallback, callbackData);
+  if(m_bBankReplicaCacheEnabled){
+    m_ptrBankReplicas[destBank] = newTensorPtr;
+  }
+  return newTensorPtr;
 }
 
 template<typename T>
@@ -642,7 +850,7 @@ void CTensorXil<T>::Reshape(const std::vector<unsigned> &newShape) {
   if (newLen != GetLen())
     throw std::runtime_error(CStringFormatter() << __func__ << ": The lengths for the two shapes do not match.");
 
-  const auto oldShapePadded = PadShape(newShape, m_iAxiWidth);
+  const auto oldShapePadded = PadShape(GetShape(), m_iAxiWidth);
   const auto newShapePadded = PadShape(newShape, m_iAxiWidth);
 
   const unsigned long oldLenPadded = std::accumulate(begin(oldShapePadded), end(oldShapePadded), 1, std::multiplies<unsigned>());
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "fpga/xilinx/xcl2.h"
+#include "CMemoryPoolStats.h"
+
+/**
+ * @brief The pool of the device buffers of CTensorXil, keyed by the DDR bank and the size class of the padded size.
+ * A released buffer is handed out again only when all of the events that were pending on it at the release time
+ * (its producer and the datamover reading from it) have completed, so that an out-of-order queue could not make a
+ * new tensor overwrite the data of a command that is still in flight.
+ * The cached bytes are capped (see SetMaxCachedBytes()), the least recently released buffers are dropped first, so the
+ * cache does not grow without bound when the shapes change between the passes.
+ * The buffers could be released from the OpenCL callbacks (the book-keeping of the kernel wrappers), so the pool is
+ * thread-safe. The tensors hold a shared pointer to the pool, which keeps it alive after CXilinxInfo is gone.
+ */
+class CXilinxBufferPool {
+ public:
+  static constexpr size_t kDefaultMaxCachedBytes = 4UL*1024*1024*1024;
+
+  CXilinxBufferPool(const cl::Context &context, bool enabled);
+  ~CXilinxBufferPool();
+
+  /**
+   * @brief      Returns a device buffer of at least sizeBytes bytes on the given bank.
+   *
+   * @param[in]  bank       The bank index, used as the key of the pool
+   * @param[in]  bankFlag   The XCL_MEM_DDR_BANKx flag of the bank, used to create a new buffer
+   * @param[in]  sizeBytes  The size in bytes (padded)
+   */
+  cl::Buffer Acquire(int bank, cl_mem_flags bankFlag, size_t sizeBytes);
+  void Release(int bank, size_t sizeBytes, const cl::Buffer &buffer, const std::vector<cl::Event> &pendingEvents);
+
+  /**
+   * @brief      Releases all of the cached buffers that are not in use.
+   */
+  void Trim();
+
+  /**
+   * @brief      Sets the cap of the bytes of the cached buffers (of all of the banks) and drops the least recently
+   *             released buffers down to it. A buffer larger than the cap is never cached.
+   */
+  void SetMaxCachedBytes(size_t maxCachedBytes);
+  size_t GetMaxCachedBytes() const;
+  size_t GetCachedBytes() const;
+  void ReportStats() const;
+  void ResetStats();
+
+ private:
+  struct CachedBuffer{
+    cl::Buffer buffer;
+    std::vector<cl::Event> pendingEvents;
+    unsigned long releaseTick;
+  };
+  static bool IsReusable(const CachedBuffer &cachedBuffer);
+  void EvictOverCap(std::vector<cl::Buffer> &evicted);
+
+  cl::Context m_oContext;
+  bool m_bEnabled;
+  size_t m_uMaxCachedBytes;
+  unsigned long m_uReleaseTick;
+  mutable std::mutex m_oMutex;
+  std::map<std::pair<int,size_t>, std::vector<CachedBuffer>> m_mFreeLists; // The oldest buffer of a key is at the front.
+  CMemoryPoolStats m_oStats;
+};
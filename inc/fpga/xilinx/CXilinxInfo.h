@@ -3,6 +3,10 @@
 #include "fpga/xilinx/xcl2.h"
 #include "GlobalHelpers.h"
 #include "CTensorBase.h"
+#include "fpga/xilinx/CXilinxBufferPool.h"
+#include "fpga/xilinx/CAsyncLifetimeManager.h"
+#include "fpga/xilinx/CBankPlanner.h"
+#include <memory>
 
 class CXilinxInfo{
  public:
@@ -10,7 +14,8 @@ class CXilinxInfo{
       cl::Program *program,
       cl::Context *context,
       cl::CommandQueue *queue,
-      bool profileOclEnabled){
+      bool profileOclEnabled,
+      unsigned baseAddrAlignBytes){
     m_oProgram = program;
     m_oContext = context;
     m_oQueue = queue;
@@ -22,12 +27,25 @@ class CXilinxInfo{
     m_oDummyDataMoverBank2 = nullptr;
     m_oDummyDataMoverBank3 = nullptr;
     m_bProfileOclEnabled = profileOclEnabled;
+    m_uBaseAddrAlignBytes = baseAddrAlignBytes;
+    m_ptrBufferPool = std::make_shared<CXilinxBufferPool>(*context, globalMemoryPoolEnabled);
+    m_ptrLifetimeManager = std::make_shared<CAsyncLifetimeManager>();
+    m_ptrBankPlanner = std::make_shared<CBankPlanner>(!globalBankPlanPath.empty(), globalBankPlanPath);
+    m_uDatamoverLaunches = 0;
+    m_uBankReplicaHits = 0;
   }
 
   bool GetProfileOclEnabled(){
     return m_bProfileOclEnabled;
   }
 
+  /**
+   * @brief      The alignment of the origins of the sub-buffers in bytes (CL_DEVICE_MEM_BASE_ADDR_ALIGN of the device).
+   */
+  unsigned GetBaseAddrAlignBytes() const{
+    return m_uBaseAddrAlignBytes;
+  }
+
   void SetDataMoverDummyTensors(
       CTensorBase *dummyTensorBank0,
       CTensorBase *dummyTensorBank1,
@@ -54,15 +72,52 @@ class CXilinxInfo{
     m_ptrDataMoverProfiledDataVec = vec;
   }
 
-  void AddProfiledDataMoverLaunchDetails(std::string taskName, unsigned parentLayerId, unsigned vecCountPadded, cl_ulong durationNanoSecOcl){
-    ProfiledLaunchData data;
-    data.taskName = taskName;
-    data.parentLayerId = parentLayerId;
-    data.durationOcl = durationNanoSecOcl;
-    data.optionalValue = vecCountPadded;
+  void AddProfiledDataMoverLaunchDetails(const ProfiledLaunchData &data){
     m_ptrDataMoverProfiledDataVec->push_back(data);
   }
 
+  /**
+   * @brief      Fills the QUEUED, SUBMIT, START and END timestamps and the duration of a completed event with profiling.
+   */
+  static void QueryProfilingTimestamps(cl_event event, ProfiledLaunchData &data){
+    cl_int stat;
+    OclCheck(stat, stat=clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_QUEUED, sizeof(data.timeQueued), &data.timeQueued, nullptr));
+    OclCheck(stat, stat=clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_SUBMIT, sizeof(data.timeSubmit), &data.timeSubmit, nullptr));
+    OclCheck(stat, stat=clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_START, sizeof(data.timeStart), &data.timeStart, nullptr));
+    OclCheck(stat, stat=clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END, sizeof(data.timeEnd), &data.timeEnd, nullptr));
+    data.durationOcl = data.timeEnd - data.timeStart;
+  }
+
+  /**
+   * @brief      The bank crossings of CTensorXil::CloneIfNeededToBank(): the datamover launches and the crossings that
+   *             reused a bank replica instead.
+   */
+  void OnDatamoverLaunch(){
+    m_uDatamoverLaunches++;
+  }
+
+  void OnBankReplicaHit(){
+    m_uBankReplicaHits++;
+  }
+
+  unsigned long GetDatamoverLaunches() const{
+    return m_uDatamoverLaunches;
+  }
+
+  unsigned long GetBankReplicaHits() const{
+    return m_uBankReplicaHits;
+  }
+
+  void ReportBankCrossingStats() const{
+    SPDLOG_LOGGER_INFO(logger, "Bank Crossings: Datamover Launches: {}, Bank Replica Hits: {}",
+                       m_uDatamoverLaunches, m_uBankReplicaHits);
+  }
+
+  void ResetBankCrossingStats(){
+    m_uDatamoverLaunches = 0;
+    m_uBankReplicaHits = 0;
+  }
+
   cl::Program* GetProgram(){
     return m_oProgram;
   }
@@ -75,6 +130,24 @@ class CXilinxInfo{
     return m_oQueue;
   }
 
+  std::shared_ptr<CXilinxBufferPool> GetBufferPool(){
+    return m_ptrBufferPool;
+  }
+
+  /**
+   * @brief      The lifetime manager of the tensors of the kernel launches, shared by all of the kernel wrappers.
+   */
+  std::shared_ptr<CAsyncLifetimeManager> GetLifetimeManager(){
+    return m_ptrLifetimeManager;
+  }
+
+  /**
+   * @brief      The planner of the banks of the weights and the uploads, see CBankPlanner.
+   */
+  CBankPlanner* GetBankPlanner(){
+    return m_ptrBankPlanner.get();
+  }
+
   cl::Kernel* GetDatamoverKernel(){
     return m_oDatamoverKernel;
   }
@@ -102,4 +175,10 @@ class CXilinxInfo{
   std::vector<ProfiledLaunchData> *m_ptrDataMoverProfiledDataVec;
   std::unique_ptr<CallbackData[]> m_ptrCallBackData;
   bool m_bProfileOclEnabled;
+  unsigned m_uBaseAddrAlignBytes;
+  std::shared_ptr<CXilinxBufferPool> m_ptrBufferPool;
+  std::shared_ptr<CAsyncLifetimeManager> m_ptrLifetimeManager;
+  std::shared_ptr<CBankPlanner> m_ptrBankPlanner;
+  unsigned long m_uDatamoverLaunches;
+  unsigned long m_uBankReplicaHits;
 };
\ No newline at end of file
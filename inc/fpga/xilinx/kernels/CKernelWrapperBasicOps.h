@@ -146,20 +146,17 @@ class CKernelWrapperBasicOps: public CKernelWrapper{
 
     // -----------------------------------------------------------------------------------------------------------------
     // #. Callbacks And Book-keepings
-    auto *callBackDataPtr = GenerateAndStoreCallBackData(this, parentLayerId);
-    outputTn->GetEventPtr()->setCallback(CL_COMPLETE, &EventCallback, callBackDataPtr);
-
     // WARNING: Always store:
     //  - the raw input tensors
     //  - the bank-crossed versions of the input tensors
     //  - the output tensors
     // Not storing raw input tensors could allow a tensor to be released
     // before its async bank-crossing operation is executed, resulting in data loss and/or fatal crash.
-    if(useScalar){
-      StoreBookKeepingEntry({inputTn1, xInputTn1, outputTn});
-    }else{
-      StoreBookKeepingEntry({inputTn1, inputTn2, xInputTn1, xInputTn2, outputTn});
-    }
+    // The entry is stored before setting the callback, which could run as soon as it is set.
+    auto *callBackDataPtr = useScalar ?
+        StoreBookKeepingEntry(parentLayerId, {inputTn1, xInputTn1, outputTn}) :
+        StoreBookKeepingEntry(parentLayerId, {inputTn1, inputTn2, xInputTn1, xInputTn2, outputTn});
+    outputTn->GetEventPtr()->setCallback(CL_COMPLETE, &EventCallback, callBackDataPtr);
 
 
     // -----------------------------------------------------------------------------------------------------------------
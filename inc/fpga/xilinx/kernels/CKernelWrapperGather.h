@@ -89,16 +89,15 @@ class CKernelWrapperGather: public CKernelWrapper{
 
     // -----------------------------------------------------------------------------------------------------------------
     // #. Callbacks And Book-keepings
-    auto *callBackDataPtr = GenerateAndStoreCallBackData(this, parentLayerId);
-    outputTn->GetEventPtr()->setCallback(CL_COMPLETE, &EventCallback, callBackDataPtr);
-
     // WARNING: Always store:
     //  - the raw input tensors
     //  - the bank-crossed versions of the input tensors
     //  - the output tensors
     // Not storing raw input tensors could allow a tensor to be released
     // before its async bank-crossing operation is executed, resulting in data loss and/or fatal crash.
-    StoreBookKeepingEntry({inputTn, xInputTn, indicesTn, xIndicesTn, outputTn});
+    // The entry is stored before setting the callback, which could run as soon as it is set.
+    auto *callBackDataPtr = StoreBookKeepingEntry(parentLayerId, {inputTn, xInputTn, indicesTn, xIndicesTn, outputTn});
+    outputTn->GetEventPtr()->setCallback(CL_COMPLETE, &EventCallback, callBackDataPtr);
 
     // -----------------------------------------------------------------------------------------------------------------
     // #. Returning Part
@@ -96,16 +96,15 @@ class CKernelWrapperMatmul: public CKernelWrapper{
 
     // -----------------------------------------------------------------------------------------------------------------
     // #. Callbacks And Book-keepings
-    auto *callBackDataPtr = GenerateAndStoreCallBackData(this, parentLayerId);
-    outputTn->GetEventPtr()->setCallback(CL_COMPLETE, &EventCallback, callBackDataPtr);
-
     // WARNING: Always store:
     //  - the raw input tensors
     //  - the bank-crossed versions of the input tensors
     //  - the output tensors
     // Not storing raw input tensors could allow a tensor to be released
     // before its async bank-crossing operation is executed, resulting in data loss and/or fatal crash.
-    StoreBookKeepingEntry({inputTn1, inputTn2, xInputTn1, xInputTn2, outputTn});
+    // The entry is stored before setting the callback, which could run as soon as it is set.
+    auto *callBackDataPtr = StoreBookKeepingEntry(parentLayerId, {inputTn1, inputTn2, xInputTn1, xInputTn2, outputTn});
+    outputTn->GetEventPtr()->setCallback(CL_COMPLETE, &EventCallback, callBackDataPtr);
 
     // -----------------------------------------------------------------------------------------------------------------
     // #. Returning Part
@@ -2,6 +2,7 @@
 
 #include "fpga/xilinx/CKernelWrapper.h"
 #include "CStringFormatter.h"
+#include <algorithm>
 #include <iostream>
 #include <vector>
 #include <cassert>
@@ -173,16 +174,15 @@ class CKernelWrapperReduce: public CKernelWrapper{
 
     // -----------------------------------------------------------------------------------------------------------------
     // #. Callbacks And Book-keepings
-    auto *callBackDataPtr = GenerateAndStoreCallBackData(this, parentLayerId);
-    outputTn->GetEventPtr()->setCallback(CL_COMPLETE, &EventCallback, callBackDataPtr);
-
     // WARNING: Always store:
     //  - the raw input tensors
     //  - the bank-crossed versions of the input tensors
     //  - the output tensors
     // Not storing raw input tensors could allow a tensor to be released
     // before its async bank-crossing operation is executed, resulting in data loss and/or fatal crash.
-    StoreBookKeepingEntry({inputTn, xInputTn, outputTn});
+    // The entry is stored before setting the callback, which could run as soon as it is set.
+    auto *callBackDataPtr = StoreBookKeepingEntry(parentLayerId, {inputTn, xInputTn, outputTn});
+    outputTn->GetEventPtr()->setCallback(CL_COMPLETE, &EventCallback, callBackDataPtr);
 
     // -----------------------------------------------------------------------------------------------------------------
     // #. Returning Part
@@ -190,6 +190,90 @@ class CKernelWrapperReduce: public CKernelWrapper{
     return std::dynamic_pointer_cast<CTensorBase>(outputTn);
   }
 
+  /**
+   * @brief      Launches the single pass mean and variance reduction (the mode 4 of task_reduce) over the axes 0, 1,
+   *             and 2 of a rank 4 tensor (TTTF).
+   *             The kernel writes both rows into one output tensor, the variance row starts at an offset that is
+   *             aligned for the OpenCL sub-buffers, so the two rows are returned as the views of that tensor.
+   *
+   * @return     The mean and the variance tensors, both of shape {dim3}.
+   */
+  std::vector<CTensorBasePtr> EnqueueKernelLaunchMoments(
+      unsigned parentLayerId,
+      CTensorBasePtr inputTn){
+
+    //-----------------------------------------------------------------------------------------------------------------
+    // #. Requirement Checks
+    ConditionCheck(inputTn->GetRank()==4, "For the mean and variance reduction, only rank 4 tensors are supported.");
+    ConditionCheck(
+        MakeDivisible<unsigned>(inputTn->GetShape()[3], CONFIG_M_AXI_WIDTH) <= ConfigTaskReduce::Sum4D::MaxSliceLen,
+        "For the mean and variance reduction, the padded last dimension should not exceed ConfigTaskReduce::Sum4D::MaxSliceLen."
+    );
+
+    // -----------------------------------------------------------------------------------------------------------------
+    // #. Pointer Castings And Memory Bank Crossings
+    auto pInputTn = std::static_pointer_cast<CTensorXil<float>>(inputTn);
+    auto xInputTn = pInputTn->CloneIfNeededToBank(m_uBankInputTn);
+    if(m_bLogMemBankCrossings) m_vMemBankCrossings.push_back("abs("+ (pInputTn)->GetTensorTag() +"-reduce_in)");
+
+    // -----------------------------------------------------------------------------------------------------------------
+    // #. Kernel Launch
+    auto shape = xInputTn->GetShape();
+    const unsigned dim0 = shape[0];
+    const unsigned dim1 = shape[1];
+    const unsigned dim2 = shape[2];
+    const unsigned dim3 = shape[3];
+    const unsigned kernelMode = 4;
+    const unsigned dim3Padded = MakeDivisible<unsigned>(dim3, CONFIG_M_AXI_WIDTH);
+    // Both of the alignments are powers of two.
+    const unsigned rowAlignBytes = std::max<unsigned>(GetXilInfo()->GetBaseAddrAlignBytes(), sizeof(float)*CONFIG_M_AXI_WIDTH);
+    const unsigned rowStrideBytes = MakeDivisible<unsigned>(dim3Padded*sizeof(float), rowAlignBytes);
+    const unsigned rowStride = rowStrideBytes / (unsigned)(sizeof(float)*CONFIG_M_AXI_WIDTH); // in vectors
+
+    auto outputTn = CTensorXilPtr<float>(new CTensorXil<float>(
+        GetXilInfo(),
+        {2, rowStrideBytes/(unsigned)sizeof(float)},
+        false,
+        m_uBankOutputTn)
+    );
+
+    cl_int stat;
+    ResetArgCounter();
+    OclCheck(stat, stat = GetKernel()->setArg(ArgCounter(), xInputTn->GetDeviceBuffer()));
+    OclCheck(stat, stat = GetKernel()->setArg(ArgCounter(), outputTn->GetDeviceBuffer()));
+    OclCheck(stat, stat = GetKernel()->setArg(ArgCounter(), kernelMode));
+    OclCheck(stat, stat = GetKernel()->setArg(ArgCounter(), rowStride));
+    OclCheck(stat, stat = GetKernel()->setArg(ArgCounter(), dim0));
+    OclCheck(stat, stat = GetKernel()->setArg(ArgCounter(), dim1));
+    OclCheck(stat, stat = GetKernel()->setArg(ArgCounter(), dim2));
+    OclCheck(stat, stat = GetKernel()->setArg(ArgCounter(), dim3));
+
+    std::vector<cl::Event> dependencies;
+
+    // Double check to make sure that bank-crossed tensors are used here.
+    dependencies.push_back(*xInputTn->GetEventPtr());
+
+    GetXilInfo()->GetQueue()->enqueueTask(
+        *GetKernel(),
+        &dependencies,
+        outputTn->GetEventPtr()
+    );
+
+    // -----------------------------------------------------------------------------------------------------------------
+    // #. Callbacks And Book-keepings
+    // The same entries as EnqueueKernelLaunch(), the views keep the output tensor alive on their own.
+    auto *callBackDataPtr = StoreBookKeepingEntry(parentLayerId, {inputTn, xInputTn, outputTn});
+    outputTn->GetEventPtr()->setCallback(CL_COMPLETE, &EventCallback, callBackDataPtr);
+
+    // -----------------------------------------------------------------------------------------------------------------
+    // #. Returning Part
+    if(m_bLogMemBankCrossings) outputTn->SetTensorTag("reduce_out");
+    // The views depend on the event of the launch, so they are made after the enqueue.
+    auto meanTn = CTensorXilPtr<float>(new CTensorXil<float>(outputTn, 0, {dim3}));
+    auto varianceTn = CTensorXilPtr<float>(new CTensorXil<float>(outputTn, rowStrideBytes, {dim3}));
+    return {std::dynamic_pointer_cast<CTensorBase>(meanTn), std::dynamic_pointer_cast<CTensorBase>(varianceTn)};
+  }
+
  private:
   unsigned m_uBankInputTn;
   unsigned m_uBankOutputTn;
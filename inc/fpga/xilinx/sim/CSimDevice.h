@@ -0,0 +1,112 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "fpga/xilinx/sim/SimOpenCL.h"
+
+/**
+ * @brief      The arguments of a kernel launch, as captured by cl::CommandQueue::enqueueTask().
+ */
+class CSimKernelArgs{
+ public:
+  explicit CSimKernelArgs(const std::vector<cl::SimKernelArg> &args): m_vArgs(args){}
+
+  template<typename T>
+  T* Buffer(unsigned index) const {
+    return reinterpret_cast<T*>(GetHostPtr(index));
+  }
+
+  template<typename T>
+  T Scalar(unsigned index) const {
+    T value;
+    std::memcpy(&value, &m_vArgs[index].scalar, sizeof(T));
+    return value;
+  }
+
+ private:
+  void* GetHostPtr(unsigned index) const;
+  const std::vector<cl::SimKernelArg> &m_vArgs;
+};
+
+/**
+ * @brief      The simulated device behind SimOpenCL.h.
+ *             The commands are run by a pool of worker threads as soon as all of the events that they depend on have
+ *             completed, so the out-of-order queue of the host behaves as it does with the FPGA. As with the FPGA
+ *             image (--nk <kernel>:1), each kernel has a single compute unit: the launches of the same kernel are
+ *             serialized and the launches of different kernels overlap. The transfers are not serialized.
+ */
+class CSimDevice{
+ public:
+  struct Command; // A command of a queue, defined in CSimDevice.cpp.
+
+  /**
+   * @brief      A kernel of the device. The signature has a character per argument: 'b' for a buffer and 'u', 'i'
+   *             or 'f' for the 32-bit scalars.
+   */
+  struct KernelEntry{
+    const char *name;
+    const char *signature;
+    void (*launch)(const CSimKernelArgs &args);
+  };
+
+  /**
+   * @brief      The task_* entry points of src/fpga/xilinx/kernels, defined in SimKernels.cpp.
+   */
+  static const std::vector<KernelEntry>& GetKernelTable();
+
+  /**
+   * @brief      Returns the index of the kernel in GetKernelTable() or -1.
+   */
+  static int FindKernel(const std::string &name);
+
+  static CSimDevice& Get();
+
+  ~CSimDevice();
+
+  /**
+   * @brief      Enqueues a command that runs task on a worker, after all of dependencies have completed.
+   *
+   * @param      queue          The queue of the command, for finish().
+   * @param[in]  computeUnit    The index of the kernel or -1 for the transfers and the markers.
+   * @param[in]  task           The command.
+   * @param[in]  dependencies   The events to wait for (the null events are ignored).
+   * @param[in]  profiling      Whether the profiling timestamps of the returned event can be queried.
+   *
+   * @return     The event of the command.
+   */
+  std::shared_ptr<_cl_event> Enqueue(_cl_command_queue *queue,
+                                     int computeUnit,
+                                     std::function<void()> task,
+                                     const std::vector<std::shared_ptr<_cl_event>> &dependencies,
+                                     bool profiling);
+
+  /**
+   * @brief      Blocks until all of the commands of the queue have completed and their callbacks have returned.
+   */
+  void Finish(_cl_command_queue *queue);
+
+  unsigned GetWorkerCount() const;
+
+  static cl_ulong GetNanoSeconds();
+
+ private:
+  CSimDevice();
+  void MakeReady(const std::shared_ptr<Command> &command);
+  void Complete(const std::shared_ptr<Command> &command);
+  bool PopRunnable(std::shared_ptr<Command> &command);
+  void WorkerThread();
+
+  std::mutex m_oMutex;
+  std::condition_variable m_oWorkCv;
+  std::condition_variable m_oIdleCv;
+  std::deque<std::shared_ptr<Command>> m_dReady;
+  std::vector<bool> m_vBusyUnits;
+  std::vector<std::thread> m_vWorkers;
+  bool m_bStop;
+};
@@ -0,0 +1,242 @@
+#pragma once
+
+/**
+ * The subset of the OpenCL C++ bindings (CL/cl2.hpp) and of the Xilinx extensions (CL/cl_ext_xilinx.h) that the host
+ * uses, implemented on top of CSimDevice. It is included by xcl2.h instead of the SDAccel headers when the host is
+ * built with SimDevice=ON (SIMDEVICE).
+ * The buffers live in the host memory, the kernels are the HLS sources of src/fpga/xilinx/kernels compiled natively
+ * (C-simulation, like the kerneltests) and the commands of the queues are executed by the worker pool of CSimDevice,
+ * honouring their event dependencies. So the host scheduling logic (the OclTests, the model) runs without SDAccel.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+typedef int32_t cl_int;
+typedef uint32_t cl_uint;
+typedef uint64_t cl_ulong;
+typedef cl_uint cl_bool;
+typedef cl_ulong cl_bitfield;
+typedef cl_bitfield cl_mem_flags;
+typedef cl_bitfield cl_device_type;
+typedef cl_bitfield cl_command_queue_properties;
+typedef cl_uint cl_device_info;
+typedef cl_uint cl_platform_info;
+typedef cl_uint cl_event_info;
+typedef cl_uint cl_profiling_info;
+typedef cl_uint cl_buffer_create_type;
+typedef intptr_t cl_context_properties;
+typedef struct _cl_event *cl_event;
+typedef struct _cl_platform_id *cl_platform_id;
+
+struct cl_buffer_region{
+  size_t origin;
+  size_t size;
+};
+
+typedef struct{
+  unsigned flags;
+  void *obj;
+  void *param;
+} cl_mem_ext_ptr_t;
+
+#define CL_CALLBACK
+
+#define CL_SUCCESS                                  0
+#define CL_PROFILING_INFO_NOT_AVAILABLE             -7
+#define CL_MISALIGNED_SUB_BUFFER_OFFSET             -13
+#define CL_INVALID_VALUE                            -30
+#define CL_INVALID_MEM_OBJECT                       -38
+#define CL_INVALID_KERNEL_NAME                      -46
+#define CL_INVALID_KERNEL                           -48
+#define CL_INVALID_ARG_INDEX                        -49
+#define CL_INVALID_ARG_SIZE                         -51
+#define CL_INVALID_KERNEL_ARGS                      -52
+#define CL_INVALID_EVENT                            -58
+#define CL_INVALID_BUFFER_SIZE                      -61
+
+#define CL_FALSE                                    0
+#define CL_TRUE                                     1
+#define CL_BLOCKING                                 CL_TRUE
+#define CL_NON_BLOCKING                             CL_FALSE
+
+#define CL_COMPLETE                                 0x0
+#define CL_RUNNING                                  0x1
+#define CL_SUBMITTED                                0x2
+#define CL_QUEUED                                   0x3
+
+#define CL_PLATFORM_NAME                            0x0902
+#define CL_DEVICE_MEM_BASE_ADDR_ALIGN               0x1019
+#define CL_DEVICE_NAME                              0x102B
+#define CL_DEVICE_TYPE_ACCELERATOR                  (1 << 3)
+#define CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE      (1 << 0)
+#define CL_QUEUE_PROFILING_ENABLE                   (1 << 1)
+#define CL_MEM_READ_WRITE                           (1 << 0)
+#define CL_MEM_USE_HOST_PTR                         (1 << 3)
+#define CL_MEM_EXT_PTR_XILINX                       (1 << 31)
+#define CL_EVENT_COMMAND_EXECUTION_STATUS           0x11D3
+#define CL_PROFILING_COMMAND_QUEUED                 0x1280
+#define CL_PROFILING_COMMAND_SUBMIT                 0x1281
+#define CL_PROFILING_COMMAND_START                  0x1282
+#define CL_PROFILING_COMMAND_END                    0x1283
+#define CL_BUFFER_CREATE_TYPE_REGION                0x1220
+
+#define XCL_MEM_DDR_BANK0                           (1 << 0)
+#define XCL_MEM_DDR_BANK1                           (1 << 1)
+#define XCL_MEM_DDR_BANK2                           (1 << 2)
+#define XCL_MEM_DDR_BANK3                           (1 << 3)
+
+cl_int clGetEventProfilingInfo(cl_event event,
+                               cl_profiling_info paramName,
+                               size_t paramValueSize,
+                               void *paramValue,
+                               size_t *paramValueSizeRet);
+
+struct _cl_mem;
+struct _cl_command_queue;
+
+namespace cl{
+
+constexpr const char *kSimPlatformName = "Xilinx";
+constexpr const char *kSimDeviceName = "xilinx_simdevice";
+constexpr cl_uint kSimBaseAddrAlignBits = 4096*8; // The alignment of the sub-buffers of the XRT devices.
+
+// The queries of the simulated device and the types of their values.
+template<cl_device_info name> struct SimDeviceInfo;
+template<> struct SimDeviceInfo<CL_DEVICE_NAME>{
+  static std::string Get(){ return kSimDeviceName; }
+};
+template<> struct SimDeviceInfo<CL_DEVICE_MEM_BASE_ADDR_ALIGN>{
+  static cl_uint Get(){ return kSimBaseAddrAlignBits; }
+};
+
+class Device{
+ public:
+  template<cl_device_info name>
+  auto getInfo(cl_int *err=nullptr) const -> decltype(SimDeviceInfo<name>::Get()) {
+    if(err) *err = CL_SUCCESS;
+    return SimDeviceInfo<name>::Get();
+  }
+};
+
+class Platform{
+ public:
+  static cl_int get(std::vector<Platform> *platforms);
+  cl_int getDevices(cl_device_type type, std::vector<Device> *devices) const;
+  template<cl_platform_info name>
+  std::string getInfo(cl_int *err=nullptr) const {
+    static_assert(name==CL_PLATFORM_NAME, "Only CL_PLATFORM_NAME is supported by the simulated platform.");
+    if(err) *err = CL_SUCCESS;
+    return kSimPlatformName;
+  }
+};
+
+class Context{
+ public:
+  Context() = default;
+  Context(const Device &device,
+          const cl_context_properties *properties=nullptr,
+          void *notifyFptr=nullptr,
+          void *data=nullptr,
+          cl_int *err=nullptr);
+};
+
+class Program{
+ public:
+  using Binaries = std::vector<std::pair<const void*, size_t>>;
+  Program() = default;
+  /**
+   * @brief      The kernels are linked into the host, the FPGA image (if any) is ignored.
+   */
+  Program(const Context &context,
+          const std::vector<Device> &devices,
+          const Binaries &binaries,
+          std::vector<cl_int> *binaryStatus=nullptr,
+          cl_int *err=nullptr);
+};
+
+class Buffer{
+ public:
+  Buffer() = default;
+  Buffer(const Context &context, cl_mem_flags flags, size_t size, void *hostPtr=nullptr, cl_int *err=nullptr);
+  Buffer createSubBuffer(cl_mem_flags flags, cl_buffer_create_type type, const void *createInfo, cl_int *err=nullptr) const;
+  _cl_mem* operator()() const { return m_ptrMem.get(); }
+
+ private:
+  friend class Kernel;
+  friend class CommandQueue;
+  std::shared_ptr<_cl_mem> m_ptrMem;
+};
+
+class Event{
+ public:
+  Event() = default;
+  cl_event operator()() const { return m_ptrEvent.get(); }
+  cl_int wait() const;
+  cl_int setCallback(cl_int type, void (CL_CALLBACK *notifyFptr)(cl_event, cl_int, void*), void *userData=nullptr);
+  cl_int getInfo(cl_event_info name, cl_int *param) const;
+  cl_int getProfilingInfo(cl_profiling_info name, cl_ulong *param) const;
+
+ private:
+  friend class CommandQueue;
+  std::shared_ptr<_cl_event> m_ptrEvent;
+};
+
+/**
+ * @brief      An argument of a kernel: a buffer or a scalar of up to 8 bytes.
+ */
+struct SimKernelArg{
+  std::shared_ptr<_cl_mem> buffer;
+  uint64_t scalar = 0;
+  size_t scalarSize = 0;  // Zero for the buffers and for the arguments that are not set.
+};
+
+class Kernel{
+ public:
+  Kernel() = default;
+  Kernel(const Program &program, const char *name, cl_int *err=nullptr);
+  cl_int setArg(cl_uint index, const Buffer &buffer);
+  template<typename T>
+  cl_int setArg(cl_uint index, const T &value){
+    static_assert(std::is_arithmetic<T>::value && sizeof(T)<=sizeof(uint64_t), "Only the buffers and the scalars are supported.");
+    uint64_t raw = 0;
+    std::memcpy(&raw, &value, sizeof(T));
+    return SetScalarArg(index, raw, sizeof(T));
+  }
+
+ private:
+  friend class CommandQueue;
+  cl_int SetScalarArg(cl_uint index, uint64_t raw, size_t size);
+  int m_iKernelIndex = -1;  // The index of the kernel in CSimDevice::GetKernelTable().
+  std::vector<SimKernelArg> m_vArgs;
+};
+
+class CommandQueue{
+ public:
+  CommandQueue() = default;
+  CommandQueue(const Context &context, const Device &device, cl_command_queue_properties properties=0, cl_int *err=nullptr);
+
+  cl_int enqueueReadBuffer(const Buffer &buffer, cl_bool blocking, size_t offset, size_t size, void *ptr,
+                           const std::vector<Event> *events=nullptr, Event *event=nullptr) const;
+  cl_int enqueueWriteBuffer(const Buffer &buffer, cl_bool blocking, size_t offset, size_t size, const void *ptr,
+                            const std::vector<Event> *events=nullptr, Event *event=nullptr) const;
+  cl_int enqueueCopyBuffer(const Buffer &src, const Buffer &dst, size_t srcOffset, size_t dstOffset, size_t size,
+                           const std::vector<Event> *events=nullptr, Event *event=nullptr) const;
+  cl_int enqueueTask(const Kernel &kernel, const std::vector<Event> *events=nullptr, Event *event=nullptr) const;
+  cl_int enqueueMarkerWithWaitList(const std::vector<Event> *events=nullptr, Event *event=nullptr) const;
+  cl_int finish() const;
+
+ private:
+  cl_int Enqueue(int computeUnit, std::function<void()> task, cl_bool blocking,
+                 const std::vector<Event> *events, Event *event) const;
+  std::shared_ptr<_cl_command_queue> m_ptrQueue;
+};
+
+}
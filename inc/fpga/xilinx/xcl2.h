@@ -37,10 +37,14 @@ EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define CL_HPP_ENABLE_PROGRAM_CONSTRUCTION_FROM_ARRAY_COMPATIBILITY 1
 #define CL_USE_DEPRECATED_OPENCL_1_2_APIS
 
+#ifdef SIMDEVICE
+#include "fpga/xilinx/sim/SimOpenCL.h"
+#else
 #include <CL/cl2.hpp>
+#include <CL/cl_ext_xilinx.h>
+#endif
 #include <iostream>
 #include <fstream>
-#include <CL/cl_ext_xilinx.h>
 // When creating a buffer with user pointer (CL_MEM_USE_HOST_PTR), under the hood
 // User ptr is used if and only if it is properly aligned (page aligned). When not 
 // aligned, runtime has no choice but to create its own host side buffer that backs
@@ -74,6 +78,7 @@ namespace xcl {
   bool is_emulation ();
   bool is_hw_emulation ();
   bool is_xpr_device (const char *device_name);
+#ifndef SIMDEVICE
     class Stream{
       public:
         static decltype(&clCreateStream) createStream;
@@ -94,4 +99,5 @@ namespace xcl {
             pollStreams = (decltype(&clPollStreams))bar;
         }
     };
+#endif
 }
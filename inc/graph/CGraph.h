@@ -0,0 +1,96 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "GlobalHelpers.h"
+#include "CTensorBase.h"
+
+/**
+ * @brief The operations of the graph nodes. Except for the first two and the last four, every operation is a layer
+ * of CImplementationBase (launched through CPlatformSelection).
+ */
+enum class GRAPH_OPS{
+  INPUT,            // A tensor given to CGraphExecutor::Execute()
+  CONSTANT,         // A tensor held by the node, or a weight that is resolved at the execution
+  CONCAT2,
+  MATMUL,
+  RELU,
+  SQRT,
+  SQUARE,
+  BASIC_OPS,
+  BASIC_OPS_SCALAR,
+  TILE,
+  TRANSPOSE,
+  GATHER,
+  REDUCE,
+  MEAN,
+  VARIANCE,
+  PAD_LAST_DIM,
+  UNPAD_LAST_DIM,
+  TOPK,
+  CONV2D,
+  KNN,
+  EDGECONV,
+  RESHAPE,          // A new tensor with the new shape that shares the buffer of its input, the input is not touched.
+  EXPAND_DIMS,      // Same as RESHAPE
+  SQUEEZE_DIMS,     // Same as RESHAPE
+  CROSS_PLATFORM    // Transfers its input to the platform of the node, if needed.
+};
+
+/**
+ * @brief A node of the graph. The edges are the tensors, each node produces exactly one and refers to the producers
+ * of its inputs by their node ids. Only the attributes of the node's operation are used.
+ */
+struct CGraphNode{
+  unsigned id;
+  GRAPH_OPS op;
+  PLATFORMS platform;
+  std::string name;
+  std::vector<unsigned> inputs;
+
+  CTensorBasePtr constantTn;      // CONSTANT (not a weight)
+  int weightIndex;                // CONSTANT (a weight): the index of its CWeightLoader::Handle, -1 otherwise
+  BASIC_OPS basicOpsMode;         // BASIC_OPS, BASIC_OPS_SCALAR
+  REDUCTION_OPS reductionMode;    // REDUCE
+  float scalar;                   // BASIC_OPS_SCALAR
+  unsigned axis;                  // CONCAT2, TILE, GATHER, TOPK, EXPAND_DIMS, PAD_LAST_DIM, UNPAD_LAST_DIM (the dim)
+  unsigned count;                 // TILE (tile count), TOPK and KNN (k), REDUCE (powY)
+  std::vector<unsigned> dims;     // REDUCE, MEAN, VARIANCE (the combination), RESHAPE (the new shape)
+
+  std::vector<std::string> dumpFileNames; // The output is dumped into these files (only when the tensor dumps are enabled).
+};
+
+/**
+ * @brief A directed acyclic graph of layers. The nodes could only refer to the nodes that are added before them, so
+ * the graph is acyclic by construction. It is filled by CGraphBuilder and run by CGraphExecutor.
+ */
+class CGraph {
+ public:
+  unsigned AddNode(const CGraphNode &node);
+  void MarkOutput(unsigned nodeId);
+
+  CGraphNode& GetNode(unsigned nodeId);
+  const CGraphNode& GetNode(unsigned nodeId) const;
+  size_t GetNodeCount() const;
+  const std::vector<unsigned>& GetInputNodes() const;
+  const std::vector<unsigned>& GetOutputNodes() const;
+
+  /**
+   * @brief      Returns the number of the nodes reading the output of each node.
+   */
+  std::vector<unsigned> GetConsumerCounts() const;
+
+  /**
+   * @brief      Returns the node ids in a topological order (Kahn's algorithm, ties are broken by the node id so the
+   * order of the builder is kept when there is no reason to change it).
+   */
+  std::vector<unsigned> GetTopologicalOrder() const;
+
+  void PrintSummary() const;
+  static std::string GetOpName(GRAPH_OPS op);
+
+ private:
+  std::vector<CGraphNode> m_vNodes;
+  std::vector<unsigned> m_vInputNodes;
+  std::vector<unsigned> m_vOutputNodes;
+};
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+#include "GlobalHelpers.h"
+#include "CWeightLoader.h"
+#include "graph/CGraph.h"
+
+/**
+ * @brief Fills a CGraph with the same calls as CPlatformSelection, but every call returns the id of a node instead of
+ * a tensor. The nodes are placed on the current platform of the builder (SetPlatform()) and are named with the current
+ * scope (SetScope()). The weights are taken from CWeightLoader by their handles once, at build time.
+ */
+class CGraphBuilder {
+ public:
+  CGraphBuilder(CGraph *graph, CWeightLoader *weightLoader, PLATFORMS platform);
+
+  void SetPlatform(PLATFORMS platform);
+  PLATFORMS GetPlatform() const;
+  void SetScope(const std::string &scope);
+
+  unsigned Input(const std::string &name);
+  unsigned Weight(CWeightLoader::Handle weight);
+  unsigned Constant(CTensorBasePtr tn, const std::string &name);
+
+  unsigned Concat2      (unsigned inputNode1, unsigned inputNode2, unsigned concatAxis);
+  unsigned MatMul       (unsigned inputNode1, unsigned inputNode2);
+  unsigned ReLU         (unsigned inputNode);
+  unsigned Sqrt         (unsigned inputNode);
+  unsigned Square       (unsigned inputNode);
+  unsigned BasicOps     (unsigned inputNode1, unsigned inputNode2, BASIC_OPS mode);
+  unsigned BasicOps     (unsigned inputNode1, float scalar, BASIC_OPS mode);
+  unsigned Tile         (unsigned inputNode, unsigned tileAxis, unsigned tileCount);
+  unsigned Transpose    (unsigned inputNode);
+  unsigned Gather       (unsigned inputNode, unsigned indicesNode, unsigned indicesOfAxis);
+  unsigned Reduce       (unsigned inputNode, REDUCTION_OPS mode, unsigned powY, const std::vector<unsigned> &combination);
+  unsigned Mean         (unsigned inputNode, const std::vector<unsigned> &combination);
+  unsigned Variance     (unsigned inputNode, const std::vector<unsigned> &combination);
+  unsigned PadLastDim   (unsigned inputNode, unsigned lastDimPadded);
+  unsigned UnpadLastDim (unsigned inputNode, unsigned lastDimUnpadded);
+  unsigned TopK         (unsigned inputNode, unsigned axis, unsigned k);
+  unsigned Conv2D       (unsigned inputNode, unsigned weightNode, unsigned biasNode);
+  unsigned KNN          (unsigned inputNode, unsigned k);
+  unsigned EdgeConv     (unsigned inputNode, unsigned knnNode, unsigned weightNode, unsigned biasNode);
+
+  unsigned Reshape      (unsigned inputNode, const std::vector<unsigned> &newShape);
+  unsigned ExpandDims   (unsigned inputNode, unsigned axis);
+  unsigned SqueezeDims  (unsigned inputNode);
+  unsigned CrossThePlatform(unsigned inputNode, PLATFORMS destPlatform);
+
+  /**
+   * @brief      Dumps the output of the node into a numpy file (only when the tensor dumps are enabled).
+   */
+  void Dump(unsigned node, const std::string &npyFileName);
+  void Output(unsigned node);
+
+ private:
+  CGraphNode NewNode(GRAPH_OPS op, const std::vector<unsigned> &inputs) const;
+  unsigned Add(const CGraphNode &node);
+
+  CGraph *m_ptrGraph;
+  CWeightLoader *m_ptrWeightLoader;
+  PLATFORMS m_ePlatform;
+  std::string m_strScope;
+  std::map<std::pair<unsigned,PLATFORMS>, unsigned> m_mWeightNodes;
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <vector>
+#include "GlobalHelpers.h"
+#include "CPlatformSelection.h"
+#include "graph/CGraph.h"
+
+/**
+ * @brief Runs a CGraph through CPlatformSelection, node by node in a topological order. The output of a node is
+ * released right after its last consumer has been launched (unless it is an output of the graph), so the lifetimes of
+ * the intermediate tensors follow the graph instead of the scopes of the code that builds it.
+ * A MEAN and a VARIANCE node of the same input, combination and platform (the batch norms) are run as a single
+ * MeanVariance layer, so their input is read once.
+ */
+class CGraphExecutor {
+ public:
+  CGraphExecutor(CPlatformSelection *platSelection, const CGraph *graph);
+
+  /**
+   * @brief      Runs the graph.
+   *
+   * @param[in]  inputTns  The tensors of the input nodes, in the order of their creation.
+   *
+   * @return     The tensors of the output nodes, in the order of CGraphBuilder::Output() calls.
+   */
+  std::vector<CTensorBasePtr> Execute(const std::vector<CTensorBasePtr> &inputTns);
+
+ private:
+  CTensorBasePtr ExecuteNode(const CGraphNode &node, const std::vector<CTensorBasePtr> &values);
+  void PairMomentNodes();
+
+  CPlatformSelection *m_ptrPlatSelection;
+  const CGraph *m_ptrGraph;
+  std::vector<unsigned> m_vOrder;
+  std::vector<unsigned> m_vConsumerCounts;
+  std::vector<bool> m_vIsOutput;
+  std::vector<int> m_vMomentsPartner; // The paired VARIANCE of a MEAN node and vice versa, -1 if not paired.
+};
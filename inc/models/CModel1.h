@@ -6,10 +6,30 @@
 #include "CStringFormatter.h"
 #include "cnpy.h"
 #include "CPlatformSelection.h"
+#include "graph/CGraph.h"
+#include "graph/CGraphBuilder.h"
+#include "graph/CGraphExecutor.h"
+#include <deque>
 #include <string>
 
 class CModel1 {
  public:
+  // The handles of the weights of a layer, resolved once at the construction (see ResolveWeights()).
+  struct DenseWeights{
+    CWeightLoader::Handle weights;
+    CWeightLoader::Handle biases;
+  };
+  struct BatchNormWeights{
+    CWeightLoader::Handle gamma;
+    CWeightLoader::Handle beta;
+    CWeightLoader::Handle emaAve;
+    CWeightLoader::Handle emaVar;
+  };
+  struct LayerWeights{ // A Conv2D, EdgeConv or FC layer followed by a batch-norm.
+    DenseWeights dense;
+    BatchNormWeights bn;
+  };
+
   CModel1(PLATFORMS targetPlatform,
           unsigned datasetOffset,
           unsigned batchSize,
@@ -19,16 +39,25 @@ class CModel1 {
           bool enableOclProfiling,
           bool enableMemBankCrossing,
           bool enableCpuUtilization,
-          bool enableTensorDumps);
+          bool enableTensorDumps,
+          bool enableBatchNormFolding=false);
   ~CModel1();
   void            SetDatasetData(std::string &pathNumpyData);
   void            SetDatasetLabels(std::string &pathNumpyLabels);
-  CTensorBasePtr  FullyConnectedForward(CTensorBasePtr inputTn, CTensorBasePtr weightsTn, CTensorBasePtr biasesTn);
-  CTensorBasePtr  BatchNormForward(CTensorBasePtr inputTn, CTensorBasePtr gammaTn, CTensorBasePtr betaTn, CTensorBasePtr emaAveTn, CTensorBasePtr emaVarTn);
-  CTensorBasePtr  GetEdgeFeatures(CTensorBasePtr inputTn, CTensorBasePtr knnTn);
-  CTensorBasePtr  PairwiseDistance(CTensorBasePtr inputTn);
-  CTensorBasePtr  TransformNet(CTensorBasePtr edgeFeaturesTn);
+  void            SetDatasetRandom(unsigned pointCloudCount, unsigned seed);
+  void            SetDatasetOffset(unsigned datasetOffset);
+  unsigned        GetDatasetOffset();
+  unsigned        GetDatasetSize();
+  unsigned        FullyConnectedForward(CGraphBuilder &builder, unsigned inputNode, const DenseWeights &weights);
+  unsigned        BatchNormForward(CGraphBuilder &builder, unsigned inputNode, const BatchNormWeights &weights, unsigned rank);
+  unsigned        TransformNet(CGraphBuilder &builder, unsigned inputNode, unsigned knnNode);
+  void            BuildGraph();
+  const CGraph*   GetGraph();
+  CPlatformSelection* GetPlatformSelection();
   CTensorBasePtr  Execute();
+  void            EnqueueBatch(unsigned datasetOffset);
+  CTensorBasePtr  CollectBatch(CTensorBasePtr &labelsTn);
+  unsigned        GetPendingBatchCount();
   CTensorBasePtr  GetLabelTn();
   CTensorBasePtr  GetDataTn();
   unsigned        GetBatchSize();
@@ -42,12 +71,39 @@ class CModel1 {
   unsigned m_uKnnK=-1;
   unsigned m_uClassCount=-1;
   bool m_bUseShapeNet;
+  bool m_bFoldBatchNorm; // The batch-norms are folded into the weights at loading and BatchNormForward is skipped.
   PLATFORMS m_eTargetPlatform;
   CTensorBasePtr m_ptrDatasetDataTn;
   CTensorBasePtr m_ptrDatasetLabelsTn;
   cnpy::NpyArray m_oNumpyObjectData;
   cnpy::NpyArray m_oNumpyObjectLabels;
+  bool m_bDatasetDataLoaded, m_bDatasetLabelsLoaded;
   CPlatformSelection* m_ptrPlatSelection;
+  CGraph* m_ptrGraph; // The DGCNN layers, built once by BuildGraph() and run by m_ptrGraphExecutor at every Execute().
+  CGraphExecutor* m_ptrGraphExecutor;
+
+  struct ModelWeights{
+    LayerWeights tconv1, tconv2, tconv3, tfc1, tfc2;
+    DenseWeights transformXYZ;
+    LayerWeights dgcnn[4];
+    LayerWeights agg;
+    LayerWeights fc[2];
+    DenseWeights fc3;
+  };
+  ModelWeights m_oWeights;
+
+  // The batches that are enqueued by EnqueueBatch() and not yet read back by CollectBatch(), oldest first.
+  struct PendingBatch{
+    unsigned datasetOffset;
+    CTensorBasePtr outputTn; // On the device, until it is collected.
+    CTensorBasePtr labelsTn;
+  };
+  std::deque<PendingBatch> m_qPendingBatches;
+
+  void ResolveWeights();
+  void SliceDatasetData();
+  void SliceDatasetLabels();
+  CTensorBasePtr RunGraph(CTensorBasePtr inputTn);
 };
 
  
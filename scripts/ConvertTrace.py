@@ -0,0 +1,237 @@
+import json
+import struct
+import sys
+import os
+
+"""
+Converts the binary trace of CProfiler (profiler.trace) to:
+    - <base>.json: the JSON trace that Report.py consumes.
+    - <base>.chrome.json: the Chrome trace-event format (ui.perfetto.dev, chrome://tracing), with a track per host
+      thread, per kernel and per DDR bank.
+The layout of the records should be kept in sync with CProfiler::TraceRecord (inc/CProfiler.h).
+"""
+
+TRACE_MAGIC = b'DP2TRACE'
+TRACE_VERSION = 2
+HEADER_FMT = '<8sIIII'
+RECORD_FMT = '<BBBBBbbxIIqQfI40s' + '16sI4I' * 4 + '16si' * 4 + '16sf' * 2 + 'QQQQ'
+RECORD_BYTES = struct.calcsize(RECORD_FMT)
+
+RECORD_LAYER_START = 1
+RECORD_LAYER_STOP = 2
+RECORD_KERNEL = 3
+RECORD_DATAMOVER = 4
+RECORD_CLOCK_SYNC = 5
+
+PLATFORMS = ['cpu', 'xil']
+
+
+def decode_str(raw):
+    return raw.split(b'\0', 1)[0].decode('utf-8', errors='replace')
+
+
+def decode_record(raw):
+    fields = struct.unpack(RECORD_FMT, raw)
+    rec = {
+        'type': fields[0],
+        'platform': PLATFORMS[fields[1]] if fields[1] < len(PLATFORMS) else 'undef',
+        'bank.src': fields[5],
+        'bank.dest': fields[6],
+        'id': fields[7],
+        'bytes': fields[8],
+        'timestamp': fields[9],
+        'duration': fields[10],
+        'cpu.usage': fields[11],
+        'thread': fields[12],
+        'name': decode_str(fields[13]),
+        'device': fields[-4:],  # queued, submit, start, end
+        'args': {}
+    }
+    shape_count, int_count, float_count = fields[2], fields[3], fields[4]
+    pos = 14
+    for i in range(4):
+        key, rank, dims = fields[pos], fields[pos + 1], fields[pos + 2:pos + 6]
+        if i < shape_count:
+            rec['args'][decode_str(key)] = list(dims[:rank])
+        pos += 6
+    for i in range(4):
+        if i < int_count:
+            rec['args'][decode_str(fields[pos])] = fields[pos + 1]
+        pos += 2
+    for i in range(2):
+        if i < float_count:
+            rec['args'][decode_str(fields[pos])] = fields[pos + 1]
+        pos += 2
+    return rec
+
+
+def read_trace(path_trace):
+    with open(path_trace, 'rb') as f:
+        data = f.read()
+    header_bytes = struct.calcsize(HEADER_FMT)
+    if len(data) < header_bytes:
+        raise ValueError('The trace file is truncated: ' + path_trace)
+    magic, version, record_bytes, info_bytes, _ = struct.unpack_from(HEADER_FMT, data, 0)
+    if magic != TRACE_MAGIC or version != TRACE_VERSION:
+        raise ValueError('The file is not a supported profiler trace: ' + path_trace)
+    if record_bytes != RECORD_BYTES:
+        raise ValueError('The record size of the trace (%d) does not match the script (%d).' % (record_bytes, RECORD_BYTES))
+    info = json.loads(data[header_bytes:header_bytes + info_bytes].decode('utf-8'))
+    records = []
+    offset = header_bytes + info_bytes
+    # A trailing partial record (a crashed run) is ignored.
+    while offset + RECORD_BYTES <= len(data):
+        records.append(decode_record(data[offset:offset + RECORD_BYTES]))
+        offset += RECORD_BYTES
+    return info, records
+
+
+def to_report_json(info, records):
+    """
+    Rebuilds the nested layers of the old JSON trace. The layers left open by a crashed run are closed with the
+    timestamp of the last record.
+    """
+    trace = []
+    stack = []
+    last_timestamp = 0
+    for rec in records:
+        if rec['type'] == RECORD_LAYER_START:
+            last_timestamp = rec['timestamp']
+            stack.append({
+                'type': 'layer',
+                'name': rec['name'],
+                'platform': rec['platform'],
+                'id': rec['id'],
+                'args': rec['args'],
+                'time.start': rec['timestamp'],
+                'cpu.usage': rec['cpu.usage'],
+                'nested': []
+            })
+        elif rec['type'] == RECORD_LAYER_STOP:
+            last_timestamp = rec['timestamp']
+            if not stack:
+                continue
+            layer = stack.pop()
+            layer['time.stop'] = rec['timestamp']
+            (stack[-1]['nested'] if stack else trace).append(layer)
+        elif rec['type'] in (RECORD_KERNEL, RECORD_DATAMOVER):
+            kernel = {
+                'type': 'kernel',
+                'name': rec['name'],
+                'platform': rec['platform'],
+                'id': rec['id']
+            }
+            if rec['type'] == RECORD_DATAMOVER:
+                kernel['bytes'] = rec['bytes']
+            kernel['duration'] = rec['duration']
+            (stack[-1]['nested'] if stack else trace).append(kernel)
+    while stack:
+        layer = stack.pop()
+        layer['time.stop'] = last_timestamp
+        (stack[-1]['nested'] if stack else trace).append(layer)
+    return {'info': info, 'trace': trace}
+
+
+PID_HOST = 0
+PID_KERNELS = 1
+PID_BANKS = 2
+
+
+def to_chrome_json(info, records):
+    """
+    The layers are on one track per host thread, the kernels on one track per kernel and the datamover transfers on
+    the tracks of both of their DDR banks. The device timestamps are mapped to the host clock with the clock sync
+    record. Without it (a trace without OpenCL profiling), the kernels are placed at the start of their parent layers.
+    """
+    events = []
+    layer_start = {}
+    stacks = {}
+    kernel_tids = {}
+    device_offset_ns = None
+    for rec in records:
+        if rec['type'] == RECORD_CLOCK_SYNC:
+            device_offset_ns = rec['device'][0] - rec['timestamp'] * 1000
+        elif rec['type'] == RECORD_LAYER_START:
+            stacks.setdefault(rec['thread'], []).append(rec)
+            layer_start[rec['id']] = rec['timestamp']
+        elif rec['type'] == RECORD_LAYER_STOP:
+            stack = stacks.get(rec['thread'])
+            if not stack:
+                continue
+            start = stack.pop()
+            args = dict(start['args'])
+            args['id'] = start['id']
+            args['cpu.usage'] = start['cpu.usage']
+            events.append({
+                'name': start['name'], 'cat': 'layer.' + start['platform'], 'ph': 'X',
+                'ts': start['timestamp'], 'dur': rec['timestamp'] - start['timestamp'],
+                'pid': PID_HOST, 'tid': rec['thread'], 'args': args
+            })
+        elif rec['type'] in (RECORD_KERNEL, RECORD_DATAMOVER):
+            queued, submit, start, end = rec['device']
+            args = {'parent.id': rec['id']}
+            if device_offset_ns is not None and start != 0:
+                ts = (start - device_offset_ns) / 1000.0
+                args['queued.to.start.us'] = (start - queued) / 1000.0
+                args['submit.to.start.us'] = (start - submit) / 1000.0
+            else:
+                ts = layer_start.get(rec['id'], 0)
+            tid = kernel_tids.setdefault(rec['name'], len(kernel_tids))
+            event = {
+                'name': rec['name'], 'cat': 'kernel.' + rec['platform'], 'ph': 'X',
+                'ts': ts, 'dur': rec['duration'] / 1000.0, 'pid': PID_KERNELS, 'tid': tid, 'args': args
+            }
+            events.append(event)
+            if rec['type'] == RECORD_DATAMOVER:
+                args['bytes'] = rec['bytes']
+                args['bank.src'] = rec['bank.src']
+                args['bank.dest'] = rec['bank.dest']
+                for bank in sorted({rec['bank.src'], rec['bank.dest']}):
+                    bank_event = dict(event)
+                    bank_event['name'] = 'datamover %d->%d' % (rec['bank.src'], rec['bank.dest'])
+                    bank_event['cat'] = 'datamover'
+                    bank_event['pid'] = PID_BANKS
+                    bank_event['tid'] = bank
+                    events.append(bank_event)
+
+    def add_name(pid, tid, name):
+        events.append({'name': 'thread_name', 'ph': 'M', 'pid': pid, 'tid': tid, 'args': {'name': name}})
+
+    events.append({'name': 'process_name', 'ph': 'M', 'pid': PID_HOST, 'args': {'name': 'Host'}})
+    events.append({'name': 'process_name', 'ph': 'M', 'pid': PID_KERNELS, 'args': {'name': 'FPGA kernels'}})
+    events.append({'name': 'process_name', 'ph': 'M', 'pid': PID_BANKS, 'args': {'name': 'DDR banks'}})
+    for thread in stacks:
+        add_name(PID_HOST, thread, 'host thread %d' % thread)
+    for name, tid in kernel_tids.items():
+        add_name(PID_KERNELS, tid, name)
+    for bank in sorted({e['tid'] for e in events if e.get('pid') == PID_BANKS and e['ph'] == 'X'}):
+        add_name(PID_BANKS, bank, 'bank %d' % bank)
+    return {'traceEvents': events, 'displayTimeUnit': 'ns', 'otherData': info}
+
+
+def convert(path_trace):
+    """
+    Writes <base>.json and <base>.chrome.json next to the trace and returns the path of the first one.
+    """
+    info, records = read_trace(path_trace)
+    base = os.path.splitext(path_trace)[0]
+    path_json = base + '.json'
+    with open(path_json, 'w') as f:
+        json.dump(to_report_json(info, records), f)
+    with open(base + '.chrome.json', 'w') as f:
+        json.dump(to_chrome_json(info, records), f)
+    print('Converted %d records of %s to %s and %s' % (len(records), path_trace, path_json, base + '.chrome.json'))
+    return path_json
+
+
+def print_help():
+    print("DeepPoint-V2-FPGA Profiler Trace Converter")
+    print("Usage:")
+    print("\tpython3 ConvertTrace.py <path to profiler.trace>")
+
+
+if __name__ == "__main__":
+    if len(sys.argv) != 2:
+        print_help()
+        exit(1)
+    convert(sys.argv[1])
@@ -7,6 +7,7 @@ import numpy as np
 from pathlib import Path
 import zipfile
 import colorama
+import ConvertTrace
 
 
 class CProfiler:
@@ -1132,6 +1133,9 @@ def batch_mode(path_dir):
             unzipped_folder = os.path.join(folder_path, "unzipped")
             zip_ref.extractall(unzipped_folder)
             json_file_path = os.path.join(unzipped_folder, 'profiler.json')
+            trace_file_path = os.path.join(unzipped_folder, 'profiler.trace')
+            if not os.path.isfile(json_file_path) and os.path.isfile(trace_file_path):
+                json_file_path = ConvertTrace.convert(trace_file_path)
             print("Analyzing ", json_file_path)
             try:
                 obj = CReporter(json_file_path)
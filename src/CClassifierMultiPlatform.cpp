@@ -2,31 +2,101 @@
 
 #include "CClassifierMultiPlatform.h"
 #include "GlobalHelpers.h"
+#include <algorithm>
+#include <cmath>
+#include <deque>
 #include <string>
+#include <vector>
 #include <sys/time.h>
 
 using namespace std;
 
+constexpr unsigned CClassifierMultiPlatform::kSyntheticDatasetSize;
+
 CClassifierMultiPlatform::CClassifierMultiPlatform(
     bool useShapeNetInstead,
     bool enableOclProfiling,
     bool enableMemBankCrossing,
     bool enableCpuUtilization,
-    bool enableTensorDumps){
+    bool enableTensorDumps,
+    bool enableBatchNormFolding,
+    bool enableBatchNormFoldingCheck,
+    bool enableStreaming){
 
   m_bUseShapeNet = useShapeNetInstead;
+  m_bEnableOclProfiling = enableOclProfiling;
+  m_bEnableMemBankCrossing = enableMemBankCrossing;
+  m_bEnableCpuUtilization = enableCpuUtilization;
+  m_bEnableTensorDumps = enableTensorDumps;
+  m_ptrClassifierModel = nullptr;
+  m_dModelCreationTime = 0;
+  m_bSucceeded = true;
+
+  if(enableStreaming){
+    RunStreaming(enableBatchNormFolding);
+  }else if(!enableBatchNormFoldingCheck){
+    CTensorPtr<float> classScoresTn;
+    RunModel(enableBatchNormFolding, classScoresTn);
+  }else{
+    // The accuracy regression check of the folded batch-norms against the default computational graph.
+    CTensorPtr<float> refScoresTn, foldedScoresTn;
+    SPDLOG_LOGGER_INFO(logger,"Running the model with the default batch-norm layers...");
+    const float refAccu = RunModel(false, refScoresTn);
+    SPDLOG_LOGGER_INFO(logger,"Running the model with the folded batch-norm layers...");
+    const float foldedAccu = RunModel(true, foldedScoresTn);
+
+    const unsigned batchSize = m_ptrClassifierModel->GetBatchSize();
+    const unsigned classCount = m_ptrClassifierModel->GetClassCount();
+    float maxDiff = 0;
+    unsigned agreedCount = 0;
+    for(unsigned b=0; b<batchSize; b++){
+      unsigned refArgMax=0, foldedArgMax=0;
+      for(unsigned c=0; c<classCount; c++){
+        const float ref = (*refScoresTn)[b*classCount+c];
+        const float folded = (*foldedScoresTn)[b*classCount+c];
+        maxDiff = std::max(maxDiff, std::abs(ref-folded));
+        if(ref > (*refScoresTn)[b*classCount+refArgMax]) refArgMax = c;
+        if(folded > (*foldedScoresTn)[b*classCount+foldedArgMax]) foldedArgMax = c;
+      }
+      if(refArgMax==foldedArgMax) agreedCount++;
+    }
+
+    SPDLOG_LOGGER_INFO(logger,"BatchNorm Folding Check: Accuracy (default): {}", refAccu);
+    SPDLOG_LOGGER_INFO(logger,"BatchNorm Folding Check: Accuracy (folded): {}", foldedAccu);
+    SPDLOG_LOGGER_INFO(logger,"BatchNorm Folding Check: Same predictions: {} out of {}", agreedCount, batchSize);
+    SPDLOG_LOGGER_INFO(logger,"BatchNorm Folding Check: Max absolute difference of the class scores: {}", maxDiff);
+
+    // The folded graph uses the moving averages alone, while the default graph mixes them with the batch
+    // statistics. So the scores are not expected to be identical, only the accuracy should not regress.
+    if(foldedAccu + kBatchNormFoldingAccuracyTolerance < refAccu){
+      SPDLOG_LOGGER_ERROR(logger,"BatchNorm Folding Check: FAILED, the accuracy of the folded model has regressed.");
+      m_bSucceeded = false;
+    }else{
+      SPDLOG_LOGGER_INFO(logger,"BatchNorm Folding Check: PASSED");
+    }
+  }
+}
+void CClassifierMultiPlatform::CreateModel(bool enableBatchNormFolding) {
+  if(m_ptrClassifierModel!=nullptr){
+    delete(m_ptrClassifierModel);
+  }
+  const double timerStart = GetTimestamp();
   m_ptrClassifierModel = new CModel1(
-      PLATFORMS::XIL,
+      globalCpuOnly ? PLATFORMS::CPU : PLATFORMS::XIL,
       0,
       globalBatchsize,
       1024,
       20,
       m_bUseShapeNet,
-      enableOclProfiling,
-      enableMemBankCrossing,
-      enableCpuUtilization,
-      enableTensorDumps);
-  if(!m_bUseShapeNet){
+      m_bEnableOclProfiling,
+      m_bEnableMemBankCrossing,
+      m_bEnableCpuUtilization,
+      m_bEnableTensorDumps,
+      enableBatchNormFolding);
+  if(globalSyntheticData){
+    SPDLOG_LOGGER_INFO(logger,"The dataset is {} random point clouds.", kSyntheticDatasetSize);
+    m_ptrClassifierModel->SetDatasetRandom(std::max(kSyntheticDatasetSize, globalBatchsize), CPlatformSelection::kSyntheticSeed);
+  }else if(!m_bUseShapeNet){
     string pclPath = globalArgDataPath; pclPath.append("/modelnet40/dataset/dataset_B2048_pcl.npy");
     string labelPath = globalArgDataPath; labelPath.append("/modelnet40/dataset/dataset_B2048_labels_int32.npy");
     SPDLOG_LOGGER_INFO(logger,"PCL NPY PATH: {}", pclPath);
@@ -43,14 +113,115 @@ CClassifierMultiPlatform::CClassifierMultiPlatform(
     m_ptrClassifierModel->SetDatasetData(pclPath);
     m_ptrClassifierModel->SetDatasetLabels(labelPath);
   }
+  // The weight uploads might still be in flight, they are waited for by the first forward pass.
+  m_dModelCreationTime = GetTimestamp()-timerStart;
+  SPDLOG_LOGGER_INFO(logger,"Model creation time (the platforms, the weights and the dataset): {} Seconds", m_dModelCreationTime);
+}
+float CClassifierMultiPlatform::RunModel(bool enableBatchNormFolding, CTensorPtr<float> &classScoresTn) {
+  CreateModel(enableBatchNormFolding);
 
   double timerStart = GetTimestamp();
-  auto classScoresTn = m_ptrClassifierModel->Execute();
-  SPDLOG_LOGGER_INFO(logger,"Model execution time with batchsize({}): {} Seconds", globalBatchsize, (GetTimestamp() -timerStart));
+  auto scoresTn = m_ptrClassifierModel->Execute();
+  const double firstPassTime = GetTimestamp() -timerStart;
+  SPDLOG_LOGGER_INFO(logger,"Model execution time with batchsize({}): {} Seconds", globalBatchsize, firstPassTime);
+  SPDLOG_LOGGER_INFO(logger,"Time to first inference: {} Seconds", m_dModelCreationTime+firstPassTime);
+
+  // A bank plan that is loaded from its file is in effect from the first pass, only a new one needs a second pass.
+  auto *bankPlanner = m_ptrClassifierModel->GetPlatformSelection()->GetClassPtrBankPlanner();
+  const bool isBankPlanBuilt = bankPlanner!=nullptr && bankPlanner->IsEnabled() && !bankPlanner->IsPlanLoaded();
+  if(globalMemoryPlannerEnabled || isBankPlanBuilt){
+    // The first pass has been recorded, the second one replays the memory plan (with the in-place layers) and the
+    // bank plan.
+    SPDLOG_LOGGER_INFO(logger,"Running the model again with the plans...");
+    timerStart = GetTimestamp();
+    scoresTn = m_ptrClassifierModel->Execute();
+    SPDLOG_LOGGER_INFO(logger,"Model execution time with batchsize({}) and the plans: {} Seconds", globalBatchsize, (GetTimestamp() -timerStart));
+  }
 
-  CTensorPtr<float> pClassScoresTn = std::dynamic_pointer_cast<CTensor<float>>(classScoresTn);
+  classScoresTn = std::dynamic_pointer_cast<CTensor<float>>(scoresTn);
   CTensorPtr<unsigned> pLabelsTn = std::dynamic_pointer_cast<CTensor<unsigned>>(m_ptrClassifierModel->GetLabelTn());
-  CalculateAccuracy(pClassScoresTn, pLabelsTn, m_ptrClassifierModel->GetBatchSize(), m_bUseShapeNet?55:40);
+  return CalculateAccuracy(classScoresTn, pLabelsTn, m_ptrClassifierModel->GetBatchSize(), m_bUseShapeNet?55:40);
+}
+void CClassifierMultiPlatform::RunStreaming(bool enableBatchNormFolding) {
+  // The platform, the device buffers of the weights and the graph are created once and stay resident, only the input
+  // batch changes between the forward passes.
+  CreateModel(enableBatchNormFolding);
+
+  const unsigned batchSize = m_ptrClassifierModel->GetBatchSize();
+  const unsigned classCount = m_ptrClassifierModel->GetClassCount();
+  const unsigned datasetSize = m_ptrClassifierModel->GetDatasetSize();
+  unsigned batchCount = datasetSize/batchSize;
+  if(globalStreamBatchLimit!=0) batchCount = std::min(batchCount, globalStreamBatchLimit);
+  ConditionCheck(batchCount!=0, "The dataset has less point clouds than the batch-size.");
+  if(globalStreamBatchLimit==0 && batchCount*batchSize!=datasetSize){
+    SPDLOG_LOGGER_WARN(logger,"Streaming: The last {} point clouds do not fill a batch and are skipped.", datasetSize-batchCount*batchSize);
+  }
+  SPDLOG_LOGGER_INFO(logger,"Streaming: {} batches of {} point clouds{}.", batchCount, batchSize, globalPipelineEnabled?", pipelined":"");
+
+  // The first batch pays for the one-time costs (building the graph, the first allocations of the pools, ...), so it
+  // is reported separately and the sustained numbers are over the rest of the batches.
+  // With the pipelining, the next batch is enqueued before the current one is collected, so two batches are in flight
+  // and the latency of a batch spans from its enqueue to its collection.
+  std::vector<double> latencies;
+  std::deque<double> enqueueTimes;
+  latencies.reserve(batchCount);
+  auto enqueueBatch = [&](unsigned batch){
+    enqueueTimes.push_back(GetTimestamp());
+    m_ptrClassifierModel->EnqueueBatch(batch*batchSize);
+  };
+  float correctCount = 0;
+  double firstLatency = 0;
+  const double streamStart = GetTimestamp();
+  double sustainedStart = streamStart;
+
+  for(unsigned batch=0; batch<batchCount; batch++){
+    if(!globalPipelineEnabled){
+      enqueueBatch(batch);
+    }else{
+      if(batch==0) enqueueBatch(0);
+      if(batch+1<batchCount) enqueueBatch(batch+1);
+    }
+    CTensorBasePtr labelsTn;
+    auto scoresTn = std::dynamic_pointer_cast<CTensor<float>>(m_ptrClassifierModel->CollectBatch(labelsTn));
+    const double latency = GetTimestamp()-enqueueTimes.front();
+    enqueueTimes.pop_front();
+
+    CTensorPtr<unsigned> pLabelsTn = std::dynamic_pointer_cast<CTensor<unsigned>>(labelsTn);
+    correctCount += CalculateAccuracy(scoresTn, pLabelsTn, batchSize, classCount, false)*(float)batchSize;
+
+    if(batch==0){
+      firstLatency = latency;
+      sustainedStart = GetTimestamp();
+    }else{
+      latencies.push_back(latency);
+    }
+    SPDLOG_LOGGER_TRACE(logger,"Streaming: Batch {} of {}: {} Seconds", batch+1, batchCount, latency);
+  }
+  const double streamEnd = GetTimestamp();
+
+  SPDLOG_LOGGER_INFO(logger,"Streaming: Point clouds: {}", batchCount*batchSize);
+  SPDLOG_LOGGER_INFO(logger,"Streaming: Accuracy: {}", correctCount/(float)(batchCount*batchSize));
+  SPDLOG_LOGGER_INFO(logger,"Streaming: Total time: {} Seconds", streamEnd-streamStart);
+  SPDLOG_LOGGER_INFO(logger,"Streaming: First batch latency: {} Seconds", firstLatency);
+  SPDLOG_LOGGER_INFO(logger,"Streaming: Time to first inference: {} Seconds", m_dModelCreationTime+firstLatency);
+  if(latencies.empty()){
+    SPDLOG_LOGGER_WARN(logger,"Streaming: At least two batches are needed for the sustained throughput and the latency percentiles.");
+    return;
+  }
+
+  std::sort(latencies.begin(), latencies.end());
+  auto percentile = [&latencies](double p){
+    // The nearest-rank percentile.
+    const size_t rank = (size_t)std::ceil(p*latencies.size());
+    return latencies[std::max<size_t>(rank, 1)-1];
+  };
+  const double sustainedTime = streamEnd-sustainedStart;
+  SPDLOG_LOGGER_INFO(logger,"Streaming: Sustained throughput: {} point clouds/sec", (latencies.size()*batchSize)/sustainedTime);
+  SPDLOG_LOGGER_INFO(logger,"Streaming: Batch latency p50: {} Seconds, p99: {} Seconds, max: {} Seconds",
+                     percentile(0.50), percentile(0.99), latencies.back());
+}
+bool CClassifierMultiPlatform::IsSucceeded() const {
+  return m_bSucceeded;
 }
 double CClassifierMultiPlatform::GetTimestamp() {
   struct timeval tp;
@@ -58,16 +229,17 @@ double CClassifierMultiPlatform::GetTimestamp() {
   int i = gettimeofday(&tp, &tzp);
   return ((double)tp.tv_sec + (double)tp.tv_usec * 1.e-6);
 }
-void CClassifierMultiPlatform::CalculateAccuracy(CTensorPtr<float> scoresTn,
+float CClassifierMultiPlatform::CalculateAccuracy(CTensorPtr<float> scoresTn,
                                                  CTensorPtr<unsigned> labelsTn,
                                                  unsigned batchSize,
-                                                 unsigned classCount) {
+                                                 unsigned classCount,
+                                                 bool logResults) {
 
   //find argmax(net) and compute bool array of corrects.
   bool *correct = new bool[batchSize];
   float accu =0;
 
-  SPDLOG_LOGGER_INFO(logger,"Computing Accuracy...");
+  if(logResults) SPDLOG_LOGGER_INFO(logger,"Computing Accuracy...");
   {
     float max_cte = -numeric_limits<float>::infinity();
     float max = 0;
@@ -109,9 +281,13 @@ void CClassifierMultiPlatform::CalculateAccuracy(CTensorPtr<float> scoresTn,
     }
     accu = correct_cnt / (float)batchSize;
 
-    SPDLOG_LOGGER_INFO(logger,"Correct Count: {}", correct_cnt);
-    SPDLOG_LOGGER_INFO(logger,"Accuracy: {}", accu);
+    if(logResults){
+      SPDLOG_LOGGER_INFO(logger,"Correct Count: {}", correct_cnt);
+      SPDLOG_LOGGER_INFO(logger,"Accuracy: {}", accu);
+    }
   }
+  delete[](correct);
+  return accu;
 }
 CClassifierMultiPlatform::~CClassifierMultiPlatform() {
   delete(m_ptrClassifierModel);
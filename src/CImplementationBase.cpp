@@ -1,6 +1,7 @@
 #define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
 
 #include "CImplementationBase.h"
+#include <algorithm>
 unsigned CImplementationBase::GenerateLayerId() {
   return m_uAtomicCounter++;
 }
@@ -20,3 +21,51 @@ void CImplementationBase::ValidateTensorPlatforms(const std::vector<CTensorBaseP
     }
   }
 }
+/**
+ * @brief      Checks that the neighbour indices of EdgeConv are in [0,N), so the gathers could not read out of bounds.
+ */
+void CImplementationBase::ValidateKnnIndices(const unsigned *ptrBuffKnnTn, size_t len, unsigned N) {
+  const unsigned maxIndex = len==0 ? 0 : *std::max_element(ptrBuffKnnTn, ptrBuffKnnTn+len);
+  ConditionCheck(len==0 || maxIndex<N, "The knn tensor has indices out of the range of shape[1] of the input tensor.");
+}
+/**
+ * @brief      KNN composed of the basic layers of the implementation: the BxNxN pairwise distance matrix followed by TopK.
+ * This is the layer sequence that CModel1 used to launch before the KNN layer.
+ *
+ * @param[in]  inputTn  The input tensor of BxNxD
+ * @param[in]  k        The k
+ *
+ * @return     The indices tensor of BxNxk
+ */
+CTensorBasePtr CImplementationBase::KnnByPairwiseDistance(CTensorBasePtr inputTn, unsigned k) {
+  const unsigned N = inputTn->GetShape()[1];
+  auto point_cloud_transpose = Transpose(inputTn);
+  auto point_cloud_inner = MatMul(inputTn, point_cloud_transpose);
+  auto point_cloud_inner2 = BasicOps(point_cloud_inner, -2.0f, BASIC_OPS::MUL_ELEMENTWISE);
+  auto point_cloud_inner2p2 = Square(inputTn);
+  auto point_cloud_sum = Reduce(point_cloud_inner2p2, REDUCTION_OPS::SUM, 1, {0,0,1});
+  auto point_cloud_sum_tiled = Tile(point_cloud_sum, 2, N); //The result is BxNxK for k=N
+  auto point_cloud_sum_transpose_tiled = Tile(point_cloud_sum, 1, N); //The result is BxkxN for k=N
+  auto rsltTmpTn = BasicOps(point_cloud_sum_tiled, point_cloud_sum_transpose_tiled, BASIC_OPS::ADD); //both input tensors are BxNxN
+  auto adjTn = BasicOps(rsltTmpTn, point_cloud_inner2, BASIC_OPS::ADD); //both input tensors are BxNxN
+  return TopK(adjTn, 2, k);
+}
+/**
+ * @brief      EdgeConv composed of the basic layers of the implementation: the BxNxKx2D edge features followed by
+ * the 1x1 Conv2D. This is the layer sequence that CModel1 used to launch before the EdgeConv layer.
+ *
+ * @param[in]  inputTn   The input tensor of BxNxD
+ * @param[in]  knnTn     The neighbour indices tensor of BxNxK
+ * @param[in]  weightTn  The weight tensor of 1x1x2Dxch_out
+ * @param[in]  biasTn    The bias tensor of ch_out
+ *
+ * @return     The output tensor of BxNxKxch_out
+ */
+CTensorBasePtr CImplementationBase::EdgeConvByEdgeFeatures(CTensorBasePtr inputTn, CTensorBasePtr knnTn, CTensorBasePtr weightTn, CTensorBasePtr biasTn) {
+  const unsigned K = knnTn->GetShape()[2];
+  auto point_cloud_neighbors = Gather(inputTn, knnTn, 1);
+  auto point_cloud_central = Tile(inputTn, 2, K);
+  auto features = BasicOps(point_cloud_neighbors, point_cloud_central, BASIC_OPS::SUB);
+  auto edge_feature = Concat2(point_cloud_central, features, 3);
+  return Conv2D(edge_feature, weightTn, biasTn);
+}
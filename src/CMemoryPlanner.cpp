@@ -0,0 +1,312 @@
+#define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+
+#include "CMemoryPlanner.h"
+#include "cpu/CTensor.h"
+#include "fpga/xilinx/CTensorXil.h"
+#include <algorithm>
+
+CMemoryPlanner::CMemoryPlanner(bool enabled) {
+  m_bEnabled = enabled;
+  m_bPassStarted = false;
+  m_bInLayer = false;
+  m_iStep = -1;
+  m_uPassCount = 0;
+  m_bHasPlan = false;
+  m_bPlanIsValid = false;
+  m_uInPlaceLayerCount = 0;
+  for(int p=0; p<2; p++){
+    m_uLiveBytes[p] = 0;
+    m_uMeasuredPeakBytes[p] = 0;
+    m_uRecordedPeakBytes[p] = 0;
+    m_uLifetimePeakBytes[p] = 0;
+  }
+}
+
+void CMemoryPlanner::SetEnabled(bool enabled) {
+  m_bEnabled = enabled;
+  m_bPassStarted = false;
+  m_bHasPlan = false;
+  m_bPlanIsValid = false;
+  m_uPassCount = 0;
+  m_uInPlaceLayerCount = 0;
+  for(int p=0; p<2; p++){
+    m_uRecordedPeakBytes[p] = 0;
+    m_uLifetimePeakBytes[p] = 0;
+  }
+}
+
+bool CMemoryPlanner::IsEnabled() const {
+  return m_bEnabled;
+}
+
+int CMemoryPlanner::PlatformIndex(PLATFORMS platform) {
+  return platform==PLATFORMS::CPU ? 0 : 1;
+}
+
+CMemoryPlanner::BufferRange CMemoryPlanner::GetBufferRange(CTensorBasePtr tn) {
+  BufferRange buffer = {tn.get(), 0, tn->GetSizeBytes()};
+  if(auto cpuFloat = std::dynamic_pointer_cast<CTensor<float>>(tn)){
+    buffer.root = nullptr;
+    buffer.begin = reinterpret_cast<uintptr_t>(cpuFloat->Get());
+  }else if(auto cpuUnsigned = std::dynamic_pointer_cast<CTensor<unsigned>>(tn)){
+    buffer.root = nullptr;
+    buffer.begin = reinterpret_cast<uintptr_t>(cpuUnsigned->Get());
+  }else if(auto xilFloat = std::dynamic_pointer_cast<CTensorXil<float>>(tn)){
+    buffer.root = xilFloat->GetRootTensor();
+    buffer.begin = xilFloat->GetRootOffsetBytes();
+  }else if(auto xilUnsigned = std::dynamic_pointer_cast<CTensorXil<unsigned>>(tn)){
+    buffer.root = xilUnsigned->GetRootTensor();
+    buffer.begin = xilUnsigned->GetRootOffsetBytes();
+  }
+  buffer.end = buffer.begin + tn->GetSizeBytes();
+  return buffer;
+}
+
+bool CMemoryPlanner::IsOverlapping(const BufferRange &buffer1, const BufferRange &buffer2) {
+  return buffer1.root==buffer2.root && buffer1.begin<buffer2.end && buffer2.begin<buffer1.end;
+}
+
+void CMemoryPlanner::BeginPass() {
+  if(!m_bEnabled) return;
+  m_vTensors.clear();
+  m_vLayers.clear();
+  m_vLiveTensors.clear();
+  for(int p=0; p<2; p++){
+    m_uLiveBytes[p] = 0;
+    m_uMeasuredPeakBytes[p] = 0;
+  }
+  m_iStep = -1;
+  m_bInLayer = false;
+  m_bPassStarted = true;
+}
+
+void CMemoryPlanner::EndPass(CTensorBasePtr outputTn) {
+  if(!m_bEnabled || !m_bPassStarted) return;
+  if(outputTn!=nullptr){
+    RecordUse(GetBufferRange(outputTn), m_iStep+1);
+  }
+  SweepReleased(m_iStep+1);
+  m_bPassStarted = false;
+  m_uPassCount++;
+  if(!m_bHasPlan){
+    for(int p=0; p<2; p++) m_uRecordedPeakBytes[p] = m_uMeasuredPeakBytes[p];
+    BuildPlan();
+  }
+  Report();
+}
+
+bool CMemoryPlanner::BeginLayer(const std::string &layerName,
+                                PLATFORMS destPlatform,
+                                const std::vector<CTensorBasePtr> &inputTns,
+                                bool isElementwise) {
+  if(!m_bEnabled || !m_bPassStarted) return false;
+  m_iStep++;
+  SweepReleased(m_iStep);
+  m_bInLayer = true;
+  for(auto &tn:inputTns){
+    RecordUse(tn);
+  }
+
+  // Only the buffer of the first input of an elementwise layer on the CPU could be overwritten, and only if the other
+  // inputs of the layer do not read any part of it.
+  int candidate = -1;
+  if(isElementwise && !inputTns.empty() &&
+     destPlatform==PLATFORMS::CPU && inputTns[0]->GetPlatform()==PLATFORMS::CPU){
+    const BufferRange buffer = GetBufferRange(inputTns[0]);
+    bool isUnique = true;
+    for(size_t i=1; i<inputTns.size(); i++){
+      if(IsOverlapping(GetBufferRange(inputTns[i]), buffer)) isUnique = false;
+    }
+    if(isUnique) candidate = FindLiveRecord(buffer);
+  }
+  m_vLayers.push_back({layerName, isElementwise, candidate, -1});
+
+  bool inPlace = false;
+  if(m_bHasPlan && m_bPlanIsValid){
+    if(m_iStep>=(int)m_vPlannedLayerNames.size() || m_vPlannedLayerNames[m_iStep]!=layerName){
+      SPDLOG_LOGGER_WARN(logger,
+                         "CMemoryPlanner: The pass has diverged from the recorded graph at layer {} ({}), the plan is dropped.",
+                         m_iStep,
+                         layerName);
+      m_bPlanIsValid = false;
+    }else{
+      inPlace = m_vInPlaceLayers[m_iStep] && candidate>=0;
+    }
+  }
+  return inPlace;
+}
+
+CTensorBasePtr CMemoryPlanner::EndLayer(CTensorBasePtr outputTn) {
+  if(!m_bEnabled || !m_bPassStarted || !m_bInLayer) return outputTn;
+  m_bInLayer = false;
+  SweepReleased(m_iStep);
+  m_vLayers.back().outputRecord = RecordOutput(outputTn);
+  return outputTn;
+}
+
+std::vector<CTensorBasePtr> CMemoryPlanner::EndLayer(const std::vector<CTensorBasePtr> &outputTns) {
+  if(!m_bEnabled || !m_bPassStarted || !m_bInLayer) return outputTns;
+  m_bInLayer = false;
+  SweepReleased(m_iStep);
+  for(size_t i=0; i<outputTns.size(); i++){
+    const int indx = RecordOutput(outputTns[i]);
+    if(i==0) m_vLayers.back().outputRecord = indx;
+  }
+  return outputTns;
+}
+
+int CMemoryPlanner::RecordOutput(CTensorBasePtr outputTn) {
+  const BufferRange buffer = GetBufferRange(outputTn);
+  int indx = FindLiveRecord(buffer);
+  if(indx<0){
+    // A new buffer. The in-place layers return their input, whose buffer is already being tracked.
+    const int p = PlatformIndex(outputTn->GetPlatform());
+    indx = (int)m_vTensors.size();
+    m_vTensors.push_back({outputTn, buffer, outputTn->GetPlatform(), outputTn->GetSizeBytes(), m_iStep, m_iStep, -1});
+    m_vLiveTensors.push_back(indx);
+    m_uLiveBytes[p] += m_vTensors[indx].bytes;
+    m_uMeasuredPeakBytes[p] = std::max(m_uMeasuredPeakBytes[p], m_uLiveBytes[p]);
+  }else{
+    m_vTensors[indx].lastUseStep = std::max(m_vTensors[indx].lastUseStep, m_iStep);
+  }
+  return indx;
+}
+
+void CMemoryPlanner::RecordUse(CTensorBasePtr tn) {
+  if(!m_bEnabled || !m_bPassStarted || tn==nullptr) return;
+  // A read between two layers must survive until the next layer has started.
+  RecordUse(GetBufferRange(tn), m_bInLayer ? m_iStep : m_iStep+1);
+}
+
+void CMemoryPlanner::RecordUse(const BufferRange &buffer, int step) {
+  // A read of a view (or of a part of a buffer) is a read of every recorded buffer that it overlaps.
+  for(int indx:m_vLiveTensors){
+    auto &tensor = m_vTensors[indx];
+    if(tensor.tensor.expired() || !IsOverlapping(tensor.buffer, buffer)) continue;
+    tensor.lastUseStep = std::max(tensor.lastUseStep, step);
+  }
+}
+
+int CMemoryPlanner::FindLiveRecord(const BufferRange &buffer) const {
+  for(int indx:m_vLiveTensors){
+    const auto &tensor = m_vTensors[indx];
+    // The buffer of a released tensor could already be handed out again to a new (untracked) tensor.
+    if(tensor.tensor.expired()) continue;
+    if(tensor.buffer.root==buffer.root && tensor.buffer.begin==buffer.begin && tensor.buffer.end==buffer.end){
+      return indx;
+    }
+  }
+  return -1;
+}
+
+void CMemoryPlanner::SweepReleased(int releaseStep) {
+  for(auto it=m_vLiveTensors.begin(); it!=m_vLiveTensors.end();){
+    auto &tensor = m_vTensors[*it];
+    if(tensor.tensor.expired()){
+      tensor.releaseStep = releaseStep;
+      m_uLiveBytes[PlatformIndex(tensor.platform)] -= tensor.bytes;
+      it = m_vLiveTensors.erase(it);
+    }else{
+      it++;
+    }
+  }
+}
+
+void CMemoryPlanner::BuildPlan() {
+  // 1. The buffer groups: the output of an in-place layer joins the group of its input. The input buffer must not be
+  // read (through any tensor that overlaps it) after the layer.
+  std::vector<BufferGroup> groups;
+  std::vector<int> tensorGroups(m_vTensors.size(), -1);
+  m_vInPlaceLayers.assign(m_vLayers.size(), false);
+  m_uInPlaceLayerCount = 0;
+  for(size_t t=0; t<m_vTensors.size(); t++){
+    const auto &tensor = m_vTensors[t];
+    const auto &layer = m_vLayers[tensor.defStep];
+    const int candidate = layer.inPlaceCandidate;
+    if(layer.isElementwise &&
+       candidate>=0 &&
+       candidate!=(int)t &&
+       tensor.platform==PLATFORMS::CPU &&
+       m_vTensors[candidate].lastUseStep==tensor.defStep &&
+       m_vTensors[candidate].bytes==tensor.bytes){
+      auto &group = groups[tensorGroups[candidate]];
+      group.lastUseStep = std::max(group.lastUseStep, tensor.lastUseStep);
+      tensorGroups[t] = tensorGroups[candidate];
+      m_vInPlaceLayers[tensor.defStep] = true;
+      m_uInPlaceLayerCount++;
+    }else{
+      tensorGroups[t] = (int)groups.size();
+      groups.push_back({tensor.platform, tensor.bytes, tensor.defStep, tensor.lastUseStep});
+    }
+  }
+
+  // 2. The peak of the lifetimes of the groups, the lower bound of any reuse of the buffers. It is only reported, the
+  // buffers are still allocated (and cached by the memory pools) one by one.
+  for(int p=0; p<2; p++){
+    m_uLifetimePeakBytes[p] = 0;
+  }
+  const size_t stepCount = m_vLayers.size()+2;
+  for(int p=0; p<2; p++){
+    std::vector<long long> delta(stepCount+1, 0);
+    for(auto &group:groups){
+      if(PlatformIndex(group.platform)!=p) continue;
+      delta[group.defStep] += (long long)group.bytes;
+      delta[group.lastUseStep+1] -= (long long)group.bytes;
+    }
+    long long live = 0;
+    for(size_t s=0; s<stepCount; s++){
+      live += delta[s];
+      m_uLifetimePeakBytes[p] = std::max(m_uLifetimePeakBytes[p], (size_t)live);
+    }
+  }
+
+  m_vPlannedLayerNames.clear();
+  for(auto &layer:m_vLayers){
+    m_vPlannedLayerNames.push_back(layer.name);
+  }
+  m_bHasPlan = true;
+  m_bPlanIsValid = true;
+}
+
+void CMemoryPlanner::Report() const {
+  const char *platformNames[] = {"CPU", "XIL"};
+  SPDLOG_LOGGER_INFO(logger, "CMemoryPlanner: Pass: {}, Layers: {}, Buffers: {}, In-place Layers: {}{}",
+                     m_uPassCount, m_vLayers.size(), m_vTensors.size(), m_uInPlaceLayerCount,
+                     m_bPlanIsValid ? "" : " (the plan is dropped)");
+  for(int p=0; p<2; p++){
+    if(m_uRecordedPeakBytes[p]==0) continue;
+    if(m_uPassCount==1){
+      SPDLOG_LOGGER_INFO(logger,
+                         "CMemoryPlanner: {}: Peak (before, measured): {} MB, Lower bound of the peak (lifetimes, not applied): {} MB",
+                         platformNames[p],
+                         m_uRecordedPeakBytes[p]/1048576.0,
+                         m_uLifetimePeakBytes[p]/1048576.0);
+    }else{
+      SPDLOG_LOGGER_INFO(logger,
+                         "CMemoryPlanner: {}: Peak (before, measured): {} MB, Peak (in-place, measured): {} MB",
+                         platformNames[p],
+                         m_uRecordedPeakBytes[p]/1048576.0,
+                         m_uMeasuredPeakBytes[p]/1048576.0);
+    }
+  }
+}
+
+bool CMemoryPlanner::HasPlan() const {
+  return m_bHasPlan;
+}
+
+unsigned CMemoryPlanner::GetInPlaceLayerCount() const {
+  return m_uInPlaceLayerCount;
+}
+
+size_t CMemoryPlanner::GetMeasuredPeakBytes() const {
+  return m_uMeasuredPeakBytes[0]+m_uMeasuredPeakBytes[1];
+}
+
+size_t CMemoryPlanner::GetRecordedPeakBytes() const {
+  return m_uRecordedPeakBytes[0]+m_uRecordedPeakBytes[1];
+}
+
+size_t CMemoryPlanner::GetLifetimePeakBytes() const {
+  return m_uLifetimePeakBytes[0]+m_uLifetimePeakBytes[1];
+}
@@ -1,6 +1,9 @@
 #define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
 
 #include "CPlatformSelection.h"
+#include <fstream>
+
+constexpr unsigned CPlatformSelection::kSyntheticSeed;
 
 CPlatformSelection::CPlatformSelection(
     PLATFORMS targetPlatform,
@@ -10,6 +13,7 @@ CPlatformSelection::CPlatformSelection(
     bool enableMemBankCrossing,
     bool enableCpuUsageSampling,
     bool enableTensorDumps,
+    bool enableBatchNormFolding,
     std::string profilerOutputPath) {
   m_bUseShapeNet = useShapeNetInstead;
   m_bLoadWeights = enableLoadingWeights;
@@ -21,28 +25,34 @@ CPlatformSelection::CPlatformSelection(
   m_ptrProfiler = new CProfiler(m_strProfilerOutputPath, m_bEnableCpuUsageSampling);
 
   m_ptrImplCpu = new CImplementationCpu(m_ptrProfiler, m_bEnableTensorDumps);
-  m_ptrImplXil = new CImplementationXilinx(m_ptrProfiler, m_bEnableOclProfiling, m_bLogMemBankCrossings);
-  m_ptrWeightsLoader = new CWeightLoader(m_ptrImplXil->GetXilInfo(), targetPlatform);
+  if(!globalCpuOnly){
+    m_ptrImplXil = new CImplementationXilinx(m_ptrProfiler, m_bEnableOclProfiling, m_bLogMemBankCrossings);
+    m_ptrWeightsLoader = new CWeightLoader(m_ptrImplXil->GetXilInfo(), targetPlatform, enableBatchNormFolding);
+  }else{
+    // No device is needed, the XIL layers and the crossings to the XIL platform are rejected.
+    ConditionCheck(targetPlatform==PLATFORMS::CPU, "Only the CPU platform could be targeted in the CPU-only mode.");
+    m_ptrImplXil = nullptr;
+    m_ptrWeightsLoader = new CWeightLoader(nullptr, PLATFORMS::CPU, enableBatchNormFolding);
+  }
+  m_ptrMemoryPlanner = new CMemoryPlanner(globalMemoryPlannerEnabled);
 
 
   if(!m_bLoadWeights) SPDLOG_LOGGER_WARN(logger,"The weights are not going to be loaded into the device memory.");
-  if(m_bLoadWeights){
-    if(!m_bUseShapeNet){
-      //ModelNet40
-      std::string wDir = globalArgDataPath; wDir.append("/modelnet40/weights/");
-      std::string wFileList = globalArgDataPath; wFileList.append("/modelnet40/weights/filelist.txt");
-      SPDLOG_LOGGER_TRACE(logger,"Weights Dir: {}", wDir);
-      SPDLOG_LOGGER_TRACE(logger,"Weights File List Path: {}", wFileList);
-      m_ptrWeightsLoader->LoadWeightsFromDisk(wDir, wFileList);
+  //ModelNet40 or ShapeNet V2
+  std::string wDir = globalArgDataPath; wDir.append(m_bUseShapeNet ? "/shapenet2/weights/" : "/modelnet40/weights/");
+  std::string wFileList = wDir + "filelist.txt";
+  if(m_bLoadWeights && globalSyntheticData){
+    // The names and the shapes are the ones of the weights directory, if it is available.
+    m_ptrWeightsLoader->LoadRandomWeights(m_bUseShapeNet?55:40, kSyntheticSeed, wDir, wFileList);
+  }else if(m_bLoadWeights){
+    std::string wBundle = wDir + CWeightBundle::kFileName;
+    SPDLOG_LOGGER_TRACE(logger,"Weights Dir: {}", wDir);
+    SPDLOG_LOGGER_TRACE(logger,"Weights File List Path: {}", wFileList);
+    if(globalWeightBundleEnabled && std::ifstream(wBundle).good() && m_ptrWeightsLoader->LoadWeightsFromBundle(wBundle, wDir, wFileList)){
+      SPDLOG_LOGGER_TRACE(logger,"Weights Bundle Path: {}", wBundle);
     }else{
-      //ShapeNet V2
-      std::string wDir = globalArgDataPath; wDir.append("/shapenet2/weights/");
-      std::string wFileList = globalArgDataPath; wFileList.append("/shapenet2/weights/filelist.txt");
-      SPDLOG_LOGGER_TRACE(logger,"Weights Dir: {}", wDir);
-      SPDLOG_LOGGER_TRACE(logger,"Weights File List Path: {}", wFileList);
       m_ptrWeightsLoader->LoadWeightsFromDisk(wDir, wFileList);
     }
-
   }
 }
 
@@ -51,6 +61,7 @@ CPlatformSelection::~CPlatformSelection() {
   delete(m_ptrImplCpu);
   delete(m_ptrImplXil);
   delete(m_ptrWeightsLoader);
+  delete(m_ptrMemoryPlanner);
   delete(m_ptrProfiler);
 }
 
@@ -60,6 +71,10 @@ CTensorBasePtr CPlatformSelection::CrossThePlatformIfNeeded(PLATFORMS destPlatfo
   using XilFloat = CTensorXil<float>;
   using XilUnsigned = CTensorXil<unsigned>;
 
+  // The dumps, the comparisons and the crossings of the layers' inputs are all reads of the source tensor.
+  m_ptrMemoryPlanner->RecordUse(srcTn);
+  ConditionCheck(destPlatform!=PLATFORMS::XIL || m_ptrImplXil!=nullptr, "The XIL platform is not available in the CPU-only mode.");
+
   if(srcTn->GetPlatform()==PLATFORMS::CPU){
     if(destPlatform==PLATFORMS::XIL){
       CTensorPtr<float> cpuFloat;
@@ -95,16 +110,70 @@ CTensorBasePtr CPlatformSelection::CrossThePlatformIfNeeded(PLATFORMS destPlatfo
 
 }
 
+/**
+ * @brief      Returns a new tensor of the same shape that shares the buffer of srcTn (zero-copy).
+ * The shape ops of the graph change the shape of the returned tensor, so the other consumers of srcTn (and the
+ * weights) keep their own shapes. The returned tensor keeps srcTn alive.
+ *
+ * @param[in]  srcTn  The source tensor (CPU or XIL)
+ */
+CTensorBasePtr CPlatformSelection::ShareBuffer(CTensorBasePtr srcTn) {
+  CTensorBasePtr aliasTn;
+  if(srcTn->GetPlatform()==PLATFORMS::CPU){
+    CTensorPtr<float> cpuFloat;
+    CTensorPtr<unsigned> cpuUnsigned;
+    if(cpuFloat = std::dynamic_pointer_cast<CTensor<float>>(srcTn)){
+      aliasTn = CTensorBasePtr(new CTensor<float>(cpuFloat->GetShape(), cpuFloat->Get(), cpuFloat));
+    } else if(cpuUnsigned = std::dynamic_pointer_cast<CTensor<unsigned>>(srcTn)){
+      aliasTn = CTensorBasePtr(new CTensor<unsigned>(cpuUnsigned->GetShape(), cpuUnsigned->Get(), cpuUnsigned));
+    }else{
+      ThrowException("Undefined tensor type, please manually defined your used type.");
+    }
+  }else{
+    CTensorXilPtr<float> xilFloat;
+    CTensorXilPtr<unsigned> xilUnsigned;
+    if(xilFloat = std::dynamic_pointer_cast<CTensorXil<float>>(srcTn)){
+      aliasTn = CTensorBasePtr(new CTensorXil<float>(xilFloat, 0, xilFloat->GetShape()));
+    } else if(xilUnsigned = std::dynamic_pointer_cast<CTensorXil<unsigned>>(srcTn)){
+      aliasTn = CTensorBasePtr(new CTensorXil<unsigned>(xilUnsigned, 0, xilUnsigned->GetShape()));
+    }else{
+      ThrowException("Undefined tensor type, please manually defined your used type.");
+    }
+  }
+  return aliasTn;
+}
+
+/**
+ * @brief      Starts a non-blocking upload of a host tensor to the device and returns the device tensor right away.
+ * The layers that consume the returned tensor depend on the event of its write, so the upload overlaps with the
+ * commands that are already in flight (for example, the tail of the previous batch).
+ *
+ * @param[in]  srcTn  The source tensor (CPU)
+ */
+CTensorBasePtr CPlatformSelection::UploadAsync(CTensorBasePtr srcTn) {
+  ConditionCheck(srcTn->GetPlatform()==PLATFORMS::CPU, "Only the host tensors could be uploaded.");
+  CTensorPtr<float> cpuFloat;
+  CTensorPtr<unsigned> cpuUnsigned;
+  if(cpuFloat = std::dynamic_pointer_cast<CTensor<float>>(srcTn)){
+    return UploadAsync<float>(cpuFloat);
+  } else if(cpuUnsigned = std::dynamic_pointer_cast<CTensor<unsigned>>(srcTn)){
+    return UploadAsync<unsigned>(cpuUnsigned);
+  }else{
+    ThrowException("Undefined platform crossing type, please manually defined your used type.");
+  }
+}
+
 CTensorBasePtr CPlatformSelection::Concat2(PLATFORMS destPlatform, CTensorBasePtr inputTn1, CTensorBasePtr inputTn2, unsigned concatAxis) {
   if(!inputTn1->IsTypeFloat32() || !inputTn2->IsTypeFloat32()){
     ThrowException("The layer only accepts types: float32.");
   }
+  m_ptrMemoryPlanner->BeginLayer(__func__, destPlatform, {inputTn1, inputTn2});
   auto qInputTn1 = CrossThePlatformIfNeeded(destPlatform, inputTn1);
   auto qInputTn2 = CrossThePlatformIfNeeded(destPlatform, inputTn2);
   if(destPlatform==PLATFORMS::CPU){
-    return m_ptrImplCpu->Concat2(qInputTn1,qInputTn2,concatAxis);
+    return m_ptrMemoryPlanner->EndLayer(m_ptrImplCpu->Concat2(qInputTn1,qInputTn2,concatAxis));
   }else if(destPlatform==PLATFORMS::XIL){
-    return m_ptrImplXil->Concat2(qInputTn1,qInputTn2,concatAxis);
+    return m_ptrMemoryPlanner->EndLayer(m_ptrImplXil->Concat2(qInputTn1,qInputTn2,concatAxis));
   }else{
     ThrowException("Undefined Platform.");
   }
@@ -114,12 +183,13 @@ CTensorBasePtr CPlatformSelection::MatMul(PLATFORMS destPlatform, CTensorBasePtr
   if(!inputTn1->IsTypeFloat32() || !inputTn2->IsTypeFloat32()){
     ThrowException("The layer only accepts types: float32.");
   }
+  m_ptrMemoryPlanner->BeginLayer(__func__, destPlatform, {inputTn1, inputTn2});
   auto qInputTn1 = CrossThePlatformIfNeeded(destPlatform, inputTn1);
   auto qInputTn2 = CrossThePlatformIfNeeded(destPlatform, inputTn2);
   if(destPlatform==PLATFORMS::CPU){
-    return m_ptrImplCpu->MatMul(qInputTn1,qInputTn2);
+    return m_ptrMemoryPlanner->EndLayer(m_ptrImplCpu->MatMul(qInputTn1,qInputTn2));
   }else if(destPlatform==PLATFORMS::XIL){
-    return m_ptrImplXil->MatMul(qInputTn1,qInputTn2);
+    return m_ptrMemoryPlanner->EndLayer(m_ptrImplXil->MatMul(qInputTn1,qInputTn2));
   }else{
     ThrowException("Undefined Platform.");
   }
@@ -129,11 +199,12 @@ CTensorBasePtr CPlatformSelection::ReLU(PLATFORMS destPlatform, CTensorBasePtr i
   if(!inputTn->IsTypeFloat32()){
     ThrowException("The layer only accepts types: float32.");
   }
+  const bool inPlace = m_ptrMemoryPlanner->BeginLayer(__func__, destPlatform, {inputTn}, true);
   auto qInputTn = CrossThePlatformIfNeeded(destPlatform, inputTn);
   if(destPlatform==PLATFORMS::CPU){
-    return m_ptrImplCpu->ReLU(qInputTn);
+    return m_ptrMemoryPlanner->EndLayer(m_ptrImplCpu->ReLU(qInputTn, inPlace));
   }else if(destPlatform==PLATFORMS::XIL){
-    return m_ptrImplXil->ReLU(qInputTn);
+    return m_ptrMemoryPlanner->EndLayer(m_ptrImplXil->ReLU(qInputTn));
   }else{
     ThrowException("Undefined Platform.");
   }
@@ -143,11 +214,12 @@ CTensorBasePtr CPlatformSelection::Sqrt(PLATFORMS destPlatform, CTensorBasePtr i
   if(!inputTn->IsTypeFloat32()){
     ThrowException("The layer only accepts types: float32.");
   }
+  const bool inPlace = m_ptrMemoryPlanner->BeginLayer(__func__, destPlatform, {inputTn}, true);
   auto qInputTn = CrossThePlatformIfNeeded(destPlatform, inputTn);
   if(destPlatform==PLATFORMS::CPU){
-    return m_ptrImplCpu->Sqrt(qInputTn);
+    return m_ptrMemoryPlanner->EndLayer(m_ptrImplCpu->Sqrt(qInputTn, inPlace));
   }else if(destPlatform==PLATFORMS::XIL){
-    return m_ptrImplXil->Sqrt(qInputTn);
+    return m_ptrMemoryPlanner->EndLayer(m_ptrImplXil->Sqrt(qInputTn));
   }else{
     ThrowException("Undefined Platform.");
   }
@@ -157,11 +229,12 @@ CTensorBasePtr CPlatformSelection::Square(PLATFORMS destPlatform, CTensorBasePtr
   if(!inputTn->IsTypeFloat32()){
     ThrowException("The layer only accepts types: float32.");
   }
+  const bool inPlace = m_ptrMemoryPlanner->BeginLayer(__func__, destPlatform, {inputTn}, true);
   auto qInputTn = CrossThePlatformIfNeeded(destPlatform, inputTn);
   if(destPlatform==PLATFORMS::CPU){
-    return m_ptrImplCpu->Square(qInputTn);
+    return m_ptrMemoryPlanner->EndLayer(m_ptrImplCpu->Square(qInputTn, inPlace));
   }else if(destPlatform==PLATFORMS::XIL){
-    return m_ptrImplXil->Square(qInputTn);
+    return m_ptrMemoryPlanner->EndLayer(m_ptrImplXil->Square(qInputTn));
   }else{
     ThrowException("Undefined Platform.");
   }
@@ -174,12 +247,13 @@ CTensorBasePtr CPlatformSelection::BasicOps(PLATFORMS destPlatform,
   if(!inputTn1->IsTypeFloat32() || !inputTn2->IsTypeFloat32()){
     ThrowException("The layer only accepts types: float32.");
   }
+  const bool inPlace = m_ptrMemoryPlanner->BeginLayer(__func__, destPlatform, {inputTn1, inputTn2}, true);
   auto qInputTn1 = CrossThePlatformIfNeeded(destPlatform, inputTn1);
   auto qInputTn2 = CrossThePlatformIfNeeded(destPlatform, inputTn2);
   if(destPlatform==PLATFORMS::CPU){
-    return m_ptrImplCpu->BasicOps(qInputTn1,qInputTn2,mode);
+    return m_ptrMemoryPlanner->EndLayer(m_ptrImplCpu->BasicOps(qInputTn1,qInputTn2,mode,inPlace));
   }else if(destPlatform==PLATFORMS::XIL){
-    return m_ptrImplXil->BasicOps(qInputTn1,qInputTn2,mode);
+    return m_ptrMemoryPlanner->EndLayer(m_ptrImplXil->BasicOps(qInputTn1,qInputTn2,mode));
   }else{
     ThrowException("Undefined Platform.");
   }
@@ -192,11 +266,12 @@ CTensorBasePtr CPlatformSelection::BasicOps(PLATFORMS destPlatform,
   if(!inputTn1->IsTypeFloat32()){
     ThrowException("The layer only accepts types: float32.");
   }
+  const bool inPlace = m_ptrMemoryPlanner->BeginLayer(__func__, destPlatform, {inputTn1}, true);
   auto qInputTn1 = CrossThePlatformIfNeeded(destPlatform, inputTn1);
   if(destPlatform==PLATFORMS::CPU){
-    return m_ptrImplCpu->BasicOps(qInputTn1,scalar,mode);
+    return m_ptrMemoryPlanner->EndLayer(m_ptrImplCpu->BasicOps(qInputTn1,scalar,mode,inPlace));
   }else if(destPlatform==PLATFORMS::XIL){
-    return m_ptrImplXil->BasicOps(qInputTn1,scalar,mode);
+    return m_ptrMemoryPlanner->EndLayer(m_ptrImplXil->BasicOps(qInputTn1,scalar,mode));
   }else{
     ThrowException("Undefined Platform.");
   }
@@ -209,11 +284,12 @@ CTensorBasePtr CPlatformSelection::Tile(PLATFORMS destPlatform,
   if(!inputTn->IsTypeFloat32()){
     ThrowException("The layer only accepts types: float32.");
   }
+  m_ptrMemoryPlanner->BeginLayer(__func__, destPlatform, {inputTn});
   auto qInputTn = CrossThePlatformIfNeeded(destPlatform, inputTn);
   if(destPlatform==PLATFORMS::CPU){
-    return m_ptrImplCpu->Tile(qInputTn,tileAxis,tileCount);
+    return m_ptrMemoryPlanner->EndLayer(m_ptrImplCpu->Tile(qInputTn,tileAxis,tileCount));
   }else if(destPlatform==PLATFORMS::XIL){
-    return m_ptrImplXil->Tile(qInputTn,tileAxis,tileCount);
+    return m_ptrMemoryPlanner->EndLayer(m_ptrImplXil->Tile(qInputTn,tileAxis,tileCount));
   }else{
     ThrowException("Undefined Platform.");
   }
@@ -223,11 +299,12 @@ CTensorBasePtr CPlatformSelection::Transpose(PLATFORMS destPlatform, CTensorBase
   if(!inputTn->IsTypeFloat32()){
     ThrowException("The layer only accepts types: float32.");
   }
+  m_ptrMemoryPlanner->BeginLayer(__func__, destPlatform, {inputTn});
   auto qInputTn = CrossThePlatformIfNeeded(destPlatform, inputTn);
   if(destPlatform==PLATFORMS::CPU){
-    return m_ptrImplCpu->Transpose(qInputTn);
+    return m_ptrMemoryPlanner->EndLayer(m_ptrImplCpu->Transpose(qInputTn));
   }else if(destPlatform==PLATFORMS::XIL){
-    return m_ptrImplXil->Transpose(qInputTn);
+    return m_ptrMemoryPlanner->EndLayer(m_ptrImplXil->Transpose(qInputTn));
   }else{
     ThrowException("Undefined Platform.");
   }
@@ -240,12 +317,13 @@ CTensorBasePtr CPlatformSelection::Gather(PLATFORMS destPlatform,
   if(!inputTn->IsTypeFloat32() || !indicesTn->IsTypeUint32()){
     ThrowException("The layer only accepts types: float32.");
   }
+  m_ptrMemoryPlanner->BeginLayer(__func__, destPlatform, {inputTn, indicesTn});
   auto qInputTn = CrossThePlatformIfNeeded(destPlatform, inputTn);
   auto qIndicesTn = CrossThePlatformIfNeeded(destPlatform, indicesTn);
   if(destPlatform==PLATFORMS::CPU){
-    return m_ptrImplCpu->Gather(qInputTn, qIndicesTn, indicesOfAxis);
+    return m_ptrMemoryPlanner->EndLayer(m_ptrImplCpu->Gather(qInputTn, qIndicesTn, indicesOfAxis));
   }else if(destPlatform==PLATFORMS::XIL){
-    return m_ptrImplXil->Gather(qInputTn, qIndicesTn, indicesOfAxis);
+    return m_ptrMemoryPlanner->EndLayer(m_ptrImplXil->Gather(qInputTn, qIndicesTn, indicesOfAxis));
   }else{
     ThrowException("Undefined Platform.");
   }
@@ -259,11 +337,12 @@ CTensorBasePtr CPlatformSelection::Reduce(PLATFORMS destPlatform,
   if(!inputTn->IsTypeFloat32()){
     ThrowException("The layer only accepts types: float32.");
   }
+  m_ptrMemoryPlanner->BeginLayer(__func__, destPlatform, {inputTn});
   auto qInputTn = CrossThePlatformIfNeeded(destPlatform, inputTn);
   if(destPlatform==PLATFORMS::CPU){
-    return m_ptrImplCpu->Reduce(qInputTn, mode, powY, combination);
+    return m_ptrMemoryPlanner->EndLayer(m_ptrImplCpu->Reduce(qInputTn, mode, powY, combination));
   }else if(destPlatform==PLATFORMS::XIL){
-    return m_ptrImplXil->Reduce(qInputTn, mode, powY, combination);
+    return m_ptrMemoryPlanner->EndLayer(m_ptrImplXil->Reduce(qInputTn, mode, powY, combination));
   }else{
     ThrowException("Undefined Platform.");
   }
@@ -275,11 +354,12 @@ CTensorBasePtr CPlatformSelection::Mean(PLATFORMS destPlatform,
   if(!inputTn->IsTypeFloat32()){
     ThrowException("The layer only accepts types: float32.");
   }
+  m_ptrMemoryPlanner->BeginLayer(__func__, destPlatform, {inputTn});
   auto qInputTn = CrossThePlatformIfNeeded(destPlatform, inputTn);
   if(destPlatform==PLATFORMS::CPU){
-    return m_ptrImplCpu->Mean(qInputTn, combination);
+    return m_ptrMemoryPlanner->EndLayer(m_ptrImplCpu->Mean(qInputTn, combination));
   }else if(destPlatform==PLATFORMS::XIL){
-    return m_ptrImplXil->Mean(qInputTn, combination);
+    return m_ptrMemoryPlanner->EndLayer(m_ptrImplXil->Mean(qInputTn, combination));
   }else{
     ThrowException("Undefined Platform.");
   }
@@ -291,25 +371,46 @@ CTensorBasePtr CPlatformSelection::Variance(PLATFORMS destPlatform,
   if(!inputTn->IsTypeFloat32()){
     ThrowException("The layer only accepts types: float32.");
   }
+  m_ptrMemoryPlanner->BeginLayer(__func__, destPlatform, {inputTn});
+  auto qInputTn = CrossThePlatformIfNeeded(destPlatform, inputTn);
+  if(destPlatform==PLATFORMS::CPU){
+    return m_ptrMemoryPlanner->EndLayer(m_ptrImplCpu->Variance(qInputTn, combination));
+  }else if(destPlatform==PLATFORMS::XIL){
+    return m_ptrMemoryPlanner->EndLayer(m_ptrImplXil->Variance(qInputTn, combination));
+  }else{
+    ThrowException("Undefined Platform.");
+  }
+}
+
+std::vector<CTensorBasePtr> CPlatformSelection::MeanVariance(PLATFORMS destPlatform,
+                                                             CTensorBasePtr inputTn,
+                                                             const std::vector<unsigned> &combination){
+  if(!inputTn->IsTypeFloat32()){
+    ThrowException("The layer only accepts types: float32.");
+  }
+  m_ptrMemoryPlanner->BeginLayer(__func__, destPlatform, {inputTn});
   auto qInputTn = CrossThePlatformIfNeeded(destPlatform, inputTn);
+  std::vector<CTensorBasePtr> outputTns;
   if(destPlatform==PLATFORMS::CPU){
-    return m_ptrImplCpu->Variance(qInputTn, combination);
+    outputTns = m_ptrImplCpu->MeanVariance(qInputTn, combination);
   }else if(destPlatform==PLATFORMS::XIL){
-    return m_ptrImplXil->Variance(qInputTn, combination);
+    outputTns = m_ptrImplXil->MeanVariance(qInputTn, combination);
   }else{
     ThrowException("Undefined Platform.");
   }
+  return m_ptrMemoryPlanner->EndLayer(outputTns);
 }
 
 CTensorBasePtr CPlatformSelection::PadLastDim(PLATFORMS destPlatform, CTensorBasePtr inputTn, unsigned lastDimPadded) {
   if(!inputTn->IsTypeFloat32()){
     ThrowException("The layer only accepts types: float32.");
   }
+  m_ptrMemoryPlanner->BeginLayer(__func__, destPlatform, {inputTn});
   auto qInputTn = CrossThePlatformIfNeeded(destPlatform, inputTn);
   if(destPlatform==PLATFORMS::CPU){
-    return m_ptrImplCpu->PadLastDim(qInputTn, lastDimPadded);
+    return m_ptrMemoryPlanner->EndLayer(m_ptrImplCpu->PadLastDim(qInputTn, lastDimPadded));
   }else if(destPlatform==PLATFORMS::XIL){
-    return m_ptrImplXil->PadLastDim(qInputTn, lastDimPadded);
+    return m_ptrMemoryPlanner->EndLayer(m_ptrImplXil->PadLastDim(qInputTn, lastDimPadded));
   }else{
     ThrowException("Undefined Platform.");
   }
@@ -321,11 +422,12 @@ CTensorBasePtr CPlatformSelection::UnpadLastDim(PLATFORMS destPlatform,
   if(!inputTn->IsTypeFloat32()){
     ThrowException("The layer only accepts types: float32.");
   }
+  m_ptrMemoryPlanner->BeginLayer(__func__, destPlatform, {inputTn});
   auto qInputTn = CrossThePlatformIfNeeded(destPlatform, inputTn);
   if(destPlatform==PLATFORMS::CPU){
-    return m_ptrImplCpu->UnpadLastDim(qInputTn, lastDimUnpadded);
+    return m_ptrMemoryPlanner->EndLayer(m_ptrImplCpu->UnpadLastDim(qInputTn, lastDimUnpadded));
   }else if(destPlatform==PLATFORMS::XIL){
-    return m_ptrImplXil->UnpadLastDim(qInputTn, lastDimUnpadded);
+    return m_ptrMemoryPlanner->EndLayer(m_ptrImplXil->UnpadLastDim(qInputTn, lastDimUnpadded));
   }else{
     ThrowException("Undefined Platform.");
   }
@@ -335,11 +437,12 @@ CTensorBasePtr CPlatformSelection::TopK(PLATFORMS destPlatform, CTensorBasePtr i
   if(!inputTn->IsTypeFloat32()){
     ThrowException("The layer only accepts types: float32.");
   }
+  m_ptrMemoryPlanner->BeginLayer(__func__, destPlatform, {inputTn});
   auto qInputTn = CrossThePlatformIfNeeded(destPlatform, inputTn);
   if(destPlatform==PLATFORMS::CPU){
-    return m_ptrImplCpu->TopK(qInputTn, axis, k);
+    return m_ptrMemoryPlanner->EndLayer(m_ptrImplCpu->TopK(qInputTn, axis, k));
   }else if(destPlatform==PLATFORMS::XIL){
-    return m_ptrImplXil->TopK(qInputTn, axis, k);
+    return m_ptrMemoryPlanner->EndLayer(m_ptrImplXil->TopK(qInputTn, axis, k));
   }else{
     ThrowException("Undefined Platform.");
   }
@@ -352,19 +455,61 @@ CTensorBasePtr CPlatformSelection::Conv2D(PLATFORMS destPlatform,
   if(!inputTn->IsTypeFloat32() || !weightTn->IsTypeFloat32() || !biasTn->IsTypeFloat32()){
     ThrowException("The layer only accepts types: float32.");
   }
+  m_ptrMemoryPlanner->BeginLayer(__func__, destPlatform, {inputTn, weightTn, biasTn});
   auto qInputTn = CrossThePlatformIfNeeded(destPlatform, inputTn);
   auto qWeightTn = CrossThePlatformIfNeeded(destPlatform, weightTn);
   auto qBiasTn = CrossThePlatformIfNeeded(destPlatform, biasTn);
   if(destPlatform==PLATFORMS::CPU){
-    return m_ptrImplCpu->Conv2D(qInputTn,qWeightTn,qBiasTn);
+    return m_ptrMemoryPlanner->EndLayer(m_ptrImplCpu->Conv2D(qInputTn,qWeightTn,qBiasTn));
   }else if(destPlatform==PLATFORMS::XIL){
-    return m_ptrImplXil->Conv2D(qInputTn,qWeightTn,qBiasTn);
+    return m_ptrMemoryPlanner->EndLayer(m_ptrImplXil->Conv2D(qInputTn,qWeightTn,qBiasTn));
+  }else{
+    ThrowException("Undefined Platform.");
+  }
+}
+
+CTensorBasePtr CPlatformSelection::KNN(PLATFORMS destPlatform, CTensorBasePtr inputTn, unsigned k) {
+  if(!inputTn->IsTypeFloat32()){
+    ThrowException("The layer only accepts types: float32.");
+  }
+  m_ptrMemoryPlanner->BeginLayer(__func__, destPlatform, {inputTn});
+  auto qInputTn = CrossThePlatformIfNeeded(destPlatform, inputTn);
+  if(destPlatform==PLATFORMS::CPU){
+    return m_ptrMemoryPlanner->EndLayer(m_ptrImplCpu->KNN(qInputTn, k));
+  }else if(destPlatform==PLATFORMS::XIL){
+    return m_ptrMemoryPlanner->EndLayer(m_ptrImplXil->KNN(qInputTn, k));
+  }else{
+    ThrowException("Undefined Platform.");
+  }
+}
+
+CTensorBasePtr CPlatformSelection::EdgeConv(PLATFORMS destPlatform,
+                                            CTensorBasePtr inputTn,
+                                            CTensorBasePtr knnTn,
+                                            CTensorBasePtr weightTn,
+                                            CTensorBasePtr biasTn) {
+  if(!inputTn->IsTypeFloat32() || !knnTn->IsTypeUint32() || !weightTn->IsTypeFloat32() || !biasTn->IsTypeFloat32()){
+    ThrowException("The layer only accepts types: float32 (input, weight, bias) and uint32 (knn).");
+  }
+  m_ptrMemoryPlanner->BeginLayer(__func__, destPlatform, {inputTn, knnTn, weightTn, biasTn});
+  auto qInputTn = CrossThePlatformIfNeeded(destPlatform, inputTn);
+  auto qKnnTn = CrossThePlatformIfNeeded(destPlatform, knnTn);
+  auto qWeightTn = CrossThePlatformIfNeeded(destPlatform, weightTn);
+  auto qBiasTn = CrossThePlatformIfNeeded(destPlatform, biasTn);
+  if(destPlatform==PLATFORMS::CPU){
+    return m_ptrMemoryPlanner->EndLayer(m_ptrImplCpu->EdgeConv(qInputTn, qKnnTn, qWeightTn, qBiasTn));
+  }else if(destPlatform==PLATFORMS::XIL){
+    return m_ptrMemoryPlanner->EndLayer(m_ptrImplXil->EdgeConv(qInputTn, qKnnTn, qWeightTn, qBiasTn));
   }else{
     ThrowException("Undefined Platform.");
   }
 }
 
 
+CImplementationCpu *CPlatformSelection::GetClassPtrImplementationCpu() {
+  return m_ptrImplCpu;
+}
+
 CImplementationXilinx *CPlatformSelection::GetClassPtrImplementationXilinx() {
   return m_ptrImplXil;
 }
@@ -405,3 +550,32 @@ bool CPlatformSelection::CompareTensors(PLATFORMS destPlatform, CTensorBasePtr i
 CWeightLoader *CPlatformSelection::GetClassPtrWeightLoader() {
   return m_ptrWeightsLoader;
 }
+
+CMemoryPlanner *CPlatformSelection::GetClassPtrMemoryPlanner() {
+  return m_ptrMemoryPlanner;
+}
+
+/**
+ * @brief      Returns the bank planner of the Xilinx implementation or nullptr in the CPU-only mode.
+ */
+CBankPlanner *CPlatformSelection::GetClassPtrBankPlanner() {
+  return m_ptrImplXil!=nullptr ? m_ptrImplXil->GetXilInfo()->GetBankPlanner() : nullptr;
+}
+
+void CPlatformSelection::ReportMemoryPoolStats() {
+  CHostMemoryPool::GetInstance().ReportStats();
+  if(m_ptrImplXil!=nullptr){
+    m_ptrImplXil->GetXilInfo()->GetBufferPool()->ReportStats();
+    m_ptrImplXil->GetXilInfo()->GetLifetimeManager()->ReportStats();
+    m_ptrImplXil->GetXilInfo()->ReportBankCrossingStats();
+  }
+}
+
+void CPlatformSelection::ResetMemoryPoolStats() {
+  CHostMemoryPool::GetInstance().ResetStats();
+  if(m_ptrImplXil!=nullptr){
+    m_ptrImplXil->GetXilInfo()->GetBufferPool()->ResetStats();
+    m_ptrImplXil->GetXilInfo()->GetLifetimeManager()->ResetStats();
+    m_ptrImplXil->GetXilInfo()->ResetBankCrossingStats();
+  }
+}
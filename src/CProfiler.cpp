@@ -1,56 +1,121 @@
 #define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
 
 #include "CProfiler.h"
+#include <algorithm>
 #include <chrono>
+#include <cstring>
+#include "rapidjson/document.h"
+#include "rapidjson/writer.h"
+#include "rapidjson/stringbuffer.h"
+
+constexpr char CProfiler::kMagic[8];
+constexpr uint32_t CProfiler::kVersion;
+constexpr unsigned CProfiler::kMaxNameLen;
+constexpr unsigned CProfiler::kMaxKeyLen;
+constexpr unsigned CProfiler::kMaxShapeArgs;
+constexpr unsigned CProfiler::kMaxIntArgs;
+constexpr unsigned CProfiler::kMaxFloatArgs;
+constexpr unsigned CProfiler::kMaxRank;
+constexpr unsigned CProfiler::kRingCapacity;
+
+namespace {
+
+// The period of the flusher, the records of a crashed run are lost for this long at most.
+constexpr auto kFlushPeriod = std::chrono::milliseconds(200);
+
+void CopyKey(char *dst, const char *src, size_t dstLen){
+  std::strncpy(dst, src, dstLen-1);
+  dst[dstLen-1] = 0;
+}
 
-CProfiler::CProfiler(const std::string &fnameJson, bool enableCpuUsageSampling) {
-  m_strFileName = fnameJson;
-  m_bEnableCpuUsageSampling = enableCpuUsageSampling;
-  m_ptrWriter = new rapidjson::Writer<rapidjson::StringBuffer>(m_oStrBuffer);
-  m_ptrFileStream = new std::ofstream(m_strFileName);
-  m_ptrWriter->StartObject();
+uint64_t GetNanoSeconds(){
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
 
-  m_ptrWriter->Key("info");
-  m_ptrWriter->StartObject();
+// A small index per host thread, in the order of their first layers.
+uint32_t GetHostThreadIndex(){
+  static std::atomic<uint32_t> threadCounter(0);
+  thread_local uint32_t threadIndex = threadCounter++;
+  return threadIndex;
+}
+
+void CopyDeviceTimestamps(CProfiler::TraceRecord &record, const CProfiler::DeviceTimestamps &timestamps){
+  record.deviceQueued = timestamps.queued;
+  record.deviceSubmit = timestamps.submit;
+  record.deviceStart = timestamps.start;
+  record.deviceEnd = timestamps.end;
+  record.duration = timestamps.end - timestamps.start;
+}
+
+}
+
+CProfiler::CProfiler(const std::string &fnameTrace, bool enableCpuUsageSampling) {
+  static_assert((kRingCapacity & (kRingCapacity-1))==0, "The capacity of the ring should be a power of two.");
+  m_strFileName = fnameTrace;
+  m_bEnableCpuUsageSampling = enableCpuUsageSampling;
+  m_ptrRing.reset(new TraceRecord[kRingCapacity]);
+  m_uHead = 0;
+  m_uTail = 0;
+  m_uLayerCount = 0;
+  m_uDroppedRecordCount = 0;
+  m_uOpenLayerCount = 0;
+  m_uOverheadNanoSeconds = 0;
+  m_bStopFlusher = false;
+  m_bFlushRequested = false;
+  m_fCpuUsage = -1.0f; // Until the first sample.
+
+  rapidjson::StringBuffer strBuffer;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(strBuffer);
+  writer.StartObject();
   {
     /// TODO: add args for the used global vars in the constructor.
-    m_ptrWriter->Key("commit.host");
-    m_ptrWriter->String(REPO_HASH_MAIN);
+    writer.Key("commit.host");
+    writer.String(REPO_HASH_MAIN);
 
-    m_ptrWriter->Key("commit.config");
-    m_ptrWriter->String(REPO_HASH_CONFIG);
+    writer.Key("commit.config");
+    writer.String(REPO_HASH_CONFIG);
 
-    m_ptrWriter->Key("globalArgXclBin");
-    m_ptrWriter->String(globalArgXclBin.c_str());
+    writer.Key("globalArgXclBin");
+    writer.String(globalArgXclBin.c_str());
 
-    m_ptrWriter->Key("globalArgDataPath");
-    m_ptrWriter->String(globalArgDataPath.c_str());
+    writer.Key("globalArgDataPath");
+    writer.String(globalArgDataPath.c_str());
 
-    m_ptrWriter->Key("globalBatchsize");
-    m_ptrWriter->Uint(globalBatchsize);
+    writer.Key("globalBatchsize");
+    writer.Uint(globalBatchsize);
 
-    m_ptrWriter->Key("globalCpuUsageSamplingEnabled");
-    m_ptrWriter->Bool(m_bEnableCpuUsageSampling);
+    writer.Key("globalCpuUsageSamplingEnabled");
+    writer.Bool(m_bEnableCpuUsageSampling);
 
-    m_ptrWriter->Key("globalDumpTensors");
-    m_ptrWriter->Bool(globalDumpTensors);
+    writer.Key("globalDumpTensors");
+    writer.Bool(globalDumpTensors);
 
-    m_ptrWriter->Key("globalDumpMemBankCrossings");
-    m_ptrWriter->Bool(globalDumpMemBankCrossings);
+    writer.Key("globalDumpMemBankCrossings");
+    writer.Bool(globalDumpMemBankCrossings);
 
-    m_ptrWriter->Key("globalProfileOclEnabled");
-    m_ptrWriter->Bool(globalProfileOclEnabled);
+    writer.Key("globalProfileOclEnabled");
+    writer.Bool(globalProfileOclEnabled);
 
-    m_ptrWriter->Key("globalShapenet");
-    m_ptrWriter->Bool(globalShapenet);
+    writer.Key("globalShapenet");
+    writer.Bool(globalShapenet);
 
-    m_ptrWriter->Key("globalModelnet");
-    m_ptrWriter->Bool(globalModelnet);
+    writer.Key("globalModelnet");
+    writer.Bool(globalModelnet);
   }
-  m_ptrWriter->EndObject();
-
-  m_ptrWriter->Key("trace");
-  m_ptrWriter->StartArray();
+  writer.EndObject();
+
+  TraceFileHeader header;
+  std::memset(&header, 0, sizeof(TraceFileHeader));
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.recordBytes = sizeof(TraceRecord);
+  header.infoBytes = strBuffer.GetSize();
+  m_oTraceFile.open(m_strFileName, std::ios::binary|std::ios::trunc);
+  ConditionCheck(m_oTraceFile.is_open(), "Failed to open the profiler trace file: "+m_strFileName);
+  m_oTraceFile.write(reinterpret_cast<const char*>(&header), sizeof(TraceFileHeader));
+  m_oTraceFile.write(strBuffer.GetString(), strBuffer.GetSize());
+  m_oTraceFile.flush();
+  m_oFlusherThread = std::thread(&CProfiler::FlusherThread, this);
 
   if(m_bEnableCpuUsageSampling) {
     SPDLOG_LOGGER_TRACE(logger, "Spinning CProfiler's thread to poll the CPU usage.");
@@ -72,127 +137,229 @@ CProfiler::CProfiler(const std::string &fnameJson, bool enableCpuUsageSampling)
 }
 
 CProfiler::~CProfiler() {
-  SPDLOG_LOGGER_TRACE(logger, "Writing profiling data to {}", m_strFileName);
-  m_ptrWriter->EndArray(); // main trace array end.
-  m_ptrWriter->EndObject(); // main json end.
-  *m_ptrFileStream<<m_oStrBuffer.GetString();
-  m_ptrFileStream->close();
+  SPDLOG_LOGGER_TRACE(logger, "Stopping CProfiler's flusher thread.");
+  {
+    std::lock_guard<std::mutex> lock(m_oFlushMutex);
+    m_bStopFlusher = true;
+  }
+  m_oFlushCv.notify_one();
+  m_oFlusherThread.join();
+  Flush();
+  m_oTraceFile.close();
+  SPDLOG_LOGGER_INFO(logger, "The profiler trace is written to {} ({} records, {} layers, {} ns of overhead per layer, {} records dropped on the full ring).",
+                     m_strFileName, m_uHead.load(), m_uLayerCount, GetOverheadPerLayerNanoSeconds(), m_uDroppedRecordCount.load());
 
   SPDLOG_LOGGER_TRACE(logger, "Stopping CProfiler's CPU usage polling thread.");
   m_bStopThread = true;
-  m_oThread.join();
+  if(m_oThread.joinable()) m_oThread.join();
   SPDLOG_LOGGER_TRACE(logger, "Done.");
+}
+
+/**
+ * @brief      Returns the next free record of the ring (zeroed), or nullptr if the ring is full. The record is dropped
+ * then, the producer does not wait for the flusher. Only the LAYER_STOPs of the recorded LAYER_STARTs (isReserved) could
+ * use the slots kept for them.
+ * The caller should hold m_oProducerMutex and call CommitRecord() after filling the record.
+ */
+CProfiler::TraceRecord* CProfiler::AcquireRecord(bool isReserved) {
+  const uint64_t head = m_uHead.load(std::memory_order_relaxed);
+  const uint64_t freeCount = kRingCapacity - (head - m_uTail.load(std::memory_order_acquire));
+  if(freeCount < (isReserved ? 1 : m_uOpenLayerCount+1)){
+    m_uDroppedRecordCount.fetch_add(1, std::memory_order_relaxed);
+    RequestFlush();
+    return nullptr;
+  }
+  auto *record = &m_ptrRing[head & (kRingCapacity-1)];
+  std::memset(record, 0, sizeof(TraceRecord));
+  return record;
+}
+
+/**
+ * @brief      Returns the open layers of the calling host thread, the caller should hold m_oProducerMutex.
+ */
+std::vector<bool>& CProfiler::GetOpenLayers() {
+  const uint32_t thread = GetHostThreadIndex();
+  if(thread>=m_vOpenLayers.size()) m_vOpenLayers.resize(thread+1);
+  return m_vOpenLayers[thread];
+}
+
+void CProfiler::CommitRecord() {
+  const uint64_t head = m_uHead.load(std::memory_order_relaxed) + 1;
+  m_uHead.store(head, std::memory_order_release);
+  // Wake up the flusher early when half of the ring is used, instead of waiting for the period.
+  if((head & (kRingCapacity/2-1))==0) RequestFlush();
+}
 
-  delete m_ptrFileStream;
-  delete m_ptrWriter;
+void CProfiler::RequestFlush() {
+  // The flag is set under the lock, so the request is not lost while the flusher is busy writing.
+  {
+    std::lock_guard<std::mutex> lock(m_oFlushMutex);
+    m_bFlushRequested = true;
+  }
+  m_oFlushCv.notify_one();
+}
+
+void CProfiler::FlusherThread() {
+  std::unique_lock<std::mutex> lock(m_oFlushMutex);
+  while(!m_bStopFlusher){
+    m_oFlushCv.wait_for(lock, kFlushPeriod, [this]{ return m_bStopFlusher || m_bFlushRequested; });
+    m_bFlushRequested = false;
+    lock.unlock();
+    Flush();
+    lock.lock();
+  }
+}
+
+/**
+ * @brief      Writes the committed records to the trace file. Only called by the flusher thread, or by the destructor
+ * after the flusher thread is joined.
+ */
+void CProfiler::Flush() {
+  uint64_t tail = m_uTail.load(std::memory_order_relaxed);
+  const uint64_t head = m_uHead.load(std::memory_order_acquire);
+  if(tail==head) return;
+  while(tail<head){
+    const uint64_t index = tail & (kRingCapacity-1);
+    const uint64_t count = std::min<uint64_t>(head-tail, kRingCapacity-index);
+    m_oTraceFile.write(reinterpret_cast<const char*>(&m_ptrRing[index]), count*sizeof(TraceRecord));
+    tail += count;
+  }
+  m_oTraceFile.flush();
+  m_uTail.store(tail, std::memory_order_release);
 }
 
 void CProfiler::StartLayer(PLATFORMS platform,
                            const unsigned layerId,
-                           const std::string &name,
-                           CProfiler::DictShapePtr *dictShapes,
-                           CProfiler::DictIntPtr *dictScalarInt,
-                           CProfiler::DictFloatPtr *dictScalarFloat) {
-  m_ptrWriter->StartObject();
-  m_ptrWriter->Key("type");
-  m_ptrWriter->String("layer");
-  m_ptrWriter->Key("name");
-  m_ptrWriter->String(name.c_str());
-  m_ptrWriter->Key("platform");
-  m_ptrWriter->String(platform==PLATFORMS::CPU? "cpu": (platform==PLATFORMS::XIL? "xil": "undef"));
-  m_ptrWriter->Key("id");
-  m_ptrWriter->Uint(layerId);
-  m_ptrWriter->Key("args");
-  m_ptrWriter->StartObject();
-  {
-    if(dictShapes!= nullptr){
-      for(auto &item: *dictShapes){
-        m_ptrWriter->Key(item.first.c_str());
-        m_ptrWriter->StartArray();
-        for(auto &dim: item.second){
-          m_ptrWriter->Uint(dim);
-        }
-        m_ptrWriter->EndArray();
-      }
+                           const char *name,
+                           std::initializer_list<ShapeArg> shapes,
+                           std::initializer_list<IntArg> scalarInts,
+                           std::initializer_list<FloatArg> scalarFloats) {
+  const uint64_t timerStart = GetNanoSeconds();
+  std::lock_guard<std::mutex> lock(m_oProducerMutex);
+  auto &openLayers = GetOpenLayers();
+  auto *record = AcquireRecord();
+  openLayers.push_back(record!=nullptr);
+  if(record!=nullptr){
+    m_uOpenLayerCount++;
+    record->type = RECORD_TYPE::LAYER_START;
+    record->platform = platform==PLATFORMS::CPU ? 0 : 1;
+    record->id = layerId;
+    record->timestamp = timerStart/1000;
+    record->thread = GetHostThreadIndex();
+    record->cpuUsage = GetLastCpuUsage();
+    CopyKey(record->name, name, kMaxNameLen);
+    for(auto &arg: shapes){
+      if(record->shapeCount==kMaxShapeArgs) break;
+      auto &dst = record->shapes[record->shapeCount++];
+      CopyKey(dst.key, arg.key, kMaxKeyLen);
+      dst.rank = std::min<size_t>(arg.shape.size(), kMaxRank);
+      std::copy(arg.shape.begin(), arg.shape.begin()+dst.rank, dst.dims);
     }
-
-    if(dictScalarInt!= nullptr) {
-      for (auto &item: *dictScalarInt) {
-        m_ptrWriter->Key(item.first.c_str());
-        m_ptrWriter->Int(item.second);
-      }
+    for(auto &arg: scalarInts){
+      if(record->intCount==kMaxIntArgs) break;
+      auto &dst = record->ints[record->intCount++];
+      CopyKey(dst.key, arg.key, kMaxKeyLen);
+      dst.value = arg.value;
     }
-
-    if(dictScalarFloat!= nullptr) {
-      for (auto &item: *dictScalarFloat) {
-        m_ptrWriter->Key(item.first.c_str());
-        m_ptrWriter->Double((double) item.second);
-      }
+    for(auto &arg: scalarFloats){
+      if(record->floatCount==kMaxFloatArgs) break;
+      auto &dst = record->floats[record->floatCount++];
+      CopyKey(dst.key, arg.key, kMaxKeyLen);
+      dst.value = arg.value;
     }
+    CommitRecord();
   }
-  m_ptrWriter->EndObject();
-  m_ptrWriter->Key("time.start");
-  m_ptrWriter->Uint64(GetTimestampMicroseconds());
-  m_ptrWriter->Key("cpu.usage");
-  m_ptrWriter->Double(GetLastCpuUsage());
-  m_ptrWriter->Key("nested");
-  m_ptrWriter->StartArray();
+  m_uLayerCount++;
+  m_uOverheadNanoSeconds += GetNanoSeconds()-timerStart;
 }
 
 void CProfiler::FinishLayer() {
-  m_ptrWriter->EndArray();
-  m_ptrWriter->Key("time.stop");
-  m_ptrWriter->Uint64(GetTimestampMicroseconds());
-  m_ptrWriter->EndObject();
+  const uint64_t timerStart = GetNanoSeconds();
+  std::lock_guard<std::mutex> lock(m_oProducerMutex);
+  auto &openLayers = GetOpenLayers();
+  TraceRecord *record = nullptr;
+  if(openLayers.empty()){
+    // A LAYER_STOP without a LAYER_START, it has no slot kept for it.
+    record = AcquireRecord();
+  }else{
+    if(openLayers.back()){
+      m_uOpenLayerCount--;
+      record = AcquireRecord(true);
+    }else{
+      m_uDroppedRecordCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    openLayers.pop_back();
+  }
+  if(record!=nullptr){
+    record->type = RECORD_TYPE::LAYER_STOP;
+    record->timestamp = timerStart/1000;
+    record->thread = GetHostThreadIndex();
+    CommitRecord();
+  }
+  m_uOverheadNanoSeconds += GetNanoSeconds()-timerStart;
 }
 
 void CProfiler::StartKernel(PLATFORMS platform,
                             const unsigned parentLayerId,
                             const std::string &name,
-                            const unsigned long durationNanoSeconds) {
-  m_ptrWriter->StartObject();
-  m_ptrWriter->Key("type");
-  m_ptrWriter->String("kernel");
-  m_ptrWriter->Key("name");
-  m_ptrWriter->String(name.c_str());
-  m_ptrWriter->Key("platform");
-  m_ptrWriter->String(platform==PLATFORMS::CPU? "cpu": (platform==PLATFORMS::XIL? "xil": "undef"));
-  m_ptrWriter->Key("id");
-  m_ptrWriter->Uint(parentLayerId);
-  m_ptrWriter->Key("duration");
-  m_ptrWriter->Uint64(durationNanoSeconds);
+                            const DeviceTimestamps &timestamps) {
+  std::lock_guard<std::mutex> lock(m_oProducerMutex);
+  auto *record = AcquireRecord();
+  if(record==nullptr) return;
+  record->type = RECORD_TYPE::KERNEL;
+  record->platform = platform==PLATFORMS::CPU ? 0 : 1;
+  record->id = parentLayerId;
+  CopyDeviceTimestamps(*record, timestamps);
+  CopyKey(record->name, name.c_str(), kMaxNameLen);
+  CommitRecord();
 }
 
 void CProfiler::StartKernelDatamover(PLATFORMS platform,
                             const unsigned parentLayerId,
                             const unsigned vecCountPadded,
+                            const int srcBank,
+                            const int destBank,
                             const std::string &name,
-                            const unsigned long durationNanoSeconds) {
-  m_ptrWriter->StartObject();
-  m_ptrWriter->Key("type");
-  m_ptrWriter->String("kernel");
-  m_ptrWriter->Key("name");
-  m_ptrWriter->String(name.c_str());
-  m_ptrWriter->Key("platform");
-  m_ptrWriter->String(platform==PLATFORMS::CPU? "cpu": (platform==PLATFORMS::XIL? "xil": "undef"));
-  m_ptrWriter->Key("id");
-  m_ptrWriter->Uint(parentLayerId);
-  m_ptrWriter->Key("bytes");
-  m_ptrWriter->Uint(vecCountPadded*CONFIG_M_AXI_WIDTH*CONFIG_DTYPE_SIZE);
-  m_ptrWriter->Key("duration");
-  m_ptrWriter->Uint64(durationNanoSeconds);
+                            const DeviceTimestamps &timestamps) {
+  std::lock_guard<std::mutex> lock(m_oProducerMutex);
+  auto *record = AcquireRecord();
+  if(record==nullptr) return;
+  record->type = RECORD_TYPE::DATAMOVER;
+  record->platform = platform==PLATFORMS::CPU ? 0 : 1;
+  record->id = parentLayerId;
+  record->bytes = vecCountPadded*CONFIG_M_AXI_WIDTH*CONFIG_DTYPE_SIZE;
+  record->srcBank = srcBank;
+  record->destBank = destBank;
+  CopyDeviceTimestamps(*record, timestamps);
+  CopyKey(record->name, name.c_str(), kMaxNameLen);
+  CommitRecord();
+}
+
+void CProfiler::AddDeviceClockSync(const int64_t hostNanoSeconds, const uint64_t deviceNanoSeconds) {
+  std::lock_guard<std::mutex> lock(m_oProducerMutex);
+  auto *record = AcquireRecord();
+  if(record==nullptr) return;
+  record->type = RECORD_TYPE::CLOCK_SYNC;
+  record->platform = 1;
+  record->timestamp = hostNanoSeconds/1000;
+  record->deviceQueued = deviceNanoSeconds;
+  CommitRecord();
+}
+
+int64_t CProfiler::GetHostNanoSeconds() {
+  return GetNanoSeconds();
 }
 
 void CProfiler::FinishKernel() {
-  m_ptrWriter->EndObject();
+  // A kernel is a single record, written by StartKernel() or StartKernelDatamover().
+}
+
+double CProfiler::GetOverheadPerLayerNanoSeconds() const {
+  return m_uLayerCount==0 ? 0.0 : (double)m_uOverheadNanoSeconds/(double)m_uLayerCount;
 }
 
-long CProfiler::GetTimestampMicroseconds() {
-  auto now = std::chrono::steady_clock::now();
-  auto now_ms = std::chrono::time_point_cast<std::chrono::microseconds>(now);
-  auto epoch = now_ms.time_since_epoch();
-  auto value = std::chrono::duration_cast<std::chrono::microseconds>(epoch);
-  return value.count();
+uint64_t CProfiler::GetDroppedRecordCount() const {
+  return m_uDroppedRecordCount.load(std::memory_order_relaxed);
 }
 
 float CProfiler::_GetCpuUsage() {
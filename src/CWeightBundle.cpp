@@ -0,0 +1,266 @@
+#define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+
+#include "CWeightBundle.h"
+#include "fpga/xilinx/AxiHelper.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <numeric>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+constexpr char CWeightBundle::kMagic[8];
+constexpr uint32_t CWeightBundle::kVersion;
+constexpr uint64_t CWeightBundle::kAlignment;
+constexpr unsigned CWeightBundle::kMaxNameLen;
+constexpr unsigned CWeightBundle::kMaxTagLen;
+constexpr unsigned CWeightBundle::kMaxRank;
+constexpr uint32_t CWeightBundle::kFlagBatchNormsFolded;
+constexpr const char *CWeightBundle::kFileName;
+
+namespace {
+
+// The host copies only need the alignment of the vector loads.
+constexpr uint64_t kHostAlignment = 64;
+
+uint64_t AlignUp(uint64_t value, uint64_t alignment){
+  return (value+alignment-1)/alignment*alignment;
+}
+
+// 64-bit FNV-1a
+constexpr uint64_t kFnvOffsetBasis = 14695981039346656037ull;
+constexpr uint64_t kFnvPrime = 1099511628211ull;
+
+uint64_t HashBytes(uint64_t hash, const void *data, size_t bytes){
+  const auto *ptr = static_cast<const unsigned char*>(data);
+  for(size_t i=0; i<bytes; i++){
+    hash = (hash ^ ptr[i]) * kFnvPrime;
+  }
+  return hash;
+}
+
+}
+
+void CWeightBundle::Write(const std::string &path,
+                          const std::vector<Record> &records,
+                          unsigned axiWidth,
+                          bool batchNormsFolded,
+                          uint64_t sourceStamp) {
+  // 1. The index. The weights of a bank are packed in the order of the records.
+  std::vector<Entry> entries(records.size());
+  std::vector<BankSection> sections;
+  std::map<int, unsigned> bankToSection;
+  for(size_t i=0; i<records.size(); i++){
+    const auto &record = records[i];
+    ConditionCheck(record.name.size()<kMaxNameLen, "The name of the weight is too long for the bundle: "+record.name);
+    ConditionCheck(record.tag.size()<kMaxTagLen, "The tag of the weight is too long for the bundle: "+record.tag);
+    ConditionCheck(!record.shape.empty() && record.shape.size()<=kMaxRank, "The rank of the weight is not supported by the bundle: "+record.name);
+    auto &entry = entries[i];
+    std::memset(&entry, 0, sizeof(Entry));
+    std::strncpy(entry.name, record.name.c_str(), kMaxNameLen-1);
+    std::strncpy(entry.tag, record.tag.c_str(), kMaxTagLen-1);
+    entry.rank = record.shape.size();
+    std::copy(record.shape.begin(), record.shape.end(), entry.shape);
+    entry.bank = record.bank;
+    if(bankToSection.count(record.bank)==0){
+      bankToSection[record.bank] = sections.size();
+      BankSection section;
+      std::memset(&section, 0, sizeof(BankSection));
+      section.bank = record.bank;
+      sections.push_back(section);
+    }
+    entry.bankSectionIndex = bankToSection[record.bank];
+    auto &section = sections[entry.bankSectionIndex];
+    const uint64_t len = std::accumulate(record.shape.begin(), record.shape.end(), (uint64_t)1, std::multiplies<uint64_t>());
+    const uint64_t lastDim = record.shape.back();
+    const uint64_t lastDimPadded = MakeDivisible<unsigned>(record.shape.back(), axiWidth);
+    entry.hostOffset = len*sizeof(float); // The size for now, the offset is set below.
+    entry.deviceOffset = section.bytes;
+    entry.deviceBytes = len/lastDim*lastDimPadded*sizeof(float);
+    section.bytes = AlignUp(section.bytes+entry.deviceBytes, kAlignment);
+  }
+
+  // 2. The layout of the file.
+  Header header;
+  std::memset(&header, 0, sizeof(Header));
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.axiWidth = axiWidth;
+  header.flags = batchNormsFolded ? kFlagBatchNormsFolded : 0;
+  header.entryCount = entries.size();
+  header.bankSectionCount = sections.size();
+  header.sourceStamp = sourceStamp;
+  uint64_t offset = sizeof(Header) + entries.size()*sizeof(Entry) + sections.size()*sizeof(BankSection);
+  header.hostSectionOffset = offset = AlignUp(offset, kAlignment);
+  for(auto &entry:entries){
+    const uint64_t bytes = entry.hostOffset;
+    entry.hostOffset = offset;
+    offset = AlignUp(offset+bytes, kHostAlignment);
+  }
+  header.hostSectionBytes = offset - header.hostSectionOffset;
+  offset = AlignUp(offset, kAlignment);
+  for(auto &section:sections){
+    section.offset = offset;
+    offset += section.bytes;
+  }
+  const uint64_t fileBytes = offset;
+
+  // 3. The data, the padded copies are zero-filled beyond the last dim.
+  std::vector<char> buff(fileBytes, 0);
+  std::memcpy(buff.data(), &header, sizeof(Header));
+  std::memcpy(buff.data()+sizeof(Header), entries.data(), entries.size()*sizeof(Entry));
+  std::memcpy(buff.data()+sizeof(Header)+entries.size()*sizeof(Entry), sections.data(), sections.size()*sizeof(BankSection));
+  for(size_t i=0; i<records.size(); i++){
+    const auto &record = records[i];
+    const auto &entry = entries[i];
+    const uint64_t len = std::accumulate(record.shape.begin(), record.shape.end(), (uint64_t)1, std::multiplies<uint64_t>());
+    std::memcpy(buff.data()+entry.hostOffset, record.data, len*sizeof(float));
+
+    const uint64_t lastDim = record.shape.back();
+    const uint64_t lastDimPadded = MakeDivisible<unsigned>(record.shape.back(), axiWidth);
+    auto *dst = reinterpret_cast<float*>(buff.data() + sections[entry.bankSectionIndex].offset + entry.deviceOffset);
+    for(uint64_t slice=0; slice<len/lastDim; slice++){
+      std::copy(record.data+slice*lastDim, record.data+(slice+1)*lastDim, dst+slice*lastDimPadded);
+    }
+  }
+
+  std::ofstream outFile(path, std::ios::binary|std::ios::trunc);
+  ConditionCheck(outFile.is_open(), "Failed to open the weight bundle for writing: "+path);
+  outFile.write(buff.data(), buff.size());
+  ConditionCheck(outFile.good(), "Failed to write the weight bundle: "+path);
+  SPDLOG_LOGGER_INFO(logger, "The weight bundle is written to {} ({} weights, {} bank sections, {} bytes).", path,
+                     entries.size(), sections.size(), fileBytes);
+}
+
+uint64_t CWeightBundle::ComputeSourceStamp(const std::string &weightsBaseDir, const std::string &pathToTxtFnameList) {
+  std::ifstream txtFile(pathToTxtFnameList);
+  ConditionCheck(txtFile.is_open(), "Failed to open the file list of the weights: "+pathToTxtFnameList);
+  uint64_t hash = kFnvOffsetBasis;
+  std::string line;
+  while(std::getline(txtFile, line)){
+    struct stat fileStat;
+    int64_t stamp[3] = {0, 0, 0};
+    if(stat((weightsBaseDir+line).c_str(), &fileStat)==0){
+      stamp[0] = fileStat.st_size;
+      stamp[1] = fileStat.st_mtim.tv_sec;
+      stamp[2] = fileStat.st_mtim.tv_nsec;
+    }
+    hash = HashBytes(hash, line.data(), line.size()+1); // With the terminating zero, as the separator.
+    hash = HashBytes(hash, stamp, sizeof(stamp));
+  }
+  return hash;
+}
+
+bool CWeightBundle::IsUpToDate(const std::string &path, uint64_t sourceStamp) {
+  Header header;
+  std::ifstream inFile(path, std::ios::binary);
+  inFile.read(reinterpret_cast<char*>(&header), sizeof(Header));
+  if(!inFile.good() || std::memcmp(header.magic, kMagic, sizeof(kMagic))!=0){
+    SPDLOG_LOGGER_WARN(logger, "The file is not a weight bundle, it is not used: {}", path);
+    return false;
+  }
+  if(header.version!=kVersion){
+    SPDLOG_LOGGER_WARN(logger, "The weight bundle is of version {} (expected {}), it is not used and should be packed again: {}",
+                       header.version, kVersion, path);
+    return false;
+  }
+  if(header.sourceStamp!=sourceStamp){
+    SPDLOG_LOGGER_WARN(logger, "The numpy files of the weights are changed after the weight bundle was packed, it is not used "
+                               "and should be packed again: {}", path);
+    return false;
+  }
+  return true;
+}
+
+CWeightBundle::CWeightBundle(const std::string &path) {
+  const int fd = open(path.c_str(), O_RDONLY);
+  ConditionCheck(fd>=0, "Failed to open the weight bundle: "+path);
+  struct stat fileStat;
+  if(fstat(fd, &fileStat)!=0){
+    close(fd);
+    ThrowException("Failed to stat the weight bundle: "+path);
+  }
+  m_uFileBytes = fileStat.st_size;
+  if(m_uFileBytes<sizeof(Header)){
+    close(fd);
+    ThrowException("The weight bundle is truncated: "+path);
+  }
+  // Writable and private, so that the borrowing CPU tensors could never modify the file.
+  void *base = mmap(nullptr, m_uFileBytes, PROT_READ|PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  ConditionCheck(base!=MAP_FAILED, "Failed to map the weight bundle: "+path);
+  const size_t fileBytes = m_uFileBytes;
+  m_ptrMapping = std::shared_ptr<char>(static_cast<char*>(base), [fileBytes](char *ptr){ munmap(ptr, fileBytes); });
+
+  m_ptrHeader = reinterpret_cast<const Header*>(m_ptrMapping.get());
+  ConditionCheck(std::memcmp(m_ptrHeader->magic, kMagic, sizeof(kMagic))==0, "The file is not a weight bundle: "+path);
+  ConditionCheck(m_ptrHeader->version==kVersion, "The version of the weight bundle is not supported: "+path);
+  const uint64_t indexBytes =
+      sizeof(Header) + (uint64_t)m_ptrHeader->entryCount*sizeof(Entry) + (uint64_t)m_ptrHeader->bankSectionCount*sizeof(BankSection);
+  ConditionCheck(indexBytes<=m_uFileBytes, "The index of the weight bundle is truncated: "+path);
+  m_ptrEntries = reinterpret_cast<const Entry*>(m_ptrMapping.get()+sizeof(Header));
+  m_ptrBankSections = reinterpret_cast<const BankSection*>(m_ptrEntries+m_ptrHeader->entryCount);
+
+  for(unsigned i=0; i<GetBankSectionCount(); i++){
+    const auto &section = GetBankSection(i);
+    ConditionCheck(section.offset%kAlignment==0 && section.offset+section.bytes<=m_uFileBytes,
+                   "A bank section of the weight bundle is out of bounds: "+path);
+  }
+  for(unsigned i=0; i<GetEntryCount(); i++){
+    const auto &entry = GetEntry(i);
+    ConditionCheck(entry.name[kMaxNameLen-1]==0 && entry.tag[kMaxTagLen-1]==0 && entry.rank>0 && entry.rank<=kMaxRank &&
+                   entry.bankSectionIndex<GetBankSectionCount(), "A bad entry is found in the weight bundle: "+path);
+    const auto shape = GetShape(i);
+    const uint64_t bytes = std::accumulate(shape.begin(), shape.end(), (uint64_t)1, std::multiplies<uint64_t>())*sizeof(float);
+    ConditionCheck(entry.hostOffset+bytes<=m_uFileBytes &&
+                   entry.deviceOffset%kAlignment==0 &&
+                   entry.deviceOffset+entry.deviceBytes<=GetBankSection(entry.bankSectionIndex).bytes,
+                   "A weight of the weight bundle is out of bounds: "+std::string(entry.name));
+  }
+  SPDLOG_LOGGER_INFO(logger, "The weight bundle {} is mapped ({} weights, {} bank sections).", path, GetEntryCount(),
+                     GetBankSectionCount());
+}
+
+unsigned CWeightBundle::GetAxiWidth() const {
+  return m_ptrHeader->axiWidth;
+}
+
+bool CWeightBundle::IsBatchNormFolded() const {
+  return (m_ptrHeader->flags & kFlagBatchNormsFolded)!=0;
+}
+
+unsigned CWeightBundle::GetEntryCount() const {
+  return m_ptrHeader->entryCount;
+}
+
+const CWeightBundle::Entry &CWeightBundle::GetEntry(unsigned index) const {
+  return m_ptrEntries[index];
+}
+
+std::vector<unsigned> CWeightBundle::GetShape(unsigned index) const {
+  const auto &entry = GetEntry(index);
+  return std::vector<unsigned>(entry.shape, entry.shape+entry.rank);
+}
+
+const float *CWeightBundle::GetHostData(unsigned index) const {
+  return reinterpret_cast<const float*>(m_ptrMapping.get() + GetEntry(index).hostOffset);
+}
+
+unsigned CWeightBundle::GetBankSectionCount() const {
+  return m_ptrHeader->bankSectionCount;
+}
+
+const CWeightBundle::BankSection &CWeightBundle::GetBankSection(unsigned index) const {
+  return m_ptrBankSections[index];
+}
+
+const float *CWeightBundle::GetBankSectionData(unsigned index) const {
+  return reinterpret_cast<const float*>(m_ptrMapping.get() + GetBankSection(index).offset);
+}
+
+std::shared_ptr<void> CWeightBundle::GetMapping() const {
+  return m_ptrMapping;
+}
@@ -1,15 +1,21 @@
 #define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
 
 #include "CWeightLoader.h"
-CWeightLoader::CWeightLoader(CXilinxInfo *xilInfo, PLATFORMS targetPlatform) {
+#include "cpu/CCpuRuntime.h"
+#include <chrono>
+#include <functional>
+#include <numeric>
+#include <random>
+CWeightLoader::CWeightLoader(CXilinxInfo *xilInfo, PLATFORMS targetPlatform, bool foldBatchNorms) {
   m_bLoadCpu = true; //always load weights on cpu //targetPlatform == PLATFORMS::CPU;
   m_bLoadXil = targetPlatform == PLATFORMS::XIL;
+  m_bFoldBatchNorms = foldBatchNorms;
   m_ptrXilInfo = xilInfo;
   m_uWeightCount = 0;
   m_bIsLoaded = false;
 }
-void CWeightLoader::LoadWeightsFromDisk(std::string &weightsBaseDir,
-                                        std::string &pathToTxtFnameList) {
+void CWeightLoader::ReadNumpyFiles(std::string &weightsBaseDir,
+                                   std::string &pathToTxtFnameList) {
   std::string line;
   int idx=0;
 
@@ -22,46 +28,397 @@ void CWeightLoader::LoadWeightsFromDisk(std::string &weightsBaseDir,
     return;
   }
 
+  std::vector<std::string> fileNames;
+  while (std::getline(txtFile, line)) {
+    fileNames.push_back(line);
+  }
+  txtFile.close();
+
+  // The numpy files are read first (in parallel), so that the batch-norms could be folded before the tensors are
+  // created.
+  m_vNumpyBuff.resize(fileNames.size());
+  CCpuRuntime::ParallelFor(fileNames.size(), 0, [&](unsigned i, unsigned){
+    m_vNumpyBuff[i] = cnpy::npy_load(weightsBaseDir + fileNames[i], globalNpyMmapEnabled);
+  });
+  for(unsigned i=0; i<fileNames.size(); i++){
+    std::vector<unsigned> __shape(m_vNumpyBuff[i].shape.begin(), m_vNumpyBuff[i].shape.end());
+    if(__shape.size()==1 && __shape[0]==0){
+      SPDLOG_LOGGER_TRACE(logger, "LoadWeightsFromDisk: An ill-shaped weight is found at index {}, skipping...", idx);
+      continue;
+    }else {
+      m_mWeightNameToIndex.insert(std::make_pair(fileNames[i], idx++) );
+      m_vWeightNames.push_back(fileNames[i]);
+      m_vWeightNumpyIndices.push_back(i);
+    }
+  }
+
+  if(m_bFoldBatchNorms){
+    FoldBatchNorms();
+  }
+}
+void CWeightLoader::LoadWeightsFromDisk(std::string &weightsBaseDir,
+                                        std::string &pathToTxtFnameList) {
   if(m_bLoadCpu) {
     SPDLOG_LOGGER_TRACE(logger, "Loading weights for PLATFORMS::CPU");
   }
   if(m_bLoadXil) {
     SPDLOG_LOGGER_TRACE(logger, "Loading weights for PLATFORMS::XIL");
   }
+  const auto timerStart = std::chrono::steady_clock::now();
+  ReadNumpyFiles(weightsBaseDir, pathToTxtFnameList);
+  CreateWeightTensors();
+  SPDLOG_LOGGER_INFO(logger, "Loaded {} weights from the numpy files in {} Seconds{}.", m_vWeightNames.size(),
+                     std::chrono::duration<double>(std::chrono::steady_clock::now()-timerStart).count(),
+                     m_bLoadXil?" (the device uploads are in flight)":"");
+}
+void CWeightLoader::CreateWeightTensors() {
+  // The weights are padded and their uploads are enqueued in parallel. The uploads are non-blocking, so the layers that
+  // consume a weight wait only for the event of its own upload, not for all of the weights.
+  const unsigned weightCount = m_vWeightNames.size();
+  if (m_bLoadCpu) m_vWeightsCpu.resize(weightCount);
+  if (m_bLoadXil) m_vWeightsXil.resize(weightCount);
+  CCpuRuntime::ParallelFor(weightCount, 0, [&](unsigned i, unsigned){
+    auto &npy = m_vNumpyBuff[m_vWeightNumpyIndices[i]];
+    std::vector<unsigned> __shape(npy.shape.begin(), npy.shape.end());
+    // The CPU weights borrow the numpy buffers (the mapped files) instead of keeping another copy of them.
+    CTensorPtr<float> cpuTn(new CTensor<float>(__shape, npy.data<float>(), npy.data_holder));
+    if (m_bLoadCpu) {
+      m_vWeightsCpu[i] = cpuTn;
+    }
+    if (m_bLoadXil) {
+      int bank = ResolveMemoryBank(PLATFORMS::XIL, m_vWeightNames[i]);
+      auto *xilTn = new CTensorXil<float>(m_ptrXilInfo, *cpuTn, bank, CONFIG_M_AXI_WIDTH, false);
+      xilTn->SetTensorTag(_ResolveTensorTagOclXilinx(m_vWeightNames[i]));
+      xilTn->SetPlacementSite(CBankPlanner::GetWeightSite(m_vWeightNames[i]));
+      // The weights are crossed to the banks of their kernels by every forward pass, but they are never written again.
+      xilTn->EnableBankReplicaCache();
+      m_vWeightsXil[i] = CTensorBasePtr(xilTn);
+    }
+  });
+  m_bIsLoaded = true;
+}
+/**
+ * @brief      Loads the weights from a weight bundle (see CWeightBundle) that is mapped once. The CPU weights borrow
+ * the host section of the bundle and every bank section is uploaded with a single transfer, the XIL weights are views
+ * of it. The padding and the banks are the ones computed when the bundle was packed.
+ *
+ * @param[in]  bundlePath          The bundle path
+ * @param[in]  weightsBaseDir      The weights directory that the bundle was packed from
+ * @param[in]  pathToTxtFnameList  The file list of the weights directory
+ *
+ * @return     False if the bundle is stale (older than the numpy files) or could not be used for the requested
+ *             batch-norm folding (nothing is loaded).
+ */
+bool CWeightLoader::LoadWeightsFromBundle(const std::string &bundlePath,
+                                          const std::string &weightsBaseDir,
+                                          const std::string &pathToTxtFnameList) {
+  if(!CWeightBundle::IsUpToDate(bundlePath, CWeightBundle::ComputeSourceStamp(weightsBaseDir, pathToTxtFnameList))){
+    return false;
+  }
+  CWeightBundle bundle(bundlePath);
+  if(bundle.IsBatchNormFolded()!=m_bFoldBatchNorms){
+    SPDLOG_LOGGER_WARN(logger, "The weight bundle was packed {} the batch-norm folding, it is not used.",
+                       bundle.IsBatchNormFolded()?"with":"without");
+    return false;
+  }
+  ConditionCheck(bundle.GetAxiWidth()==CONFIG_M_AXI_WIDTH, "The weight bundle was packed for another AXI width, it should be packed again.");
+
+  // The uploads of the bank sections are non-blocking, the views (the weights) depend on the events of their sections.
+  const auto timerStart = std::chrono::steady_clock::now();
+  std::vector<CTensorXilPtr<float>> bankTensors;
+  if(m_bLoadXil){
+    ConditionCheck(CWeightBundle::kAlignment%m_ptrXilInfo->GetBaseAddrAlignBytes()==0,
+                   "The weights of the bundle are not aligned for the sub-buffers of the device.");
+    for(unsigned s=0; s<bundle.GetBankSectionCount(); s++){
+      const auto &section = bundle.GetBankSection(s);
+      const unsigned rows = section.bytes/(CONFIG_M_AXI_WIDTH*sizeof(float));
+      // The sections are padded already, they are uploaded right from the mapping, which is kept until the write is done.
+      bankTensors.push_back(CTensorXilPtr<float>(
+          new CTensorXil<float>(m_ptrXilInfo, {rows, CONFIG_M_AXI_WIDTH}, bundle.GetBankSectionData(s), bundle.GetMapping(), section.bank)));
+    }
+  }
+
+  for(unsigned i=0; i<bundle.GetEntryCount(); i++){
+    const auto &entry = bundle.GetEntry(i);
+    const auto shape = bundle.GetShape(i);
+    m_mWeightNameToIndex.insert(std::make_pair(std::string(entry.name), i));
+    m_vWeightNames.push_back(entry.name);
+    if (m_bLoadCpu) {
+      m_vWeightsCpu.push_back(CTensorBasePtr(new CTensor<float>(shape, const_cast<float*>(bundle.GetHostData(i)), bundle.GetMapping())));
+    }
+    if (m_bLoadXil) {
+      auto *xilTn = new CTensorXil<float>(bankTensors[entry.bankSectionIndex], entry.deviceOffset, shape);
+      xilTn->SetTensorTag(std::string(entry.tag));
+      xilTn->SetPlacementSite(CBankPlanner::GetWeightSite(m_vWeightNames.back()));
+      xilTn->EnableBankReplicaCache();
+      m_vWeightsXil.push_back(CTensorBasePtr(xilTn));
+    }
+  }
+  m_uWeightCount = bundle.GetEntryCount();
+  m_bIsLoaded = true;
+  // The banks of the bundle are the ones of its packing, the weights that are planned elsewhere are moved.
+  ApplyBankPlan();
+  SPDLOG_LOGGER_INFO(logger, "Loaded {} weights from the weight bundle in {} Seconds with {} device transfers in flight.", m_uWeightCount,
+                     std::chrono::duration<double>(std::chrono::steady_clock::now()-timerStart).count(), bankTensors.size());
+  return true;
+}
+/**
+ * @brief      Reads the names of the weights from the file list and their shapes from the headers of their numpy files
+ * (the data is not read).
+ *
+ * @return     False if the file list or one of the numpy files could not be opened.
+ */
+bool CWeightLoader::ReadNumpyShapes(const std::string &weightsBaseDir,
+                                    const std::string &pathToTxtFnameList,
+                                    std::vector<std::pair<std::string, std::vector<unsigned>>> &weightShapes) {
+  std::ifstream txtFile(pathToTxtFnameList);
+  if (!txtFile.is_open()) return false;
+  std::string line;
   while (std::getline(txtFile, line)) {
-    std::string weight_npy_path = weightsBaseDir + line;
-    m_vNumpyBuff.push_back(cnpy::npy_load(weight_npy_path));
-    std::vector<unsigned> __shape(m_vNumpyBuff.back().shape.begin(), m_vNumpyBuff.back().shape.end());
-    if(__shape.size()==1 && __shape[0]==0){
-      SPDLOG_LOGGER_TRACE(logger, "LoadWeightsFromDisk: An ill-shaped weight is found at index {}, skipping...", idx);
-      continue;
-    }else {
-      m_mWeightNameToIndex.insert(std::make_pair(line, idx++) );
-      if (m_bLoadCpu) {
-        m_vWeightsCpu.push_back(CTensorBasePtr(new CTensor<float>(__shape, m_vNumpyBuff.back().data<float>())));
-      }
-      if (m_bLoadXil) {
-        int bank = ResolveMemoryBank(PLATFORMS::XIL, line);
-        m_vWeightsXil.push_back(CTensorBasePtr(new CTensorXil<float>(m_ptrXilInfo,
-                                                                     __shape,
-                                                                     m_vNumpyBuff.back().data<float>(),
-                                                                     bank)));
-        auto tag = _ResolveTensorTagOclXilinx(line);
-        std::dynamic_pointer_cast<CTensorXil<float>>(m_vWeightsXil[idx-1])->SetTensorTag(tag);
+    FILE *fp = fopen((weightsBaseDir + line).c_str(), "rb");
+    if (fp == nullptr) return false;
+    size_t wordSize;
+    bool fortranOrder;
+    std::vector<size_t> shape;
+    cnpy::parse_npy_header(fp, wordSize, shape, fortranOrder);
+    fclose(fp);
+    if (shape.size()==1 && shape[0]==0) continue; // The ill-shaped weights are skipped, like ReadNumpyFiles().
+    weightShapes.emplace_back(line, std::vector<unsigned>(shape.begin(), shape.end()));
+  }
+  return true;
+}
+/**
+ * @brief      Generates random weights with the names and the shapes of the numpy files of the weights directory
+ * (filelist.txt and the headers of the files in it) of the model, so that the model runs without the data of the
+ * weights. Without the weights directory, the names and the shapes of the weights of CModel1 are used instead.
+ * The weights are scaled by their fan-in and the batch-norm variances are positive, so the activations stay finite
+ * through the layers. The batch-norms are folded if enabled, just like the weights from the disk.
+ *
+ * @param[in]  classCount          The class count of the last FC layer (40 for ModelNet40 and 55 for ShapeNetV2),
+ *                                 only used without the weights directory
+ * @param[in]  seed                The seed
+ * @param[in]  weightsBaseDir      The weights directory
+ * @param[in]  pathToTxtFnameList  The file list of the weights directory
+ */
+void CWeightLoader::LoadRandomWeights(unsigned classCount,
+                                      unsigned seed,
+                                      const std::string &weightsBaseDir,
+                                      const std::string &pathToTxtFnameList) {
+  const auto timerStart = std::chrono::steady_clock::now();
+  std::vector<std::pair<std::string, std::vector<unsigned>>> weightShapes;
+  if(!ReadNumpyShapes(weightsBaseDir, pathToTxtFnameList, weightShapes)){
+    SPDLOG_LOGGER_INFO(logger, "The weights directory is not available ({}), the built-in shapes of the weights are used.",
+                       pathToTxtFnameList);
+    weightShapes.clear();
+    struct DenseLayer{
+      std::string name;
+      std::vector<unsigned> shapeWeights; // The last dim is the output channel.
+      bool hasBatchNorm;
+    };
+    const std::vector<DenseLayer> layers = {
+        {"transform_net1.tconv1", {1,1,6,64}, true},
+        {"transform_net1.tconv2", {1,1,64,128}, true},
+        {"transform_net1.tconv3", {1,1,128,1024}, true},
+        {"transform_net1.tfc1", {1024,512}, true},
+        {"transform_net1.tfc2", {512,256}, true},
+        {"transform_net1.transform_XYZ", {256,9}, false},
+        {"dgcnn1", {1,1,6,64}, true},
+        {"dgcnn2", {1,1,128,64}, true},
+        {"dgcnn3", {1,1,128,64}, true},
+        {"dgcnn4", {1,1,128,128}, true},
+        {"agg", {1,1,320,1024}, true},
+        {"fc1", {1024,512}, true},
+        {"fc2", {512,256}, true},
+        {"fc3", {256,classCount}, false}
+    };
+    for(auto &layer:layers){
+      const unsigned chOut = layer.shapeWeights.back();
+      weightShapes.emplace_back(layer.name + ".weights.npy", layer.shapeWeights);
+      weightShapes.emplace_back(layer.name + ".biases.npy", std::vector<unsigned>{chOut});
+      if(layer.hasBatchNorm){
+        const std::string bnPrefix = layer.name + ".bn.";
+        const std::string momentsPrefix = bnPrefix + layer.name + ".bn.moments.";
+        weightShapes.emplace_back(bnPrefix + "gamma.npy", std::vector<unsigned>{chOut});
+        weightShapes.emplace_back(bnPrefix + "beta.npy", std::vector<unsigned>{chOut});
+        weightShapes.emplace_back(momentsPrefix + "Squeeze.ExponentialMovingAverage.npy", std::vector<unsigned>{chOut});
+        weightShapes.emplace_back(momentsPrefix + "Squeeze_1.ExponentialMovingAverage.npy", std::vector<unsigned>{chOut});
       }
     }
   }
-  m_bIsLoaded = true;
-  txtFile.close();
+
+  auto endsWith = [](const std::string &name, const std::string &suffix){
+    return name.size()>=suffix.size() && name.compare(name.size()-suffix.size(), suffix.size(), suffix)==0;
+  };
+  std::mt19937 generator(seed);
+  for(auto &weightShape:weightShapes){
+    const std::string &name = weightShape.first;
+    const std::vector<unsigned> &shape = weightShape.second;
+    // The ranges by the kind of the weight, the batch-norm gammas and variances are positive.
+    float minValue = -0.1f, maxValue = 0.1f;
+    if(endsWith(name, ".weights.npy")){
+      const unsigned fanIn = std::accumulate(shape.begin(), shape.end()-1, 1u, std::multiplies<unsigned>());
+      maxValue = std::sqrt(3.0f/fanIn); // The variance of the outputs is kept at the one of the inputs.
+      minValue = -maxValue;
+    }else if(endsWith(name, ".gamma.npy") || endsWith(name, "Squeeze_1.ExponentialMovingAverage.npy")){
+      minValue = 0.5f;
+      maxValue = 1.5f;
+    }
+
+    std::vector<size_t> __shape(shape.begin(), shape.end());
+    cnpy::NpyArray npy(__shape, sizeof(float), false);
+    std::uniform_real_distribution<float> distribution(minValue, maxValue);
+    std::generate(npy.data<float>(), npy.data<float>()+npy.num_vals, [&](){ return distribution(generator); });
+    m_mWeightNameToIndex.insert(std::make_pair(name, (unsigned)m_vWeightNames.size()));
+    m_vWeightNames.push_back(name);
+    m_vWeightNumpyIndices.push_back(m_vNumpyBuff.size());
+    m_vNumpyBuff.push_back(npy);
+  }
+  m_uWeightCount = m_vWeightNames.size();
+
+  if(m_bFoldBatchNorms){
+    FoldBatchNorms();
+  }
+  CreateWeightTensors();
+  SPDLOG_LOGGER_INFO(logger, "Generated {} random weights (seed {}) in {} Seconds{}.", m_uWeightCount, seed,
+                     std::chrono::duration<double>(std::chrono::steady_clock::now()-timerStart).count(),
+                     m_bLoadXil?" (the device uploads are in flight)":"");
+}
+/**
+ * @brief      Reads the numpy files of the weights (and folds the batch-norms if enabled), then writes them into a
+ * weight bundle with their XIL banks and tags resolved and their device copies padded.
+ */
+void CWeightLoader::PackWeightsBundle(std::string &weightsBaseDir,
+                                      std::string &pathToTxtFnameList,
+                                      const std::string &bundlePath) {
+  ReadNumpyFiles(weightsBaseDir, pathToTxtFnameList);
+  std::vector<CWeightBundle::Record> records;
+  for(unsigned i=0; i<m_vWeightNames.size(); i++){
+    auto &npy = m_vNumpyBuff[m_vWeightNumpyIndices[i]];
+    CWeightBundle::Record record;
+    record.name = m_vWeightNames[i];
+    record.tag = _ResolveTensorTagOclXilinx(m_vWeightNames[i]);
+    record.bank = _ResolveMemoryBankOclXilinx(m_vWeightNames[i]);
+    record.shape.assign(npy.shape.begin(), npy.shape.end());
+    record.data = npy.data<float>();
+    records.push_back(record);
+  }
+  CWeightBundle::Write(bundlePath, records, CONFIG_M_AXI_WIDTH, m_bFoldBatchNorms,
+                       CWeightBundle::ComputeSourceStamp(weightsBaseDir, pathToTxtFnameList));
+}
+/**
+ * @brief      Interns the name of a weight. The name is looked up only here, so a missing weight is caught when the
+ * handles are resolved (at the model construction) and not in the middle of an inference.
+ */
+CWeightLoader::Handle CWeightLoader::ResolveWeight(const std::string &name) const {
+  auto it = m_mWeightNameToIndex.find(name);
+  ConditionCheck(it!=m_mWeightNameToIndex.end(), "The given key for the weight does not exist: "+name);
+  return Handle{it->second};
+}
+const std::string& CWeightLoader::GetWeightName(Handle handle) const {
+  ConditionCheck(handle.index<m_vWeightNames.size(), "The weight handle is not valid.");
+  return m_vWeightNames[handle.index];
+}
+CTensorBasePtr CWeightLoader::AccessWeights(PLATFORMS platform, Handle handle) const {
+  const auto &weights = platform == PLATFORMS::CPU ? m_vWeightsCpu : m_vWeightsXil;
+  ConditionCheck(handle.index<weights.size(), "The weight handle is not valid for the requested platform.");
+  return weights[handle.index];
 }
 CTensorBasePtr CWeightLoader::AccessWeights(PLATFORMS platform, std::string &&name) {
-  ConditionCheck(m_mWeightNameToIndex.count(name)>0, "The given key for the weight does not exist.");
-  if(platform == PLATFORMS::CPU)
-    return m_vWeightsCpu[m_mWeightNameToIndex[name]];
-  else if (platform == PLATFORMS::XIL)
-    return m_vWeightsXil[m_mWeightNameToIndex[name]];
-  else
-    assert(false);
+  return AccessWeights(platform, ResolveWeight(name));
+}
+/**
+ * @brief      Moves the XIL weights to their banks in the plan of CBankPlanner (if any). The copies of a moved weight
+ * on the other banks, including the one it is moved from, are kept as its bank replicas.
+ */
+void CWeightLoader::ApplyBankPlan() {
+  if(!m_bLoadXil || !m_ptrXilInfo->GetBankPlanner()->HasPlan()) return;
+  unsigned movedCount = 0;
+  unsigned long movedBytes = 0;
+  for(unsigned i=0; i<m_vWeightsXil.size(); i++){
+    const int bank = m_ptrXilInfo->GetBankPlanner()->GetPlannedBank(CBankPlanner::GetWeightSite(m_vWeightNames[i]));
+    auto xilTn = std::dynamic_pointer_cast<CTensorXil<float>>(m_vWeightsXil[i]);
+    if(bank==-1 || xilTn->GetDramBank()==bank) continue;
+    m_vWeightsXil[i] = xilTn->MoveToBank(bank);
+    movedCount++;
+    movedBytes += xilTn->GetSizeBytesPadded();
+  }
+  SPDLOG_LOGGER_INFO(logger, "Moved {} weights ({} MB) to their planned banks.", movedCount, movedBytes/1048576.0);
+}
+bool CWeightLoader::IsBatchNormFolded() const {
+  return m_bFoldBatchNorms;
+}
+cnpy::NpyArray& CWeightLoader::GetNumpyArray(const std::string &name) {
+  // The weights of a bundle are loaded without their numpy buffers.
+  ConditionCheck(!m_vNumpyBuff.empty() && m_vWeightNumpyIndices.size()==m_vWeightNames.size(),
+                 "The numpy buffers of the weights are not available, the weights are loaded from a weight bundle.");
+  auto it = m_mWeightNameToIndex.find(name);
+  ConditionCheck(it!=m_mWeightNameToIndex.end(), "The weight required for folding the batch-norms does not exist.");
+  return m_vNumpyBuff[m_vWeightNumpyIndices[it->second]];
+}
+/**
+ * @brief      Folds every inference-time batch-norm into the weight and the bias of the Conv2D or the FC layer right
+ * before it. With the exponential moving averages of the mean and the variance as the batch-norm statistics:
+ *   s = gamma / sqrt(ema_var + 1e-8)
+ *   W'[:,c] = W[:,c] * s[c]
+ *   b'[c] = (b[c] - ema_mean[c]) * s[c] + beta[c]
+ * Therefore the batch-norm layers are reduced to identity and CModel1::BatchNormForward is skipped.
+ * The weights are modified in the numpy buffers, before the platform tensors are created.
+ */
+void CWeightLoader::FoldBatchNorms() {
+  const std::vector<std::string> foldedLayers = {
+      "transform_net1.tconv1",
+      "transform_net1.tconv2",
+      "transform_net1.tconv3",
+      "transform_net1.tfc1",
+      "transform_net1.tfc2",
+      "dgcnn1",
+      "dgcnn2",
+      "dgcnn3",
+      "dgcnn4",
+      "agg",
+      "fc1",
+      "fc2"
+  };
+  const float epsilon = 1e-8f; // The same epsilon as CModel1::BatchNormForward
+
+  for(auto &layer:foldedLayers){
+    const std::string bnPrefix = layer + ".bn.";
+    const std::string momentsPrefix = bnPrefix + layer + ".bn.moments.";
+    auto &npyWeight = GetNumpyArray(layer + ".weights.npy");
+    auto &npyBias = GetNumpyArray(layer + ".biases.npy");
+    auto &npyGamma = GetNumpyArray(bnPrefix + "gamma.npy");
+    auto &npyBeta = GetNumpyArray(bnPrefix + "beta.npy");
+    auto &npyMean = GetNumpyArray(momentsPrefix + "Squeeze.ExponentialMovingAverage.npy");
+    auto &npyVar = GetNumpyArray(momentsPrefix + "Squeeze_1.ExponentialMovingAverage.npy");
+
+    const size_t chOut = npyBias.num_vals;
+    const size_t weightLen = npyWeight.num_vals;
+    ConditionCheck(weightLen%chOut==0, "The weight and the bias of the layer to be folded are incompatible.");
+    ConditionCheck(
+        npyGamma.num_vals==chOut && npyBeta.num_vals==chOut && npyMean.num_vals==chOut && npyVar.num_vals==chOut,
+        "The batch-norm and the bias of the layer to be folded are incompatible.");
+
+    float *ptrWeight = npyWeight.data<float>();
+    float *ptrBias = npyBias.data<float>();
+    const float *ptrGamma = npyGamma.data<float>();
+    const float *ptrBeta = npyBeta.data<float>();
+    const float *ptrMean = npyMean.data<float>();
+    const float *ptrVar = npyVar.data<float>();
+
+    // The last dimension of the weights (1x1xDxch_out for Conv2D and Dxch_out for FC) is the output channel.
+    std::vector<float> scale(chOut);
+    for(size_t c=0; c<chOut; c++){
+      scale[c] = ptrGamma[c] / std::sqrt(ptrVar[c] + epsilon);
+    }
+    for(size_t i=0; i<weightLen; i++){
+      ptrWeight[i] *= scale[i%chOut];
+    }
+    for(size_t c=0; c<chOut; c++){
+      ptrBias[c] = (ptrBias[c] - ptrMean[c]) * scale[c] + ptrBeta[c];
+    }
+    SPDLOG_LOGGER_TRACE(logger, "The batch-norm of the layer \"{}\" is folded into its weight and bias.", layer);
+  }
+  SPDLOG_LOGGER_INFO(logger, "Folded {} batch-norms into their preceding layers.", foldedLayers.size());
 }
 int CWeightLoader::ResolveMemoryBank(PLATFORMS platform, std::string &name) {
   if(platform == PLATFORMS::XIL)
@@ -70,6 +427,12 @@ int CWeightLoader::ResolveMemoryBank(PLATFORMS platform, std::string &name) {
     assert(false);
 }
 int CWeightLoader::_ResolveMemoryBankOclXilinx(std::string &name) {
+  // The bank plan of a previous run (--bankplan) overrides the banks of the kernels below.
+  if(m_ptrXilInfo!=nullptr){
+    const int plannedBank = m_ptrXilInfo->GetBankPlanner()->GetPlannedBank(CBankPlanner::GetWeightSite(name));
+    if(plannedBank!=-1) return plannedBank;
+  }
+
   assert(
     ConfigTaskConv2::BankIndex_inputTn == ConfigTaskConv2::BankIndex_weightTn &&
     ConfigTaskConv2::BankIndex_weightTn == ConfigTaskConv2::BankIndex_biasTn &&
@@ -18,6 +18,21 @@ bool globalProfileOclEnabled=true;
 bool globalCpuUsageSamplingEnabled=false;
 bool globalModelnet=true;
 bool globalShapenet=false;
+bool globalCpuNaiveKernels=false;
+bool globalFoldBatchNorms=false;
+bool globalFoldBatchNormsCheck=false;
+bool globalMemoryPoolEnabled=true;
+bool globalNpyMmapEnabled=true;
+bool globalMemoryPlannerEnabled=false;
+unsigned globalCpuThreadCount=0;
+bool globalStreamingEnabled=false;
+unsigned globalStreamBatchLimit=0;
+bool globalPipelineEnabled=false;
+bool globalWeightBundleEnabled=true;
+bool globalPackWeightBundle=false;
+bool globalCpuOnly=false;
+bool globalSyntheticData=false;
+string globalBankPlanPath;
 
 void Handler(int sig) {
   void *array[40];
@@ -52,13 +67,13 @@ void SetupModules(int argc, const char* argv[]){
   ArgumentParser parser(argv[0], "DeeppointV2FPGA");
   parser.add_argument()
       .names({"-i", "--image"})
-      .description("FPGA image(*.xclbin or *.awsxclbin)")
-      .required(true);
+      .description("FPGA image(*.xclbin or *.awsxclbin), not needed with --cpuonly")
+      .required(false);
 
   parser.add_argument()
       .names({"-d", "--data"})
-      .description("Data directory")
-      .required(true);
+      .description("Data directory, not needed with --synthetic")
+      .required(false);
 
   parser.add_argument()
       .names({"-y", "--shapenet2"})
@@ -100,6 +115,76 @@ void SetupModules(int argc, const char* argv[]){
       .description("Disable CPU usage sampling on the kernel launches. (no value is needed for this argument)")
       .required(false);
 
+  parser.add_argument()
+      .names({"--cpunaive"})
+      .description("Use the naive reference loops for the layers of the CPU implementation instead of the optimized kernels. (no value is needed for this argument)")
+      .required(false);
+
+  parser.add_argument()
+      .names({"--cputhreads"})
+      .description("The number of the threads of the CPU implementation's thread pool (default: the hardware concurrency)")
+      .required(false);
+
+  parser.add_argument()
+      .names({"--foldbn"})
+      .description("Inference mode: fold the batch-norms (with their moving averages) into the weights of the preceding Conv2D/FC layers at loading. (no value is needed for this argument)")
+      .required(false);
+
+  parser.add_argument()
+      .names({"--foldbncheck"})
+      .description("Run the model with and without the folded batch-norms and check the accuracy for regressions. (no value is needed for this argument)")
+      .required(false);
+
+  parser.add_argument()
+      .names({"--nomempool"})
+      .description("Disable the host and device buffer pools of the tensors, every tensor allocates and frees its own buffers. (no value is needed for this argument)")
+      .required(false);
+
+  parser.add_argument()
+      .names({"--nommap"})
+      .description("Read the numpy files of the weights and the dataset into the host memory instead of memory-mapping them. (no value is needed for this argument)")
+      .required(false);
+
+  parser.add_argument()
+      .names({"--memplan"})
+      .description("Record the forward pass, plan the reuse of the intermediate tensors and replay the plan (with the in-place elementwise layers) in a second pass. The peak memory before and after is reported. (no value is needed for this argument)")
+      .required(false);
+
+  parser.add_argument()
+      .names({"--stream"})
+      .description("Streaming mode: keep the model resident and run it over all of the batches of the dataset, then report the sustained throughput and the batch latency percentiles. (no value is needed for this argument)")
+      .required(false);
+
+  parser.add_argument()
+      .names({"--streamlimit"})
+      .description("The maximum number of the batches of the streaming mode (default: all of the dataset)")
+      .required(false);
+
+  parser.add_argument()
+      .names({"--pipeline"})
+      .description("Streaming mode with the consecutive batches pipelined: the next batch is uploaded and enqueued while the current one is finishing and being read back. Implies --stream. (no value is needed for this argument)")
+      .required(false);
+  parser.add_argument()
+      .names({"--nobundle"})
+      .description("Ignore the weight bundle (weights.bundle) of the weights directory and load the numpy files. (no value is needed for this argument)")
+      .required(false);
+  parser.add_argument()
+      .names({"--packweights"})
+      .description("Pack the weights of the selected dataset (-y) into the weight bundle of its weights directory and exit, honours --foldbn. (no value is needed for this argument)")
+      .required(false);
+  parser.add_argument()
+      .names({"--cpuonly"})
+      .description("Run the model on the CPU platform only, the Xilinx implementation (the device and the FPGA image) is not created. (no value is needed for this argument)")
+      .required(false);
+  parser.add_argument()
+      .names({"--synthetic"})
+      .description("Use random weights (with the shapes of the model) and random point clouds instead of the data directory, for benchmarking. The accuracy is meaningless. (no value is needed for this argument)")
+      .required(false);
+  parser.add_argument()
+      .names({"--bankplan"})
+      .description("The bank plan file. If it exists, the weights and the uploads are placed on its banks, otherwise the first forward pass is recorded, the banks of the weights and the uploads are planned to minimize the datamover traffic and the plan is saved to it. The bytes moved before and after the planning are reported.")
+      .required(false);
+
   parser.enable_help();
   auto err = parser.parse(argc, argv);
   if(err){
@@ -113,6 +198,17 @@ void SetupModules(int argc, const char* argv[]){
     exit(EXIT_SUCCESS);
   }
 
+#ifdef SIMDEVICE
+  const bool imageRequired = false; // The kernels of the simulated device are linked into the host.
+#else
+  const bool imageRequired = !parser.exists("cpuonly");
+#endif
+  if((imageRequired && !parser.exists("i")) || (!parser.exists("d") && !parser.exists("synthetic"))){
+    std::cerr << "The FPGA image (-i) is required unless --cpuonly is given and the data directory (-d) is required unless --synthetic is given." << std::endl;
+    parser.print_help();
+    exit(EXIT_FAILURE);
+  }
+
   {
     // HOST LOGGER
     auto console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
@@ -194,6 +290,82 @@ void SetupModules(int argc, const char* argv[]){
     globalCpuUsageSamplingEnabled = true;
   }
 
+  if(parser.exists("cpunaive")) {
+    globalCpuNaiveKernels = true;
+    SPDLOG_LOGGER_INFO(logger,"The CPU implementation is going to use the naive reference kernels.");
+  }
+
+  if(parser.exists("cputhreads")) {
+    globalCpuThreadCount = parser.get<unsigned>("cputhreads");
+    SPDLOG_LOGGER_INFO(logger,"The CPU implementation is going to use {} threads.", globalCpuThreadCount);
+  }
+
+  if(parser.exists("foldbn")) {
+    globalFoldBatchNorms = true;
+    SPDLOG_LOGGER_INFO(logger,"The batch-norms are going to be folded into the weights of their preceding layers.");
+  }
+
+  if(parser.exists("foldbncheck")) {
+    globalFoldBatchNormsCheck = true;
+    SPDLOG_LOGGER_INFO(logger,"The accuracy of the folded batch-norms is going to be checked against the default graph.");
+  }
+
+  if(parser.exists("nomempool")) {
+    globalMemoryPoolEnabled = false;
+    SPDLOG_LOGGER_INFO(logger,"The buffer pools of the tensors are disabled.");
+  }
+
+  if(parser.exists("nommap")) {
+    globalNpyMmapEnabled = false;
+    SPDLOG_LOGGER_INFO(logger,"The numpy files are going to be read instead of memory-mapped.");
+  }
+
+  if(parser.exists("memplan")) {
+    globalMemoryPlannerEnabled = true;
+    SPDLOG_LOGGER_INFO(logger,"The forward pass is going to be recorded and replayed with the memory plan.");
+  }
+
+  if(parser.exists("stream")) {
+    globalStreamingEnabled = true;
+    SPDLOG_LOGGER_INFO(logger,"The model is going to run over all of the batches of the dataset (streaming mode).");
+  }
+
+  if(parser.exists("streamlimit")) {
+    globalStreamBatchLimit = parser.get<unsigned>("streamlimit");
+    SPDLOG_LOGGER_INFO(logger,"The streaming mode is limited to {} batches.", globalStreamBatchLimit);
+  }
+
+  if(parser.exists("pipeline")) {
+    globalStreamingEnabled = true;
+    globalPipelineEnabled = true;
+    SPDLOG_LOGGER_INFO(logger,"The consecutive batches of the streaming mode are going to be pipelined.");
+  }
+
+  if(parser.exists("nobundle")) {
+    globalWeightBundleEnabled = false;
+    SPDLOG_LOGGER_INFO(logger,"The weight bundle is ignored, the weights are going to be loaded from the numpy files.");
+  }
+
+  if(parser.exists("packweights")) {
+    globalPackWeightBundle = true;
+    SPDLOG_LOGGER_INFO(logger,"The weights are going to be packed into the weight bundle.");
+  }
+
+  if(parser.exists("cpuonly")) {
+    globalCpuOnly = true;
+    SPDLOG_LOGGER_INFO(logger,"The model is going to run on the CPU platform only, the Xilinx implementation is not created.");
+  }
+
+  if(parser.exists("synthetic")) {
+    globalSyntheticData = true;
+    SPDLOG_LOGGER_WARN(logger,"The weights and the point clouds are random, the accuracy is meaningless.");
+  }
+
+  if(parser.exists("bankplan")) {
+    globalBankPlanPath = parser.get<string>("bankplan");
+    SPDLOG_LOGGER_INFO(logger,"The banks of the weights and the uploads are going to be planned with the bank plan file: {}", globalBankPlanPath);
+  }
+
   if(parser.exists("noprofileocl")) {
     globalProfileOclEnabled = false;
     SPDLOG_LOGGER_INFO(logger,"The OpenCL profiling is forcibly disabled to increase performance.");
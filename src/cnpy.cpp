@@ -9,6 +9,10 @@
 #include<cstring>
 #include<iomanip>
 #include<stdint.h>
+#include<fcntl.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include<unistd.h>
 
 char cnpy::BigEndianTest() {
     int x = 1;
@@ -325,7 +329,33 @@ cnpy::NpyArray cnpy::npz_load(std::string fname, std::string varname) {
     abort();
 }
 
-cnpy::NpyArray cnpy::npy_load(std::string fname) {
+static cnpy::NpyArray map_the_npy_file(FILE* fp) {
+    std::vector<size_t> shape;
+    size_t word_size;
+    bool fortran_order;
+    cnpy::parse_npy_header(fp,word_size,shape,fortran_order);
+    const size_t data_offset = ftell(fp);
+
+    struct stat file_stat;
+    if(fstat(fileno(fp),&file_stat) != 0)
+        ThrowException("map_the_npy_file: failed fstat");
+    const size_t file_size = file_stat.st_size;
+
+    cnpy::NpyArray arr(shape, word_size, fortran_order, nullptr);
+    if(data_offset + arr.num_bytes() > file_size)
+        ThrowException("map_the_npy_file: the file is smaller than its header says");
+
+    //private and writable: the pages that are modified in-place (e.g. the folded batch-norms) are copied on write,
+    //the rest stay shared with the page cache.
+    void* base = mmap(NULL,file_size,PROT_READ|PROT_WRITE,MAP_PRIVATE,fileno(fp),0);
+    if(base == MAP_FAILED)
+        ThrowException("map_the_npy_file: failed mmap");
+    std::shared_ptr<char> mapping(static_cast<char*>(base), [file_size](char* ptr){ munmap(ptr,file_size); });
+    arr.data_holder = std::shared_ptr<char>(mapping, mapping.get() + data_offset);
+    return arr;
+}
+
+cnpy::NpyArray cnpy::npy_load(std::string fname, bool use_mmap) {
 
     FILE* fp = fopen(fname.c_str(), "rb");
 
@@ -334,7 +364,7 @@ cnpy::NpyArray cnpy::npy_load(std::string fname) {
         abort();  
     }
 
-    NpyArray arr = load_the_npy_file(fp);
+    NpyArray arr = use_mmap ? map_the_npy_file(fp) : load_the_npy_file(fp);
 
     fclose(fp);
     return arr;
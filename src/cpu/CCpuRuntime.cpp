@@ -0,0 +1,85 @@
+#include "cpu/CCpuRuntime.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::atomic<CCpuThreadPool*> globalThreadPool(nullptr);
+
+}
+
+CCpuRuntime::ISA CCpuRuntime::GetIsa() {
+#if defined(__x86_64__) || defined(__i386__)
+  static const ISA isa = [](){
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx512f")) return ISA::AVX512;
+    if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return ISA::AVX2;
+    return ISA::SCALAR;
+  }();
+  return isa;
+#else
+  return ISA::SCALAR;
+#endif
+}
+
+std::string CCpuRuntime::GetIsaName() {
+  switch(GetIsa()){
+    case ISA::AVX512: return "avx512";
+    case ISA::AVX2: return "avx2";
+    default: return "scalar";
+  }
+}
+
+unsigned CCpuRuntime::GetDefaultThreadCount() {
+  CCpuThreadPool *pool = globalThreadPool.load();
+  if(pool!=nullptr) return pool->GetThreadCount();
+  const unsigned hw = std::thread::hardware_concurrency();
+  return hw==0 ? 1 : hw;
+}
+
+void CCpuRuntime::SetThreadPool(CCpuThreadPool *threadPool) {
+  globalThreadPool.store(threadPool);
+}
+
+CCpuThreadPool* CCpuRuntime::GetThreadPool() {
+  return globalThreadPool.load();
+}
+
+void CCpuRuntime::ParallelFor(unsigned taskCount, unsigned threadCount, const std::function<void(unsigned,unsigned)> &body) {
+  CCpuThreadPool *pool = globalThreadPool.load();
+  if(pool!=nullptr){
+    pool->ParallelFor(taskCount, threadCount, body);
+    return;
+  }
+  if(threadCount==0) threadCount = GetDefaultThreadCount();
+  const unsigned workers = std::max(1u, std::min(taskCount, threadCount));
+  if(workers==1){
+    for(unsigned t=0; t<taskCount; t++) body(t, 0);
+    return;
+  }
+  std::atomic_uint nextTask(0);
+  auto worker = [&](unsigned workerIndex){
+    for(unsigned t=nextTask++; t<taskCount; t=nextTask++){
+      body(t, workerIndex);
+    }
+  };
+  std::vector<std::thread> threads;
+  threads.reserve(workers-1);
+  for(unsigned w=1; w<workers; w++){
+    threads.emplace_back(worker, w);
+  }
+  worker(0);
+  for(auto &th:threads) th.join();
+}
+
+void CCpuRuntime::ParallelForRange(size_t len, size_t grainSize, const std::function<void(size_t,size_t)> &body) {
+  if(len==0) return;
+  grainSize = std::max<size_t>(1, grainSize);
+  const size_t taskCount = (len+grainSize-1)/grainSize;
+  ParallelFor((unsigned)taskCount, 0, [&](unsigned task, unsigned){
+    const size_t begin = (size_t)task*grainSize;
+    body(begin, std::min(len, begin+grainSize));
+  });
+}
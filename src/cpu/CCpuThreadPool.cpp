@@ -0,0 +1,168 @@
+#include "cpu/CCpuThreadPool.h"
+#include <algorithm>
+
+namespace {
+
+// True while the thread runs the tasks of a pool (always true for the pool threads).
+thread_local bool tlsInsideTask = false;
+
+}
+
+CCpuThreadPool::CCpuThreadPool(unsigned threadCount) {
+  if(threadCount==0) threadCount = std::thread::hardware_concurrency();
+  m_uThreadCount = std::max(1u, threadCount);
+  m_uGeneration = 0;
+  m_uActiveWorkers = 0;
+  m_uPendingWorkers = 0;
+  m_bStop = false;
+  m_ptrBody = nullptr;
+  for(unsigned w=0; w<m_uThreadCount; w++){
+    m_vRanges.emplace_back(new TaskRange());
+    m_vRanges.back()->begin = 0;
+    m_vRanges.back()->end = 0;
+  }
+  m_vThreads.reserve(m_uThreadCount-1);
+  for(unsigned w=1; w<m_uThreadCount; w++){
+    m_vThreads.emplace_back(&CCpuThreadPool::WorkerLoop, this, w);
+  }
+}
+
+CCpuThreadPool::~CCpuThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(m_oMutex);
+    m_bStop = true;
+  }
+  m_oCvStart.notify_all();
+  for(auto &th:m_vThreads) th.join();
+}
+
+unsigned CCpuThreadPool::GetThreadCount() const {
+  return m_uThreadCount;
+}
+
+bool CCpuThreadPool::IsInsideTask() {
+  return tlsInsideTask;
+}
+
+void CCpuThreadPool::ParallelFor(unsigned taskCount, unsigned maxWorkers, const std::function<void(unsigned,unsigned)> &body) {
+  if(taskCount==0) return;
+  if(maxWorkers==0) maxWorkers = m_uThreadCount;
+  const unsigned workers = std::min(taskCount, std::min(maxWorkers, m_uThreadCount));
+  if(workers<=1 || tlsInsideTask){
+    for(unsigned t=0; t<taskCount; t++) body(t, 0);
+    return;
+  }
+
+  std::lock_guard<std::mutex> callLock(m_oCallMutex);
+
+  // The initial even split, the ranges of the idle workers stay empty.
+  for(unsigned w=0; w<m_uThreadCount; w++){
+    std::lock_guard<std::mutex> lock(m_vRanges[w]->mutex);
+    m_vRanges[w]->begin = w<workers ? (unsigned)((unsigned long long)taskCount*w/workers) : 0;
+    m_vRanges[w]->end = w<workers ? (unsigned)((unsigned long long)taskCount*(w+1)/workers) : 0;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_oMutex);
+    m_ptrBody = &body;
+    m_oException = nullptr;
+    m_uActiveWorkers = workers;
+    m_uPendingWorkers = workers-1;
+    m_uGeneration++;
+  }
+  m_oCvStart.notify_all();
+
+  tlsInsideTask = true;
+  RunWorker(0);
+  tlsInsideTask = false;
+
+  std::exception_ptr exception;
+  {
+    std::unique_lock<std::mutex> lock(m_oMutex);
+    m_oCvDone.wait(lock, [this]{ return m_uPendingWorkers==0; });
+    m_ptrBody = nullptr;
+    exception = m_oException;
+  }
+  if(exception) std::rethrow_exception(exception);
+}
+
+void CCpuThreadPool::WorkerLoop(unsigned workerIndex) {
+  tlsInsideTask = true;
+  unsigned long seenGeneration = 0;
+  while(true){
+    {
+      std::unique_lock<std::mutex> lock(m_oMutex);
+      m_oCvStart.wait(lock, [&]{ return m_bStop || m_uGeneration!=seenGeneration; });
+      if(m_bStop) return;
+      seenGeneration = m_uGeneration;
+      if(workerIndex>=m_uActiveWorkers) continue;
+    }
+
+    RunWorker(workerIndex);
+
+    bool isLast;
+    {
+      std::lock_guard<std::mutex> lock(m_oMutex);
+      isLast = (--m_uPendingWorkers==0);
+    }
+    if(isLast) m_oCvDone.notify_one();
+  }
+}
+
+void CCpuThreadPool::RunWorker(unsigned workerIndex) {
+  unsigned task;
+  do{
+    while(PopTask(workerIndex, task)){
+      try{
+        (*m_ptrBody)(task, workerIndex);
+      }catch(...){
+        std::lock_guard<std::mutex> lock(m_oMutex);
+        if(!m_oException) m_oException = std::current_exception();
+      }
+    }
+  }while(StealTasks(workerIndex));
+}
+
+bool CCpuThreadPool::PopTask(unsigned workerIndex, unsigned &task) {
+  auto &range = *m_vRanges[workerIndex];
+  std::lock_guard<std::mutex> lock(range.mutex);
+  if(range.begin>=range.end) return false;
+  task = range.begin++;
+  return true;
+}
+
+bool CCpuThreadPool::StealTasks(unsigned workerIndex) {
+  const unsigned workers = m_uActiveWorkers;
+  while(true){
+    // Pick the victim with the most tasks left, the sizes are only a hint until the victim is locked.
+    unsigned victim = workerIndex, largest = 0;
+    for(unsigned i=1; i<workers; i++){
+      const unsigned w = (workerIndex+i)%workers;
+      std::lock_guard<std::mutex> lock(m_vRanges[w]->mutex);
+      const unsigned left = m_vRanges[w]->end - m_vRanges[w]->begin;
+      if(left>largest){
+        largest = left;
+        victim = w;
+      }
+    }
+    if(largest==0) return false;
+
+    unsigned stolenBegin, stolenEnd;
+    {
+      auto &range = *m_vRanges[victim];
+      std::lock_guard<std::mutex> lock(range.mutex);
+      const unsigned left = range.end - range.begin;
+      if(left==0) continue; // Drained in the meantime, look again.
+      stolenEnd = range.end;
+      stolenBegin = range.end - (left+1)/2;
+      range.end = stolenBegin;
+    }
+    {
+      auto &range = *m_vRanges[workerIndex];
+      std::lock_guard<std::mutex> lock(range.mutex);
+      range.begin = stolenBegin;
+      range.end = stolenEnd;
+    }
+    return true;
+  }
+}
@@ -0,0 +1,57 @@
+#include "cpu/CEdgeConvCpu.h"
+#include "cpu/CCpuRuntime.h"
+#include "cpu/CGemmCpu.h"
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+// The edge rows of a tile. (kTileRows x 2D floats per worker)
+constexpr unsigned kTileRows = 128;
+
+}
+
+void CEdgeConvCpu::EdgeConv(
+    const float *ptrInput,
+    const unsigned *ptrIndices,
+    const float *ptrWeight,
+    const float *ptrBias,
+    float *ptrOutput,
+    unsigned batchSize,
+    unsigned pointCount,
+    unsigned dim,
+    unsigned k,
+    unsigned chOut,
+    unsigned threadCount) {
+  if(threadCount==0) threadCount = CCpuRuntime::GetDefaultThreadCount();
+
+  const unsigned N = pointCount, D = dim, D2 = 2*dim, K = k;
+  const size_t rowCount = (size_t)batchSize*N*K;
+  const unsigned taskCount = (unsigned)((rowCount+kTileRows-1)/kTileRows);
+  if(taskCount==0) return;
+
+  const unsigned workers = std::max(1u, std::min(taskCount, threadCount));
+  std::vector<std::vector<float>> tiles(workers, std::vector<float>((size_t)kTileRows*D2));
+
+  CCpuRuntime::ParallelFor(taskCount, workers, [&](unsigned task, unsigned worker){
+    const size_t row0 = (size_t)task*kTileRows;
+    const unsigned rows = (unsigned)std::min<size_t>(kTileRows, rowCount-row0);
+    float *ptrTile = tiles[worker].data();
+
+    // The edge features of the rows [row0, row0+rows), row = (b*N + n)*K + kk.
+    for(unsigned r=0; r<rows; r++){
+      const size_t row = row0+r;
+      const size_t bn = row/K;
+      const size_t b = bn/N;
+      const float *ptrCentral = ptrInput + bn*D;
+      const float *ptrNeighbor = ptrInput + (b*N + ptrIndices[row])*D;
+      float *ptrEdge = ptrTile + (size_t)r*D2;
+      for(unsigned d=0; d<D; d++){
+        ptrEdge[d] = ptrCentral[d];
+        ptrEdge[D+d] = ptrNeighbor[d] - ptrCentral[d];
+      }
+    }
+
+    CGemmCpu::Gemm(ptrTile, ptrWeight, ptrOutput + row0*chOut, 1, rows, D2, chOut, ptrBias, 1);
+  });
+}
@@ -0,0 +1,316 @@
+#include "cpu/CGemmCpu.h"
+#include "cpu/CCpuRuntime.h"
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define GEMM_CPU_X86
+#endif
+
+namespace {
+
+// MR must be the same for all of the micro-kernels as the packing of A depends on it.
+constexpr unsigned kMR = 6;
+// The rows of A handled by a single task, should be a multiple of kMR. (kBlockM x kBlockK floats of packed A fit in L2)
+constexpr unsigned kBlockM = 72;
+// The depth of the packed panels. (kBlockK x NR floats of packed B fit in L1)
+constexpr unsigned kBlockK = 256;
+// Below this many MACs, the threads cost more than they save.
+constexpr size_t kMinMacsPerThread = 1u<<18;
+
+// bias, if not null, points to NR values to be added to every row of the tile on the write-back.
+typedef void (*MicroKernel)(unsigned kc, const float *a, const float *b, float *c, unsigned ldc, bool accumulate, const float *bias);
+
+struct AlignedFree{
+  void operator()(float *ptr) const { free(ptr); }
+};
+typedef std::unique_ptr<float[], AlignedFree> AlignedBuff;
+
+AlignedBuff AllocateAligned(size_t len){
+  void *ptr = nullptr;
+  if(posix_memalign(&ptr, 64, std::max<size_t>(len,1)*sizeof(float)) != 0){
+    throw std::bad_alloc();
+  }
+  return AlignedBuff(static_cast<float*>(ptr));
+}
+
+void MicroKernelScalar(unsigned kc, const float *a, const float *b, float *c, unsigned ldc, bool accumulate, const float *bias){
+  constexpr unsigned NR = 8;
+  float acc[kMR][NR] = {};
+  for(unsigned p=0; p<kc; p++){
+    for(unsigned i=0; i<kMR; i++){
+      const float ai = a[i];
+      for(unsigned j=0; j<NR; j++){
+        acc[i][j] += ai * b[j];
+      }
+    }
+    a += kMR;
+    b += NR;
+  }
+  for(unsigned i=0; i<kMR; i++){
+    for(unsigned j=0; j<NR; j++){
+      float val = accumulate ? c[i*ldc+j]+acc[i][j] : acc[i][j];
+      c[i*ldc+j] = bias ? val+bias[j] : val;
+    }
+  }
+}
+
+#ifdef GEMM_CPU_X86
+__attribute__((target("avx2,fma")))
+void MicroKernelAvx2(unsigned kc, const float *a, const float *b, float *c, unsigned ldc, bool accumulate, const float *bias){
+  constexpr unsigned NR = 16;
+  __m256 acc[kMR][2];
+  for(unsigned i=0; i<kMR; i++){
+    acc[i][0] = _mm256_setzero_ps();
+    acc[i][1] = _mm256_setzero_ps();
+  }
+  for(unsigned p=0; p<kc; p++){
+    const __m256 b0 = _mm256_load_ps(b);
+    const __m256 b1 = _mm256_load_ps(b+8);
+    for(unsigned i=0; i<kMR; i++){
+      const __m256 ai = _mm256_broadcast_ss(a+i);
+      acc[i][0] = _mm256_fmadd_ps(ai, b0, acc[i][0]);
+      acc[i][1] = _mm256_fmadd_ps(ai, b1, acc[i][1]);
+    }
+    a += kMR;
+    b += NR;
+  }
+  const __m256 bias0 = bias ? _mm256_loadu_ps(bias) : _mm256_setzero_ps();
+  const __m256 bias1 = bias ? _mm256_loadu_ps(bias+8) : _mm256_setzero_ps();
+  for(unsigned i=0; i<kMR; i++){
+    float *ci = c + i*ldc;
+    if(accumulate){
+      acc[i][0] = _mm256_add_ps(acc[i][0], _mm256_loadu_ps(ci));
+      acc[i][1] = _mm256_add_ps(acc[i][1], _mm256_loadu_ps(ci+8));
+    }
+    if(bias){
+      acc[i][0] = _mm256_add_ps(acc[i][0], bias0);
+      acc[i][1] = _mm256_add_ps(acc[i][1], bias1);
+    }
+    _mm256_storeu_ps(ci, acc[i][0]);
+    _mm256_storeu_ps(ci+8, acc[i][1]);
+  }
+}
+
+__attribute__((target("avx512f")))
+void MicroKernelAvx512(unsigned kc, const float *a, const float *b, float *c, unsigned ldc, bool accumulate, const float *bias){
+  constexpr unsigned NR = 32;
+  __m512 acc[kMR][2];
+  for(unsigned i=0; i<kMR; i++){
+    acc[i][0] = _mm512_setzero_ps();
+    acc[i][1] = _mm512_setzero_ps();
+  }
+  for(unsigned p=0; p<kc; p++){
+    const __m512 b0 = _mm512_load_ps(b);
+    const __m512 b1 = _mm512_load_ps(b+16);
+    for(unsigned i=0; i<kMR; i++){
+      const __m512 ai = _mm512_set1_ps(a[i]);
+      acc[i][0] = _mm512_fmadd_ps(ai, b0, acc[i][0]);
+      acc[i][1] = _mm512_fmadd_ps(ai, b1, acc[i][1]);
+    }
+    a += kMR;
+    b += NR;
+  }
+  const __m512 bias0 = bias ? _mm512_loadu_ps(bias) : _mm512_setzero_ps();
+  const __m512 bias1 = bias ? _mm512_loadu_ps(bias+16) : _mm512_setzero_ps();
+  for(unsigned i=0; i<kMR; i++){
+    float *ci = c + i*ldc;
+    if(accumulate){
+      acc[i][0] = _mm512_add_ps(acc[i][0], _mm512_loadu_ps(ci));
+      acc[i][1] = _mm512_add_ps(acc[i][1], _mm512_loadu_ps(ci+16));
+    }
+    if(bias){
+      acc[i][0] = _mm512_add_ps(acc[i][0], bias0);
+      acc[i][1] = _mm512_add_ps(acc[i][1], bias1);
+    }
+    _mm512_storeu_ps(ci, acc[i][0]);
+    _mm512_storeu_ps(ci+16, acc[i][1]);
+  }
+}
+#endif
+
+/**
+ * @brief      Packs B (sizeK x sizeN, row-major) into panels of NR columns, zero-padded on the last panel.
+ * Layout: [panel][k][NR], so that any kBlockK slice of a panel is contiguous.
+ */
+template <unsigned NR>
+void PackPanelB(const float *ptrB, float *ptrPacked, unsigned sizeK, unsigned sizeN, unsigned panel){
+  const unsigned j0 = panel*NR;
+  const unsigned nr = std::min(NR, sizeN-j0);
+  float *dst = ptrPacked + (size_t)panel*sizeK*NR;
+  for(unsigned k=0; k<sizeK; k++){
+    const float *src = ptrB + (size_t)k*sizeN + j0;
+    unsigned j=0;
+    for(; j<nr; j++) dst[j] = src[j];
+    for(; j<NR; j++) dst[j] = 0;
+    dst += NR;
+  }
+}
+
+/**
+ * @brief      Packs the mc x kc block of A starting at (i0,k0) into micro-panels of kMR rows, zero-padded.
+ * Layout: [micro-panel][k][kMR]
+ */
+void PackBlockA(const float *ptrA, float *ptrPacked, unsigned sizeK, unsigned i0, unsigned mc, unsigned k0, unsigned kc){
+  for(unsigned r0=0; r0<mc; r0+=kMR){
+    const unsigned mr = std::min(kMR, mc-r0);
+    for(unsigned k=0; k<kc; k++){
+      unsigned r=0;
+      for(; r<mr; r++) ptrPacked[r] = ptrA[(size_t)(i0+r0+r)*sizeK + k0+k];
+      for(; r<kMR; r++) ptrPacked[r] = 0;
+      ptrPacked += kMR;
+    }
+  }
+}
+
+template <unsigned NR>
+void GemmBlocked(
+    MicroKernel kernel,
+    const float *ptrA,
+    const float *ptrB,
+    float *ptrC,
+    unsigned batchSize,
+    unsigned sizeM,
+    unsigned sizeK,
+    unsigned sizeN,
+    const float *ptrBias,
+    unsigned threadCount){
+
+  const unsigned panelsN = (sizeN+NR-1)/NR;
+  const unsigned blocksM = (sizeM+kBlockM-1)/kBlockM;
+  const size_t packedLenB = (size_t)panelsN*sizeK*NR;
+
+  const size_t macs = (size_t)batchSize*sizeM*sizeN*sizeK;
+  threadCount = (unsigned)std::max<size_t>(1, std::min<size_t>(threadCount, macs/kMinMacsPerThread));
+
+  // 1. Packing all of the B panels of all of the batches.
+  AlignedBuff packedB = AllocateAligned(packedLenB*batchSize);
+  CCpuRuntime::ParallelFor(batchSize*panelsN, threadCount, [&](unsigned task, unsigned){
+    const unsigned b = task/panelsN;
+    const unsigned panel = task%panelsN;
+    PackPanelB<NR>(ptrB+(size_t)b*sizeK*sizeN, packedB.get()+b*packedLenB, sizeK, sizeN, panel);
+  });
+
+  // 2. The tasks are (batch, row-tile) pairs. Each worker owns a buffer for the packed A block.
+  std::vector<AlignedBuff> packedA;
+  const unsigned workers = std::max(1u, std::min(batchSize*blocksM, threadCount));
+  for(unsigned w=0; w<workers; w++){
+    packedA.push_back(AllocateAligned((size_t)kBlockM*kBlockK));
+  }
+
+  CCpuRuntime::ParallelFor(batchSize*blocksM, workers, [&](unsigned task, unsigned worker){
+    const unsigned b = task/blocksM;
+    const unsigned i0 = (task%blocksM)*kBlockM;
+    const unsigned mc = std::min(kBlockM, sizeM-i0);
+    const float *ptrBatchA = ptrA + (size_t)b*sizeM*sizeK;
+    const float *ptrBatchPackedB = packedB.get() + b*packedLenB;
+    float *ptrBatchC = ptrC + (size_t)b*sizeM*sizeN;
+    float *ptrPackedA = packedA[worker].get();
+    alignas(64) float tmpTile[kMR*NR];
+
+    if(sizeK==0){
+      for(unsigned i=i0; i<i0+mc; i++){
+        for(unsigned j=0; j<sizeN; j++) ptrBatchC[(size_t)i*sizeN+j] = ptrBias ? ptrBias[j] : 0.0f;
+      }
+      return;
+    }
+
+    for(unsigned k0=0; k0<sizeK; k0+=kBlockK){
+      const unsigned kc = std::min(kBlockK, sizeK-k0);
+      const bool accumulate = k0!=0;
+      // The bias is fused into the write-back of the last depth block.
+      const bool addBias = ptrBias && k0+kc==sizeK;
+      PackBlockA(ptrBatchA, ptrPackedA, sizeK, i0, mc, k0, kc);
+
+      for(unsigned panel=0; panel<panelsN; panel++){
+        const unsigned j0 = panel*NR;
+        const unsigned nr = std::min(NR, sizeN-j0);
+        const float *ptrPanelB = ptrBatchPackedB + (size_t)panel*sizeK*NR + (size_t)k0*NR;
+
+        for(unsigned r0=0; r0<mc; r0+=kMR){
+          const unsigned mr = std::min(kMR, mc-r0);
+          const float *ptrMicroA = ptrPackedA + (size_t)r0*kc;
+          float *ptrTileC = ptrBatchC + (size_t)(i0+r0)*sizeN + j0;
+
+          if(mr==kMR && nr==NR){
+            kernel(kc, ptrMicroA, ptrPanelB, ptrTileC, sizeN, accumulate, addBias ? ptrBias+j0 : nullptr);
+          }else{
+            // Edge tile: compute the full tile into a scratch buffer and write back the valid part only.
+            kernel(kc, ptrMicroA, ptrPanelB, tmpTile, NR, false, nullptr);
+            for(unsigned i=0; i<mr; i++){
+              for(unsigned j=0; j<nr; j++){
+                float &dst = ptrTileC[(size_t)i*sizeN+j];
+                float val = accumulate ? dst+tmpTile[i*NR+j] : tmpTile[i*NR+j];
+                dst = addBias ? val+ptrBias[j0+j] : val;
+              }
+            }
+          }
+        }
+      }
+    }
+  });
+}
+
+}
+
+void CGemmCpu::Gemm(
+    const float *ptrA,
+    const float *ptrB,
+    float *ptrC,
+    unsigned batchSize,
+    unsigned sizeM,
+    unsigned sizeK,
+    unsigned sizeN,
+    const float *ptrBias,
+    unsigned threadCount) {
+  if(batchSize==0 || sizeM==0 || sizeN==0) return;
+  if(threadCount==0) threadCount = CCpuRuntime::GetDefaultThreadCount();
+
+  switch(CCpuRuntime::GetIsa()){
+#ifdef GEMM_CPU_X86
+    case CCpuRuntime::ISA::AVX512:
+      GemmBlocked<32>(MicroKernelAvx512, ptrA, ptrB, ptrC, batchSize, sizeM, sizeK, sizeN, ptrBias, threadCount);
+      break;
+    case CCpuRuntime::ISA::AVX2:
+      GemmBlocked<16>(MicroKernelAvx2, ptrA, ptrB, ptrC, batchSize, sizeM, sizeK, sizeN, ptrBias, threadCount);
+      break;
+#endif
+    default:
+      GemmBlocked<8>(MicroKernelScalar, ptrA, ptrB, ptrC, batchSize, sizeM, sizeK, sizeN, ptrBias, threadCount);
+      break;
+  }
+}
+
+void CGemmCpu::GemmNaive(
+    const float *ptrA,
+    const float *ptrB,
+    float *ptrC,
+    unsigned batchSize,
+    unsigned sizeM,
+    unsigned sizeK,
+    unsigned sizeN,
+    const float *ptrBias) {
+  size_t indxS1,indxS2,indxD;
+  for(unsigned b=0;b<batchSize;b++) {
+    // for element of output of sizeM x sizeN
+    for(unsigned j=0;j<sizeM;j++){
+      for(unsigned i=0;i<sizeN;i++){
+        //mat1: select row j
+        //mat2: select col i
+        float sum=0;
+        for(unsigned mat1_x=0;mat1_x<sizeK;mat1_x++)
+        {
+          indxS1 = b*sizeM*sizeK + j*sizeK + mat1_x;
+          indxS2 = b*sizeK*sizeN + mat1_x*sizeN + i;
+          sum += ptrA[indxS1] * ptrB[indxS2];
+        }
+        indxD = b*sizeM*sizeN + j*sizeN + i;
+        ptrC[indxD] = ptrBias ? sum + ptrBias[i] : sum;
+      }
+    }
+  }
+}
@@ -0,0 +1,116 @@
+#define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+
+#include "cpu/CHostMemoryPool.h"
+#include <cstdlib>
+
+CHostMemoryPool& CHostMemoryPool::GetInstance() {
+  // Never destroyed, the static tensors could be released after the other static objects.
+  static CHostMemoryPool *instance = new CHostMemoryPool();
+  return *instance;
+}
+
+void* CHostMemoryPool::Allocate(size_t sizeBytes) {
+  const size_t sizeClass = CMemoryPoolStats::GetSizeClass(sizeBytes);
+  {
+    std::lock_guard<std::mutex> lock(m_oMutex);
+    auto it = m_mFreeLists.find(sizeClass);
+    if(m_bEnabled && it!=m_mFreeLists.end() && !it->second.empty()){
+      void *ptr = it->second.back().ptr;
+      it->second.pop_back();
+      m_oStats.OnAcquire(sizeClass, true);
+      return ptr;
+    }
+    m_oStats.OnAcquire(sizeClass, false);
+  }
+  void *ptr = nullptr;
+  if (posix_memalign(&ptr, 4096, sizeClass))
+    ThrowException("Failed to allocate aligned memory (bad_alloc())!");
+  return ptr;
+}
+
+void CHostMemoryPool::Release(void *ptr, size_t sizeBytes) {
+  const size_t sizeClass = CMemoryPoolStats::GetSizeClass(sizeBytes);
+  std::vector<void*> evicted;
+  {
+    std::lock_guard<std::mutex> lock(m_oMutex);
+    const bool isCached = m_bEnabled && sizeClass<=m_uMaxCachedBytes;
+    m_oStats.OnRelease(sizeClass, isCached);
+    if(isCached){
+      m_mFreeLists[sizeClass].push_back({ptr, m_uReleaseTick++});
+      EvictOverCap(evicted);
+    }else{
+      evicted.push_back(ptr);
+    }
+  }
+  for(void *evictedPtr:evicted){
+    free(evictedPtr);
+  }
+}
+
+void CHostMemoryPool::EvictOverCap(std::vector<void*> &evicted) {
+  while(m_oStats.GetBytesCached()>m_uMaxCachedBytes){
+    auto oldest = m_mFreeLists.end();
+    for(auto it=m_mFreeLists.begin(); it!=m_mFreeLists.end(); it++){
+      if(it->second.empty()) continue;
+      if(oldest==m_mFreeLists.end() || it->second.front().releaseTick<oldest->second.front().releaseTick) oldest = it;
+    }
+    if(oldest==m_mFreeLists.end()) break;
+    evicted.push_back(oldest->second.front().ptr);
+    oldest->second.erase(oldest->second.begin());
+    m_oStats.OnEvict(oldest->first);
+  }
+}
+
+void CHostMemoryPool::Trim() {
+  std::lock_guard<std::mutex> lock(m_oMutex);
+  for(auto &freeList:m_mFreeLists){
+    for(auto &cachedBuffer:freeList.second){
+      free(cachedBuffer.ptr);
+      m_oStats.OnTrim(freeList.first);
+    }
+  }
+  m_mFreeLists.clear();
+}
+
+void CHostMemoryPool::SetMaxCachedBytes(size_t maxCachedBytes) {
+  std::vector<void*> evicted;
+  {
+    std::lock_guard<std::mutex> lock(m_oMutex);
+    m_uMaxCachedBytes = maxCachedBytes;
+    EvictOverCap(evicted);
+  }
+  for(void *evictedPtr:evicted){
+    free(evictedPtr);
+  }
+}
+
+size_t CHostMemoryPool::GetMaxCachedBytes() const {
+  std::lock_guard<std::mutex> lock(m_oMutex);
+  return m_uMaxCachedBytes;
+}
+
+size_t CHostMemoryPool::GetCachedBytes() const {
+  std::lock_guard<std::mutex> lock(m_oMutex);
+  return m_oStats.GetBytesCached();
+}
+
+void CHostMemoryPool::SetEnabled(bool enabled) {
+  if(!enabled) Trim();
+  std::lock_guard<std::mutex> lock(m_oMutex);
+  m_bEnabled = enabled;
+}
+
+bool CHostMemoryPool::IsEnabled() const {
+  std::lock_guard<std::mutex> lock(m_oMutex);
+  return m_bEnabled;
+}
+
+void CHostMemoryPool::ReportStats() const {
+  std::lock_guard<std::mutex> lock(m_oMutex);
+  m_oStats.Report("Host Memory Pool");
+}
+
+void CHostMemoryPool::ResetStats() {
+  std::lock_guard<std::mutex> lock(m_oMutex);
+  m_oStats.ResetCounters();
+}
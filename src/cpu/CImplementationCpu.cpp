@@ -1,11 +1,56 @@
 #define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
 
 #include "cpu/CImplementationCpu.h"
+#include "cpu/CGemmCpu.h"
+#include "cpu/CCpuRuntime.h"
+#include "cpu/CTopKCpu.h"
+#include "cpu/CKnnCpu.h"
+#include "cpu/CEdgeConvCpu.h"
+
+namespace {
+
+// The minimum number of the elements that are worth a task of the parallel-for.
+constexpr size_t kElementsPerTask = 16*1024;
+
+// The number of the items (rows, output elements, ...) of elementsPerItem elements each, per task.
+size_t GetGrainSize(size_t elementsPerItem) {
+  return std::max<size_t>(1, kElementsPerTask/std::max<size_t>(1, elementsPerItem));
+}
+
+}
+
 CImplementationCpu::CImplementationCpu(CProfiler *profiler, bool enableTensorDumps) {
   m_ePlatform = PLATFORMS::CPU;
   m_ptrProfiler = profiler;
   m_bEnableTensorDumps = enableTensorDumps;
+  m_bUseNaiveKernels = globalCpuNaiveKernels;
+  m_ptrThreadPool = new CCpuThreadPool(globalCpuThreadCount);
+  CCpuRuntime::SetThreadPool(m_ptrThreadPool);
+  CHostMemoryPool::GetInstance().SetEnabled(globalMemoryPoolEnabled);
   ResetLayerIdCounter(100000);
+  SPDLOG_LOGGER_INFO(logger, "CImplementationCpu: kernels: {}, isa: {}, threads: {}",
+                     m_bUseNaiveKernels?"naive":"optimized", CCpuRuntime::GetIsaName(), m_ptrThreadPool->GetThreadCount());
+}
+CImplementationCpu::~CImplementationCpu() {
+  if(CCpuRuntime::GetThreadPool()==m_ptrThreadPool){
+    CCpuRuntime::SetThreadPool(nullptr);
+  }
+  delete(m_ptrThreadPool);
+}
+void CImplementationCpu::SetUseNaiveKernels(bool useNaiveKernels) {
+  m_bUseNaiveKernels = useNaiveKernels;
+}
+bool CImplementationCpu::GetUseNaiveKernels() const {
+  return m_bUseNaiveKernels;
+}
+unsigned CImplementationCpu::GetThreadCount() const {
+  return m_ptrThreadPool->GetThreadCount();
+}
+CTensorPtr<float> CImplementationCpu::CreateElementwiseResult(CTensorPtr<float> inputTn, bool inPlace) {
+  if(inPlace){
+    return inputTn;
+  }
+  return CTensorPtr<float>(new CTensor<float>(inputTn->GetShape()));
 }
 void CImplementationCpu::DumpToNumpyFile(std::string npyFileName, CTensorBasePtr inputTn, std::string npyDumpDir) {
   // The template member functions of a non-template class should be declared and defined in the header file ONLY.
@@ -43,9 +88,8 @@ CTensorBasePtr CImplementationCpu::Concat2(CTensorBasePtr inputTn1, CTensorBaseP
       GetPlatform(),
       GenerateLayerId(),
       __func__,
-      new CProfiler::DictShapePtr({{"shape1",inputTn1->GetShape()},{"shape2",inputTn2->GetShape()}}),
-      new CProfiler::DictIntPtr({{"concatAxis",concatAxis}}),
-      nullptr);
+      {{"shape1",inputTn1->GetShape()},{"shape2",inputTn2->GetShape()}},
+      {{"concatAxis",concatAxis}});
 
   ValidateTensorPlatforms({inputTn1,inputTn2}, PLATFORMS::CPU);
   ConditionCheck(inputTn1->GetRank()==inputTn2->GetRank(), "Input tensors are of unequal ranks.");
@@ -103,14 +147,15 @@ CTensorBasePtr CImplementationCpu::Concat2(CTensorBasePtr inputTn1, CTensorBaseP
     }
 
     rsltTn = CTensorPtr<float>(new CTensor<float>({dimR0,dimR1,dimR2,dimR3}));
-    size_t indxS1, indxS2, indxD;
-
     float *ptrBuffInputTn1 = pInputTn1->Get();
     float *ptrBuffInputTn2 = pInputTn2->Get();
     float *ptrBuffRsltTn = rsltTn->Get();
 
-    for (unsigned d0 = 0; d0 < dimA0; d0++) {
-      for (unsigned d1 = 0; d1 < dimA1; d1++) {
+    // Over the rows (d0, d1) of each input.
+    CCpuRuntime::ParallelForRange((size_t)dimA0*dimA1, GetGrainSize((size_t)dimA2*dimA3), [&](size_t begin, size_t end){
+      size_t indxS1, indxD;
+      for (size_t row = begin; row < end; row++) {
+        const unsigned d0 = row / dimA1, d1 = row % dimA1;
         for (unsigned d2 = 0; d2 < dimA2; d2++) {
           for (unsigned d3 = 0; d3 < dimA3; d3++) {
             indxS1 = d0 * dimA1 * dimA2 * dimA3 +
@@ -125,10 +170,12 @@ CTensorBasePtr CImplementationCpu::Concat2(CTensorBasePtr inputTn1, CTensorBaseP
           }
         }
       }
-    }
+    });
 
-    for (unsigned d0 = 0; d0 < dimB0; d0++) {
-      for (unsigned d1 = 0; d1 < dimB1; d1++) {
+    CCpuRuntime::ParallelForRange((size_t)dimB0*dimB1, GetGrainSize((size_t)dimB2*dimB3), [&](size_t begin, size_t end){
+      size_t indxS2, indxD;
+      for (size_t row = begin; row < end; row++) {
+        const unsigned d0 = row / dimB1, d1 = row % dimB1;
         for (unsigned d2 = 0; d2 < dimB2; d2++) {
           for (unsigned d3 = 0; d3 < dimB3; d3++) {
             indxS2 = d0 * dimB1 * dimB2 * dimB3 +
@@ -143,7 +190,7 @@ CTensorBasePtr CImplementationCpu::Concat2(CTensorBasePtr inputTn1, CTensorBaseP
           }
         }
       }
-    }
+    });
   }
   m_ptrProfiler->FinishLayer();
   return rsltTn;
@@ -153,9 +200,7 @@ CTensorBasePtr CImplementationCpu::MatMul(CTensorBasePtr inputTn1, CTensorBasePt
       GetPlatform(),
       GenerateLayerId(),
       __func__,
-      new CProfiler::DictShapePtr({{"shape1",inputTn1->GetShape()},{"shape2",inputTn2->GetShape()}}),
-      nullptr,
-      nullptr);
+      {{"shape1",inputTn1->GetShape()},{"shape2",inputTn2->GetShape()}});
 
   ValidateTensorPlatforms({inputTn1,inputTn2}, PLATFORMS::CPU);
 
@@ -178,29 +223,14 @@ CTensorBasePtr CImplementationCpu::MatMul(CTensorBasePtr inputTn1, CTensorBasePt
   ConditionCheck(shape1[0]==shape2[0], "Unequal shape1[0] and shape2[0].");
   CTensorPtr<float> rsltTn(new CTensor<float>({batchSize,matrixH1,matrixW2}));
 
-  size_t indxS1,indxS2,indxD;
   float *ptrBuffInputTn1 = pInputTn1->Get();
   float *ptrBuffInputTn2 = pInputTn2->Get();
   float *ptrBuffRsltTn = rsltTn->Get();
 
-  for(unsigned b=0;b<batchSize;b++) {
-    // for element of output of matrixH1 x matrixW2
-    for(unsigned j=0;j<matrixH1;j++){
-      for(unsigned i=0;i<matrixW2;i++){
-        //mat1: select row j
-        //mat2: select col i
-        float sum=0;
-        for(unsigned mat1_x=0;mat1_x<matrixW1;mat1_x++)
-        {
-          indxS1 = b*matrixH1*matrixW1 + j*matrixW1 + mat1_x;
-          indxS2 = b*matrixH2*matrixW2 + mat1_x*matrixW2 + i;
-          sum += ptrBuffInputTn1[indxS1] * ptrBuffInputTn2[indxS2];
-        }
-        // for element of output of matrixH1 x matrixW2
-        indxD = b*matrixH1*matrixW2 + j*matrixW2 + i;
-        ptrBuffRsltTn[indxD] = sum;
-      }
-    }
+  if(m_bUseNaiveKernels){
+    CGemmCpu::GemmNaive(ptrBuffInputTn1, ptrBuffInputTn2, ptrBuffRsltTn, batchSize, matrixH1, matrixW1, matrixW2);
+  }else{
+    CGemmCpu::Gemm(ptrBuffInputTn1, ptrBuffInputTn2, ptrBuffRsltTn, batchSize, matrixH1, matrixW1, matrixW2);
   }
 
   pInputTn1->SqueezeDimZeroTimesTry(diff);
@@ -210,78 +240,89 @@ CTensorBasePtr CImplementationCpu::MatMul(CTensorBasePtr inputTn1, CTensorBasePt
   return rsltTn;
 }
 CTensorBasePtr CImplementationCpu::ReLU(CTensorBasePtr inputTn) {
+  return ReLU(inputTn, false);
+}
+CTensorBasePtr CImplementationCpu::ReLU(CTensorBasePtr inputTn, bool inPlace) {
   m_ptrProfiler->StartLayer(
       GetPlatform(),
       GenerateLayerId(),
       __func__,
-      new CProfiler::DictShapePtr({{"shape",inputTn->GetShape()}}),
-      nullptr,
-      nullptr);
+      {{"shape",inputTn->GetShape()}});
   ValidateTensorPlatforms({inputTn}, PLATFORMS::CPU);
   ConditionCheck(inputTn->GetLen()!=0, "The input tensor is of length zero!");
   auto pInputTn = std::dynamic_pointer_cast<CTensor<float>>(inputTn);
-  CTensorPtr<float> rsltTn(new CTensor<float>(inputTn->GetShape()));
+  CTensorPtr<float> rsltTn = CreateElementwiseResult(pInputTn, inPlace);
   const size_t len = inputTn->GetLen();
   float *ptrBuffInputTn = pInputTn->Get();
   float *ptrBuffRsltTn = rsltTn->Get();
-  for(size_t i=0;i<len;i++){
-    ptrBuffRsltTn[i] = (ptrBuffInputTn[i]>0) ? ptrBuffInputTn[i] : 0;
-  }
+  CCpuRuntime::ParallelForRange(len, kElementsPerTask, [&](size_t begin, size_t end){
+    for(size_t i=begin;i<end;i++){
+      ptrBuffRsltTn[i] = (ptrBuffInputTn[i]>0) ? ptrBuffInputTn[i] : 0;
+    }
+  });
   m_ptrProfiler->FinishLayer();
   return rsltTn;
 }
 CTensorBasePtr CImplementationCpu::Sqrt(CTensorBasePtr inputTn) {
+  return Sqrt(inputTn, false);
+}
+CTensorBasePtr CImplementationCpu::Sqrt(CTensorBasePtr inputTn, bool inPlace) {
   m_ptrProfiler->StartLayer(
       GetPlatform(),
       GenerateLayerId(),
       __func__,
-      new CProfiler::DictShapePtr({{"shape",inputTn->GetShape()}}),
-      nullptr,
-      nullptr);
+      {{"shape",inputTn->GetShape()}});
   ValidateTensorPlatforms({inputTn}, PLATFORMS::CPU);
   ConditionCheck(inputTn->GetLen()!=0, "The input tensor is of length zero!");
   auto pInputTn = std::dynamic_pointer_cast<CTensor<float>>(inputTn);
-  CTensorPtr<float> rsltTn(new CTensor<float>(inputTn->GetShape()));
+  CTensorPtr<float> rsltTn = CreateElementwiseResult(pInputTn, inPlace);
   const size_t len = inputTn->GetLen();
   float *ptrBuffInputTn = pInputTn->Get();
   float *ptrBuffRsltTn = rsltTn->Get();
-  for(size_t i=0;i<len;i++){
-    ptrBuffRsltTn[i] = sqrt(ptrBuffInputTn[i]);
-  }
+  CCpuRuntime::ParallelForRange(len, kElementsPerTask, [&](size_t begin, size_t end){
+    for(size_t i=begin;i<end;i++){
+      ptrBuffRsltTn[i] = sqrt(ptrBuffInputTn[i]);
+    }
+  });
   m_ptrProfiler->FinishLayer();
   return rsltTn;
 }
 CTensorBasePtr CImplementationCpu::Square(CTensorBasePtr inputTn) {
+  return Square(inputTn, false);
+}
+CTensorBasePtr CImplementationCpu::Square(CTensorBasePtr inputTn, bool inPlace) {
   m_ptrProfiler->StartLayer(
       GetPlatform(),
       GenerateLayerId(),
       __func__,
-      new CProfiler::DictShapePtr({{"shape",inputTn->GetShape()}}),
-      nullptr,
-      nullptr);
+      {{"shape",inputTn->GetShape()}});
   ValidateTensorPlatforms({inputTn}, PLATFORMS::CPU);
   ConditionCheck(inputTn->GetLen()!=0, "The input tensor is of length zero!");
   auto pInputTn = std::dynamic_pointer_cast<CTensor<float>>(inputTn);
-  CTensorPtr<float> rsltTn(new CTensor<float>(inputTn->GetShape()));
+  CTensorPtr<float> rsltTn = CreateElementwiseResult(pInputTn, inPlace);
   const size_t len = inputTn->GetLen();
   float *ptrBuffInputTn = pInputTn->Get();
   float *ptrBuffRsltTn = rsltTn->Get();
-  for(size_t i=0;i<len;i++){
-    ptrBuffRsltTn[i] = (ptrBuffInputTn[i])*(ptrBuffInputTn[i]);
-  }
+  CCpuRuntime::ParallelForRange(len, kElementsPerTask, [&](size_t begin, size_t end){
+    for(size_t i=begin;i<end;i++){
+      ptrBuffRsltTn[i] = (ptrBuffInputTn[i])*(ptrBuffInputTn[i]);
+    }
+  });
   m_ptrProfiler->FinishLayer();
   return rsltTn;
 }
 CTensorBasePtr CImplementationCpu::BasicOps(CTensorBasePtr inputTn1, CTensorBasePtr inputTn2, BASIC_OPS mode) {
+  return BasicOps(inputTn1, inputTn2, mode, false);
+}
+CTensorBasePtr CImplementationCpu::BasicOps(CTensorBasePtr inputTn1, CTensorBasePtr inputTn2, BASIC_OPS mode, bool inPlace) {
   m_ptrProfiler->StartLayer(
       GetPlatform(),
       GenerateLayerId(),
       __func__,
-      new CProfiler::DictShapePtr({{"shape1",inputTn1->GetShape()},{"shape2",inputTn2->GetShape()}}),
-      new CProfiler::DictIntPtr({{
-                                     "mode",
-                                     mode==BASIC_OPS::ADD ? 0 : mode==BASIC_OPS::SUB ? 1 : mode==BASIC_OPS::MUL_ELEMENTWISE ? 2 : 3}}),
-      nullptr);
+      {{"shape1",inputTn1->GetShape()},{"shape2",inputTn2->GetShape()}},
+      {{
+        "mode",
+        mode==BASIC_OPS::ADD ? 0 : mode==BASIC_OPS::SUB ? 1 : mode==BASIC_OPS::MUL_ELEMENTWISE ? 2 : 3}});
   ValidateTensorPlatforms({inputTn1,inputTn2}, PLATFORMS::CPU);
   ConditionCheck(inputTn1->GetRank()>=inputTn2->GetRank(), "The first input tensor's rank cannot be smaller than the second's.");
   ConditionCheck(inputTn1->GetRank()>=1 && inputTn1->GetRank()<=4, "Bad inputTn1 tensor rank.");
@@ -289,9 +330,8 @@ CTensorBasePtr CImplementationCpu::BasicOps(CTensorBasePtr inputTn1, CTensorBase
   auto pInputTn1 = std::dynamic_pointer_cast<CTensor<float>>(inputTn1);
   auto pInputTn2 = std::dynamic_pointer_cast<CTensor<float>>(inputTn2);
   unsigned diff = pInputTn1->ExpandDimZeroToRank(4);
-  CTensorPtr<float> rsltTn(new CTensor<float>(pInputTn1->GetShape()));
+  CTensorPtr<float> rsltTn = CreateElementwiseResult(pInputTn1, inPlace);
   {
-    size_t indxS1, indxS2;
     unsigned dim0, dim1, dim2, dim3;
     unsigned dim0B, dim1B, dim2B, dim3B;
     int dim0B_IsNotZero, dim1B_IsNotZero, dim2B_IsNotZero, dim3B_IsNotZero;
@@ -348,53 +388,57 @@ CTensorBasePtr CImplementationCpu::BasicOps(CTensorBasePtr inputTn1, CTensorBase
     float *ptrBuffInputTn2 = pInputTn2->Get();
     float *ptrBuffRsltTn = rsltTn->Get();
 
-    for(unsigned d0=0;d0<dim0;d0++){
-      for(unsigned d1=0;d1<dim1;d1++) {
-        for(unsigned d2=0;d2<dim2;d2++) {
-          for(unsigned d3=0;d3<dim3;d3++) {
-            indxS1 = d0*dim1*dim2*dim3+
-                d1*dim2*dim3+
-                d2*dim3+
-                d3;
-            indxS2 = d0 * dim1B * dim2B * dim3B * dim0B_IsNotZero +
-                d1 * dim2B * dim3B * dim1B_IsNotZero +
-                d2 * dim3B * dim2B_IsNotZero +
-                d3 * dim3B_IsNotZero;
-
-            if(mode==BASIC_OPS::ADD)                      //Add
-              ptrBuffRsltTn[indxS1] = ptrBuffInputTn1[indxS1] + ptrBuffInputTn2[indxS2];
-            else if(mode==BASIC_OPS::SUB)                 //Sub
-              ptrBuffRsltTn[indxS1] = ptrBuffInputTn1[indxS1] - ptrBuffInputTn2[indxS2];
-            else if(mode==BASIC_OPS::MUL_ELEMENTWISE)     //Mul (element wise)
-              ptrBuffRsltTn[indxS1] = ptrBuffInputTn1[indxS1] * ptrBuffInputTn2[indxS2];
-            else if(mode==BASIC_OPS::DIV_ELEMENTWISE)     //Div (element wise)
-              ptrBuffRsltTn[indxS1] = ptrBuffInputTn1[indxS1] / ptrBuffInputTn2[indxS2];
-          }
+    // Over the rows (d0, d1, d2) of inputTn1.
+    CCpuRuntime::ParallelForRange((size_t)dim0*dim1*dim2, GetGrainSize(dim3), [&](size_t begin, size_t end){
+      size_t indxS1, indxS2;
+      for(size_t row=begin;row<end;row++){
+        const unsigned d0 = row/(dim1*dim2), d1 = (row/dim2)%dim1, d2 = row%dim2;
+        for(unsigned d3=0;d3<dim3;d3++) {
+          indxS1 = d0*dim1*dim2*dim3+
+              d1*dim2*dim3+
+              d2*dim3+
+              d3;
+          indxS2 = d0 * dim1B * dim2B * dim3B * dim0B_IsNotZero +
+              d1 * dim2B * dim3B * dim1B_IsNotZero +
+              d2 * dim3B * dim2B_IsNotZero +
+              d3 * dim3B_IsNotZero;
+
+          if(mode==BASIC_OPS::ADD)                      //Add
+            ptrBuffRsltTn[indxS1] = ptrBuffInputTn1[indxS1] + ptrBuffInputTn2[indxS2];
+          else if(mode==BASIC_OPS::SUB)                 //Sub
+            ptrBuffRsltTn[indxS1] = ptrBuffInputTn1[indxS1] - ptrBuffInputTn2[indxS2];
+          else if(mode==BASIC_OPS::MUL_ELEMENTWISE)     //Mul (element wise)
+            ptrBuffRsltTn[indxS1] = ptrBuffInputTn1[indxS1] * ptrBuffInputTn2[indxS2];
+          else if(mode==BASIC_OPS::DIV_ELEMENTWISE)     //Div (element wise)
+            ptrBuffRsltTn[indxS1] = ptrBuffInputTn1[indxS1] / ptrBuffInputTn2[indxS2];
         }
       }
-    }
+    });
 
   }
   
   pInputTn1->SqueezeDimZeroTimesTry(diff);
-  rsltTn->SqueezeDimZeroTimesTry(diff);
+  if(rsltTn!=pInputTn1) rsltTn->SqueezeDimZeroTimesTry(diff);
 
   m_ptrProfiler->FinishLayer();
   return rsltTn;
 }
 CTensorBasePtr CImplementationCpu::BasicOps(CTensorBasePtr inputTn1, float scalar, BASIC_OPS mode) {
+  return BasicOps(inputTn1, scalar, mode, false);
+}
+CTensorBasePtr CImplementationCpu::BasicOps(CTensorBasePtr inputTn1, float scalar, BASIC_OPS mode, bool inPlace) {
   m_ptrProfiler->StartLayer(
       GetPlatform(),
       GenerateLayerId(),
       __func__,
-      new CProfiler::DictShapePtr({{"shape",inputTn1->GetShape()}}),
-      nullptr,
-      new CProfiler::DictFloatPtr({{"scalar",scalar}}));
+      {{"shape",inputTn1->GetShape()}},
+      {},
+      {{"scalar",scalar}});
   ValidateTensorPlatforms({inputTn1}, PLATFORMS::CPU);
 
   // This method is used only in CPU impl.
   CTensorBasePtr tmpTn(new CTensor<float>({1}, &scalar));
-  auto rsltTn = BasicOps(inputTn1, tmpTn, mode);
+  auto rsltTn = BasicOps(inputTn1, tmpTn, mode, inPlace);
 
   m_ptrProfiler->FinishLayer();
   return rsltTn;
@@ -409,9 +453,8 @@ CTensorBasePtr CImplementationCpu::Tile(CTensorBasePtr inputTn, unsigned tileAxi
       GetPlatform(),
       GenerateLayerId(),
       __func__,
-      new CProfiler::DictShapePtr({{"shape",inputTn->GetShape()}}),
-      new CProfiler::DictIntPtr({{"tileAxis",tileAxis},{"tileCount",tileCount}}),
-      nullptr);
+      {{"shape",inputTn->GetShape()}},
+      {{"tileAxis",tileAxis},{"tileCount",tileCount}});
 
   ValidateTensorPlatforms({inputTn}, PLATFORMS::CPU);
 
@@ -419,7 +462,6 @@ CTensorBasePtr CImplementationCpu::Tile(CTensorBasePtr inputTn, unsigned tileAxi
   const unsigned rank = pInputTn->GetRank();
   auto shape = pInputTn->GetShape();
   CTensorPtr<float> rsltTn;
-  size_t indxS1, indxD;
   float *ptrBuffInputTn = pInputTn->Get();
 
   if(rank==3 && tileAxis==2) {
@@ -433,8 +475,10 @@ CTensorBasePtr CImplementationCpu::Tile(CTensorBasePtr inputTn, unsigned tileAxi
     rsltTn = CTensorPtr<float>(new CTensor<float>({B, N, K, D}));
     float *ptrBuffRsltTn = rsltTn->Get();
 
-    for (unsigned b = 0; b < B; b++) {
-      for (unsigned n = 0; n < N; n++) {
+    CCpuRuntime::ParallelForRange((size_t)B*N, GetGrainSize((size_t)K*D), [&](size_t begin, size_t end){
+      size_t indxS1, indxD;
+      for (size_t row = begin; row < end; row++) {
+        const unsigned b = row / N, n = row % N;
         indxS1 = b * N * D + n * D + 0; //beginning of dim2 of input
         for (unsigned k = 0; k < K; k++) {
           indxD = b * N * K * D + n * K * D + k * D + 0;
@@ -443,7 +487,7 @@ CTensorBasePtr CImplementationCpu::Tile(CTensorBasePtr inputTn, unsigned tileAxi
                     ptrBuffRsltTn + indxD);
         }
       }
-    }
+    });
 
   }
 
@@ -457,15 +501,17 @@ CTensorBasePtr CImplementationCpu::Tile(CTensorBasePtr inputTn, unsigned tileAxi
     rsltTn = CTensorPtr<float>(new CTensor<float>({B, N, K}));
     float *ptrBuffRsltTn = rsltTn->Get();
 
-    for (unsigned b = 0; b < B; b++) {
-      for (unsigned n = 0; n < N; n++) {
+    CCpuRuntime::ParallelForRange((size_t)B*N, GetGrainSize(K), [&](size_t begin, size_t end){
+      size_t indxS1, indxD;
+      for (size_t row = begin; row < end; row++) {
+        const unsigned b = row / N, n = row % N;
         indxS1 = b*N + n;
         for(unsigned k=0;k<K;k++){
           indxD = b*N*K + n*K + k;
           ptrBuffRsltTn[indxD] = ptrBuffInputTn[indxS1];
         }
       }
-    }
+    });
 
   }
 
@@ -479,15 +525,17 @@ CTensorBasePtr CImplementationCpu::Tile(CTensorBasePtr inputTn, unsigned tileAxi
     rsltTn = CTensorPtr<float>(new CTensor<float>({B, K, N}));
     float *ptrBuffRsltTn = rsltTn->Get();
 
-    for(unsigned b = 0; b < B; b++) {
-      for(unsigned k=0; k<K; k++){
+    CCpuRuntime::ParallelForRange((size_t)B*K, GetGrainSize(N), [&](size_t begin, size_t end){
+      size_t indxS1, indxD;
+      for(size_t row = begin; row < end; row++) {
+        const unsigned b = row / K, k = row % K;
         for(unsigned n = 0; n < N; n++) {
           indxD  = b*K*N + k*N + n;
           indxS1 = b*1*N + n;
           ptrBuffRsltTn[indxD] = ptrBuffInputTn[indxS1];
         }
       }
-    }
+    });
 
   }
 
@@ -499,9 +547,7 @@ CTensorBasePtr CImplementationCpu::Transpose(CTensorBasePtr inputTn) {
       GetPlatform(),
       GenerateLayerId(),
       __func__,
-      new CProfiler::DictShapePtr({{"shape",inputTn->GetShape()}}),
-      nullptr,
-      nullptr);
+      {{"shape",inputTn->GetShape()}});
 
   ValidateTensorPlatforms({inputTn}, PLATFORMS::CPU);
   ConditionCheck(inputTn->GetRank()==3 || inputTn->GetRank()==2, "Unsupported input tensor rank.");
@@ -512,19 +558,20 @@ CTensorBasePtr CImplementationCpu::Transpose(CTensorBasePtr inputTn) {
   auto dim1 = shape[1];
   auto dim2 = shape[2];
   CTensorPtr<float> rsltTn(new CTensor<float>({dim0, dim2, dim1}));
-  size_t indxS, indxD;
   float *ptrBuffInputTn = pInputTn->Get();
   float *ptrBuffRsltTn = rsltTn->Get();
 
-  for(unsigned b=0; b<dim0; b++){
-    for(unsigned j = 0; j < dim1; j++) {
+  CCpuRuntime::ParallelForRange((size_t)dim0*dim1, GetGrainSize(dim2), [&](size_t begin, size_t end){
+    size_t indxS, indxD;
+    for(size_t row = begin; row < end; row++) {
+      const unsigned b = row / dim1, j = row % dim1;
       for(unsigned i = 0; i < dim2 ; i++) {
         indxS = b * dim1 * dim2 + j * dim2 + i;
         indxD = b * dim1 * dim2 + i * dim1 + j;
         ptrBuffRsltTn[indxD] = ptrBuffInputTn[indxS];
       }
     }
-  }
+  });
 
   pInputTn->SqueezeDimZeroTimesTry(diff);
   ///TODO: Confirm that squeezing the output tensor is NOT required ?
@@ -536,9 +583,7 @@ CTensorBasePtr CImplementationCpu::Gather(CTensorBasePtr inputTn, CTensorBasePtr
       GetPlatform(),
       GenerateLayerId(),
       __func__,
-      new CProfiler::DictShapePtr({{"shape",inputTn->GetShape()}, {"shape.indices",indicesTn->GetShape()}}),
-      nullptr,
-      nullptr);
+      {{"shape",inputTn->GetShape()}, {"shape.indices",indicesTn->GetShape()}});
 
   ValidateTensorPlatforms({inputTn}, PLATFORMS::CPU);
   ConditionCheck(inputTn->GetRank()==3, "inputTn is required to be of rank 3.");
@@ -556,7 +601,6 @@ CTensorBasePtr CImplementationCpu::Gather(CTensorBasePtr inputTn, CTensorBasePtr
   //indices_axis  is considered to be 1 (the dimension that is equal to 'N')
 
   //Gather knn's indices from input array.
-  size_t indxS1, indxS2, indxD;
   auto shape = pInputTn->GetShape();
   unsigned
       B = shape[0],
@@ -568,8 +612,10 @@ CTensorBasePtr CImplementationCpu::Gather(CTensorBasePtr inputTn, CTensorBasePtr
   unsigned *ptrBuffIndicesTn = pIndices->Get();
   float *ptrBuffRsltTn = rsltTn->Get();
 
-  for(unsigned b=0;b<B;b++){
-    for(unsigned n=0;n<N;n++){
+  CCpuRuntime::ParallelForRange((size_t)B*N, GetGrainSize((size_t)K*D), [&](size_t begin, size_t end){
+    size_t indxS1, indxS2, indxD;
+    for(size_t row=begin;row<end;row++){
+      const unsigned b = row/N, n = row%N;
       for(unsigned k=0;k<K;k++){
         indxS1 = b*N*K + n*K + k;
         for(unsigned d=0;d<D;d++){
@@ -579,7 +625,7 @@ CTensorBasePtr CImplementationCpu::Gather(CTensorBasePtr inputTn, CTensorBasePtr
         }
       }
     }
-  }
+  });
 
   m_ptrProfiler->FinishLayer();
   return rsltTn;
@@ -592,20 +638,19 @@ CTensorBasePtr CImplementationCpu::Reduce(CTensorBasePtr inputTn,
       GetPlatform(),
       GenerateLayerId(),
       __func__,
-      new CProfiler::DictShapePtr({
-                                    {"shape",inputTn->GetShape()},
-                                    {"combination",combination}
-      }),
-      new CProfiler::DictIntPtr({
-                                    {"reduction_op",
-                                     mode==REDUCTION_OPS::SUM?0:
-                                     mode==REDUCTION_OPS::MAX?1:
-                                     -1
-                                    },
-                                    {"powY",powY},
-                                    {"rank",inputTn->GetRank()}
-                                }),
-      nullptr);
+      {
+        {"shape",inputTn->GetShape()},
+        {"combination",combination}
+      },
+      {
+        {"reduction_op",
+         mode==REDUCTION_OPS::SUM?0:
+         mode==REDUCTION_OPS::MAX?1:
+         -1
+        },
+        {"powY",powY},
+        {"rank",inputTn->GetRank()}
+      });
 
   ValidateTensorPlatforms({inputTn}, PLATFORMS::CPU);
   auto pInputTn = std::dynamic_pointer_cast<CTensor<float>>(inputTn);
@@ -624,73 +669,72 @@ CTensorBasePtr CImplementationCpu::Reduce(CTensorBasePtr inputTn,
   unsigned rank = pInputTn->GetRank();
   auto shape = pInputTn->GetShape();
   CTensorPtr<float> rsltTn;
-  size_t indxD, indxS;
   float *ptrBuffInputTn = pInputTn->Get();
 
   if(mode==REDUCTION_OPS::SUM && rank==3){
-    //rsltTn = CTensorPtr<float>(new CTensor<float>({B, N, K, D}));
-
     if(localComb[0]&&localComb[1]&&localComb[2]){ //TTT
       rsltTn = CTensorPtr<float>(new CTensor<float>({1}));
       float *ptrBuffRsltTn = rsltTn->Get();
+      const size_t limit = pInputTn->GetLen();
+
+      // The partial sums of the tasks are added in order, so the result does not depend on the thread count.
+      const unsigned taskCount = (unsigned)((limit+kElementsPerTask-1)/kElementsPerTask);
+      std::vector<float> partialSums(taskCount, 0);
+      CCpuRuntime::ParallelFor(taskCount, 0, [&](unsigned task, unsigned){
+        const size_t end = std::min(limit, (task+1)*kElementsPerTask);
+        float sum = 0;
+        for(size_t b=task*kElementsPerTask;b<end;b++) {
+          sum += ptrBuffInputTn[b];
+        }
+        partialSums[task] = sum;
+      });
       float sum = 0;
-      unsigned limit = pInputTn->GetLen();
-
-      for(unsigned b=0;b<limit;b++) {
-        sum += ptrBuffInputTn[b];
-      }
+      for(auto partialSum:partialSums) sum += partialSum;
       ptrBuffRsltTn[0] = sum;
     } else if(localComb[0]&&!localComb[1]&&!localComb[2]){ //TFF
       const unsigned dim0 = shape[0], dim1 = shape[1], dim2 = shape[2];
       rsltTn = CTensorPtr<float>(new CTensor<float>({dim1,dim2}));
       float *ptrBuffRsltTn = rsltTn->Get();
-      float sum=0;
 
-      for(unsigned d1=0; d1<dim1; d1++){
-        for(unsigned d2=0; d2<dim2; d2++){
-          sum=0;
-          indxD = d1 * dim2 + d2;
+      CCpuRuntime::ParallelForRange((size_t)dim1*dim2, GetGrainSize(dim0), [&](size_t begin, size_t end){
+        for(size_t indxD=begin; indxD<end; indxD++){
+          const unsigned d1 = indxD / dim2, d2 = indxD % dim2;
+          float sum=0;
           for(unsigned dx=0;dx<dim0;dx++){
-            indxS = dx * dim1*dim2 + d1 * dim2 + d2;
-            sum += ptrBuffInputTn[indxS] ;
+            sum += ptrBuffInputTn[(size_t)dx * dim1*dim2 + d1 * dim2 + d2];
           }
           ptrBuffRsltTn[indxD] = sum;
         }
-      }
+      });
     }else if(!localComb[0]&&localComb[1]&&!localComb[2]) { //FTF
       const unsigned dim0 = shape[0], dim1 = shape[1], dim2 = shape[2];
       rsltTn = CTensorPtr<float>(new CTensor<float>({dim0,dim2}));
       float *ptrBuffRsltTn = rsltTn->Get();
-      float sum=0;
 
-      for(unsigned d0=0; d0<dim0;d0++){
-        for(unsigned d2=0;d2<dim2;d2++){
-          sum=0;
-          indxD = d0 *dim2 + d2;
+      CCpuRuntime::ParallelForRange((size_t)dim0*dim2, GetGrainSize(dim1), [&](size_t begin, size_t end){
+        for(size_t indxD=begin; indxD<end; indxD++){
+          const unsigned d0 = indxD / dim2, d2 = indxD % dim2;
+          float sum=0;
           for(unsigned dx=0;dx<dim1;dx++){
-            indxS = d0 * dim1*dim2 + dx * dim2 + d2;
-            sum+=ptrBuffInputTn[indxS] ;
+            sum += ptrBuffInputTn[(size_t)d0 * dim1*dim2 + dx * dim2 + d2];
           }
           ptrBuffRsltTn[indxD] = sum;
         }
-      }
+      });
     }else if(!localComb[0]&&!localComb[1]&&localComb[2]) { //FFT
       const unsigned dim0 = shape[0], dim1 = shape[1], dim2 = shape[2];
       rsltTn = CTensorPtr<float>(new CTensor<float>({dim0,dim1}));
       float *ptrBuffRsltTn = rsltTn->Get();
-      float sum=0;
 
-      for(unsigned d0=0; d0<dim0;d0++){
-        for(unsigned d1=0;d1<dim1;d1++){
-          sum=0;
-          indxD = d0 * dim1 + d1;
+      CCpuRuntime::ParallelForRange((size_t)dim0*dim1, GetGrainSize(dim2), [&](size_t begin, size_t end){
+        for(size_t indxD=begin; indxD<end; indxD++){
+          float sum=0;
           for(unsigned dx=0;dx<dim2;dx++){
-            indxS = d0 * dim1*dim2 + d1 * dim2 + dx;
-            sum+=ptrBuffInputTn[indxS] ;
+            sum += ptrBuffInputTn[indxD * dim2 + dx];
           }
           ptrBuffRsltTn[indxD] = sum;
         }
-      }
+      });
     }else{
       ConditionCheck(false, "Unimplemented reduce sum 3 combination.");
     }
@@ -701,116 +745,98 @@ CTensorBasePtr CImplementationCpu::Reduce(CTensorBasePtr inputTn,
       rsltTn = CTensorPtr<float>(new CTensor<float>({dim3}));
       float *ptrBuffRsltTn = rsltTn->Get();
 
-      float sum = 0;
-      for (unsigned d3 = 0; d3 < dim3; d3++) {
-        sum = 0;
-        indxD = d3;
-        for (unsigned d0 = 0; d0 < dim0; d0++) {
-          for (unsigned d1 = 0; d1 < dim1; d1++) {
-            for (unsigned d2 = 0; d2 < dim2; d2++) {
-
-              indxS = d0 * dim1 * dim2 * dim3 +
-                  d1 * dim2 * dim3 +
-                  d2 * dim3 +
-                  d3;
-
-              sum += ptrBuffInputTn[indxS];
-            }
+      // Each task sums a block of the rows (d0, d1, d2) into its own partial vector (dim3), the partial vectors are
+      // added in order afterwards.
+      const size_t rows = (size_t)dim0*dim1*dim2;
+      const size_t rowsPerTask = GetGrainSize(dim3);
+      const unsigned taskCount = (unsigned)((rows+rowsPerTask-1)/rowsPerTask);
+      std::vector<float> partialSums((size_t)taskCount*dim3, 0);
+      CCpuRuntime::ParallelFor(taskCount, 0, [&](unsigned task, unsigned){
+        float *ptrPartial = partialSums.data() + (size_t)task*dim3;
+        const size_t end = std::min(rows, (task+1)*rowsPerTask);
+        for(size_t row=task*rowsPerTask; row<end; row++){
+          const float *ptrRow = ptrBuffInputTn + row*dim3;
+          for(unsigned d3 = 0; d3 < dim3; d3++){
+            ptrPartial[d3] += ptrRow[d3];
           }
         }
-        ptrBuffRsltTn[indxD] = sum;
+      });
+      for (unsigned d3 = 0; d3 < dim3; d3++) {
+        float sum = 0;
+        for(unsigned task=0; task<taskCount; task++){
+          sum += partialSums[(size_t)task*dim3+d3];
+        }
+        ptrBuffRsltTn[d3] = sum;
       }
     }else{
       ConditionCheck(false, "Unimplemented reduce sum 4 combination.");
     }
   }else if(mode==REDUCTION_OPS::MAX && rank==4){
+    const float max_cte= -std::numeric_limits<float>::max();
+
     // Max4 FTFF
     if(!localComb[0] && !localComb[1] && !localComb[2] && localComb[3]){ //over dim 3
       const unsigned dim0 = shape[0], dim1 = shape[1], dim2 = shape[2], dim3 = shape[3];
       rsltTn = CTensorPtr<float>(new CTensor<float>({dim0, dim1, dim2}));
       float *ptrBuffRsltTn = rsltTn->Get();
 
-      const float max_cte= -std::numeric_limits<float>::max();
-      float max= -std::numeric_limits<float>::max();
-
-      for(unsigned d0=0;d0<dim0;d0++){
-        for(unsigned d1=0;d1<dim1;d1++){
-          for(unsigned d2=0;d2<dim2;d2++){
-            indxD = d0*dim1*dim2+
-                d1*dim2+
-                d2;
-            max = max_cte;
-            for(unsigned d3=0;d3<dim3;d3++){
-              indxS = d0*dim1*dim2*dim3+
-                  d1*dim2*dim3+
-                  d2*dim3+
-                  d3;
-              if(max<ptrBuffInputTn[indxS]){
-                max = ptrBuffInputTn[indxS];
-              }
+      CCpuRuntime::ParallelForRange((size_t)dim0*dim1*dim2, GetGrainSize(dim3), [&](size_t begin, size_t end){
+        for(size_t indxD=begin; indxD<end; indxD++){
+          float max = max_cte;
+          for(unsigned d3=0;d3<dim3;d3++){
+            const float val = ptrBuffInputTn[indxD*dim3+d3];
+            if(max<val){
+              max = val;
             }
-            ptrBuffRsltTn[indxD]=max;
           }
+          ptrBuffRsltTn[indxD]=max;
         }
-      }
+      });
     }else if(!localComb[0] && !localComb[1] && localComb[2] && !localComb[3]) { //over dim 2
       const unsigned dim0 = shape[0], dim1 = shape[1], dim2 = shape[2], dim3 = shape[3];
       rsltTn = CTensorPtr<float>(new CTensor<float>({dim0, dim1, dim3}));
       float *ptrBuffRsltTn = rsltTn->Get();
 
-      const float max_cte= -std::numeric_limits<float>::max();
-      float max= 0;
-
-      for(unsigned d0=0;d0<dim0;d0++){
-        for(unsigned d1=0;d1<dim1;d1++){
+      // Over the rows (d0, d1), the max of the dim2 slices of each row is taken along dim3.
+      CCpuRuntime::ParallelForRange((size_t)dim0*dim1, GetGrainSize((size_t)dim2*dim3), [&](size_t begin, size_t end){
+        for(size_t row=begin; row<end; row++){
+          float *ptrDst = ptrBuffRsltTn + row*dim3;
+          const float *ptrSrc = ptrBuffInputTn + row*dim2*dim3;
           for(unsigned d3=0;d3<dim3;d3++){
-            indxD = d0*dim1*dim3+
-                d1*dim3+
-                d3;
-            max = max_cte;
-
-            for(unsigned d2=0;d2<dim2;d2++){
-              indxS = d0*dim1*dim2*dim3+
-                  d1*dim2*dim3+
-                  d2*dim3+
-                  d3;
-              if(max<ptrBuffInputTn[indxS]){
-                max = ptrBuffInputTn[indxS];
+            ptrDst[d3] = max_cte;
+          }
+          for(unsigned d2=0;d2<dim2;d2++){
+            for(unsigned d3=0;d3<dim3;d3++){
+              if(ptrDst[d3]<ptrSrc[(size_t)d2*dim3+d3]){
+                ptrDst[d3] = ptrSrc[(size_t)d2*dim3+d3];
               }
             }
-            ptrBuffRsltTn[indxD]=max;
           }
         }
-      }
+      });
     }else if(!localComb[0] && localComb[1] && !localComb[2] && !localComb[3]) { //over dim 1
       const unsigned dim0 = shape[0], dim1 = shape[1], dim2 = shape[2], dim3 = shape[3];
       rsltTn = CTensorPtr<float>(new CTensor<float>({dim0, dim2, dim3}));
       float *ptrBuffRsltTn = rsltTn->Get();
 
-      const float max_cte= -std::numeric_limits<float>::max();
-      float max= 0;
-
-      for(unsigned d0=0;d0<dim0;d0++){
-        for(unsigned d2=0;d2<dim2;d2++){
+      // Over the rows (d0, d2) of the output.
+      CCpuRuntime::ParallelForRange((size_t)dim0*dim2, GetGrainSize((size_t)dim1*dim3), [&](size_t begin, size_t end){
+        for(size_t row=begin; row<end; row++){
+          const unsigned d0 = row / dim2, d2 = row % dim2;
+          float *ptrDst = ptrBuffRsltTn + row*dim3;
           for(unsigned d3=0;d3<dim3;d3++){
-            indxD = d0*dim2*dim3+
-                d2*dim3+
-                d3;
-            max = max_cte;
-
-            for(unsigned d1=0;d1<dim1;d1++){
-              indxS = d0*dim1*dim2*dim3+
-                  d1*dim2*dim3+
-                  d2*dim3+
-                  d3;
-              if(max<ptrBuffInputTn[indxS]){
-                max = ptrBuffInputTn[indxS];
+            ptrDst[d3] = max_cte;
+          }
+          for(unsigned d1=0;d1<dim1;d1++){
+            const float *ptrSrc = ptrBuffInputTn + (size_t)d0*dim1*dim2*dim3 + (size_t)d1*dim2*dim3 + (size_t)d2*dim3;
+            for(unsigned d3=0;d3<dim3;d3++){
+              if(ptrDst[d3]<ptrSrc[d3]){
+                ptrDst[d3] = ptrSrc[d3];
               }
             }
-            ptrBuffRsltTn[indxD]=max;
           }
         }
-      }
+      });
     }else{
       ConditionCheck(false, "Unimplemented reduce max 4 combination.");
     }
@@ -830,14 +856,13 @@ CTensorBasePtr CImplementationCpu::Mean(CTensorBasePtr inputTn,
       GetPlatform(),
       GenerateLayerId(),
       __func__,
-      new CProfiler::DictShapePtr({
-                                    {"shape",inputTn->GetShape()},
-                                    {"combination",combination},
-                                }),
-      new CProfiler::DictIntPtr({
-                                    {"rank",inputTn->GetRank()}
-                                }),
-      nullptr);
+      {
+        {"shape",inputTn->GetShape()},
+        {"combination",combination},
+      },
+      {
+        {"rank",inputTn->GetRank()}
+      });
 
   ValidateTensorPlatforms({inputTn}, PLATFORMS::CPU);
   auto pInputTn = std::dynamic_pointer_cast<CTensor<float>>(inputTn);
@@ -895,14 +920,13 @@ CTensorBasePtr CImplementationCpu::Variance(CTensorBasePtr inputTn,
       GetPlatform(),
       GenerateLayerId(),
       __func__,
-      new CProfiler::DictShapePtr({
-                                    {"shape",inputTn->GetShape()},
-                                    {"combination",combination}
-                                }),
-      new CProfiler::DictIntPtr({
-                                    {"rank",inputTn->GetRank()}
-                                }),
-      nullptr);
+      {
+        {"shape",inputTn->GetShape()},
+        {"combination",combination}
+      },
+      {
+        {"rank",inputTn->GetRank()}
+      });
 
   ValidateTensorPlatforms({inputTn}, PLATFORMS::CPU);
   auto pInputTn = std::dynamic_pointer_cast<CTensor<float>>(inputTn);
@@ -928,22 +952,26 @@ CTensorBasePtr CImplementationCpu::Variance(CTensorBasePtr inputTn,
       float *ptrBuffMeanTn = pMeanTn->Get();
       float *ptrBuffVarianceTn = varianceTn->Get();
 
-      size_t indxS1;
+      // The same partial vectors as the rank 4 reduce sum, over the blocks of the rows (d0, d1, d2).
+      const size_t rows = (size_t)dim0*dim1*dim2;
+      const size_t rowsPerTask = GetGrainSize(dim3);
+      const unsigned taskCount = (unsigned)((rows+rowsPerTask-1)/rowsPerTask);
+      std::vector<float> partialSums((size_t)taskCount*dim3, 0);
+      CCpuRuntime::ParallelFor(taskCount, 0, [&](unsigned task, unsigned){
+        float *ptrPartial = partialSums.data() + (size_t)task*dim3;
+        const size_t end = std::min(rows, (task+1)*rowsPerTask);
+        for(size_t row=task*rowsPerTask; row<end; row++){
+          const float *ptrRow = ptrBuffInputTn + row*dim3;
+          for(unsigned d3 = 0; d3 < dim3; d3++){
+            float delta = (ptrRow[d3] - ptrBuffMeanTn[d3]);
+            ptrPartial[d3] += delta*delta;
+          }
+        }
+      });
       for (unsigned d3 = 0; d3 < dim3; d3++) { //over the last-dim
         ptrBuffVarianceTn[d3]=0;
-
-        for (unsigned d0 = 0; d0 < dim0; d0++) {
-          for (unsigned d1 = 0; d1 < dim1; d1++) {
-            for (unsigned d2 = 0; d2 < dim2; d2++) {
-              indxS1 = d0*dim1*dim2*dim3+
-                  d1*dim2*dim3+
-                  d2*dim3+
-                  d3;
-
-              float delta = (ptrBuffInputTn[indxS1] - ptrBuffMeanTn[d3]);
-              ptrBuffVarianceTn[d3] += delta*delta;
-            }
-          }
+        for(unsigned task=0; task<taskCount; task++){
+          ptrBuffVarianceTn[d3] += partialSums[(size_t)task*dim3+d3];
         }
       }
 
@@ -960,17 +988,16 @@ CTensorBasePtr CImplementationCpu::Variance(CTensorBasePtr inputTn,
       float *ptrBuffMeanTn = pMeanTn->Get();
       float *ptrBuffVarianceTn = varianceTn->Get();
 
-      size_t indxS1;
-      for(unsigned d1 = 0; d1 < dim1; d1++) { //over the last-dim
-        ptrBuffVarianceTn[d1]=0;
+      CCpuRuntime::ParallelForRange(dim1, GetGrainSize(dim0), [&](size_t begin, size_t end){
+        for(size_t d1 = begin; d1 < end; d1++) { //over the last-dim
+          ptrBuffVarianceTn[d1]=0;
 
-        for (unsigned d0 = 0; d0 < dim0; d0++) {
-          indxS1 = d0*dim1 + d1;
-
-          float delta = (ptrBuffInputTn[indxS1]-ptrBuffMeanTn[d1]);
-          ptrBuffVarianceTn[d1] += delta*delta;
+          for (unsigned d0 = 0; d0 < dim0; d0++) {
+            float delta = (ptrBuffInputTn[(size_t)d0*dim1 + d1]-ptrBuffMeanTn[d1]);
+            ptrBuffVarianceTn[d1] += delta*delta;
+          }
         }
-      }
+      });
       auto varianceFinalTn = BasicOps(varianceTn,(float)(1.0f/(float)(dim0)),BASIC_OPS::MUL_ELEMENTWISE);
       rsltTn = std::dynamic_pointer_cast<CTensor<float>>(varianceFinalTn);
     }
@@ -994,14 +1021,108 @@ CTensorBasePtr CImplementationCpu::Variance(CTensorBasePtr inputTn,
   m_ptrProfiler->FinishLayer();
   return rsltTn;
 }
+std::vector<CTensorBasePtr> CImplementationCpu::MeanVariance(CTensorBasePtr inputTn,
+                                                             const std::vector<unsigned> &combination) {
+  m_ptrProfiler->StartLayer(
+      GetPlatform(),
+      GenerateLayerId(),
+      __func__,
+      {
+        {"shape",inputTn->GetShape()},
+        {"combination",combination}
+      },
+      {
+        {"rank",inputTn->GetRank()}
+      });
+
+  ValidateTensorPlatforms({inputTn}, PLATFORMS::CPU);
+  ConditionCheck(inputTn->GetRank()==2 || inputTn->GetRank()==4, "Only tensors of ranks 2 and 4 are supported.");
+  ConditionCheck(combination.size()==inputTn->GetRank(), "The combination's size must be equal to the input tensor's rank.");
+  if(inputTn->GetRank()==4){
+    ConditionCheck(
+        (combination[0] && combination[1] && combination[2] && !combination[3]),
+        "Unsupported combination for the input tensor."
+    );
+  }
+  if(inputTn->GetRank()==2){
+    ConditionCheck(
+        (combination[0] && !combination[1]),
+        "Unsupported combination for the input tensor."
+    );
+  }
+
+  std::vector<CTensorBasePtr> outputTns;
+  if(m_bUseNaiveKernels){
+    // The two passes of the separate layers.
+    outputTns = {Mean(inputTn, combination), Variance(inputTn, combination)};
+    m_ptrProfiler->FinishLayer();
+    return outputTns;
+  }
+
+  auto pInputTn = std::dynamic_pointer_cast<CTensor<float>>(inputTn);
+  // Both TTTF (rank 4) and TF (rank 2) reduce all of the rows of the last dimension.
+  const unsigned dim3 = inputTn->GetShape().back();
+  const size_t rows = inputTn->GetLen()/dim3;
+  CTensorPtr<float> meanTn(new CTensor<float>({dim3}));
+  CTensorPtr<float> varianceTn(new CTensor<float>({dim3}));
+  const float *ptrBuffInputTn = pInputTn->Get();
+  float *ptrBuffMeanTn = meanTn->Get();
+  float *ptrBuffVarianceTn = varianceTn->Get();
+
+  // A single pass of Welford's algorithm per column over the blocks of the rows, the inner loops run over the
+  // contiguous columns so they are vectorized. The partial moments of the blocks are merged in order (Chan et al.).
+  const size_t rowsPerTask = GetGrainSize(dim3);
+  const unsigned taskCount = (unsigned)((rows+rowsPerTask-1)/rowsPerTask);
+  std::vector<float> partialMeans((size_t)taskCount*dim3, 0);
+  std::vector<float> partialM2s((size_t)taskCount*dim3, 0);
+  CCpuRuntime::ParallelFor(taskCount, 0, [&](unsigned task, unsigned){
+    float *ptrMean = partialMeans.data() + (size_t)task*dim3;
+    float *ptrM2 = partialM2s.data() + (size_t)task*dim3;
+    const size_t begin = task*rowsPerTask;
+    const size_t end = std::min(rows, begin+rowsPerTask);
+    for(size_t row=begin; row<end; row++){
+      const float *ptrRow = ptrBuffInputTn + row*dim3;
+      const float invCount = 1.0f/(float)(row-begin+1);
+      for(unsigned d3 = 0; d3 < dim3; d3++){
+        const float delta = ptrRow[d3] - ptrMean[d3];
+        ptrMean[d3] += delta*invCount;
+        ptrM2[d3] += delta*(ptrRow[d3] - ptrMean[d3]);
+      }
+    }
+  });
+
+  std::fill(ptrBuffMeanTn, ptrBuffMeanTn+dim3, 0.0f);
+  std::fill(ptrBuffVarianceTn, ptrBuffVarianceTn+dim3, 0.0f); // holds M2 until the end
+  size_t count = 0;
+  for(unsigned task=0; task<taskCount; task++){
+    const float *ptrMean = partialMeans.data() + (size_t)task*dim3;
+    const float *ptrM2 = partialM2s.data() + (size_t)task*dim3;
+    const size_t taskRows = std::min(rows, (task+1)*rowsPerTask) - task*rowsPerTask;
+    const float coefMean = (float)taskRows/(float)(count+taskRows);
+    const float coefM2 = (float)count*coefMean;
+    for(unsigned d3 = 0; d3 < dim3; d3++){
+      const float delta = ptrMean[d3] - ptrBuffMeanTn[d3];
+      ptrBuffMeanTn[d3] += delta*coefMean;
+      ptrBuffVarianceTn[d3] += ptrM2[d3] + delta*delta*coefM2;
+    }
+    count += taskRows;
+  }
+  const float invRows = 1.0f/(float)rows;
+  for(unsigned d3 = 0; d3 < dim3; d3++){
+    ptrBuffVarianceTn[d3] *= invRows;
+  }
+
+  outputTns = {meanTn, varianceTn};
+  m_ptrProfiler->FinishLayer();
+  return outputTns;
+}
 CTensorBasePtr CImplementationCpu::PadLastDim(CTensorBasePtr inputTn, unsigned lastDimPadded) {
   m_ptrProfiler->StartLayer(
       GetPlatform(),
       GenerateLayerId(),
       __func__,
-      new CProfiler::DictShapePtr({{"shape",inputTn->GetShape()}}),
-      new CProfiler::DictIntPtr({{"lastDimPadded",lastDimPadded}}),
-      nullptr);
+      {{"shape",inputTn->GetShape()}},
+      {{"lastDimPadded",lastDimPadded}});
 
   ValidateTensorPlatforms({inputTn}, PLATFORMS::CPU);
   ConditionCheck(
@@ -1039,11 +1160,13 @@ CTensorBasePtr CImplementationCpu::PadLastDim(CTensorBasePtr inputTn, unsigned l
   float *ptrBuffInputTn = pInputTn->Get();
   float *ptrBuffRsltTn = rsltTn->Get();
 
-  for(unsigned d0=0; d0<dim0; d0++){
-    for(unsigned d1=0; d1<lastDimPadded; d1++){
-      ptrBuffRsltTn[d0*lastDimPadded+d1] = (d1<dim1) ? ptrBuffInputTn[d0*dim1+d1] : 0;
+  CCpuRuntime::ParallelForRange(dim0, GetGrainSize(lastDimPadded), [&](size_t begin, size_t end){
+    for(size_t d0=begin; d0<end; d0++){
+      for(unsigned d1=0; d1<lastDimPadded; d1++){
+        ptrBuffRsltTn[d0*lastDimPadded+d1] = (d1<dim1) ? ptrBuffInputTn[d0*dim1+d1] : 0;
+      }
     }
-  }
+  });
 
   m_ptrProfiler->FinishLayer();
   return rsltTn;
@@ -1053,9 +1176,8 @@ CTensorBasePtr CImplementationCpu::UnpadLastDim(CTensorBasePtr inputTn, unsigned
       GetPlatform(),
       GenerateLayerId(),
       __func__,
-      new CProfiler::DictShapePtr({{"shape",inputTn->GetShape()}}),
-      new CProfiler::DictIntPtr({{"lastDimUnpadded",lastDimUnpadded}}),
-      nullptr);
+      {{"shape",inputTn->GetShape()}},
+      {{"lastDimUnpadded",lastDimUnpadded}});
 
   ValidateTensorPlatforms({inputTn}, PLATFORMS::CPU);
   ConditionCheck(
@@ -1085,11 +1207,13 @@ CTensorBasePtr CImplementationCpu::UnpadLastDim(CTensorBasePtr inputTn, unsigned
   float *ptrBuffInputTn = pInputTn->Get();
   float *ptrBuffRsltTn = rsltTn->Get();
 
-  for(unsigned d0=0; d0<dim0; d0++){
-    for(unsigned d1=0; d1<lastDimUnpadded; d1++){
-      ptrBuffRsltTn[d0*lastDimUnpadded+d1] = ptrBuffInputTn[d0*dim1+d1];
+  CCpuRuntime::ParallelForRange(dim0, GetGrainSize(lastDimUnpadded), [&](size_t begin, size_t end){
+    for(size_t d0=begin; d0<end; d0++){
+      for(unsigned d1=0; d1<lastDimUnpadded; d1++){
+        ptrBuffRsltTn[d0*lastDimUnpadded+d1] = ptrBuffInputTn[d0*dim1+d1];
+      }
     }
-  }
+  });
 
   m_ptrProfiler->FinishLayer();
   return rsltTn;
@@ -1099,12 +1223,11 @@ CTensorBasePtr CImplementationCpu::TopK(CTensorBasePtr inputTn, unsigned axis, u
       GetPlatform(),
       GenerateLayerId(),
       __func__,
-      new CProfiler::DictShapePtr({{"shape",inputTn->GetShape()}}),
-      new CProfiler::DictIntPtr({
+      {{"shape",inputTn->GetShape()}},
+      {
         {"axis",axis},
         {"k",k},
-        }),
-      nullptr);
+      });
 
   ValidateTensorPlatforms({inputTn}, PLATFORMS::CPU);
   ConditionCheck(inputTn->GetRank()==3, "Only input tensors of rank 3 are supported.");
@@ -1114,26 +1237,16 @@ CTensorBasePtr CImplementationCpu::TopK(CTensorBasePtr inputTn, unsigned axis, u
   auto pInputTn = std::dynamic_pointer_cast<CTensor<float>>(inputTn);
   const auto shape = pInputTn->GetShape();
 
-  size_t indxS = 0;
   const unsigned B = shape[0], N2 = shape[1], N = shape[2], K = (unsigned)k;
   CTensorPtr<unsigned> rsltTn(new CTensor<unsigned>({B,N2,K}));
   float *ptrBuffInputTn = pInputTn->Get();
   unsigned *ptrBuffRsltTn = rsltTn->Get();
 
-  float tmp_array[N];
-  unsigned indices[N];
-
-  for(unsigned b=0;b<B*N2;b++){
-    for(unsigned i = 0 ;i<N;i++){
-      indices[i]=i;
-    }
-    indxS = b*N + 0;
-    std::copy(ptrBuffInputTn+indxS, ptrBuffInputTn+indxS+N, tmp_array);
-    std::sort(  indices,
-                indices+N,
-                [&](int i1, int i2) { return tmp_array[i1] < tmp_array[i2]; } );
-
-    std::copy(indices, indices+K, ptrBuffRsltTn+(b*K));
+  // Both of the paths break the ties by the lower index first, same as task_topk.
+  if(m_bUseNaiveKernels){
+    CTopKCpu::TopKNaive(ptrBuffInputTn, ptrBuffRsltTn, B*N2, N, K);
+  }else{
+    CTopKCpu::TopK(ptrBuffInputTn, ptrBuffRsltTn, B*N2, N, K);
   }
 
   m_ptrProfiler->FinishLayer();
@@ -1145,13 +1258,11 @@ CTensorBasePtr CImplementationCpu::Conv2D(CTensorBasePtr inputTn, CTensorBasePtr
       GetPlatform(),
       GenerateLayerId(),
       __func__,
-      new CProfiler::DictShapePtr({
+      {
         {"shape.i",inputTn->GetShape()},
         {"shape.w",weightTn->GetShape()},
         {"shape.b",biasTn->GetShape()},
-        }),
-      nullptr,
-      nullptr);
+      });
 
   ValidateTensorPlatforms({inputTn,weightTn,biasTn}, PLATFORMS::CPU);
 
@@ -1162,13 +1273,13 @@ CTensorBasePtr CImplementationCpu::Conv2D(CTensorBasePtr inputTn, CTensorBasePtr
   auto pBias = std::dynamic_pointer_cast<CTensor<float>>(biasTn);
 
   const auto shapeInput = pInputTn->GetShape();
-  size_t indxS1,indxS2,indxD;
 
   const auto B = shapeInput[0];
   const auto N = shapeInput[1];
   const auto K = shapeInput[2];
   const auto D = shapeInput[3];
   const auto ch_out = weightTn->GetShape().back();
+  ConditionCheck(weightTn->GetLen()==(size_t)D*ch_out, "Incompatible input and weight tensors.");
 
   CTensorPtr<float> rsltTn (new CTensor<float>({B,N,K,ch_out}));
   float *pBuffInputTn = pInputTn->Get();
@@ -1176,21 +1287,87 @@ CTensorBasePtr CImplementationCpu::Conv2D(CTensorBasePtr inputTn, CTensorBasePtr
   float *pBuffBiasTn = pBias->Get();
   float *pBuffRsltTnTn = rsltTn->Get();
 
-  for(unsigned b=0;b<B;b++){
-    for(unsigned n=0;n<N;n++){
-      for(unsigned k=0;k<K;k++){
-        indxS1 = b*N*K*D + n*K*D + k*D + 0;
-        for(unsigned ch=0;ch<ch_out;ch++){
-          float sum=0;
-          for(unsigned d=0;d<D;d++){
-            indxS2 = d*ch_out + ch;
-            sum += pBuffInputTn[indxS1+d] * pBuffWeightTn[indxS2];
-          }
-          indxD=b*N*K*ch_out+ n*K*ch_out+ k*ch_out+ ch;
-          pBuffRsltTnTn[indxD] = sum + pBuffBiasTn[ch];
-        }
-      }
-    }
+  // The 1x1 convolution is a (B*N*K x D) by (D x ch_out) matrix product, with the bias added on the output write.
+  if(m_bUseNaiveKernels){
+    CGemmCpu::GemmNaive(pBuffInputTn, pBuffWeightTn, pBuffRsltTnTn, 1, B*N*K, D, ch_out, pBuffBiasTn);
+  }else{
+    CGemmCpu::Gemm(pBuffInputTn, pBuffWeightTn, pBuffRsltTnTn, 1, B*N*K, D, ch_out, pBuffBiasTn);
+  }
+
+  m_ptrProfiler->FinishLayer();
+  return rsltTn;
+}
+CTensorBasePtr CImplementationCpu::KNN(CTensorBasePtr inputTn, unsigned k) {
+  m_ptrProfiler->StartLayer(
+      GetPlatform(),
+      GenerateLayerId(),
+      __func__,
+      {{"shape",inputTn->GetShape()}},
+      {
+        {"k",k},
+      });
+
+  ValidateTensorPlatforms({inputTn}, PLATFORMS::CPU);
+  ConditionCheck(inputTn->GetRank()==3, "Only input tensors of rank 3 are supported.");
+  ConditionCheck(inputTn->GetShape()[1]>k && k>0, "The value for k should be greater than zero and less than shape[1].");
+
+  CTensorBasePtr rsltTn;
+  if(m_bUseNaiveKernels){
+    rsltTn = KnnByPairwiseDistance(inputTn, k);
+  }else{
+    auto pInputTn = std::dynamic_pointer_cast<CTensor<float>>(inputTn);
+    const auto shape = pInputTn->GetShape();
+    const unsigned B = shape[0], N = shape[1], D = shape[2];
+    CTensorPtr<unsigned> pRsltTn(new CTensor<unsigned>({B,N,k}));
+    CKnnCpu::Knn(pInputTn->Get(), pRsltTn->Get(), B, N, D, k);
+    rsltTn = pRsltTn;
+  }
+
+  m_ptrProfiler->FinishLayer();
+  return rsltTn;
+}
+CTensorBasePtr CImplementationCpu::EdgeConv(CTensorBasePtr inputTn, CTensorBasePtr knnTn, CTensorBasePtr weightTn, CTensorBasePtr biasTn) {
+  m_ptrProfiler->StartLayer(
+      GetPlatform(),
+      GenerateLayerId(),
+      __func__,
+      {
+        {"shape.i",inputTn->GetShape()},
+        {"shape.knn",knnTn->GetShape()},
+        {"shape.w",weightTn->GetShape()},
+        {"shape.b",biasTn->GetShape()},
+      });
+
+  ValidateTensorPlatforms({inputTn,knnTn,weightTn,biasTn}, PLATFORMS::CPU);
+  ConditionCheck(inputTn->GetRank()==3, "Only input tensors of rank 3 are supported.");
+  ConditionCheck(knnTn->GetRank()==3, "Only knn tensors of rank 3 are supported.");
+  ConditionCheck(
+      inputTn->GetShape()[0]==knnTn->GetShape()[0] && inputTn->GetShape()[1]==knnTn->GetShape()[1],
+      "Incompatible input and knn tensors.");
+  ConditionCheck(weightTn->GetShape().back()==biasTn->GetShape().back(), "Incompatible weight and bias tensors.");
+
+  const auto shapeInput = inputTn->GetShape();
+  const unsigned B = shapeInput[0];
+  const unsigned N = shapeInput[1];
+  const unsigned D = shapeInput[2];
+  const unsigned K = knnTn->GetShape()[2];
+  const unsigned ch_out = weightTn->GetShape().back();
+  ConditionCheck(weightTn->GetLen()==(size_t)2*D*ch_out, "Incompatible input and weight tensors.");
+  ValidateKnnIndices(std::dynamic_pointer_cast<CTensor<unsigned>>(knnTn)->Get(), knnTn->GetLen(), N);
+
+  CTensorBasePtr rsltTn;
+  if(m_bUseNaiveKernels){
+    rsltTn = EdgeConvByEdgeFeatures(inputTn, knnTn, weightTn, biasTn);
+  }else{
+    // The edge features [x_i, x_j - x_i] are built per tile and are fed directly to the GEMM.
+    auto pInputTn = std::dynamic_pointer_cast<CTensor<float>>(inputTn);
+    auto pKnnTn = std::dynamic_pointer_cast<CTensor<unsigned>>(knnTn);
+    auto pWeightTn = std::dynamic_pointer_cast<CTensor<float>>(weightTn);
+    auto pBiasTn = std::dynamic_pointer_cast<CTensor<float>>(biasTn);
+    CTensorPtr<float> pRsltTn(new CTensor<float>({B,N,K,ch_out}));
+    CEdgeConvCpu::EdgeConv(
+        pInputTn->Get(), pKnnTn->Get(), pWeightTn->Get(), pBiasTn->Get(), pRsltTn->Get(), B, N, D, K, ch_out);
+    rsltTn = pRsltTn;
   }
 
   m_ptrProfiler->FinishLayer();
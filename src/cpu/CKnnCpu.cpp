@@ -0,0 +1,76 @@
+#include "cpu/CKnnCpu.h"
+#include "cpu/CCpuRuntime.h"
+#include "cpu/CGemmCpu.h"
+#include "cpu/CTopKCpu.h"
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+// The rows of a distance tile. (kTileRows x pointCount floats per worker)
+constexpr unsigned kTileRows = 64;
+
+}
+
+void CKnnCpu::Knn(
+    const float *ptrInput,
+    unsigned *ptrIndices,
+    unsigned batchSize,
+    unsigned pointCount,
+    unsigned dim,
+    unsigned k,
+    unsigned threadCount) {
+  if(batchSize==0 || pointCount==0 || k==0) return;
+  if(threadCount==0) threadCount = CCpuRuntime::GetDefaultThreadCount();
+
+  const unsigned N = pointCount, D = dim;
+  const unsigned tilesPerBatch = (N+kTileRows-1)/kTileRows;
+  const unsigned taskCount = batchSize*tilesPerBatch;
+
+  // 1. The squared norms (BxN) and the transposed points (BxDxN, the B operand of the inner products).
+  std::vector<float> squaredNorms((size_t)batchSize*N);
+  std::vector<float> transposed((size_t)batchSize*D*N);
+  CCpuRuntime::ParallelFor(batchSize, threadCount, [&](unsigned b, unsigned){
+    const float *ptrBatch = ptrInput + (size_t)b*N*D;
+    float *ptrBatchT = transposed.data() + (size_t)b*D*N;
+    for(unsigned n=0; n<N; n++){
+      float sum = 0;
+      for(unsigned d=0; d<D; d++){
+        const float val = ptrBatch[(size_t)n*D+d];
+        sum += val*val;
+        ptrBatchT[(size_t)d*N+n] = val;
+      }
+      squaredNorms[(size_t)b*N+n] = sum;
+    }
+  });
+
+  // 2. The tiles. Each worker owns a distance tile and a heap scratch.
+  const unsigned workers = std::max(1u, std::min(taskCount, threadCount));
+  std::vector<std::vector<float>> tiles(workers, std::vector<float>((size_t)kTileRows*N));
+  std::vector<std::vector<CTopKCpu::Candidate>> scratches(workers, std::vector<CTopKCpu::Candidate>(k));
+
+  CCpuRuntime::ParallelFor(taskCount, workers, [&](unsigned task, unsigned worker){
+    const unsigned b = task/tilesPerBatch;
+    const unsigned r0 = (task%tilesPerBatch)*kTileRows;
+    const unsigned rows = std::min(kTileRows, N-r0);
+    const float *ptrNorms = squaredNorms.data() + (size_t)b*N;
+    float *ptrTile = tiles[worker].data();
+
+    // The inner products of the rows [r0, r0+rows) against all of the points of the batch.
+    CGemmCpu::Gemm(
+        ptrInput + ((size_t)b*N+r0)*D,
+        transposed.data() + (size_t)b*D*N,
+        ptrTile,
+        1, rows, D, N, nullptr, 1);
+
+    for(unsigned r=0; r<rows; r++){
+      float *ptrRow = ptrTile + (size_t)r*N;
+      const float normI = ptrNorms[r0+r];
+      // Same expression order as CImplementationBase::KnnByPairwiseDistance: (|x_i|^2 + |x_j|^2) + (-2 x_i.x_j)
+      for(unsigned j=0; j<N; j++){
+        ptrRow[j] = (normI + ptrNorms[j]) + (-2.0f*ptrRow[j]);
+      }
+      CTopKCpu::SelectRow(ptrRow, N, k, ptrIndices + ((size_t)b*N+r0+r)*k, scratches[worker].data());
+    }
+  });
+}
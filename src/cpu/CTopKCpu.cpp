@@ -0,0 +1,128 @@
+#include "cpu/CTopKCpu.h"
+#include "cpu/CCpuRuntime.h"
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define TOPK_CPU_X86
+#endif
+
+namespace {
+
+// The rows handled by a single task.
+constexpr unsigned kRowsPerTask = 64;
+
+inline bool CandidateLess(const CTopKCpu::Candidate &a, const CTopKCpu::Candidate &b){
+  return a.value < b.value || (a.value == b.value && a.index < b.index);
+}
+
+typedef unsigned (*FindFirstLessFunc)(const float *ptrRow, unsigned begin, unsigned rowLen, float threshold);
+
+unsigned FindFirstLessScalar(const float *ptrRow, unsigned begin, unsigned rowLen, float threshold){
+  for(unsigned i=begin; i<rowLen; i++){
+    if(ptrRow[i] < threshold) return i;
+  }
+  return rowLen;
+}
+
+#ifdef TOPK_CPU_X86
+__attribute__((target("avx2")))
+unsigned FindFirstLessAvx2(const float *ptrRow, unsigned begin, unsigned rowLen, float threshold){
+  const __m256 thr = _mm256_set1_ps(threshold);
+  unsigned i = begin;
+  for(; i+8<=rowLen; i+=8){
+    const int mask = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(ptrRow+i), thr, _CMP_LT_OQ));
+    if(mask) return i + __builtin_ctz(mask);
+  }
+  return FindFirstLessScalar(ptrRow, i, rowLen, threshold);
+}
+
+__attribute__((target("avx512f")))
+unsigned FindFirstLessAvx512(const float *ptrRow, unsigned begin, unsigned rowLen, float threshold){
+  const __m512 thr = _mm512_set1_ps(threshold);
+  unsigned i = begin;
+  for(; i+16<=rowLen; i+=16){
+    const __mmask16 mask = _mm512_cmp_ps_mask(_mm512_loadu_ps(ptrRow+i), thr, _CMP_LT_OQ);
+    if(mask) return i + __builtin_ctz((unsigned)mask);
+  }
+  return FindFirstLessScalar(ptrRow, i, rowLen, threshold);
+}
+#endif
+
+FindFirstLessFunc ResolveFindFirstLess(){
+  switch(CCpuRuntime::GetIsa()){
+#ifdef TOPK_CPU_X86
+    case CCpuRuntime::ISA::AVX512: return FindFirstLessAvx512;
+    case CCpuRuntime::ISA::AVX2: return FindFirstLessAvx2;
+#endif
+    default: return FindFirstLessScalar;
+  }
+}
+
+}
+
+unsigned CTopKCpu::FindFirstLess(const float *ptrRow, unsigned begin, unsigned rowLen, float threshold) {
+  static const FindFirstLessFunc func = ResolveFindFirstLess();
+  return func(ptrRow, begin, rowLen, threshold);
+}
+
+void CTopKCpu::SelectRow(const float *ptrRow, unsigned rowLen, unsigned k, unsigned *ptrIndices, Candidate *scratch) {
+  // A max-heap on (value, index) holding the k smallest elements seen so far.
+  for(unsigned i=0; i<k; i++){
+    scratch[i] = {ptrRow[i], i};
+  }
+  std::make_heap(scratch, scratch+k, CandidateLess);
+
+  // The elements are visited in the ascending order of their indices, so an element with the same value as the
+  // heap's top always loses the tie. Therefore only the elements strictly less than the top value are candidates.
+  unsigned i = FindFirstLess(ptrRow, k, rowLen, scratch[0].value);
+  while(i<rowLen){
+    std::pop_heap(scratch, scratch+k, CandidateLess);
+    scratch[k-1] = {ptrRow[i], i};
+    std::push_heap(scratch, scratch+k, CandidateLess);
+    i = FindFirstLess(ptrRow, i+1, rowLen, scratch[0].value);
+  }
+
+  std::sort_heap(scratch, scratch+k, CandidateLess);
+  for(unsigned j=0; j<k; j++){
+    ptrIndices[j] = scratch[j].index;
+  }
+}
+
+void CTopKCpu::TopK(
+    const float *ptrInput,
+    unsigned *ptrIndices,
+    unsigned rowCount,
+    unsigned rowLen,
+    unsigned k,
+    unsigned threadCount) {
+  if(k==0) return;
+  const unsigned taskCount = (rowCount+kRowsPerTask-1)/kRowsPerTask;
+  CCpuRuntime::ParallelFor(taskCount, threadCount, [&](unsigned task, unsigned){
+    std::vector<Candidate> scratch(k);
+    const unsigned rowEnd = std::min(rowCount, (task+1)*kRowsPerTask);
+    for(unsigned row=task*kRowsPerTask; row<rowEnd; row++){
+      SelectRow(ptrInput+(size_t)row*rowLen, rowLen, k, ptrIndices+(size_t)row*k, scratch.data());
+    }
+  });
+}
+
+void CTopKCpu::TopKNaive(
+    const float *ptrInput,
+    unsigned *ptrIndices,
+    unsigned rowCount,
+    unsigned rowLen,
+    unsigned k) {
+  std::vector<unsigned> indices(rowLen);
+  for(unsigned row=0; row<rowCount; row++){
+    const float *ptrRow = ptrInput+(size_t)row*rowLen;
+    std::iota(indices.begin(), indices.end(), 0);
+    std::stable_sort(
+        indices.begin(),
+        indices.end(),
+        [&](unsigned i1, unsigned i2) { return ptrRow[i1] < ptrRow[i2]; } );
+    std::copy(indices.begin(), indices.begin()+k, ptrIndices+(size_t)row*k);
+  }
+}
@@ -0,0 +1,134 @@
+#define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+
+#include "fpga/xilinx/CAsyncLifetimeManager.h"
+#include <algorithm>
+
+CAsyncLifetimeManager::CAsyncLifetimeManager(unsigned ringSize) {
+  ConditionCheck(ringSize>0, "The ring of the callback records should not be empty.");
+  m_vRing.resize(ringSize);
+  for(auto &record:m_vRing){
+    record.sizeBytes = 0;
+    record.inUse = false;
+  }
+  m_uNextSlot = 0;
+  m_uInFlight = 0;
+  m_uLiveTensors = 0;
+  m_uLiveBytes = 0;
+  m_uPeakBytes = 0;
+  m_uPinnedLaunches = 0;
+  m_uRingStalls = 0;
+}
+
+CAsyncLifetimeManager::~CAsyncLifetimeManager() {
+  // The callbacks of the pending launches still point into the ring.
+  WaitForAll();
+}
+
+CallbackData* CAsyncLifetimeManager::Pin(const std::vector<CTensorBasePtr> &tensors,
+                                         void *classPtr,
+                                         unsigned parentLayerId,
+                                         bool profileKernel) {
+  // The bank-crossed clone of a tensor that is already on the right bank is the tensor itself.
+  std::vector<CTensorBasePtr> uniqueTensors;
+  unsigned long sizeBytes = 0;
+  for(auto &tn:tensors){
+    if(tn==nullptr || std::find(uniqueTensors.begin(), uniqueTensors.end(), tn)!=uniqueTensors.end()) continue;
+    uniqueTensors.push_back(tn);
+    sizeBytes += tn->GetSizeBytes();
+  }
+
+  std::unique_lock<std::mutex> lock(m_oMutex);
+  if(m_uInFlight==m_vRing.size()){
+    m_uRingStalls++;
+    m_oReleasedCv.wait(lock, [this]{ return m_uInFlight<m_vRing.size(); });
+  }
+  while(m_vRing[m_uNextSlot].inUse){
+    m_uNextSlot = (m_uNextSlot+1) % m_vRing.size();
+  }
+  const unsigned slot = m_uNextSlot;
+  m_uNextSlot = (m_uNextSlot+1) % m_vRing.size();
+
+  Record &record = m_vRing[slot];
+  record.data.classPtr = classPtr;
+  record.data.parentLayerId = parentLayerId;
+  record.data.kernelBookKeeperId = slot;
+  record.data.profileKernel = profileKernel;
+  record.data.optionalValue = 0;
+  record.data.srcBank = -1;
+  record.data.destBank = -1;
+  record.tensors = std::move(uniqueTensors);
+  record.sizeBytes = sizeBytes;
+  record.inUse = true;
+
+  m_uInFlight++;
+  m_uPinnedLaunches++;
+  m_uLiveTensors += record.tensors.size();
+  m_uLiveBytes += sizeBytes;
+  m_uPeakBytes = std::max(m_uPeakBytes, m_uLiveBytes);
+  return &record.data;
+}
+
+void CAsyncLifetimeManager::Release(CallbackData *record) {
+  std::vector<CTensorBasePtr> tensors;
+  {
+    std::lock_guard<std::mutex> lock(m_oMutex);
+    const unsigned slot = record->kernelBookKeeperId;
+    ConditionCheck(slot<m_vRing.size() && &m_vRing[slot].data==record && m_vRing[slot].inUse,
+                   "Releasing a callback record that is not pinned.");
+    Record &entry = m_vRing[slot];
+    tensors.swap(entry.tensors);
+    m_uLiveTensors -= tensors.size();
+    m_uLiveBytes -= entry.sizeBytes;
+    entry.sizeBytes = 0;
+    entry.inUse = false;
+    m_uInFlight--;
+  }
+  m_oReleasedCv.notify_all();
+  // The last references could be dropped here, which returns the device buffers to CXilinxBufferPool. This is done
+  // outside of the lock, as the pool has its own.
+  tensors.clear();
+}
+
+void CAsyncLifetimeManager::WaitForAll() {
+  std::unique_lock<std::mutex> lock(m_oMutex);
+  m_oReleasedCv.wait(lock, [this]{ return m_uInFlight==0; });
+}
+
+unsigned CAsyncLifetimeManager::GetInFlightLaunches() const {
+  std::lock_guard<std::mutex> lock(m_oMutex);
+  return m_uInFlight;
+}
+
+unsigned long CAsyncLifetimeManager::GetLiveTensors() const {
+  std::lock_guard<std::mutex> lock(m_oMutex);
+  return m_uLiveTensors;
+}
+
+unsigned long CAsyncLifetimeManager::GetLiveDeviceBytes() const {
+  std::lock_guard<std::mutex> lock(m_oMutex);
+  return m_uLiveBytes;
+}
+
+unsigned long CAsyncLifetimeManager::GetPeakDeviceBytes() const {
+  std::lock_guard<std::mutex> lock(m_oMutex);
+  return m_uPeakBytes;
+}
+
+unsigned CAsyncLifetimeManager::GetRingSize() const {
+  return (unsigned)m_vRing.size();
+}
+
+void CAsyncLifetimeManager::ReportStats() const {
+  std::lock_guard<std::mutex> lock(m_oMutex);
+  SPDLOG_LOGGER_INFO(logger, "Async Lifetime Manager: Launches: {}, In Flight: {}, Ring Size: {}, Ring Stalls: {}",
+                     m_uPinnedLaunches, m_uInFlight, m_vRing.size(), m_uRingStalls);
+  SPDLOG_LOGGER_INFO(logger, "Async Lifetime Manager: Live Tensors: {}, Live: {} MB (Peak: {} MB)",
+                     m_uLiveTensors, m_uLiveBytes/1048576.0, m_uPeakBytes/1048576.0);
+}
+
+void CAsyncLifetimeManager::ResetStats() {
+  std::lock_guard<std::mutex> lock(m_oMutex);
+  m_uPinnedLaunches = 0;
+  m_uRingStalls = 0;
+  m_uPeakBytes = m_uLiveBytes;
+}
@@ -0,0 +1,218 @@
+#define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+
+#include "fpga/xilinx/CBankPlanner.h"
+#include <algorithm>
+#include <fstream>
+
+constexpr const char *CBankPlanner::kInputUploadSite;
+
+CBankPlanner::CBankPlanner(bool enabled, const std::string &planPath) {
+  m_bEnabled = enabled;
+  m_bPassStarted = false;
+  m_uPassCount = 0;
+  m_uUploadCount = 0;
+  m_uScopeUploadCount = 0;
+  m_strPlanPath = planPath;
+  m_uFixedBytes = 0;
+  m_uMeasuredBytes = 0;
+  m_bHasPlan = false;
+  m_bPlanIsLoaded = false;
+  m_uRecordedBytes = 0;
+  m_uPlannedBytes = 0;
+  m_uRecordedFixedBytes = 0;
+  if(m_bEnabled && !m_strPlanPath.empty()){
+    m_bPlanIsLoaded = LoadPlan();
+    m_bHasPlan = m_bPlanIsLoaded;
+  }
+}
+
+bool CBankPlanner::IsEnabled() const {
+  return m_bEnabled;
+}
+
+bool CBankPlanner::HasPlan() const {
+  return m_bHasPlan;
+}
+
+bool CBankPlanner::IsPlanLoaded() const {
+  return m_bPlanIsLoaded;
+}
+
+bool CBankPlanner::IsBankEnabled(unsigned bank) {
+  switch(bank){
+#ifdef USEMEMORYBANK0
+    case 0: return true;
+#endif
+#ifdef USEMEMORYBANK1
+    case 1: return true;
+#endif
+#ifdef USEMEMORYBANK2
+    case 2: return true;
+#endif
+#ifdef USEMEMORYBANK3
+    case 3: return true;
+#endif
+    default: return false;
+  }
+}
+
+std::string CBankPlanner::GetWeightSite(const std::string &weightName) {
+  return "weight." + weightName;
+}
+
+void CBankPlanner::SetUploadScope(const std::string &scope) {
+  m_strUploadScope = scope;
+  m_uScopeUploadCount = 0;
+}
+
+std::string CBankPlanner::NextUploadSite() {
+  if(!m_bEnabled || !m_bPassStarted) return "";
+  if(!m_strUploadScope.empty()) return "upload." + m_strUploadScope + "." + std::to_string(m_uScopeUploadCount++);
+  return "upload." + std::to_string(m_uUploadCount++);
+}
+
+int CBankPlanner::GetPlannedBank(const std::string &site) const {
+  if(!m_bEnabled || !m_bHasPlan || site.empty()) return -1;
+  auto it = m_mPlan.find(site);
+  return it==m_mPlan.end() ? -1 : it->second;
+}
+
+void CBankPlanner::BeginPass() {
+  if(!m_bEnabled) return;
+  m_mSites.clear();
+  m_uFixedBytes = 0;
+  m_uMeasuredBytes = 0;
+  m_uUploadCount = 0;
+  m_strUploadScope.clear();
+  m_uScopeUploadCount = 0;
+  m_bPassStarted = true;
+}
+
+bool CBankPlanner::EndPass() {
+  if(!m_bEnabled || !m_bPassStarted) return false;
+  m_bPassStarted = false;
+  m_uPassCount++;
+  bool isBuilt = false;
+  if(!m_bHasPlan){
+    BuildPlan();
+    if(!m_strPlanPath.empty()) SavePlan();
+    isBuilt = true;
+  }
+  Report();
+  return isBuilt;
+}
+
+void CBankPlanner::RecordRead(const std::string &site, int srcBank, unsigned destBank, unsigned long bytes, bool hasReplicas) {
+  if(!m_bEnabled || !m_bPassStarted) return;
+  if(site.empty()){
+    // The output of a kernel, its bank is the bank of the kernel port.
+    if(srcBank!=(int)destBank) m_uFixedBytes += bytes;
+    return;
+  }
+  auto it = m_mSites.find(site);
+  if(it==m_mSites.end()){
+    SiteRecord record;
+    record.homeBank = srcBank;
+    record.hasReplicas = hasReplicas;
+    std::fill(record.readBytes, record.readBytes+4, 0);
+    it = m_mSites.insert(std::make_pair(site, record)).first;
+  }
+  auto &readBytes = it->second.readBytes[destBank];
+  readBytes = hasReplicas ? std::max(readBytes, bytes) : readBytes+bytes;
+}
+
+void CBankPlanner::RecordMove(unsigned long bytes) {
+  if(!m_bEnabled || !m_bPassStarted) return;
+  m_uMeasuredBytes += bytes;
+}
+
+unsigned long CBankPlanner::CrossedBytes(const SiteRecord &record, int homeBank) {
+  unsigned long bytes = 0;
+  for(int b=0; b<4; b++){
+    if(b!=homeBank) bytes += record.readBytes[b];
+  }
+  return bytes;
+}
+
+void CBankPlanner::BuildPlan() {
+  m_mPlan.clear();
+  m_uRecordedBytes = m_uFixedBytes;
+  m_uPlannedBytes = m_uFixedBytes;
+  m_uRecordedFixedBytes = m_uFixedBytes;
+  for(auto &site:m_mSites){
+    const auto &record = site.second;
+    // The current bank wins the ties, so a balanced site is not moved for nothing.
+    int bestBank = record.homeBank;
+    for(unsigned b=0; b<4; b++){
+      if(IsBankEnabled(b) && CrossedBytes(record, b)<CrossedBytes(record, bestBank)) bestBank = b;
+    }
+    m_mPlan[site.first] = bestBank;
+    m_uRecordedBytes += CrossedBytes(record, record.homeBank);
+    m_uPlannedBytes += CrossedBytes(record, bestBank);
+  }
+  m_bHasPlan = true;
+}
+
+bool CBankPlanner::LoadPlan() {
+  std::ifstream planFile(m_strPlanPath);
+  if(!planFile.good()) return false;
+  std::string site;
+  int bank;
+  while(planFile >> site >> bank){
+    ConditionCheck(bank>=0 && bank<=3 && IsBankEnabled(bank),
+                   "The bank plan " + m_strPlanPath + " uses a disabled bank, it should be recorded again.");
+    m_mPlan[site] = bank;
+  }
+  SPDLOG_LOGGER_INFO(logger, "CBankPlanner: Loaded the banks of {} sites from {}", m_mPlan.size(), m_strPlanPath);
+  return true;
+}
+
+void CBankPlanner::SavePlan() const {
+  std::ofstream planFile(m_strPlanPath);
+  if(!planFile.good()){
+    SPDLOG_LOGGER_WARN(logger, "CBankPlanner: Could not write the bank plan to {}", m_strPlanPath);
+    return;
+  }
+  for(auto &site:m_mPlan){
+    planFile << site.first << " " << site.second << "\n";
+  }
+  SPDLOG_LOGGER_INFO(logger, "CBankPlanner: Saved the banks of {} sites to {}", m_mPlan.size(), m_strPlanPath);
+}
+
+void CBankPlanner::Report() const {
+  if(m_uPassCount==1 && !m_bPlanIsLoaded){
+    unsigned movedSites = 0;
+    for(auto &site:m_mSites){
+      if(m_mPlan.at(site.first)!=site.second.homeBank) movedSites++;
+    }
+    SPDLOG_LOGGER_INFO(logger, "CBankPlanner: Pass: 1, Sites: {}, Moved Sites: {}", m_mSites.size(), movedSites);
+    SPDLOG_LOGGER_INFO(logger,
+                       "CBankPlanner: Crossed (before): {} MB, Crossed (planned): {} MB, Fixed (kernel outputs): {} MB, Datamover: {} MB",
+                       m_uRecordedBytes/1048576.0,
+                       m_uPlannedBytes/1048576.0,
+                       m_uRecordedFixedBytes/1048576.0,
+                       m_uMeasuredBytes/1048576.0);
+  }else if(m_bPlanIsLoaded){
+    SPDLOG_LOGGER_INFO(logger, "CBankPlanner: Pass: {}, Datamover: {} MB, Fixed (kernel outputs): {} MB (the plan is loaded from {})",
+                       m_uPassCount, m_uMeasuredBytes/1048576.0, m_uFixedBytes/1048576.0, m_strPlanPath);
+  }else{
+    SPDLOG_LOGGER_INFO(logger, "CBankPlanner: Pass: {}, Datamover: {} MB (before the planning: {} MB, planned: {} MB)",
+                       m_uPassCount, m_uMeasuredBytes/1048576.0, m_uRecordedBytes/1048576.0, m_uPlannedBytes/1048576.0);
+  }
+}
+
+unsigned long CBankPlanner::GetRecordedBytes() const {
+  return m_uRecordedBytes;
+}
+
+unsigned long CBankPlanner::GetPlannedBytes() const {
+  return m_uPlannedBytes;
+}
+
+unsigned long CBankPlanner::GetFixedBytes() const {
+  return m_uRecordedFixedBytes;
+}
+
+unsigned long CBankPlanner::GetMeasuredBytes() const {
+  return m_uMeasuredBytes;
+}
@@ -57,8 +57,27 @@ CImplementationXilinx::CImplementationXilinx(
     );
     m_strDeviceName = m_oDevice.getInfo<CL_DEVICE_NAME>();
     SPDLOG_LOGGER_TRACE(logger,"Found Device: {}", m_strDeviceName.c_str());
+    cl_uint baseAddrAlignBits;
+    OclCheck(m_iStatus, baseAddrAlignBits = m_oDevice.getInfo<CL_DEVICE_MEM_BASE_ADDR_ALIGN>(&m_iStatus));
+
+    if(m_bEnableOclProfiling){
+      // The profiling timestamps are in the clock of the device, a marker maps them to the host clock of the profiler.
+      cl::Event marker;
+      const int64_t hostBefore = CProfiler::GetHostNanoSeconds();
+      OclCheck(m_iStatus, m_iStatus = m_ptrQueue->enqueueMarkerWithWaitList(nullptr, &marker));
+      const int64_t hostAfter = CProfiler::GetHostNanoSeconds();
+      marker.wait();
+      cl_ulong deviceQueued = 0;
+      OclCheck(m_iStatus, m_iStatus = marker.getProfilingInfo(CL_PROFILING_COMMAND_QUEUED, &deviceQueued));
+      m_ptrProfiler->AddDeviceClockSync(hostBefore+(hostAfter-hostBefore)/2, deviceQueued);
+    }
 
+#ifdef SIMDEVICE
+    // The kernels of the simulated device are linked into the host, there is no FPGA image to load.
+    std::vector<unsigned char> fileBuf;
+#else
     auto fileBuf = xcl::read_binary_file(globalArgXclBin);
+#endif
     cl::Program::Binaries bins{{fileBuf.data(), fileBuf.size()}};
     OclCheck(
         m_iStatus,
@@ -70,7 +89,7 @@ CImplementationXilinx::CImplementationXilinx(
             &m_iStatus)
     );
 
-    m_ptrXilInfo = new CXilinxInfo(m_ptrProgram, m_ptrContext, m_ptrQueue, m_bEnableOclProfiling);
+    m_ptrXilInfo = new CXilinxInfo(m_ptrProgram, m_ptrContext, m_ptrQueue, m_bEnableOclProfiling, baseAddrAlignBits/8);
     m_ptrDataMoverProfiledDataVec = new vector<ProfiledLaunchData>();
     m_ptrXilInfo->SetAccumulatedProfiledKernelLaunchDataVecPtr(m_ptrDataMoverProfiledDataVec);
 #ifdef USEMEMORYBANK0
@@ -319,11 +338,12 @@ CImplementationXilinx::~CImplementationXilinx() {
   for(auto &vecData:accumulatedProfiledKernelsData){
     if(vecData.size()!=0) {
       for (auto &data:vecData) {
+        const CProfiler::DeviceTimestamps timestamps = {data.timeQueued, data.timeSubmit, data.timeStart, data.timeEnd};
         if(data.parentLayerId == DATAMOVER_ID){
-          m_ptrProfiler->StartKernelDatamover(PLATFORMS::XIL, data.parentLayerId, data.optionalValue, data.taskName, data.durationOcl);
+          m_ptrProfiler->StartKernelDatamover(PLATFORMS::XIL, data.parentLayerId, data.optionalValue, data.srcBank, data.destBank, data.taskName, timestamps);
           m_ptrProfiler->FinishKernel();
         }else{
-          m_ptrProfiler->StartKernel(PLATFORMS::XIL, data.parentLayerId, data.taskName, data.durationOcl);
+          m_ptrProfiler->StartKernel(PLATFORMS::XIL, data.parentLayerId, data.taskName, timestamps);
           m_ptrProfiler->FinishKernel();
         }
       }
@@ -345,9 +365,8 @@ CTensorBasePtr CImplementationXilinx::Concat2(CTensorBasePtr inputTn1, CTensorBa
       GetPlatform(),
       GenerateLayerId(),
       __func__,
-      new CProfiler::DictShapePtr({{"shape1",inputTn1->GetShape()},{"shape2",inputTn2->GetShape()}}),
-      new CProfiler::DictIntPtr({{"concatAxis",concatAxis}}),
-      nullptr);
+      {{"shape1",inputTn1->GetShape()},{"shape2",inputTn2->GetShape()}},
+      {{"concatAxis",concatAxis}});
 
   ValidateTensorPlatforms({inputTn1,inputTn2}, PLATFORMS::XIL);
 
@@ -362,9 +381,7 @@ CTensorBasePtr CImplementationXilinx::MatMul(CTensorBasePtr inputTn1, CTensorBas
       GetPlatform(),
       GenerateLayerId(),
       __func__,
-      new CProfiler::DictShapePtr({{"shape1",inputTn1->GetShape()},{"shape2",inputTn2->GetShape()}}),
-      nullptr,
-      nullptr);
+      {{"shape1",inputTn1->GetShape()},{"shape2",inputTn2->GetShape()}});
 
   ValidateTensorPlatforms({inputTn1,inputTn2}, PLATFORMS::XIL);
 
@@ -379,9 +396,7 @@ CTensorBasePtr CImplementationXilinx::ReLU(CTensorBasePtr inputTn) {
       GetPlatform(),
       GenerateLayerId(),
       __func__,
-      new CProfiler::DictShapePtr({{"shape",inputTn->GetShape()}}),
-      nullptr,
-      nullptr);
+      {{"shape",inputTn->GetShape()}});
 
   ValidateTensorPlatforms({inputTn}, PLATFORMS::XIL);
 
@@ -397,9 +412,7 @@ CTensorBasePtr CImplementationXilinx::Sqrt(CTensorBasePtr inputTn) {
       GetPlatform(),
       GenerateLayerId(),
       __func__,
-      new CProfiler::DictShapePtr({{"shape",inputTn->GetShape()}}),
-      nullptr,
-      nullptr);
+      {{"shape",inputTn->GetShape()}});
 
   ValidateTensorPlatforms({inputTn}, PLATFORMS::XIL);
 
@@ -415,9 +428,7 @@ CTensorBasePtr CImplementationXilinx::Square(CTensorBasePtr inputTn) {
       GetPlatform(),
       GenerateLayerId(),
       __func__,
-      new CProfiler::DictShapePtr({{"shape",inputTn->GetShape()}}),
-      nullptr,
-      nullptr);
+      {{"shape",inputTn->GetShape()}});
 
   ValidateTensorPlatforms({inputTn}, PLATFORMS::XIL);
 
@@ -432,11 +443,10 @@ CTensorBasePtr CImplementationXilinx::BasicOps(CTensorBasePtr inputTn1, CTensorB
       GetPlatform(),
       GenerateLayerId(),
       __func__,
-      new CProfiler::DictShapePtr({{"shape1",inputTn1->GetShape()},{"shape2",inputTn2->GetShape()}}),
-      new CProfiler::DictIntPtr({{
-                                     "mode",
-                                     mode==BASIC_OPS::ADD ? 0 : mode==BASIC_OPS::SUB ? 1 : mode==BASIC_OPS::MUL_ELEMENTWISE ? 2 : 3}}),
-      nullptr);
+      {{"shape1",inputTn1->GetShape()},{"shape2",inputTn2->GetShape()}},
+      {{
+        "mode",
+        mode==BASIC_OPS::ADD ? 0 : mode==BASIC_OPS::SUB ? 1 : mode==BASIC_OPS::MUL_ELEMENTWISE ? 2 : 3}});
 
   ValidateTensorPlatforms({inputTn1,inputTn2}, PLATFORMS::XIL);
 
@@ -456,13 +466,13 @@ CTensorBasePtr CImplementationXilinx::BasicOps(CTensorBasePtr inputTn1, float sc
       GetPlatform(),
       GenerateLayerId(),
       __func__,
-      new CProfiler::DictShapePtr({{"shape1",inputTn1->GetShape()},{"shape2",{1}}}),
-      new CProfiler::DictIntPtr({{
-                                     "mode",
-                                     mode==BASIC_OPS::ADD ? 0 :
-                                       mode==BASIC_OPS::SUB ? 1 :
-                                       mode==BASIC_OPS::MUL_ELEMENTWISE ? 2 : 3}}),
-      new CProfiler::DictFloatPtr({{"scalar",scalar}}));
+      {{"shape1",inputTn1->GetShape()},{"shape2",{1}}},
+      {{
+        "mode",
+        mode==BASIC_OPS::ADD ? 0 :
+          mode==BASIC_OPS::SUB ? 1 :
+          mode==BASIC_OPS::MUL_ELEMENTWISE ? 2 : 3}},
+      {{"scalar",scalar}});
 
   ValidateTensorPlatforms({inputTn1}, PLATFORMS::XIL);
 
@@ -482,9 +492,8 @@ CTensorBasePtr CImplementationXilinx::Tile(CTensorBasePtr inputTn, unsigned tile
       GetPlatform(),
       GenerateLayerId(),
       __func__,
-      new CProfiler::DictShapePtr({{"shape",inputTn->GetShape()}}),
-      new CProfiler::DictIntPtr({{"tileAxis",tileAxis},{"tileCount",tileCount}}),
-      nullptr);
+      {{"shape",inputTn->GetShape()}},
+      {{"tileAxis",tileAxis},{"tileCount",tileCount}});
 
   ValidateTensorPlatforms({inputTn}, PLATFORMS::XIL);
 
@@ -499,9 +508,7 @@ CTensorBasePtr CImplementationXilinx::Transpose(CTensorBasePtr inputTn) {
       GetPlatform(),
       GenerateLayerId(),
       __func__,
-      new CProfiler::DictShapePtr({{"shape",inputTn->GetShape()}}),
-      nullptr,
-      nullptr);
+      {{"shape",inputTn->GetShape()}});
 
   ValidateTensorPlatforms({inputTn}, PLATFORMS::XIL);
 
@@ -515,9 +522,8 @@ CTensorBasePtr CImplementationXilinx::Gather(CTensorBasePtr inputTn, CTensorBase
       GetPlatform(),
       GenerateLayerId(),
       __func__,
-      new CProfiler::DictShapePtr({{"shape",inputTn->GetShape()}, {"shape.indices",indicesTn->GetShape()}}),
-      new CProfiler::DictIntPtr({{"indicesOfAxis",indicesOfAxis}}),
-      nullptr);
+      {{"shape",inputTn->GetShape()}, {"shape.indices",indicesTn->GetShape()}},
+      {{"indicesOfAxis",indicesOfAxis}});
 
   ValidateTensorPlatforms({inputTn,indicesTn}, PLATFORMS::XIL);
 
@@ -534,11 +540,11 @@ CTensorBasePtr CImplementationXilinx::Reduce(CTensorBasePtr inputTn,
       GetPlatform(),
       GenerateLayerId(),
       __func__,
-      new CProfiler::DictShapePtr({
+      {
         {"shape",inputTn->GetShape()},
         {"combination",combination},
-        }),
-      new CProfiler::DictIntPtr({
+      },
+      {
         {"reduction_op",
          mode==REDUCTION_OPS::SUM?0:
          mode==REDUCTION_OPS::MAX?1:
@@ -546,8 +552,7 @@ CTensorBasePtr CImplementationXilinx::Reduce(CTensorBasePtr inputTn,
         },
         {"powY",powY},
         {"rank",inputTn->GetRank()},
-      }),
-      nullptr);
+      });
 
   ValidateTensorPlatforms({inputTn}, PLATFORMS::XIL);
 
@@ -568,14 +573,13 @@ CTensorBasePtr CImplementationXilinx::Mean(CTensorBasePtr inputTn,
       GetPlatform(),
       GenerateLayerId(),
       __func__,
-      new CProfiler::DictShapePtr({
+      {
         {"shape",inputTn->GetShape()},
         {"combination",combination},
-      }),
-      new CProfiler::DictIntPtr({
-                                    {"rank",inputTn->GetRank()}
-      }),
-      nullptr);
+      },
+      {
+        {"rank",inputTn->GetRank()}
+      });
 
   ValidateTensorPlatforms({inputTn}, PLATFORMS::XIL);
   ConditionCheck(inputTn->GetRank()==2 || inputTn->GetRank()==4, "Only tensors of ranks 2 and 4 are supported.");
@@ -614,14 +618,13 @@ CTensorBasePtr CImplementationXilinx::Variance(CTensorBasePtr inputTn,
       GetPlatform(),
       GenerateLayerId(),
       __func__,
-      new CProfiler::DictShapePtr({
-                                  {"shape",inputTn->GetShape()},
-                                  {"combination",combination}
-                                }),
-      new CProfiler::DictIntPtr({
-                                    {"rank",inputTn->GetRank()}
-                                }),
-      nullptr);
+      {
+        {"shape",inputTn->GetShape()},
+        {"combination",combination}
+      },
+      {
+        {"rank",inputTn->GetRank()}
+      });
 
   ValidateTensorPlatforms({inputTn}, PLATFORMS::XIL);
   ConditionCheck(inputTn->GetRank()==2 || inputTn->GetRank()==4, "Only tensors of ranks 2 and 4 are supported.");
@@ -638,33 +641,61 @@ CTensorBasePtr CImplementationXilinx::Variance(CTensorBasePtr inputTn,
         "Unsupported combination for the input tensor."
     );
   }
-  auto localCombination = combination;
 
-  unsigned diff = inputTn->ExpandDimZeroToRank(4);
-  for(unsigned d=0; d<diff; d++){
-    localCombination.insert(localCombination.begin(),1); // we do not insert 0 here as we want to use the TTTF reduction kernel.
-  }
+  unsigned diff = inputTn->ExpandDimZeroToRank(4); // The rank 2 tensors are reduced as TTTF.
 
-  CTensorBasePtr tmpTn = Reduce(inputTn, REDUCTION_OPS::SUM, 1, localCombination);
-  CTensorBasePtr varianceXi2Tn = Reduce(inputTn, REDUCTION_OPS::SUM, 2, localCombination);
-  float coef = (float)inputTn->GetLen() / (float)tmpTn->GetLen();
-  CTensorBasePtr meanTn = BasicOps(tmpTn, coef, BASIC_OPS::DIV_ELEMENTWISE);
-  CTensorBasePtr tmp2Tn = BasicOps(varianceXi2Tn, coef, BASIC_OPS::DIV_ELEMENTWISE);
-  CTensorBasePtr tmp3Tn = BasicOps(meanTn, meanTn, BASIC_OPS::MUL_ELEMENTWISE);
-  CTensorBasePtr outputTn = BasicOps(tmp2Tn, tmp3Tn, BASIC_OPS::SUB);
+  // A single pass of the mean and variance reduction, the mean row is dropped.
+  CTensorBasePtr outputTn = m_ptrKernelReduce->EnqueueKernelLaunchMoments(GetTheLastLayerId(), inputTn)[1];
 
   inputTn->SqueezeDimZeroTimesTry(diff);
   m_ptrProfiler->FinishLayer();
   return outputTn;
 }
+std::vector<CTensorBasePtr> CImplementationXilinx::MeanVariance(CTensorBasePtr inputTn,
+                                                                const std::vector<unsigned> &combination) {
+  m_ptrProfiler->StartLayer(
+      GetPlatform(),
+      GenerateLayerId(),
+      __func__,
+      {
+        {"shape",inputTn->GetShape()},
+        {"combination",combination}
+      },
+      {
+        {"rank",inputTn->GetRank()}
+      });
+
+  ValidateTensorPlatforms({inputTn}, PLATFORMS::XIL);
+  ConditionCheck(inputTn->GetRank()==2 || inputTn->GetRank()==4, "Only tensors of ranks 2 and 4 are supported.");
+  ConditionCheck(combination.size()==inputTn->GetRank(), "The combination's size must be equal to the input tensor's rank.");
+  if(inputTn->GetRank()==4){
+    ConditionCheck(
+        (combination[0] && combination[1] && combination[2] && !combination[3]),
+        "Unsupported combination for the input tensor."
+    );
+  }
+  if(inputTn->GetRank()==2){
+    ConditionCheck(
+        (combination[0] && !combination[1]),
+        "Unsupported combination for the input tensor."
+    );
+  }
+
+  // The rank 2 tensors are reduced as TTTF, same as Variance().
+  unsigned diff = inputTn->ExpandDimZeroToRank(4);
+  std::vector<CTensorBasePtr> outputTns = m_ptrKernelReduce->EnqueueKernelLaunchMoments(GetTheLastLayerId(), inputTn);
+
+  inputTn->SqueezeDimZeroTimesTry(diff);
+  m_ptrProfiler->FinishLayer();
+  return outputTns;
+}
 CTensorBasePtr CImplementationXilinx::PadLastDim(CTensorBasePtr inputTn, unsigned lastDimPadded) {
   m_ptrProfiler->StartLayer(
       GetPlatform(),
       GenerateLayerId(),
       __func__,
-      new CProfiler::DictShapePtr({{"shape",inputTn->GetShape()}}),
-      new CProfiler::DictIntPtr({{"lastDimPadded",lastDimPadded}}),
-      nullptr);
+      {{"shape",inputTn->GetShape()}},
+      {{"lastDimPadded",lastDimPadded}});
 
   ValidateTensorPlatforms({inputTn}, PLATFORMS::XIL);
 
@@ -679,9 +710,8 @@ CTensorBasePtr CImplementationXilinx::UnpadLastDim(CTensorBasePtr inputTn, unsig
       GetPlatform(),
       GenerateLayerId(),
       __func__,
-      new CProfiler::DictShapePtr({{"shape",inputTn->GetShape()}}),
-      new CProfiler::DictIntPtr({{"lastDimUnpadded",lastDimUnpadded}}),
-      nullptr);
+      {{"shape",inputTn->GetShape()}},
+      {{"lastDimUnpadded",lastDimUnpadded}});
 
   ValidateTensorPlatforms({inputTn}, PLATFORMS::XIL);
 
@@ -696,12 +726,11 @@ CTensorBasePtr CImplementationXilinx::TopK(CTensorBasePtr inputTn, unsigned axis
       GetPlatform(),
       GenerateLayerId(),
       __func__,
-      new CProfiler::DictShapePtr({{"shape",inputTn->GetShape()}}),
-      new CProfiler::DictIntPtr({
+      {{"shape",inputTn->GetShape()}},
+      {
         {"axis",axis},
         {"k",k},
-      }),
-      nullptr);
+      });
 
   ValidateTensorPlatforms({inputTn}, PLATFORMS::XIL);
 
@@ -716,13 +745,11 @@ CTensorBasePtr CImplementationXilinx::Conv2D(CTensorBasePtr inputTn, CTensorBase
       GetPlatform(),
       GenerateLayerId(),
       __func__,
-      new CProfiler::DictShapePtr({
+      {
         {"shape.i",inputTn->GetShape()},
         {"shape.w",weightTn->GetShape()},
         {"shape.b",biasTn->GetShape()}
-        }),
-      nullptr,
-      nullptr);
+      });
 
   ValidateTensorPlatforms({inputTn,weightTn,biasTn}, PLATFORMS::XIL);
 
@@ -789,3 +816,53 @@ CTensorBasePtr CImplementationXilinx::Conv2D(CTensorBasePtr inputTn, CTensorBase
   m_ptrProfiler->FinishLayer();
   return outputTn;
 }
+CTensorBasePtr CImplementationXilinx::KNN(CTensorBasePtr inputTn, unsigned k) {
+  m_ptrProfiler->StartLayer(
+      GetPlatform(),
+      GenerateLayerId(),
+      __func__,
+      {{"shape",inputTn->GetShape()}},
+      {
+        {"k",k},
+      });
+
+  ValidateTensorPlatforms({inputTn}, PLATFORMS::XIL);
+  ConditionCheck(inputTn->GetRank()==3, "Only input tensors of rank 3 are supported.");
+  ConditionCheck(inputTn->GetShape()[1]>k && k>0, "The value for k should be greater than zero and less than shape[1].");
+
+  // There is no fused kernel for KNN, the layer is composed of the existing kernels.
+  CTensorBasePtr outputTn = KnnByPairwiseDistance(inputTn, k);
+
+  m_ptrProfiler->FinishLayer();
+  return outputTn;
+}
+CTensorBasePtr CImplementationXilinx::EdgeConv(CTensorBasePtr inputTn, CTensorBasePtr knnTn, CTensorBasePtr weightTn, CTensorBasePtr biasTn) {
+  m_ptrProfiler->StartLayer(
+      GetPlatform(),
+      GenerateLayerId(),
+      __func__,
+      {
+        {"shape.i",inputTn->GetShape()},
+        {"shape.knn",knnTn->GetShape()},
+        {"shape.w",weightTn->GetShape()},
+        {"shape.b",biasTn->GetShape()},
+      });
+
+  ValidateTensorPlatforms({inputTn,knnTn,weightTn,biasTn}, PLATFORMS::XIL);
+  ConditionCheck(inputTn->GetRank()==3, "Only input tensors of rank 3 are supported.");
+  ConditionCheck(knnTn->GetRank()==3, "Only knn tensors of rank 3 are supported.");
+  ConditionCheck(
+      inputTn->GetShape()[0]==knnTn->GetShape()[0] && inputTn->GetShape()[1]==knnTn->GetShape()[1],
+      "Incompatible input and knn tensors.");
+#ifndef NDEBUG
+  // The indices are on the device, so they are read back (blocking) only in the debug builds.
+  auto hostKnnTn = std::static_pointer_cast<CTensorXil<unsigned>>(knnTn)->TransferToHost();
+  ValidateKnnIndices(hostKnnTn->Get(), hostKnnTn->GetLen(), inputTn->GetShape()[1]);
+#endif
+
+  // There is no fused kernel for EdgeConv, the layer is composed of the existing kernels.
+  CTensorBasePtr outputTn = EdgeConvByEdgeFeatures(inputTn, knnTn, weightTn, biasTn);
+
+  m_ptrProfiler->FinishLayer();
+  return outputTn;
+}
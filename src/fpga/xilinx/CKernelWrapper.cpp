@@ -17,7 +17,7 @@ CKernelWrapper::CKernelWrapper(std::string taskName,
   m_bProfileOcl = profileOcl;
   m_bLogMemBankCrossings = logMemBankCrossings;
   m_oXilInfo = xilInfo;
-  ResetBookKeeper();
+  m_ptrLifetimeManager = m_oXilInfo->GetLifetimeManager();
 
   if(m_bIsEnabled){
     OclCheck(m_iStatus,
@@ -34,10 +34,6 @@ CKernelWrapper::~CKernelWrapper() {
   SPDLOG_LOGGER_TRACE(logger, "Dumping bank-crossing logs for {} ...", m_strTaskName);
   SPDLOG_LOGGER_TRACE(logger, bankCrossingsLog);
   SPDLOG_LOGGER_TRACE(logger, "Dumping bank-crossing logs for {} has finished.", m_strTaskName);
-
-  for(auto *p:m_vCallBackData){
-    delete(p);
-  }
 }
 
 cl::Kernel *CKernelWrapper::GetKernel() const {
@@ -45,28 +41,26 @@ cl::Kernel *CKernelWrapper::GetKernel() const {
 }
 
 void CKernelWrapper::EventCallback(cl_event event, cl_int execStatus, void *userData) {
+  auto *callbackData = (CallbackData *) userData;
+  auto *classPtr = static_cast<CKernelWrapper*>(callbackData->classPtr);
+
   if( execStatus != CL_COMPLETE ) {
-    std::cout<<"ERROR IN KERNEL EXECUTION\n";
-    ///TODO REPORT ERROR WITH SPDLOGGER
-    return;
+    SPDLOG_LOGGER_ERROR(logger, "The launch of {} (layer {}) has failed with the status {}.",
+                        classPtr->m_strTaskName, callbackData->parentLayerId, execStatus);
+  }else if(callbackData->profileKernel){
+    ProfiledLaunchData data;
+    data.taskName = classPtr->m_strTaskName;
+    data.parentLayerId = callbackData->parentLayerId;
+    data.optionalValue = 0;
+    data.srcBank = -1;
+    data.destBank = -1;
+    CXilinxInfo::QueryProfilingTimestamps(event, data);
+    classPtr->AddProfiledKernelLaunchDetails(data);
   }
 
-  cl_ulong deviceTimeStart=0, deviceTimeEnd=0; //nano-seconds
-
-  if(((CallbackData *) userData)->profileKernel){
-    cl_int stat;
-    OclCheck(stat, stat=clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_START, sizeof(deviceTimeStart), &deviceTimeStart, nullptr));
-    OclCheck(stat, stat=clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END, sizeof(deviceTimeEnd), &deviceTimeEnd, nullptr));
-    cl_ulong durationNanoSeconds = deviceTimeEnd - deviceTimeStart;
-    //std::cout<<"KERNEL: ns:"<<durationNanoSeconds<<std::endl;
-    auto *classPtr = static_cast<CKernelWrapper*>(((CallbackData *)userData)->classPtr);
-    classPtr->AddProfiledKernelLaunchDetails(classPtr->m_strTaskName, ((CallbackData *) userData)->parentLayerId, durationNanoSeconds);
-
-    // Now that the async kernel is executed, we can release the smart pointers of the tensors required for this kernel.
-    // Only the content of that row in the book-keeping vector is cleared; this is to make sure that the indexing system
-    // would not get changed across multiple kernel launches.
-    classPtr->ReleaseBookKeepingEntryAt( ((CallbackData *) userData)->kernelBookKeeperId);
-  }
+  // Now that the async kernel is done (with or without the profiling), the smart pointers of the tensors required for
+  // this kernel are released and the callback data is recycled. The callback data should not be used after this.
+  classPtr->m_ptrLifetimeManager->Release(callbackData);
 }
 CXilinxInfo *CKernelWrapper::GetXilInfo() const {
   return m_oXilInfo;
@@ -86,48 +80,10 @@ bool CKernelWrapper::IsKernelEnabled() const {
 std::vector<ProfiledLaunchData> &CKernelWrapper::GetAccumulatedProfiledKernelLaunchData() {
   return m_vProfiledKernelLaunches;
 }
-void CKernelWrapper::AddProfiledKernelLaunchDetails(std::string taskName,
-                                                    unsigned parentLayerId,
-                                                    cl_ulong durationNanoSecOcl) {
-  ProfiledLaunchData data;
-  data.taskName = taskName;
-  data.parentLayerId = parentLayerId;
-  data.durationOcl = durationNanoSecOcl;
+void CKernelWrapper::AddProfiledKernelLaunchDetails(const ProfiledLaunchData &data) {
   m_vProfiledKernelLaunches.push_back(data);
 }
-void CKernelWrapper::ResetBookKeeper() {
-  m_uBookKeeperCounter=0;
-  m_vBookKeeper.clear();
-}
-unsigned CKernelWrapper::GetTotalTensorsInBookKeeper() {
-  unsigned cnt=0;
-  if(!m_vBookKeeper.empty()){
-    for(auto &v:m_vBookKeeper){
-      cnt += v.size();
-    }
-  }
-  return cnt;
-}
-unsigned CKernelWrapper::GenerateBookKeeperId() {
-  return m_uBookKeeperCounter++;
-}
-unsigned CKernelWrapper::GetTheLastBookKeeperId() {
-  // returns -1 if empty otw a zero based index.
-  return m_uBookKeeperCounter-1;
-}
-CallbackData* CKernelWrapper::GenerateAndStoreCallBackData(void* classPtr, unsigned parentLayerId) {
-  CallbackData *obj = new CallbackData();
-  obj->profileKernel = GetProfileOclEnabled();
-  obj->kernelBookKeeperId = GenerateBookKeeperId();
-  obj->classPtr = classPtr;
-  obj->parentLayerId = parentLayerId;
-  m_vCallBackData.push_back(obj);
-  return obj;//m_vCallBackData.back();
+CallbackData* CKernelWrapper::StoreBookKeepingEntry(unsigned parentLayerId,
+                                                    const std::vector<CTensorBasePtr> &vecTensorsToBePreserved) {
+  return m_ptrLifetimeManager->Pin(vecTensorsToBePreserved, this, parentLayerId, GetProfileOclEnabled());
 }
-void CKernelWrapper::StoreBookKeepingEntry(const std::vector<CTensorBasePtr> &vecTensorsToBePreserved) {
-  m_vBookKeeper.push_back(vecTensorsToBePreserved);
-}
-void CKernelWrapper::ReleaseBookKeepingEntryAt(unsigned kernelBookKeepingId) {
-  m_vBookKeeper.at(kernelBookKeepingId).clear();
-}
-
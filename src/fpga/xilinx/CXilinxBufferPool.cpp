@@ -0,0 +1,125 @@
+#define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+
+#include "fpga/xilinx/CXilinxBufferPool.h"
+
+CXilinxBufferPool::CXilinxBufferPool(const cl::Context &context, bool enabled) {
+  m_oContext = context;
+  m_bEnabled = enabled;
+  m_uMaxCachedBytes = kDefaultMaxCachedBytes;
+  m_uReleaseTick = 0;
+}
+
+CXilinxBufferPool::~CXilinxBufferPool() {
+  Trim();
+}
+
+bool CXilinxBufferPool::IsReusable(const CachedBuffer &cachedBuffer) {
+  for(auto &event:cachedBuffer.pendingEvents){
+    if(event()==nullptr) continue;
+    cl_int status;
+    cl_int eventStatus;
+    OclCheck(status, status = event.getInfo(CL_EVENT_COMMAND_EXECUTION_STATUS, &eventStatus));
+    if(eventStatus!=CL_COMPLETE) return false;
+  }
+  return true;
+}
+
+cl::Buffer CXilinxBufferPool::Acquire(int bank, cl_mem_flags bankFlag, size_t sizeBytes) {
+  const size_t sizeClass = CMemoryPoolStats::GetSizeClass(sizeBytes);
+  {
+    std::lock_guard<std::mutex> lock(m_oMutex);
+    auto it = m_mFreeLists.find(std::make_pair(bank, sizeClass));
+    if(m_bEnabled && it!=m_mFreeLists.end()){
+      auto &freeList = it->second;
+      for(size_t i=freeList.size(); i-->0;){
+        if(IsReusable(freeList[i])){
+          cl::Buffer buffer = freeList[i].buffer;
+          freeList.erase(freeList.begin()+i);
+          m_oStats.OnAcquire(sizeClass, true);
+          return buffer;
+        }
+      }
+    }
+    m_oStats.OnAcquire(sizeClass, false);
+  }
+
+  cl_mem_ext_ptr_t extPtr;
+  extPtr.flags = bankFlag;
+  extPtr.obj = nullptr;
+  extPtr.param = 0;
+  cl_mem_flags flags = CL_MEM_READ_WRITE;
+  flags |= CL_MEM_EXT_PTR_XILINX;
+
+  cl_int status;
+  cl::Buffer buffer;
+  OclCheck(status, buffer = cl::Buffer(m_oContext, flags, sizeClass, &extPtr, &status));
+  return buffer;
+}
+
+void CXilinxBufferPool::Release(int bank,
+                                size_t sizeBytes,
+                                const cl::Buffer &buffer,
+                                const std::vector<cl::Event> &pendingEvents) {
+  const size_t sizeClass = CMemoryPoolStats::GetSizeClass(sizeBytes);
+  // The evicted buffers are dropped after the lock, the OpenCL runtime keeps them until their pending commands are done.
+  std::vector<cl::Buffer> evicted;
+  std::lock_guard<std::mutex> lock(m_oMutex);
+  const bool isCached = m_bEnabled && sizeClass<=m_uMaxCachedBytes;
+  m_oStats.OnRelease(sizeClass, isCached);
+  if(isCached){
+    m_mFreeLists[std::make_pair(bank, sizeClass)].push_back({buffer, pendingEvents, m_uReleaseTick++});
+    EvictOverCap(evicted);
+  }
+  // Otherwise the last reference to the buffer is dropped by the caller.
+}
+
+void CXilinxBufferPool::EvictOverCap(std::vector<cl::Buffer> &evicted) {
+  while(m_oStats.GetBytesCached()>m_uMaxCachedBytes){
+    auto oldest = m_mFreeLists.end();
+    for(auto it=m_mFreeLists.begin(); it!=m_mFreeLists.end(); it++){
+      if(it->second.empty()) continue;
+      if(oldest==m_mFreeLists.end() || it->second.front().releaseTick<oldest->second.front().releaseTick) oldest = it;
+    }
+    if(oldest==m_mFreeLists.end()) break;
+    evicted.push_back(oldest->second.front().buffer);
+    oldest->second.erase(oldest->second.begin());
+    m_oStats.OnEvict(oldest->first.second);
+  }
+}
+
+void CXilinxBufferPool::Trim() {
+  std::lock_guard<std::mutex> lock(m_oMutex);
+  for(auto &freeList:m_mFreeLists){
+    for(size_t i=0; i<freeList.second.size(); i++){
+      m_oStats.OnTrim(freeList.first.second);
+    }
+  }
+  m_mFreeLists.clear();
+}
+
+void CXilinxBufferPool::SetMaxCachedBytes(size_t maxCachedBytes) {
+  std::vector<cl::Buffer> evicted;
+  std::lock_guard<std::mutex> lock(m_oMutex);
+  m_uMaxCachedBytes = maxCachedBytes;
+  EvictOverCap(evicted);
+}
+
+size_t CXilinxBufferPool::GetMaxCachedBytes() const {
+  std::lock_guard<std::mutex> lock(m_oMutex);
+  return m_uMaxCachedBytes;
+}
+
+size_t CXilinxBufferPool::GetCachedBytes() const {
+  std::lock_guard<std::mutex> lock(m_oMutex);
+  return m_oStats.GetBytesCached();
+}
+
+void CXilinxBufferPool::ReportStats() const {
+  std::lock_guard<std::mutex> lock(m_oMutex);
+  m_oStats.Report("Xilinx Buffer Pool");
+}
+
+void CXilinxBufferPool::ResetStats() {
+  std::lock_guard<std::mutex> lock(m_oMutex);
+  m_oStats.ResetCounters();
+}
@@ -381,6 +381,115 @@ void ReduceSumRank4Axes012_V4(
     }
 }
 
+/**
+ * @brief      Computes the mean and the variance of the input tensor over the axes 0, 1, and 2 (TTTF) in a single
+ *             pass, instead of the two passes of ReduceSumRank4Axes012_V4 (pow_y=1 and pow_y=2).
+ *             The sums and the sums of the squares are accumulated per lane, shifted by the first slice of the input,
+ *             so that the cancellation of var=E[x^2]-E[x]^2 stays small for the activations with large means.
+ *             The mean is written at outputTn[0:vecsPerSlice] and the variance at outputTn[rowStride:rowStride+vecsPerSlice].
+ *             This kernel complies with the padded last dim policy.
+ *             This kernel supports burst read/write.
+ *
+ * @param[in]  inputTn    The input tn
+ * @param      outputTn   The output tn
+ * @param[in]  rowStride  The offset of the variance row in outputTn (in vectors)
+ * @param[in]  dim0       The dim 0
+ * @param[in]  dim1       The dim 1
+ * @param[in]  dim2       The dim 2
+ * @param[in]  dim3       The dim 3
+ */
+void ReduceMomentsRank4Axes012(
+        const MemoryPackF_t *inputTn,
+        MemoryPackF_t *outputTn,
+        const unsigned rowStride,
+        const unsigned dim0,
+        const unsigned dim1,
+        const unsigned dim2,
+        const unsigned dim3){
+
+#ifdef KERNEL_LOGS
+    cout<<"Simulation mode is enabled."<<endl;
+#endif
+
+    CONFIG_DTYPE buffShift[ConfigTaskReduce::Sum4D::MaxSliceLen];
+    #pragma HLS ARRAY_PARTITION variable=buffShift cyclic factor=CONFIG_M_AXI_WIDTH dim=1
+    CONFIG_DTYPE buffSum[ConfigTaskReduce::Sum4D::MaxSliceLen];
+    #pragma HLS ARRAY_PARTITION variable=buffSum cyclic factor=CONFIG_M_AXI_WIDTH dim=1
+    CONFIG_DTYPE buffSumSq[ConfigTaskReduce::Sum4D::MaxSliceLen];
+    #pragma HLS ARRAY_PARTITION variable=buffSumSq cyclic factor=CONFIG_M_AXI_WIDTH dim=1
+
+    const unsigned batchSize = dim0*dim1*dim2;
+    const unsigned dim3Padded = MakeDivisible<unsigned>(dim3, CONFIG_M_AXI_WIDTH);
+    const unsigned vecsPerSlice = dim3Padded/CONFIG_M_AXI_WIDTH;
+
+    assert(dim3Padded<=ConfigTaskReduce::Sum4D::MaxSliceLen);
+    assert(rowStride>=vecsPerSlice);
+
+    LoopInit0:
+    for(unsigned iVec=0; iVec<vecsPerSlice; iVec++){
+        #pragma HLS LOOP_TRIPCOUNT min=8 max=8
+        #pragma HLS PIPELINE II=1
+
+        MemoryPackF_t vec = inputTn[iVec];
+
+        LoopInit1:
+        for(unsigned i=0; i<CONFIG_M_AXI_WIDTH; i++){
+            #pragma HLS UNROLL
+            buffShift[iVec*CONFIG_M_AXI_WIDTH+i]=vec[i];
+            buffSum[iVec*CONFIG_M_AXI_WIDTH+i]=0;
+            buffSumSq[iVec*CONFIG_M_AXI_WIDTH+i]=0;
+        }
+    }
+
+    LoopBatch:
+    for(unsigned batch=0; batch<batchSize; batch++){
+        #pragma HLS PIPELINE off
+        #pragma HLS LOOP_FLATTEN off
+        #pragma HLS LOOP_TRIPCOUNT min=102400 max=102400
+
+        LoopSlice0:
+        for(unsigned iVec=0; iVec<vecsPerSlice; iVec++){
+            #pragma HLS LOOP_TRIPCOUNT min=8 max=8
+            #pragma HLS PIPELINE II=1
+            #pragma HLS DEPENDENCE variable=buffSum array inter false
+            #pragma HLS DEPENDENCE variable=buffSumSq array inter false
+
+            const unsigned indxS = batch*vecsPerSlice + iVec;
+            MemoryPackF_t vec = inputTn[indxS];
+
+            LoopCompute:
+            for(unsigned i=0; i<CONFIG_M_AXI_WIDTH; i++){
+                #pragma HLS UNROLL
+                const CONFIG_DTYPE delta = vec[i] - buffShift[iVec*CONFIG_M_AXI_WIDTH + i];
+                buffSum[iVec*CONFIG_M_AXI_WIDTH + i] += delta;
+                buffSumSq[iVec*CONFIG_M_AXI_WIDTH + i] += delta * delta;
+            }
+        }
+    }
+
+    const CONFIG_DTYPE coef = (CONFIG_DTYPE)1 / (CONFIG_DTYPE)batchSize;
+
+    LoopSlice1:
+    for(unsigned iVec=0; iVec<vecsPerSlice; iVec++){
+        #pragma HLS LOOP_TRIPCOUNT min=8 max=8
+        #pragma HLS PIPELINE II=1
+
+        MemoryPackF_t meanVec, varianceVec;
+
+        LoopOutput:
+        for(unsigned i=0; i<CONFIG_M_AXI_WIDTH; i++){
+            #pragma HLS UNROLL
+            const CONFIG_DTYPE shiftedMean = buffSum[iVec*CONFIG_M_AXI_WIDTH+i] * coef;
+            const CONFIG_DTYPE variance = buffSumSq[iVec*CONFIG_M_AXI_WIDTH+i] * coef - shiftedMean * shiftedMean;
+            meanVec[i] = buffShift[iVec*CONFIG_M_AXI_WIDTH+i] + shiftedMean;
+            varianceVec[i] = (variance > 0) ? variance : 0;
+        }
+
+        outputTn[iVec] = meanVec;
+        outputTn[rowStride + iVec] = varianceVec;
+    }
+}
+
 /*
 void ReduceSumRank4Axes012_V3_UnitRead(
     const MemoryPackF_t *inputTn,
@@ -842,16 +951,18 @@ extern "C" {
  *             1) ReduceSum, Rank3 & FFT
  *             2) ReduceSum, Rank4 & TTTF
  *             3) ReduceMax, Rank3 & FTF
+ *             4) Mean and Variance (single pass), Rank4 & TTTF
  *             For mode(1) pow_y, dim3, and overaxis3 are don't cares.
  *             For mode(2) there is not any don't cares.
  *             For mode(3) pow_y, dim3, and overaxis3 are don't cares.
+ *             For mode(4) pow_y is the offset of the variance row in outputTn (in vectors).
  *             This kernel supports burst read/write.
  *             
  *
  * @param[in]  inputTn    The input tn
  * @param      outputTn   The output tn
- * @param[in]  mode       The operation mode(1,2,or 3)
- * @param[in]  pow_y      The pow y
+ * @param[in]  mode       The operation mode(1,2,3, or 4)
+ * @param[in]  pow_y      The pow y (the row stride for mode 4)
  * @param[in]  dim0       The dim 0
  * @param[in]  dim1       The dim 1
  * @param[in]  dim2       The dim 2
@@ -883,7 +994,7 @@ void task_reduce(
     cout<<"Simulation mode is enabled."<<endl;
 #endif
 
-    assert(mode==1 || mode==2 || mode==3);
+    assert(mode==1 || mode==2 || mode==3 || mode==4);
 
     if(mode==1){
 #ifdef KERNEL_LOGS
@@ -905,6 +1016,13 @@ void task_reduce(
 #endif
         ReduceMaxRank3Axis1_V3(inputTn, outputTn, dim0, dim1, dim2); // Non-dataflow
     }
+
+    if(mode==4){
+#ifdef KERNEL_LOGS
+        cout<<"ReduceMomentsRank4Axes012 is selected."<<endl;
+#endif
+        ReduceMomentsRank4Axes012(inputTn, outputTn, pow_y, dim0, dim1, dim2, dim3); // Non-dataflow
+    }
     
 }
 }
@@ -1,7 +1,9 @@
 #include <cassert>
 #include <iostream>
 #include <limits>
+#ifndef SIMDEVICE
 #include <hls_math.h>
+#endif
 #include "hlslib/xilinx/Stream.h"
 #include "hlslib/xilinx/Simulation.h"
 #include "hlslib/xilinx/Utility.h"
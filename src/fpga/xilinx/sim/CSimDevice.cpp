@@ -0,0 +1,448 @@
+#define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+
+#include "fpga/xilinx/sim/CSimDevice.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include "GlobalHelpers.h"
+
+using namespace std;
+
+constexpr size_t kSimBufferAlignment = 4096;
+
+struct _cl_mem{
+  shared_ptr<char> storage;  // Shared with the parent buffer for the sub-buffers.
+  size_t offset;
+  size_t size;
+  bool isSubBuffer;
+  char* GetHostPtr() const { return storage.get()+offset; }
+};
+
+struct _cl_event{
+  mutex eventMutex;
+  condition_variable completeCv;
+  cl_int status = CL_QUEUED;
+  bool profiling = false;
+  cl_ulong timeQueued = 0, timeSubmit = 0, timeStart = 0, timeEnd = 0;
+  vector<pair<void (*)(cl_event, cl_int, void*), void*>> callbacks;
+  vector<shared_ptr<CSimDevice::Command>> dependents;  // The commands waiting for this event.
+};
+
+struct _cl_command_queue{
+  bool outOfOrder;
+  bool profiling;
+  mutex queueMutex;
+  shared_ptr<_cl_event> lastEvent;  // Only for the in-order queues.
+  unsigned outstanding = 0;         // Guarded by the mutex of CSimDevice.
+};
+
+struct CSimDevice::Command{
+  _cl_command_queue *queue;
+  int computeUnit;
+  function<void()> task;
+  shared_ptr<_cl_event> event;
+  atomic<unsigned> pendingDependencies;
+};
+
+void* CSimKernelArgs::GetHostPtr(unsigned index) const {
+  return m_vArgs[index].buffer->GetHostPtr();
+}
+
+CSimDevice& CSimDevice::Get() {
+  static CSimDevice device;
+  return device;
+}
+
+CSimDevice::CSimDevice() {
+  m_bStop = false;
+  m_vBusyUnits.assign(GetKernelTable().size(), false);
+  // Enough workers for all of the compute units and a transfer to be busy at the same time.
+  const unsigned hardwareThreads = std::max(2u, std::thread::hardware_concurrency());
+  const unsigned workerCount = std::min<unsigned>(hardwareThreads, GetKernelTable().size()+1);
+  for(unsigned i=0; i<workerCount; i++){
+    m_vWorkers.emplace_back(&CSimDevice::WorkerThread, this);
+  }
+}
+
+CSimDevice::~CSimDevice() {
+  {
+    lock_guard<mutex> lock(m_oMutex);
+    m_bStop = true;
+  }
+  m_oWorkCv.notify_all();
+  for(auto &worker:m_vWorkers){
+    worker.join();
+  }
+}
+
+int CSimDevice::FindKernel(const string &name) {
+  const auto &table = GetKernelTable();
+  for(size_t i=0; i<table.size(); i++){
+    if(name==table[i].name) return (int)i;
+  }
+  return -1;
+}
+
+unsigned CSimDevice::GetWorkerCount() const {
+  return (unsigned)m_vWorkers.size();
+}
+
+cl_ulong CSimDevice::GetNanoSeconds() {
+  return (cl_ulong)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+shared_ptr<_cl_event> CSimDevice::Enqueue(_cl_command_queue *queue,
+                                          int computeUnit,
+                                          function<void()> task,
+                                          const vector<shared_ptr<_cl_event>> &dependencies,
+                                          bool profiling) {
+  auto command = make_shared<Command>();
+  command->queue = queue;
+  command->computeUnit = computeUnit;
+  command->task = std::move(task);
+  command->event = make_shared<_cl_event>();
+  command->event->profiling = profiling;
+  command->event->timeQueued = GetNanoSeconds();
+  // The extra count keeps the command from being released before all of its dependencies are registered.
+  command->pendingDependencies = 1;
+  {
+    lock_guard<mutex> lock(m_oMutex);
+    queue->outstanding++;
+  }
+  for(auto &dependency:dependencies){
+    if(!dependency) continue;
+    lock_guard<mutex> lock(dependency->eventMutex);
+    if(dependency->status!=CL_COMPLETE){
+      command->pendingDependencies++;
+      dependency->dependents.push_back(command);
+    }
+  }
+  if(--command->pendingDependencies==0){
+    MakeReady(command);
+  }
+  return command->event;
+}
+
+void CSimDevice::MakeReady(const shared_ptr<Command> &command) {
+  {
+    lock_guard<mutex> lock(command->event->eventMutex);
+    command->event->status = CL_SUBMITTED;
+    command->event->timeSubmit = GetNanoSeconds();
+  }
+  {
+    lock_guard<mutex> lock(m_oMutex);
+    m_dReady.push_back(command);
+  }
+  m_oWorkCv.notify_one();
+}
+
+bool CSimDevice::PopRunnable(shared_ptr<Command> &command) {
+  // The oldest ready command whose compute unit is idle, guarded by m_oMutex.
+  for(auto it=m_dReady.begin(); it!=m_dReady.end(); it++){
+    const int unit = (*it)->computeUnit;
+    if(unit<0 || !m_vBusyUnits[unit]){
+      command = *it;
+      m_dReady.erase(it);
+      if(unit>=0) m_vBusyUnits[unit] = true;
+      return true;
+    }
+  }
+  return false;
+}
+
+void CSimDevice::Complete(const shared_ptr<Command> &command) {
+  auto &event = command->event;
+  vector<pair<void (*)(cl_event, cl_int, void*), void*>> callbacks;
+  vector<shared_ptr<Command>> dependents;
+  {
+    lock_guard<mutex> lock(event->eventMutex);
+    event->timeEnd = GetNanoSeconds();
+    event->status = CL_COMPLETE;
+    callbacks.swap(event->callbacks);
+    dependents.swap(event->dependents);
+  }
+  event->completeCv.notify_all();
+  for(auto &callback:callbacks){
+    callback.first(event.get(), CL_COMPLETE, callback.second);
+  }
+  for(auto &dependent:dependents){
+    if(--dependent->pendingDependencies==0){
+      MakeReady(dependent);
+    }
+  }
+}
+
+void CSimDevice::WorkerThread() {
+  unique_lock<mutex> lock(m_oMutex);
+  while(true){
+    shared_ptr<Command> command;
+    m_oWorkCv.wait(lock, [&]{ return PopRunnable(command) || m_bStop; });
+    if(!command) return;
+    lock.unlock();
+
+    {
+      lock_guard<mutex> eventLock(command->event->eventMutex);
+      command->event->status = CL_RUNNING;
+      command->event->timeStart = GetNanoSeconds();
+    }
+    command->task();
+    Complete(command);
+
+    lock.lock();
+    if(command->computeUnit>=0){
+      m_vBusyUnits[command->computeUnit] = false;
+      // A command of this compute unit might be waiting in the ready queue.
+      m_oWorkCv.notify_all();
+    }
+    if(--command->queue->outstanding==0){
+      m_oIdleCv.notify_all();
+    }
+  }
+}
+
+void CSimDevice::Finish(_cl_command_queue *queue) {
+  unique_lock<mutex> lock(m_oMutex);
+  m_oIdleCv.wait(lock, [&]{ return queue->outstanding==0; });
+}
+
+//======================================================================================================================
+
+cl_int clGetEventProfilingInfo(cl_event event,
+                               cl_profiling_info paramName,
+                               size_t paramValueSize,
+                               void *paramValue,
+                               size_t *paramValueSizeRet) {
+  if(event==nullptr) return CL_INVALID_EVENT;
+  if(paramValueSize<sizeof(cl_ulong)) return CL_INVALID_VALUE;
+  lock_guard<mutex> lock(event->eventMutex);
+  if(!event->profiling || event->status!=CL_COMPLETE) return CL_PROFILING_INFO_NOT_AVAILABLE;
+  cl_ulong value;
+  switch(paramName){
+    case CL_PROFILING_COMMAND_QUEUED: value = event->timeQueued; break;
+    case CL_PROFILING_COMMAND_SUBMIT: value = event->timeSubmit; break;
+    case CL_PROFILING_COMMAND_START: value = event->timeStart; break;
+    case CL_PROFILING_COMMAND_END: value = event->timeEnd; break;
+    default: return CL_INVALID_VALUE;
+  }
+  *(cl_ulong*)paramValue = value;
+  if(paramValueSizeRet) *paramValueSizeRet = sizeof(cl_ulong);
+  return CL_SUCCESS;
+}
+
+namespace cl{
+
+cl_int Platform::get(vector<Platform> *platforms) {
+  platforms->assign(1, Platform());
+  return CL_SUCCESS;
+}
+
+cl_int Platform::getDevices(cl_device_type type, vector<Device> *devices) const {
+  devices->assign(1, Device());
+  return CL_SUCCESS;
+}
+
+Context::Context(const Device &device,
+                 const cl_context_properties *properties,
+                 void *notifyFptr,
+                 void *data,
+                 cl_int *err) {
+  if(err) *err = CL_SUCCESS;
+}
+
+Program::Program(const Context &context,
+                 const vector<Device> &devices,
+                 const Binaries &binaries,
+                 vector<cl_int> *binaryStatus,
+                 cl_int *err) {
+  SPDLOG_LOGGER_INFO(logger, "The simulated device runs {} kernels on {} workers, the FPGA image is not used.",
+                     CSimDevice::GetKernelTable().size(), CSimDevice::Get().GetWorkerCount());
+  if(binaryStatus) binaryStatus->assign(devices.size(), CL_SUCCESS);
+  if(err) *err = CL_SUCCESS;
+}
+
+Buffer::Buffer(const Context &context, cl_mem_flags flags, size_t size, void *hostPtr, cl_int *err) {
+  if(size==0){
+    if(err) *err = CL_INVALID_BUFFER_SIZE;
+    return;
+  }
+  void *ptr = nullptr;
+  if(posix_memalign(&ptr, kSimBufferAlignment, size)!=0){
+    throw bad_alloc();
+  }
+  m_ptrMem = make_shared<_cl_mem>();
+  m_ptrMem->storage = shared_ptr<char>((char*)ptr, free);
+  m_ptrMem->offset = 0;
+  m_ptrMem->size = size;
+  m_ptrMem->isSubBuffer = false;
+  if(err) *err = CL_SUCCESS;
+}
+
+Buffer Buffer::createSubBuffer(cl_mem_flags flags, cl_buffer_create_type type, const void *createInfo, cl_int *err) const {
+  Buffer subBuffer;
+  const auto *region = (const cl_buffer_region*)createInfo;
+  cl_int status = CL_SUCCESS;
+  if(!m_ptrMem || m_ptrMem->isSubBuffer || type!=CL_BUFFER_CREATE_TYPE_REGION){
+    // As with OpenCL, a sub-buffer could not be created from another sub-buffer.
+    status = CL_INVALID_MEM_OBJECT;
+  }else if(region->size==0 || region->origin+region->size>m_ptrMem->size){
+    status = CL_INVALID_VALUE;
+  }else if(region->origin%kSimBufferAlignment!=0){
+    status = CL_MISALIGNED_SUB_BUFFER_OFFSET;
+  }else{
+    subBuffer.m_ptrMem = make_shared<_cl_mem>();
+    subBuffer.m_ptrMem->storage = m_ptrMem->storage;
+    subBuffer.m_ptrMem->offset = m_ptrMem->offset+region->origin;
+    subBuffer.m_ptrMem->size = region->size;
+    subBuffer.m_ptrMem->isSubBuffer = true;
+  }
+  if(err) *err = status;
+  return subBuffer;
+}
+
+cl_int Event::wait() const {
+  if(!m_ptrEvent) return CL_INVALID_EVENT;
+  unique_lock<mutex> lock(m_ptrEvent->eventMutex);
+  m_ptrEvent->completeCv.wait(lock, [&]{ return m_ptrEvent->status==CL_COMPLETE; });
+  return CL_SUCCESS;
+}
+
+cl_int Event::setCallback(cl_int type, void (CL_CALLBACK *notifyFptr)(cl_event, cl_int, void*), void *userData) {
+  if(!m_ptrEvent) return CL_INVALID_EVENT;
+  if(type!=CL_COMPLETE) return CL_INVALID_VALUE;
+  {
+    lock_guard<mutex> lock(m_ptrEvent->eventMutex);
+    if(m_ptrEvent->status!=CL_COMPLETE){
+      m_ptrEvent->callbacks.emplace_back(notifyFptr, userData);
+      return CL_SUCCESS;
+    }
+  }
+  // The command has already completed.
+  notifyFptr(m_ptrEvent.get(), CL_COMPLETE, userData);
+  return CL_SUCCESS;
+}
+
+cl_int Event::getInfo(cl_event_info name, cl_int *param) const {
+  if(!m_ptrEvent) return CL_INVALID_EVENT;
+  if(name!=CL_EVENT_COMMAND_EXECUTION_STATUS) return CL_INVALID_VALUE;
+  lock_guard<mutex> lock(m_ptrEvent->eventMutex);
+  *param = m_ptrEvent->status;
+  return CL_SUCCESS;
+}
+
+cl_int Event::getProfilingInfo(cl_profiling_info name, cl_ulong *param) const {
+  return clGetEventProfilingInfo(m_ptrEvent.get(), name, sizeof(cl_ulong), param, nullptr);
+}
+
+Kernel::Kernel(const Program &program, const char *name, cl_int *err) {
+  m_iKernelIndex = CSimDevice::FindKernel(name);
+  if(m_iKernelIndex>=0){
+    m_vArgs.resize(strlen(CSimDevice::GetKernelTable()[m_iKernelIndex].signature));
+  }
+  if(err) *err = m_iKernelIndex>=0 ? CL_SUCCESS : CL_INVALID_KERNEL_NAME;
+}
+
+cl_int Kernel::setArg(cl_uint index, const Buffer &buffer) {
+  if(m_iKernelIndex<0) return CL_INVALID_KERNEL;
+  if(index>=m_vArgs.size()) return CL_INVALID_ARG_INDEX;
+  if(CSimDevice::GetKernelTable()[m_iKernelIndex].signature[index]!='b' || !buffer.m_ptrMem) return CL_INVALID_MEM_OBJECT;
+  m_vArgs[index].buffer = buffer.m_ptrMem;
+  m_vArgs[index].scalarSize = 0;
+  return CL_SUCCESS;
+}
+
+cl_int Kernel::SetScalarArg(cl_uint index, uint64_t raw, size_t size) {
+  if(m_iKernelIndex<0) return CL_INVALID_KERNEL;
+  if(index>=m_vArgs.size()) return CL_INVALID_ARG_INDEX;
+  // All of the scalar arguments of the kernels are 32-bit.
+  if(CSimDevice::GetKernelTable()[m_iKernelIndex].signature[index]=='b' || size!=sizeof(uint32_t)) return CL_INVALID_ARG_SIZE;
+  m_vArgs[index].buffer.reset();
+  m_vArgs[index].scalar = raw;
+  m_vArgs[index].scalarSize = size;
+  return CL_SUCCESS;
+}
+
+CommandQueue::CommandQueue(const Context &context, const Device &device, cl_command_queue_properties properties, cl_int *err) {
+  m_ptrQueue = make_shared<_cl_command_queue>();
+  m_ptrQueue->outOfOrder = (properties & CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE)!=0;
+  m_ptrQueue->profiling = (properties & CL_QUEUE_PROFILING_ENABLE)!=0;
+  if(err) *err = CL_SUCCESS;
+}
+
+cl_int CommandQueue::Enqueue(int computeUnit, function<void()> task, cl_bool blocking,
+                             const vector<Event> *events, Event *event) const {
+  vector<shared_ptr<_cl_event>> dependencies;
+  if(events){
+    for(auto &e:*events) dependencies.push_back(e.m_ptrEvent);
+  }
+
+  shared_ptr<_cl_event> newEvent;
+  if(m_ptrQueue->outOfOrder){
+    newEvent = CSimDevice::Get().Enqueue(m_ptrQueue.get(), computeUnit, std::move(task), dependencies, m_ptrQueue->profiling);
+  }else{
+    // The commands of an in-order queue depend on their predecessors.
+    lock_guard<mutex> lock(m_ptrQueue->queueMutex);
+    dependencies.push_back(m_ptrQueue->lastEvent);
+    newEvent = CSimDevice::Get().Enqueue(m_ptrQueue.get(), computeUnit, std::move(task), dependencies, m_ptrQueue->profiling);
+    m_ptrQueue->lastEvent = newEvent;
+  }
+
+  if(event) event->m_ptrEvent = newEvent;
+  if(blocking){
+    unique_lock<mutex> lock(newEvent->eventMutex);
+    newEvent->completeCv.wait(lock, [&]{ return newEvent->status==CL_COMPLETE; });
+  }
+  return CL_SUCCESS;
+}
+
+cl_int CommandQueue::enqueueReadBuffer(const Buffer &buffer, cl_bool blocking, size_t offset, size_t size, void *ptr,
+                                       const vector<Event> *events, Event *event) const {
+  if(!buffer.m_ptrMem) return CL_INVALID_MEM_OBJECT;
+  if(offset+size>buffer.m_ptrMem->size) return CL_INVALID_VALUE;
+  auto mem = buffer.m_ptrMem;
+  return Enqueue(-1, [mem, offset, size, ptr]{ memcpy(ptr, mem->GetHostPtr()+offset, size); }, blocking, events, event);
+}
+
+cl_int CommandQueue::enqueueWriteBuffer(const Buffer &buffer, cl_bool blocking, size_t offset, size_t size, const void *ptr,
+                                        const vector<Event> *events, Event *event) const {
+  if(!buffer.m_ptrMem) return CL_INVALID_MEM_OBJECT;
+  if(offset+size>buffer.m_ptrMem->size) return CL_INVALID_VALUE;
+  // As with OpenCL, ptr is read when the command runs, the host should keep it alive for the non-blocking writes.
+  auto mem = buffer.m_ptrMem;
+  return Enqueue(-1, [mem, offset, size, ptr]{ memcpy(mem->GetHostPtr()+offset, ptr, size); }, blocking, events, event);
+}
+
+cl_int CommandQueue::enqueueCopyBuffer(const Buffer &src, const Buffer &dst, size_t srcOffset, size_t dstOffset, size_t size,
+                                       const vector<Event> *events, Event *event) const {
+  if(!src.m_ptrMem || !dst.m_ptrMem) return CL_INVALID_MEM_OBJECT;
+  if(srcOffset+size>src.m_ptrMem->size || dstOffset+size>dst.m_ptrMem->size) return CL_INVALID_VALUE;
+  auto srcMem = src.m_ptrMem;
+  auto dstMem = dst.m_ptrMem;
+  return Enqueue(-1, [srcMem, dstMem, srcOffset, dstOffset, size]{
+    memmove(dstMem->GetHostPtr()+dstOffset, srcMem->GetHostPtr()+srcOffset, size);
+  }, CL_FALSE, events, event);
+}
+
+cl_int CommandQueue::enqueueTask(const Kernel &kernel, const vector<Event> *events, Event *event) const {
+  if(kernel.m_iKernelIndex<0) return CL_INVALID_KERNEL;
+  const auto &entry = CSimDevice::GetKernelTable()[kernel.m_iKernelIndex];
+  for(size_t i=0; i<kernel.m_vArgs.size(); i++){
+    const bool isSet = entry.signature[i]=='b' ? (bool)kernel.m_vArgs[i].buffer : kernel.m_vArgs[i].scalarSize!=0;
+    if(!isSet) return CL_INVALID_KERNEL_ARGS;
+  }
+  // The arguments are captured at the enqueue, the kernel object can be reused for the next launch right away.
+  auto args = kernel.m_vArgs;
+  auto launch = entry.launch;
+  return Enqueue(kernel.m_iKernelIndex, [args, launch]{ launch(CSimKernelArgs(args)); }, CL_FALSE, events, event);
+}
+
+cl_int CommandQueue::enqueueMarkerWithWaitList(const vector<Event> *events, Event *event) const {
+  return Enqueue(-1, []{}, CL_FALSE, events, event);
+}
+
+cl_int CommandQueue::finish() const {
+  CSimDevice::Get().Finish(m_ptrQueue.get());
+  return CL_SUCCESS;
+}
+
+}
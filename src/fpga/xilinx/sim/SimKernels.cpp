@@ -0,0 +1,172 @@
+#define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+
+#include "fpga/xilinx/sim/CSimDevice.h"
+#include "hlslib/xilinx/DataPack.h"
+#include "AxiHelper.h"
+#include "Conv2D.h"
+#include "xilinx/config.h"
+
+// The top-functions of src/fpga/xilinx/kernels, compiled natively with HLSLIB_XILINX (C-simulation) as in the
+// kerneltests.
+extern "C" {
+void task_conv2_1x1_direct(MemoryPackK_t const a[], MemoryPackM_t const b[], MemoryPackM_t const e[], MemoryPackM_t c[],
+                           const unsigned size_n, const unsigned size_k, const unsigned size_m);
+void task_topk(const MemoryPackF_t *inputTn, MemoryPackI_t *indicesSplitedTn, const unsigned dim0, const unsigned dim1,
+               const unsigned kValue, const unsigned vecsPerSlice, const unsigned vecsPerOutputSlice);
+void task_basicops(const MemoryPackF_t *inputTn1, const MemoryPackF_t *inputTn2, MemoryPackF_t *outputTn,
+                   const unsigned dim0, const unsigned dim1, const unsigned dim2, const unsigned dim3,
+                   const unsigned dim0B, const unsigned dim1B, const unsigned dim2B, const unsigned dim3B,
+                   const int rankA, const int rankB, const int mode, const float scalar);
+void task_reduce(const MemoryPackF_t *inputTn, MemoryPackF_t *outputTn, const unsigned mode, const unsigned pow_y,
+                 const unsigned dim0, const unsigned dim1, const unsigned dim2, const unsigned dim3);
+void task_matmul(const CONFIG_DTYPE *inputTn1, const MemoryPackF_t *inputTn2, MemoryPackF_t *outputTn,
+                 const unsigned sizeBatch, const unsigned sizeN, const unsigned sizeK, const unsigned sizeM);
+void task_tile(const MemoryPackF_t *inputTn, MemoryPackF_t *outputTn, const unsigned dim0, const unsigned dim1,
+               const unsigned dim2, const unsigned rank, const unsigned tileAxis, const unsigned tileSize);
+void task_gather(const MemoryPackF_t *inputTn, const unsigned *indicesTn, MemoryPackF_t *outputTn,
+                 unsigned indicesAxis, unsigned inputDim0, unsigned inputDim1, unsigned inputDim2,
+                 unsigned indicesDim0, unsigned indicesDim1, unsigned indicesDim2);
+void task_concat(const MemoryPackF_t *inputTn1, const MemoryPackF_t *inputTn2, MemoryPackF_t *outputTn,
+                 const unsigned dim0, const unsigned dim1, const unsigned dim2, const unsigned dimA3,
+                 const unsigned dimB3, const int concatDim);
+void task_transpose(const MemoryPackF_t *inputTn, MemoryPackF_t *outputTn, const unsigned dim0, const unsigned dim1,
+                    const unsigned dim2);
+void task_relu_sqrt_square(const MemoryPackF_t *inputTn, MemoryPackF_t *outputTn, const unsigned len,
+                           const unsigned mode);
+void task_pad_unpad(const MemoryPackF_t *inputTn, MemoryPackF_t *outputTn, const unsigned mode, const unsigned dim0,
+                    const unsigned dim1, const unsigned pad_dim1Padded, const unsigned pad_lcm,
+                    const unsigned unpad_dim1Unpadded);
+void task_datamover(
+#ifdef USEMEMORYBANK0
+    MemoryPackF_t *dataBank0,
+#endif
+#ifdef USEMEMORYBANK1
+    MemoryPackF_t *dataBank1,
+#endif
+#ifdef USEMEMORYBANK2
+    MemoryPackF_t *dataBank2,
+#endif
+#ifdef USEMEMORYBANK3
+    MemoryPackF_t *dataBank3,
+#endif
+    const unsigned srcBank, const unsigned destBank, const unsigned vecCount);
+}
+
+namespace {
+
+void LaunchConv2(const CSimKernelArgs &a){
+  task_conv2_1x1_direct(a.Buffer<MemoryPackK_t>(0), a.Buffer<MemoryPackM_t>(1), a.Buffer<MemoryPackM_t>(2),
+                        a.Buffer<MemoryPackM_t>(3), a.Scalar<unsigned>(4), a.Scalar<unsigned>(5), a.Scalar<unsigned>(6));
+}
+
+void LaunchTopK(const CSimKernelArgs &a){
+  task_topk(a.Buffer<MemoryPackF_t>(0), a.Buffer<MemoryPackI_t>(1), a.Scalar<unsigned>(2), a.Scalar<unsigned>(3),
+            a.Scalar<unsigned>(4), a.Scalar<unsigned>(5), a.Scalar<unsigned>(6));
+}
+
+void LaunchBasicOps(const CSimKernelArgs &a){
+  task_basicops(a.Buffer<MemoryPackF_t>(0), a.Buffer<MemoryPackF_t>(1), a.Buffer<MemoryPackF_t>(2),
+                a.Scalar<unsigned>(3), a.Scalar<unsigned>(4), a.Scalar<unsigned>(5), a.Scalar<unsigned>(6),
+                a.Scalar<unsigned>(7), a.Scalar<unsigned>(8), a.Scalar<unsigned>(9), a.Scalar<unsigned>(10),
+                a.Scalar<int>(11), a.Scalar<int>(12), a.Scalar<int>(13), a.Scalar<float>(14));
+}
+
+void LaunchReduce(const CSimKernelArgs &a){
+  task_reduce(a.Buffer<MemoryPackF_t>(0), a.Buffer<MemoryPackF_t>(1), a.Scalar<unsigned>(2), a.Scalar<unsigned>(3),
+              a.Scalar<unsigned>(4), a.Scalar<unsigned>(5), a.Scalar<unsigned>(6), a.Scalar<unsigned>(7));
+}
+
+void LaunchMatmul(const CSimKernelArgs &a){
+  task_matmul(a.Buffer<CONFIG_DTYPE>(0), a.Buffer<MemoryPackF_t>(1), a.Buffer<MemoryPackF_t>(2),
+              a.Scalar<unsigned>(3), a.Scalar<unsigned>(4), a.Scalar<unsigned>(5), a.Scalar<unsigned>(6));
+}
+
+void LaunchTile(const CSimKernelArgs &a){
+  task_tile(a.Buffer<MemoryPackF_t>(0), a.Buffer<MemoryPackF_t>(1), a.Scalar<unsigned>(2), a.Scalar<unsigned>(3),
+            a.Scalar<unsigned>(4), a.Scalar<unsigned>(5), a.Scalar<unsigned>(6), a.Scalar<unsigned>(7));
+}
+
+void LaunchGather(const CSimKernelArgs &a){
+  task_gather(a.Buffer<MemoryPackF_t>(0), a.Buffer<unsigned>(1), a.Buffer<MemoryPackF_t>(2),
+              a.Scalar<unsigned>(3), a.Scalar<unsigned>(4), a.Scalar<unsigned>(5), a.Scalar<unsigned>(6),
+              a.Scalar<unsigned>(7), a.Scalar<unsigned>(8), a.Scalar<unsigned>(9));
+}
+
+void LaunchConcat(const CSimKernelArgs &a){
+  task_concat(a.Buffer<MemoryPackF_t>(0), a.Buffer<MemoryPackF_t>(1), a.Buffer<MemoryPackF_t>(2),
+              a.Scalar<unsigned>(3), a.Scalar<unsigned>(4), a.Scalar<unsigned>(5), a.Scalar<unsigned>(6),
+              a.Scalar<unsigned>(7), a.Scalar<int>(8));
+}
+
+void LaunchTranspose(const CSimKernelArgs &a){
+  task_transpose(a.Buffer<MemoryPackF_t>(0), a.Buffer<MemoryPackF_t>(1), a.Scalar<unsigned>(2), a.Scalar<unsigned>(3),
+                 a.Scalar<unsigned>(4));
+}
+
+void LaunchReluSqrtSquare(const CSimKernelArgs &a){
+  task_relu_sqrt_square(a.Buffer<MemoryPackF_t>(0), a.Buffer<MemoryPackF_t>(1), a.Scalar<unsigned>(2),
+                        a.Scalar<unsigned>(3));
+}
+
+void LaunchPadUnpad(const CSimKernelArgs &a){
+  task_pad_unpad(a.Buffer<MemoryPackF_t>(0), a.Buffer<MemoryPackF_t>(1), a.Scalar<unsigned>(2), a.Scalar<unsigned>(3),
+                 a.Scalar<unsigned>(4), a.Scalar<unsigned>(5), a.Scalar<unsigned>(6), a.Scalar<unsigned>(7));
+}
+
+// A buffer argument per enabled memory bank, then srcBank, destBank and vecCount.
+constexpr unsigned kDatamoverBankCount = 0
+#ifdef USEMEMORYBANK0
+    +1
+#endif
+#ifdef USEMEMORYBANK1
+    +1
+#endif
+#ifdef USEMEMORYBANK2
+    +1
+#endif
+#ifdef USEMEMORYBANK3
+    +1
+#endif
+    ;
+constexpr const char *kDatamoverSignature = kDatamoverBankCount==1 ? "buuu" :
+                                            kDatamoverBankCount==2 ? "bbuuu" :
+                                            kDatamoverBankCount==3 ? "bbbuuu" : "bbbbuuu";
+
+void LaunchDatamover(const CSimKernelArgs &a){
+  unsigned arg = 0;
+  task_datamover(
+#ifdef USEMEMORYBANK0
+      a.Buffer<MemoryPackF_t>(arg++),
+#endif
+#ifdef USEMEMORYBANK1
+      a.Buffer<MemoryPackF_t>(arg++),
+#endif
+#ifdef USEMEMORYBANK2
+      a.Buffer<MemoryPackF_t>(arg++),
+#endif
+#ifdef USEMEMORYBANK3
+      a.Buffer<MemoryPackF_t>(arg++),
+#endif
+      a.Scalar<unsigned>(kDatamoverBankCount), a.Scalar<unsigned>(kDatamoverBankCount+1),
+      a.Scalar<unsigned>(kDatamoverBankCount+2));
+}
+
+}
+
+const std::vector<CSimDevice::KernelEntry>& CSimDevice::GetKernelTable() {
+  static const std::vector<KernelEntry> table = {
+      {"task_conv2_1x1_direct", "bbbbuuu", &LaunchConv2},
+      {"task_topk", "bbuuuuu", &LaunchTopK},
+      {"task_basicops", "bbbuuuuuuuuiiif", &LaunchBasicOps},
+      {"task_reduce", "bbuuuuuu", &LaunchReduce},
+      {"task_matmul", "bbbuuuu", &LaunchMatmul},
+      {"task_tile", "bbuuuuuu", &LaunchTile},
+      {"task_gather", "bbbuuuuuuu", &LaunchGather},
+      {"task_concat", "bbbuuuuui", &LaunchConcat},
+      {"task_transpose", "bbuuu", &LaunchTranspose},
+      {"task_relu_sqrt_square", "bbuu", &LaunchReluSqrtSquare},
+      {"task_pad_unpad", "bbuuuuuu", &LaunchPadUnpad},
+      {"task_datamover", kDatamoverSignature, &LaunchDatamover}
+  };
+  return table;
+}
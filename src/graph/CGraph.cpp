@@ -0,0 +1,128 @@
+#define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+
+#include "graph/CGraph.h"
+#include <map>
+#include <queue>
+#include <functional>
+
+unsigned CGraph::AddNode(const CGraphNode &node) {
+  const unsigned nodeId = (unsigned)m_vNodes.size();
+  for(auto inputId:node.inputs){
+    ConditionCheck(inputId<nodeId, "The inputs of a graph node should be added before the node.");
+  }
+  m_vNodes.push_back(node);
+  m_vNodes.back().id = nodeId;
+  if(node.op==GRAPH_OPS::INPUT) m_vInputNodes.push_back(nodeId);
+  return nodeId;
+}
+
+void CGraph::MarkOutput(unsigned nodeId) {
+  ConditionCheck(nodeId<m_vNodes.size(), "Undefined graph node.");
+  m_vOutputNodes.push_back(nodeId);
+}
+
+CGraphNode& CGraph::GetNode(unsigned nodeId) {
+  ConditionCheck(nodeId<m_vNodes.size(), "Undefined graph node.");
+  return m_vNodes[nodeId];
+}
+
+const CGraphNode& CGraph::GetNode(unsigned nodeId) const {
+  ConditionCheck(nodeId<m_vNodes.size(), "Undefined graph node.");
+  return m_vNodes[nodeId];
+}
+
+size_t CGraph::GetNodeCount() const {
+  return m_vNodes.size();
+}
+
+const std::vector<unsigned>& CGraph::GetInputNodes() const {
+  return m_vInputNodes;
+}
+
+const std::vector<unsigned>& CGraph::GetOutputNodes() const {
+  return m_vOutputNodes;
+}
+
+std::vector<unsigned> CGraph::GetConsumerCounts() const {
+  std::vector<unsigned> counts(m_vNodes.size(), 0);
+  for(auto &node:m_vNodes){
+    for(auto inputId:node.inputs){
+      counts[inputId]++;
+    }
+  }
+  return counts;
+}
+
+std::vector<unsigned> CGraph::GetTopologicalOrder() const {
+  std::vector<unsigned> inDegrees(m_vNodes.size(), 0);
+  std::vector<std::vector<unsigned>> consumers(m_vNodes.size());
+  for(auto &node:m_vNodes){
+    inDegrees[node.id] = (unsigned)node.inputs.size();
+    for(auto inputId:node.inputs){
+      consumers[inputId].push_back(node.id);
+    }
+  }
+
+  std::priority_queue<unsigned, std::vector<unsigned>, std::greater<unsigned>> ready;
+  for(auto &node:m_vNodes){
+    if(inDegrees[node.id]==0) ready.push(node.id);
+  }
+  std::vector<unsigned> order;
+  order.reserve(m_vNodes.size());
+  while(!ready.empty()){
+    const unsigned nodeId = ready.top();
+    ready.pop();
+    order.push_back(nodeId);
+    for(auto consumerId:consumers[nodeId]){
+      if(--inDegrees[consumerId]==0) ready.push(consumerId);
+    }
+  }
+  ConditionCheck(order.size()==m_vNodes.size(), "The graph has a cycle.");
+  return order;
+}
+
+void CGraph::PrintSummary() const {
+  std::map<std::string, unsigned> opCounts;
+  unsigned cpuNodes=0, xilNodes=0;
+  for(auto &node:m_vNodes){
+    opCounts[GetOpName(node.op)]++;
+    if(node.op==GRAPH_OPS::INPUT || node.op==GRAPH_OPS::CONSTANT) continue;
+    if(node.platform==PLATFORMS::CPU) cpuNodes++; else xilNodes++;
+  }
+  SPDLOG_LOGGER_INFO(logger, "CGraph: Nodes: {}, Inputs: {}, Outputs: {}, Nodes on CPU: {}, Nodes on XIL: {}",
+                     m_vNodes.size(), m_vInputNodes.size(), m_vOutputNodes.size(), cpuNodes, xilNodes);
+  for(auto &opCount:opCounts){
+    SPDLOG_LOGGER_TRACE(logger, "CGraph: {}: {}", opCount.first, opCount.second);
+  }
+}
+
+std::string CGraph::GetOpName(GRAPH_OPS op) {
+  switch(op){
+    case GRAPH_OPS::INPUT:            return "Input";
+    case GRAPH_OPS::CONSTANT:         return "Constant";
+    case GRAPH_OPS::CONCAT2:          return "Concat2";
+    case GRAPH_OPS::MATMUL:           return "MatMul";
+    case GRAPH_OPS::RELU:             return "ReLU";
+    case GRAPH_OPS::SQRT:             return "Sqrt";
+    case GRAPH_OPS::SQUARE:           return "Square";
+    case GRAPH_OPS::BASIC_OPS:        return "BasicOps";
+    case GRAPH_OPS::BASIC_OPS_SCALAR: return "BasicOpsScalar";
+    case GRAPH_OPS::TILE:             return "Tile";
+    case GRAPH_OPS::TRANSPOSE:        return "Transpose";
+    case GRAPH_OPS::GATHER:           return "Gather";
+    case GRAPH_OPS::REDUCE:           return "Reduce";
+    case GRAPH_OPS::MEAN:             return "Mean";
+    case GRAPH_OPS::VARIANCE:         return "Variance";
+    case GRAPH_OPS::PAD_LAST_DIM:     return "PadLastDim";
+    case GRAPH_OPS::UNPAD_LAST_DIM:   return "UnpadLastDim";
+    case GRAPH_OPS::TOPK:             return "TopK";
+    case GRAPH_OPS::CONV2D:           return "Conv2D";
+    case GRAPH_OPS::KNN:              return "KNN";
+    case GRAPH_OPS::EDGECONV:         return "EdgeConv";
+    case GRAPH_OPS::RESHAPE:          return "Reshape";
+    case GRAPH_OPS::EXPAND_DIMS:      return "ExpandDims";
+    case GRAPH_OPS::SQUEEZE_DIMS:     return "SqueezeDims";
+    case GRAPH_OPS::CROSS_PLATFORM:   return "CrossPlatform";
+  }
+  ThrowException("Undefined graph operation.");
+}
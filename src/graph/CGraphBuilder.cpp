@@ -0,0 +1,208 @@
+#define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+
+#include "graph/CGraphBuilder.h"
+
+CGraphBuilder::CGraphBuilder(CGraph *graph, CWeightLoader *weightLoader, PLATFORMS platform) {
+  m_ptrGraph = graph;
+  m_ptrWeightLoader = weightLoader;
+  m_ePlatform = platform;
+}
+
+void CGraphBuilder::SetPlatform(PLATFORMS platform) {
+  m_ePlatform = platform;
+}
+
+PLATFORMS CGraphBuilder::GetPlatform() const {
+  return m_ePlatform;
+}
+
+void CGraphBuilder::SetScope(const std::string &scope) {
+  m_strScope = scope;
+}
+
+CGraphNode CGraphBuilder::NewNode(GRAPH_OPS op, const std::vector<unsigned> &inputs) const {
+  CGraphNode node;
+  node.id = 0;
+  node.op = op;
+  node.platform = m_ePlatform;
+  node.name = m_strScope.empty() ? CGraph::GetOpName(op) : m_strScope+"/"+CGraph::GetOpName(op);
+  node.inputs = inputs;
+  node.weightIndex = -1;
+  node.basicOpsMode = BASIC_OPS::ADD;
+  node.reductionMode = REDUCTION_OPS::SUM;
+  node.scalar = 0;
+  node.axis = 0;
+  node.count = 0;
+  return node;
+}
+
+unsigned CGraphBuilder::Add(const CGraphNode &node) {
+  return m_ptrGraph->AddNode(node);
+}
+
+unsigned CGraphBuilder::Input(const std::string &name) {
+  auto node = NewNode(GRAPH_OPS::INPUT, {});
+  node.name = name;
+  return Add(node);
+}
+
+unsigned CGraphBuilder::Weight(CWeightLoader::Handle weight) {
+  auto key = std::make_pair(weight.index, m_ePlatform);
+  auto it = m_mWeightNodes.find(key);
+  if(it!=m_mWeightNodes.end()) return it->second;
+  // The node keeps the handle and not the tensor, so the weights that are moved after the graph is built (see
+  // CWeightLoader::ApplyBankPlan()) are the ones that the executor runs with.
+  ConditionCheck(m_ptrWeightLoader->AccessWeights(m_ePlatform, weight)!=nullptr, "The weight is not loaded for the platform of the graph node.");
+  auto node = NewNode(GRAPH_OPS::CONSTANT, {});
+  node.name = m_ptrWeightLoader->GetWeightName(weight);
+  node.weightIndex = (int)weight.index;
+  const unsigned nodeId = Add(node);
+  m_mWeightNodes[key] = nodeId;
+  return nodeId;
+}
+
+unsigned CGraphBuilder::Constant(CTensorBasePtr tn, const std::string &name) {
+  auto node = NewNode(GRAPH_OPS::CONSTANT, {});
+  node.name = name;
+  node.platform = tn->GetPlatform();
+  node.constantTn = tn;
+  return Add(node);
+}
+
+unsigned CGraphBuilder::Concat2(unsigned inputNode1, unsigned inputNode2, unsigned concatAxis) {
+  auto node = NewNode(GRAPH_OPS::CONCAT2, {inputNode1, inputNode2});
+  node.axis = concatAxis;
+  return Add(node);
+}
+
+unsigned CGraphBuilder::MatMul(unsigned inputNode1, unsigned inputNode2) {
+  return Add(NewNode(GRAPH_OPS::MATMUL, {inputNode1, inputNode2}));
+}
+
+unsigned CGraphBuilder::ReLU(unsigned inputNode) {
+  return Add(NewNode(GRAPH_OPS::RELU, {inputNode}));
+}
+
+unsigned CGraphBuilder::Sqrt(unsigned inputNode) {
+  return Add(NewNode(GRAPH_OPS::SQRT, {inputNode}));
+}
+
+unsigned CGraphBuilder::Square(unsigned inputNode) {
+  return Add(NewNode(GRAPH_OPS::SQUARE, {inputNode}));
+}
+
+unsigned CGraphBuilder::BasicOps(unsigned inputNode1, unsigned inputNode2, BASIC_OPS mode) {
+  auto node = NewNode(GRAPH_OPS::BASIC_OPS, {inputNode1, inputNode2});
+  node.basicOpsMode = mode;
+  return Add(node);
+}
+
+unsigned CGraphBuilder::BasicOps(unsigned inputNode1, float scalar, BASIC_OPS mode) {
+  auto node = NewNode(GRAPH_OPS::BASIC_OPS_SCALAR, {inputNode1});
+  node.basicOpsMode = mode;
+  node.scalar = scalar;
+  return Add(node);
+}
+
+unsigned CGraphBuilder::Tile(unsigned inputNode, unsigned tileAxis, unsigned tileCount) {
+  auto node = NewNode(GRAPH_OPS::TILE, {inputNode});
+  node.axis = tileAxis;
+  node.count = tileCount;
+  return Add(node);
+}
+
+unsigned CGraphBuilder::Transpose(unsigned inputNode) {
+  return Add(NewNode(GRAPH_OPS::TRANSPOSE, {inputNode}));
+}
+
+unsigned CGraphBuilder::Gather(unsigned inputNode, unsigned indicesNode, unsigned indicesOfAxis) {
+  auto node = NewNode(GRAPH_OPS::GATHER, {inputNode, indicesNode});
+  node.axis = indicesOfAxis;
+  return Add(node);
+}
+
+unsigned CGraphBuilder::Reduce(unsigned inputNode,
+                               REDUCTION_OPS mode,
+                               unsigned powY,
+                               const std::vector<unsigned> &combination) {
+  auto node = NewNode(GRAPH_OPS::REDUCE, {inputNode});
+  node.reductionMode = mode;
+  node.count = powY;
+  node.dims = combination;
+  return Add(node);
+}
+
+unsigned CGraphBuilder::Mean(unsigned inputNode, const std::vector<unsigned> &combination) {
+  auto node = NewNode(GRAPH_OPS::MEAN, {inputNode});
+  node.dims = combination;
+  return Add(node);
+}
+
+unsigned CGraphBuilder::Variance(unsigned inputNode, const std::vector<unsigned> &combination) {
+  auto node = NewNode(GRAPH_OPS::VARIANCE, {inputNode});
+  node.dims = combination;
+  return Add(node);
+}
+
+unsigned CGraphBuilder::PadLastDim(unsigned inputNode, unsigned lastDimPadded) {
+  auto node = NewNode(GRAPH_OPS::PAD_LAST_DIM, {inputNode});
+  node.axis = lastDimPadded;
+  return Add(node);
+}
+
+unsigned CGraphBuilder::UnpadLastDim(unsigned inputNode, unsigned lastDimUnpadded) {
+  auto node = NewNode(GRAPH_OPS::UNPAD_LAST_DIM, {inputNode});
+  node.axis = lastDimUnpadded;
+  return Add(node);
+}
+
+unsigned CGraphBuilder::TopK(unsigned inputNode, unsigned axis, unsigned k) {
+  auto node = NewNode(GRAPH_OPS::TOPK, {inputNode});
+  node.axis = axis;
+  node.count = k;
+  return Add(node);
+}
+
+unsigned CGraphBuilder::Conv2D(unsigned inputNode, unsigned weightNode, unsigned biasNode) {
+  return Add(NewNode(GRAPH_OPS::CONV2D, {inputNode, weightNode, biasNode}));
+}
+
+unsigned CGraphBuilder::KNN(unsigned inputNode, unsigned k) {
+  auto node = NewNode(GRAPH_OPS::KNN, {inputNode});
+  node.count = k;
+  return Add(node);
+}
+
+unsigned CGraphBuilder::EdgeConv(unsigned inputNode, unsigned knnNode, unsigned weightNode, unsigned biasNode) {
+  return Add(NewNode(GRAPH_OPS::EDGECONV, {inputNode, knnNode, weightNode, biasNode}));
+}
+
+unsigned CGraphBuilder::Reshape(unsigned inputNode, const std::vector<unsigned> &newShape) {
+  auto node = NewNode(GRAPH_OPS::RESHAPE, {inputNode});
+  node.dims = newShape;
+  return Add(node);
+}
+
+unsigned CGraphBuilder::ExpandDims(unsigned inputNode, unsigned axis) {
+  auto node = NewNode(GRAPH_OPS::EXPAND_DIMS, {inputNode});
+  node.axis = axis;
+  return Add(node);
+}
+
+unsigned CGraphBuilder::SqueezeDims(unsigned inputNode) {
+  return Add(NewNode(GRAPH_OPS::SQUEEZE_DIMS, {inputNode}));
+}
+
+unsigned CGraphBuilder::CrossThePlatform(unsigned inputNode, PLATFORMS destPlatform) {
+  auto node = NewNode(GRAPH_OPS::CROSS_PLATFORM, {inputNode});
+  node.platform = destPlatform;
+  return Add(node);
+}
+
+void CGraphBuilder::Dump(unsigned node, const std::string &npyFileName) {
+  m_ptrGraph->GetNode(node).dumpFileNames.push_back(npyFileName);
+}
+
+void CGraphBuilder::Output(unsigned node) {
+  m_ptrGraph->MarkOutput(node);
+}
@@ -0,0 +1,157 @@
+#define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+
+#include "graph/CGraphExecutor.h"
+
+CGraphExecutor::CGraphExecutor(CPlatformSelection *platSelection, const CGraph *graph) {
+  m_ptrPlatSelection = platSelection;
+  m_ptrGraph = graph;
+  m_vOrder = m_ptrGraph->GetTopologicalOrder();
+  m_vConsumerCounts = m_ptrGraph->GetConsumerCounts();
+  m_vIsOutput.assign(m_ptrGraph->GetNodeCount(), false);
+  for(auto nodeId:m_ptrGraph->GetOutputNodes()){
+    m_vIsOutput[nodeId] = true;
+  }
+  PairMomentNodes();
+}
+
+void CGraphExecutor::PairMomentNodes() {
+  m_vMomentsPartner.assign(m_ptrGraph->GetNodeCount(), -1);
+  for(unsigned meanId=0; meanId<m_ptrGraph->GetNodeCount(); meanId++){
+    const auto &meanNode = m_ptrGraph->GetNode(meanId);
+    // Only the combinations of MeanVariance (TTTF and TF).
+    if(meanNode.op!=GRAPH_OPS::MEAN ||
+       (meanNode.dims!=std::vector<unsigned>{1,1,1,0} && meanNode.dims!=std::vector<unsigned>{1,0})) continue;
+    for(unsigned varianceId=0; varianceId<m_ptrGraph->GetNodeCount(); varianceId++){
+      const auto &varianceNode = m_ptrGraph->GetNode(varianceId);
+      if(varianceNode.op==GRAPH_OPS::VARIANCE && m_vMomentsPartner[varianceId]==-1 &&
+         varianceNode.inputs==meanNode.inputs && varianceNode.dims==meanNode.dims &&
+         varianceNode.platform==meanNode.platform){
+        m_vMomentsPartner[meanId] = (int)varianceId;
+        m_vMomentsPartner[varianceId] = (int)meanId;
+        break;
+      }
+    }
+  }
+}
+
+std::vector<CTensorBasePtr> CGraphExecutor::Execute(const std::vector<CTensorBasePtr> &inputTns) {
+  const auto &inputNodes = m_ptrGraph->GetInputNodes();
+  ConditionCheck(inputTns.size()==inputNodes.size(), "The number of the given tensors does not match the input nodes of the graph.");
+
+  std::vector<CTensorBasePtr> values(m_ptrGraph->GetNodeCount());
+  for(size_t i=0; i<inputNodes.size(); i++){
+    values[inputNodes[i]] = inputTns[i];
+  }
+  std::vector<unsigned> remainingConsumers = m_vConsumerCounts;
+  auto *bankPlanner = m_ptrPlatSelection->GetClassPtrBankPlanner();
+
+  for(auto nodeId:m_vOrder){
+    const auto &node = m_ptrGraph->GetNode(nodeId);
+    // The uploads of the layers are named after their nodes, so their planned banks stay with them.
+    if(bankPlanner!=nullptr) bankPlanner->SetUploadScope("node" + std::to_string(nodeId));
+    if(m_vMomentsPartner[nodeId]!=-1){
+      // The first node of the pair runs the layer, the second one has its output already.
+      if(values[nodeId]==nullptr){
+        ConditionCheck(values[node.inputs[0]]!=nullptr, "The input of a graph node is not available.");
+        auto moments = m_ptrPlatSelection->MeanVariance(node.platform, values[node.inputs[0]], node.dims);
+        const bool isMean = node.op==GRAPH_OPS::MEAN;
+        values[nodeId] = isMean ? moments[0] : moments[1];
+        values[m_vMomentsPartner[nodeId]] = isMean ? moments[1] : moments[0];
+      }
+    }else if(node.op!=GRAPH_OPS::INPUT){
+      values[nodeId] = ExecuteNode(node, values);
+    }
+    for(auto &dumpFileName:node.dumpFileNames){
+      m_ptrPlatSelection->DumpToNumpyFile(PLATFORMS::CPU, dumpFileName, values[nodeId]);
+    }
+    for(auto inputId:node.inputs){
+      if(--remainingConsumers[inputId]==0 && !m_vIsOutput[inputId]){
+        values[inputId].reset();
+      }
+    }
+  }
+
+  if(bankPlanner!=nullptr) bankPlanner->SetUploadScope("");
+
+  std::vector<CTensorBasePtr> outputTns;
+  for(auto nodeId:m_ptrGraph->GetOutputNodes()){
+    outputTns.push_back(values[nodeId]);
+  }
+  return outputTns;
+}
+
+CTensorBasePtr CGraphExecutor::ExecuteNode(const CGraphNode &node, const std::vector<CTensorBasePtr> &values) {
+  std::vector<CTensorBasePtr> inputTns;
+  for(auto inputId:node.inputs){
+    ConditionCheck(values[inputId]!=nullptr, "The input of a graph node is not available.");
+    inputTns.push_back(values[inputId]);
+  }
+  const PLATFORMS platform = node.platform;
+
+  switch(node.op){
+    case GRAPH_OPS::CONSTANT:
+      if(node.weightIndex>=0){
+        return m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(platform, CWeightLoader::Handle{(unsigned)node.weightIndex});
+      }
+      return node.constantTn;
+    case GRAPH_OPS::CONCAT2:
+      return m_ptrPlatSelection->Concat2(platform, inputTns[0], inputTns[1], node.axis);
+    case GRAPH_OPS::MATMUL:
+      return m_ptrPlatSelection->MatMul(platform, inputTns[0], inputTns[1]);
+    case GRAPH_OPS::RELU:
+      return m_ptrPlatSelection->ReLU(platform, inputTns[0]);
+    case GRAPH_OPS::SQRT:
+      return m_ptrPlatSelection->Sqrt(platform, inputTns[0]);
+    case GRAPH_OPS::SQUARE:
+      return m_ptrPlatSelection->Square(platform, inputTns[0]);
+    case GRAPH_OPS::BASIC_OPS:
+      return m_ptrPlatSelection->BasicOps(platform, inputTns[0], inputTns[1], node.basicOpsMode);
+    case GRAPH_OPS::BASIC_OPS_SCALAR:
+      return m_ptrPlatSelection->BasicOps(platform, inputTns[0], node.scalar, node.basicOpsMode);
+    case GRAPH_OPS::TILE:
+      return m_ptrPlatSelection->Tile(platform, inputTns[0], node.axis, node.count);
+    case GRAPH_OPS::TRANSPOSE:
+      return m_ptrPlatSelection->Transpose(platform, inputTns[0]);
+    case GRAPH_OPS::GATHER:
+      return m_ptrPlatSelection->Gather(platform, inputTns[0], inputTns[1], node.axis);
+    case GRAPH_OPS::REDUCE:
+      return m_ptrPlatSelection->Reduce(platform, inputTns[0], node.reductionMode, node.count, node.dims);
+    case GRAPH_OPS::MEAN:
+      return m_ptrPlatSelection->Mean(platform, inputTns[0], node.dims);
+    case GRAPH_OPS::VARIANCE:
+      return m_ptrPlatSelection->Variance(platform, inputTns[0], node.dims);
+    case GRAPH_OPS::PAD_LAST_DIM:
+      return m_ptrPlatSelection->PadLastDim(platform, inputTns[0], node.axis);
+    case GRAPH_OPS::UNPAD_LAST_DIM:
+      return m_ptrPlatSelection->UnpadLastDim(platform, inputTns[0], node.axis);
+    case GRAPH_OPS::TOPK:
+      return m_ptrPlatSelection->TopK(platform, inputTns[0], node.axis, node.count);
+    case GRAPH_OPS::CONV2D:
+      return m_ptrPlatSelection->Conv2D(platform, inputTns[0], inputTns[1], inputTns[2]);
+    case GRAPH_OPS::KNN:
+      return m_ptrPlatSelection->KNN(platform, inputTns[0], node.count);
+    case GRAPH_OPS::EDGECONV:
+      return m_ptrPlatSelection->EdgeConv(platform, inputTns[0], inputTns[1], inputTns[2], inputTns[3]);
+    // The shape ops return a new tensor that shares the buffer of their input, the input (that could have the other
+    // consumers or be a weight) keeps its shape.
+    case GRAPH_OPS::RESHAPE:{
+      auto outputTn = m_ptrPlatSelection->ShareBuffer(inputTns[0]);
+      outputTn->Reshape(node.dims);
+      return outputTn;
+    }
+    case GRAPH_OPS::EXPAND_DIMS:{
+      auto outputTn = m_ptrPlatSelection->ShareBuffer(inputTns[0]);
+      outputTn->ExpandDims(node.axis);
+      return outputTn;
+    }
+    case GRAPH_OPS::SQUEEZE_DIMS:{
+      auto outputTn = m_ptrPlatSelection->ShareBuffer(inputTns[0]);
+      outputTn->SqueezeDims();
+      return outputTn;
+    }
+    case GRAPH_OPS::CROSS_PLATFORM:
+      return m_ptrPlatSelection->CrossThePlatformIfNeeded(platform, inputTns[0]);
+    default:
+      ThrowException("Undefined graph operation.");
+  }
+}
@@ -2,18 +2,32 @@
 
 #include "GlobalHelpers.h"
 #include "CClassifierMultiPlatform.h"
+#include "CWeightLoader.h"
 
 CClassifierMultiPlatform *classifier;
 
 int main(int argc, const char* argv[]){
   SetupModules(argc,argv);
+  if(globalPackWeightBundle){
+    // Only the numpy files are read, no device is needed.
+    std::string wDir = globalArgDataPath; wDir.append(globalShapenet ? "/shapenet2/weights/" : "/modelnet40/weights/");
+    std::string wFileList = wDir + "filelist.txt";
+    CWeightLoader weightLoader(nullptr, PLATFORMS::CPU, globalFoldBatchNorms);
+    weightLoader.PackWeightsBundle(wDir, wFileList, wDir + CWeightBundle::kFileName);
+    return EXIT_SUCCESS;
+  }
   classifier = new CClassifierMultiPlatform(
       globalShapenet,
       globalProfileOclEnabled,
       globalDumpMemBankCrossings,
       globalCpuUsageSamplingEnabled,
-      globalDumpTensors);
+      globalDumpTensors,
+      globalFoldBatchNorms,
+      globalFoldBatchNormsCheck,
+      globalStreamingEnabled);
   SPDLOG_LOGGER_TRACE(logger, "The forward pass has finished.");
+  const int exitCode = classifier->IsSucceeded() ? EXIT_SUCCESS : EXIT_FAILURE;
   delete(classifier);
   SPDLOG_LOGGER_TRACE(logger, "Closing.");
+  return exitCode;
 }
@@ -1,6 +1,8 @@
 #define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
 
 #include "models/CModel1.h"
+#include <algorithm>
+#include <random>
 
 CModel1::CModel1(
     PLATFORMS targetPlatform,
@@ -12,9 +14,11 @@ CModel1::CModel1(
     bool enableOclProfiling,
     bool enableMemBankCrossing,
     bool enableCpuUtilization,
-    bool enableTensorDumps){
+    bool enableTensorDumps,
+    bool enableBatchNormFolding){
 
   m_bUseShapeNet = useShapeNetInstead;
+  m_bFoldBatchNorm = enableBatchNormFolding;
   m_uClassCount = m_bUseShapeNet?55:40;
   m_uDatasetOffset = datasetOffset;
   m_uBatchSize = batchSize;
@@ -28,42 +32,137 @@ CModel1::CModel1(
       enableOclProfiling,
       enableMemBankCrossing,
       enableCpuUtilization,
-      enableTensorDumps
+      enableTensorDumps,
+      enableBatchNormFolding
   );
+  m_ptrGraph = nullptr;
+  m_ptrGraphExecutor = nullptr;
+  m_bDatasetDataLoaded = false;
+  m_bDatasetLabelsLoaded = false;
+  ResolveWeights();
+}
+
+void CModel1::ResolveWeights() {
+  // The names are looked up once here, a missing weight fails the construction of the model.
+  auto *weightLoader = m_ptrPlatSelection->GetClassPtrWeightLoader();
+  auto dense = [weightLoader](const std::string &layerName){
+    return DenseWeights{
+        weightLoader->ResolveWeight(layerName+".weights.npy"),
+        weightLoader->ResolveWeight(layerName+".biases.npy")};
+  };
+  auto layer = [&](const std::string &layerName){
+    const std::string prefix = layerName+".bn.";
+    return LayerWeights{
+        dense(layerName),
+        BatchNormWeights{
+            weightLoader->ResolveWeight(prefix+"gamma.npy"),
+            weightLoader->ResolveWeight(prefix+"beta.npy"),
+            weightLoader->ResolveWeight(prefix+prefix+"moments.Squeeze.ExponentialMovingAverage.npy"),
+            weightLoader->ResolveWeight(prefix+prefix+"moments.Squeeze_1.ExponentialMovingAverage.npy")}};
+  };
+
+  m_oWeights.tconv1 = layer("transform_net1.tconv1");
+  m_oWeights.tconv2 = layer("transform_net1.tconv2");
+  m_oWeights.tconv3 = layer("transform_net1.tconv3");
+  m_oWeights.tfc1 = layer("transform_net1.tfc1");
+  m_oWeights.tfc2 = layer("transform_net1.tfc2");
+  m_oWeights.transformXYZ = dense("transform_net1.transform_XYZ");
+  for(unsigned i=0; i<4; i++){
+    m_oWeights.dgcnn[i] = layer("dgcnn"+std::to_string(i+1));
+  }
+  m_oWeights.agg = layer("agg");
+  for(unsigned i=0; i<2; i++){
+    m_oWeights.fc[i] = layer("fc"+std::to_string(i+1));
+  }
+  m_oWeights.fc3 = dense("fc3");
 }
 
 CModel1::~CModel1() {
+  delete(m_ptrGraphExecutor);
+  delete(m_ptrGraph);
   delete(m_ptrPlatSelection);
 }
 
 void CModel1::SetDatasetData(std::string &pathNumpyData) {
-  m_oNumpyObjectData = cnpy::npy_load(pathNumpyData);
+  m_oNumpyObjectData = cnpy::npy_load(pathNumpyData, globalNpyMmapEnabled);
   auto rawNpyShape = m_oNumpyObjectData.shape;
   auto rawNpyRank = rawNpyShape.size();
   ConditionCheck(rawNpyRank==3, "The input numpy files for the dataset do not have a rank of 3.");
   ConditionCheck(rawNpyShape[0]>=m_uBatchSize, "The input numpy files for the dataset have less models than the target batch-size.");
   ConditionCheck(rawNpyShape[1]==m_uPointsPerCloud, "The input numpy files for the dataset should have the set number of points per model.");
   ConditionCheck(rawNpyShape[2]==3, "The input numpy files for the dataset should have 3 features per point.");
-  ConditionCheck(m_uDatasetOffset+m_uBatchSize<=rawNpyShape[0], "The input numpy files for the dataset are too small for the current dataset offset.");
-  unsigned offset = m_uDatasetOffset*(m_uPointsPerCloud*3);
-  auto *ptrBuff = m_oNumpyObjectData.data<float>() + offset;
-  m_ptrDatasetDataTn = CTensorBasePtr(
-      new CTensor<float>({m_uBatchSize,m_uPointsPerCloud,3}, ptrBuff));
+  m_bDatasetDataLoaded = true;
+  SliceDatasetData();
 }
 
 void CModel1::SetDatasetLabels(std::string &pathNumpyLabels) {
   // dataType of npy file should be int32, NOT uchar8!
   // use dataset_B5_labels_int32.npy
-  m_oNumpyObjectLabels = cnpy::npy_load(pathNumpyLabels);
+  m_oNumpyObjectLabels = cnpy::npy_load(pathNumpyLabels, globalNpyMmapEnabled);
   auto rawNpyShape = m_oNumpyObjectLabels.shape;
   auto rawNpyRank = rawNpyShape.size();
   ConditionCheck(rawNpyRank==2 && rawNpyShape[1]==1, "The input numpy files for the dataset labels do not have a rank of 2 with shape[1]=1.");
-  ConditionCheck(m_uDatasetOffset+m_uBatchSize<=rawNpyShape[0], "The input numpy files for the dataset labels are too small for the current dataset offset.");
+  m_bDatasetLabelsLoaded = true;
+  SliceDatasetLabels();
+}
+
+/**
+ * @brief      Fills the dataset with random point clouds (in the unit cube, like the normalized datasets) and random
+ * labels, for running the model without the data directory.
+ *
+ * @param[in]  pointCloudCount  The number of the point clouds
+ * @param[in]  seed             The seed
+ */
+void CModel1::SetDatasetRandom(unsigned pointCloudCount, unsigned seed) {
+  ConditionCheck(pointCloudCount>=m_uBatchSize, "The random dataset should have at least a batch of point clouds.");
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<float> pointDistribution(-1.0f, 1.0f);
+  std::uniform_int_distribution<int> labelDistribution(0, m_uClassCount-1);
+
+  m_oNumpyObjectData = cnpy::NpyArray({pointCloudCount, m_uPointsPerCloud, 3}, sizeof(float), false);
+  std::generate(m_oNumpyObjectData.data<float>(), m_oNumpyObjectData.data<float>()+m_oNumpyObjectData.num_vals,
+                [&](){ return pointDistribution(generator); });
+  m_oNumpyObjectLabels = cnpy::NpyArray({pointCloudCount, 1}, sizeof(int), false);
+  std::generate(m_oNumpyObjectLabels.data<int>(), m_oNumpyObjectLabels.data<int>()+m_oNumpyObjectLabels.num_vals,
+                [&](){ return labelDistribution(generator); });
+
+  m_bDatasetDataLoaded = true;
+  m_bDatasetLabelsLoaded = true;
+  SliceDatasetData();
+  SliceDatasetLabels();
+}
+
+void CModel1::SetDatasetOffset(unsigned datasetOffset) {
+  // The loaded numpy files stay resident, the input tensors borrow the batch at the new offset without copying it.
+  m_uDatasetOffset = datasetOffset;
+  if(m_bDatasetDataLoaded) SliceDatasetData();
+  if(m_bDatasetLabelsLoaded) SliceDatasetLabels();
+}
+
+unsigned CModel1::GetDatasetOffset() {
+  return m_uDatasetOffset;
+}
+
+unsigned CModel1::GetDatasetSize() {
+  ConditionCheck(m_bDatasetDataLoaded, "The dataset is not loaded.");
+  return m_oNumpyObjectData.shape[0];
+}
+
+void CModel1::SliceDatasetData() {
+  ConditionCheck(m_uDatasetOffset+m_uBatchSize<=m_oNumpyObjectData.shape[0], "The input numpy files for the dataset are too small for the current dataset offset.");
+  size_t offset = (size_t)m_uDatasetOffset*(m_uPointsPerCloud*3);
+  auto *ptrBuff = m_oNumpyObjectData.data<float>() + offset;
+  m_ptrDatasetDataTn = CTensorBasePtr(
+      new CTensor<float>({m_uBatchSize,m_uPointsPerCloud,3}, ptrBuff, m_oNumpyObjectData.data_holder));
+}
+
+void CModel1::SliceDatasetLabels() {
+  ConditionCheck(m_uDatasetOffset+m_uBatchSize<=m_oNumpyObjectLabels.shape[0], "The input numpy files for the dataset labels are too small for the current dataset offset.");
   unsigned offset = m_uDatasetOffset;
   auto *_ptrBuff = m_oNumpyObjectLabels.data<int>() + offset;
   auto *ptrBuff = reinterpret_cast<unsigned*>(_ptrBuff);
   m_ptrDatasetLabelsTn = CTensorBasePtr(
-      new CTensor<unsigned>({m_uBatchSize}, ptrBuff));
+      new CTensor<unsigned>({m_uBatchSize}, ptrBuff, m_oNumpyObjectLabels.data_holder));
 }
 
 CTensorBasePtr CModel1::GetDataTn() {
@@ -86,233 +185,106 @@ PLATFORMS CModel1::GetTargetPlatform() {
   return m_eTargetPlatform;
 }
 
-CTensorBasePtr CModel1::FullyConnectedForward(CTensorBasePtr inputTn, CTensorBasePtr weightsTn, CTensorBasePtr biasesTn) {
-  auto tmp = m_ptrPlatSelection->MatMul(GetTargetPlatform(), inputTn, weightsTn);
-  return m_ptrPlatSelection->BasicOps(GetTargetPlatform(), tmp, biasesTn, BASIC_OPS::ADD);
+unsigned CModel1::FullyConnectedForward(CGraphBuilder &builder, unsigned inputNode, const DenseWeights &weights) {
+  auto tmp = builder.MatMul(inputNode, builder.Weight(weights.weights));
+  return builder.BasicOps(tmp, builder.Weight(weights.biases), BASIC_OPS::ADD);
 }
 
-CTensorBasePtr CModel1::BatchNormForward(CTensorBasePtr inputTn,
-                                       CTensorBasePtr gammaTn,
-                                       CTensorBasePtr betaTn,
-                                       CTensorBasePtr emaAveTn,
-                                       CTensorBasePtr emaVarTn) {
- 
-  const float bn_decay = 0.5f;
-  const auto rank = inputTn->GetRank();
-  
-  CTensorBasePtr mu;
-  CTensorBasePtr var;
-  
-  if(rank==4){
-    //mu and var is of shape (dim3)
-    mu = m_ptrPlatSelection->Mean(GetTargetPlatform(), inputTn, {1,1,1,0});
-    var = m_ptrPlatSelection->Variance(GetTargetPlatform(), inputTn, {1,1,1,0});
-
-    // Exponential Moving Average for mu and var
-    CTensorBasePtr update_delta_ave, update_delta_var;
-    CTensorBasePtr update_delta_ave2, update_delta_var2;
-
-    update_delta_ave = m_ptrPlatSelection->BasicOps(GetTargetPlatform(), emaAveTn, mu, BASIC_OPS::SUB);
-    update_delta_ave2 = m_ptrPlatSelection->BasicOps(GetTargetPlatform(), update_delta_ave, bn_decay, BASIC_OPS::MUL_ELEMENTWISE);
-    update_delta_var = m_ptrPlatSelection->BasicOps(GetTargetPlatform(), emaVarTn, var, BASIC_OPS::SUB);
-    update_delta_var2 = m_ptrPlatSelection->BasicOps(GetTargetPlatform(), update_delta_var, bn_decay, BASIC_OPS::MUL_ELEMENTWISE);
-
-    auto final_ave =  m_ptrPlatSelection->BasicOps(GetTargetPlatform(), emaAveTn, update_delta_ave2, BASIC_OPS::SUB);
-    auto final_var =  m_ptrPlatSelection->BasicOps(GetTargetPlatform(), emaVarTn, update_delta_var2, BASIC_OPS::SUB);
-    auto xNormTmp1 = m_ptrPlatSelection->BasicOps(GetTargetPlatform(),inputTn,final_ave, BASIC_OPS::SUB);
-    auto xNormTmp2 = m_ptrPlatSelection->BasicOps(GetTargetPlatform(),final_var,1e-8, BASIC_OPS::ADD);
-    auto xNormTmp3 = m_ptrPlatSelection->Sqrt(GetTargetPlatform(),xNormTmp2);
-    auto xNorm = m_ptrPlatSelection->BasicOps(GetTargetPlatform(),xNormTmp1,xNormTmp3, BASIC_OPS::DIV_ELEMENTWISE);
-    auto rsltTmp1 = m_ptrPlatSelection->BasicOps(GetTargetPlatform(),xNorm,gammaTn, BASIC_OPS::MUL_ELEMENTWISE);
-    auto rsltTn = m_ptrPlatSelection->BasicOps(GetTargetPlatform(),rsltTmp1,betaTn, BASIC_OPS::ADD);
-    
-    return rsltTn;
-  } else if(rank==2){
-    //mu and var is of shape (dim1)
-    mu = m_ptrPlatSelection->Mean(GetTargetPlatform(), inputTn, {1,0});
-    var = m_ptrPlatSelection->Variance(GetTargetPlatform(), inputTn, {1,0});
-
-    // Exponential Moving Average for mu and var
-    CTensorBasePtr update_delta_ave, update_delta_var;
-    CTensorBasePtr update_delta_ave2, update_delta_var2;
-
-    update_delta_ave = m_ptrPlatSelection->BasicOps(GetTargetPlatform(), emaAveTn, mu, BASIC_OPS::SUB);
-    update_delta_ave2 = m_ptrPlatSelection->BasicOps(GetTargetPlatform(), update_delta_ave, bn_decay, BASIC_OPS::MUL_ELEMENTWISE);
-    update_delta_var = m_ptrPlatSelection->BasicOps(GetTargetPlatform(), emaVarTn, var, BASIC_OPS::SUB);
-    update_delta_var2 = m_ptrPlatSelection->BasicOps(GetTargetPlatform(), update_delta_var, bn_decay, BASIC_OPS::MUL_ELEMENTWISE);
-
-    auto final_ave =  m_ptrPlatSelection->BasicOps(GetTargetPlatform(), emaAveTn, update_delta_ave2, BASIC_OPS::SUB);
-    auto final_var =  m_ptrPlatSelection->BasicOps(GetTargetPlatform(), emaVarTn, update_delta_var2, BASIC_OPS::SUB);
-    auto xNormTmp1 = m_ptrPlatSelection->BasicOps(GetTargetPlatform(),inputTn,final_ave, BASIC_OPS::SUB);
-    auto xNormTmp2 = m_ptrPlatSelection->BasicOps(GetTargetPlatform(),final_var,1e-8, BASIC_OPS::ADD);
-    auto xNormTmp3 = m_ptrPlatSelection->Sqrt(GetTargetPlatform(),xNormTmp2);
-    auto xNorm = m_ptrPlatSelection->BasicOps(GetTargetPlatform(),xNormTmp1,xNormTmp3, BASIC_OPS::DIV_ELEMENTWISE);
-    auto rsltTmp1 = m_ptrPlatSelection->BasicOps(GetTargetPlatform(),xNorm,gammaTn, BASIC_OPS::MUL_ELEMENTWISE);
-    auto rsltTn = m_ptrPlatSelection->BasicOps(GetTargetPlatform(),rsltTmp1,betaTn, BASIC_OPS::ADD);
-    
-    return rsltTn;
-  }else{
-    ConditionCheck(false, "Something has gone wrong.")
+unsigned CModel1::BatchNormForward(CGraphBuilder &builder, unsigned inputNode, const BatchNormWeights &weights, unsigned rank) {
+  if(m_bFoldBatchNorm){
+    // The inference-time batch-norm is already folded into the weight and the bias of the preceding layer.
+    return inputNode;
   }
-}
-
-CTensorBasePtr CModel1::GetEdgeFeatures(CTensorBasePtr inputTn, CTensorBasePtr knnTn) {
-  //Gather TopK's indices from the input array.
-  auto point_cloud_neighbors = m_ptrPlatSelection->Gather(GetTargetPlatform(),inputTn,knnTn,1);
-
-  //BxNxD into BxNxKxD
-  //inputTn->ExpandDims(2);
-  auto point_cloud_central = m_ptrPlatSelection->Tile(GetTargetPlatform(),inputTn,2,m_uKnnK);
-  //inputTn->SqueezeDims();
-
-  auto features = m_ptrPlatSelection->BasicOps(GetTargetPlatform(), point_cloud_neighbors,point_cloud_central,BASIC_OPS::SUB);
-
-  //concatenate centrals and features (BxNxKxD) and (BxNxKxD)
-  auto edge_feature = m_ptrPlatSelection->Concat2(GetTargetPlatform(), point_cloud_central,features,3);
-  
-  return edge_feature;
-}
-
-CTensorBasePtr CModel1::PairwiseDistance(CTensorBasePtr inputTn) {
-  auto point_cloud_transpose = m_ptrPlatSelection->Transpose(GetTargetPlatform(),inputTn);
-  auto point_cloud_inner =  m_ptrPlatSelection->MatMul(GetTargetPlatform(),inputTn,point_cloud_transpose);
-  auto point_cloud_inner2 = m_ptrPlatSelection->BasicOps(GetTargetPlatform(),point_cloud_inner,-2.0f,BASIC_OPS::MUL_ELEMENTWISE);
-  auto point_cloud_inner2p2 = m_ptrPlatSelection->Square(GetTargetPlatform(),inputTn);
 
-  ///TODO: REDUCE LAYER IS CHANGED, CHECK IT.
-  //auto point_cloud_sum = m_ptrPlatSelection->ReduceSum(GetTargetPlatform(),point_cloud_inner2p2,false,false,true);
-  auto point_cloud_sum = m_ptrPlatSelection->Reduce(GetTargetPlatform(),point_cloud_inner2p2,REDUCTION_OPS::SUM,1,{0,0,1});
-
-  auto point_cloud_sum_tiled =  m_ptrPlatSelection->Tile(GetTargetPlatform(),point_cloud_sum,2,m_uPointsPerCloud); //The result is BxNxK for k=N
-  auto point_cloud_sum_transpose_tiled =  m_ptrPlatSelection->Tile(GetTargetPlatform(),point_cloud_sum,1,m_uPointsPerCloud); //The result is BxkxN for k=N
-  auto rsltTmpTn = m_ptrPlatSelection->BasicOps(GetTargetPlatform(),point_cloud_sum_tiled,point_cloud_sum_transpose_tiled, BASIC_OPS::ADD); //both input tensors are BxNxN
-  auto rsltTn = m_ptrPlatSelection->BasicOps(GetTargetPlatform(),rsltTmpTn,point_cloud_inner2, BASIC_OPS::ADD); //both input tensors are BxNxN
+  ConditionCheck(rank==4 || rank==2, "Something has gone wrong.");
+  const float bn_decay = 0.5f;
 
-  return rsltTn;
+  auto gammaNode = builder.Weight(weights.gamma);
+  auto betaNode = builder.Weight(weights.beta);
+  auto emaAveNode = builder.Weight(weights.emaAve);
+  auto emaVarNode = builder.Weight(weights.emaVar);
+
+  // mu and var are of shape (dim3) for rank 4 and (dim1) for rank 2.
+  const std::vector<unsigned> combination = rank==4 ? std::vector<unsigned>{1,1,1,0} : std::vector<unsigned>{1,0};
+  auto mu = builder.Mean(inputNode, combination);
+  auto var = builder.Variance(inputNode, combination);
+
+  // Exponential Moving Average for mu and var
+  auto update_delta_ave = builder.BasicOps(emaAveNode, mu, BASIC_OPS::SUB);
+  auto update_delta_ave2 = builder.BasicOps(update_delta_ave, bn_decay, BASIC_OPS::MUL_ELEMENTWISE);
+  auto update_delta_var = builder.BasicOps(emaVarNode, var, BASIC_OPS::SUB);
+  auto update_delta_var2 = builder.BasicOps(update_delta_var, bn_decay, BASIC_OPS::MUL_ELEMENTWISE);
+
+  auto final_ave = builder.BasicOps(emaAveNode, update_delta_ave2, BASIC_OPS::SUB);
+  auto final_var = builder.BasicOps(emaVarNode, update_delta_var2, BASIC_OPS::SUB);
+  auto xNormTmp1 = builder.BasicOps(inputNode, final_ave, BASIC_OPS::SUB);
+  auto xNormTmp2 = builder.BasicOps(final_var, 1e-8f, BASIC_OPS::ADD);
+  auto xNormTmp3 = builder.Sqrt(xNormTmp2);
+  auto xNorm = builder.BasicOps(xNormTmp1, xNormTmp3, BASIC_OPS::DIV_ELEMENTWISE);
+  auto rsltTmp1 = builder.BasicOps(xNorm, gammaNode, BASIC_OPS::MUL_ELEMENTWISE);
+  return builder.BasicOps(rsltTmp1, betaNode, BASIC_OPS::ADD);
 }
 
-CTensorBasePtr CModel1::TransformNet(CTensorBasePtr edgeFeaturesTn) {
+unsigned CModel1::TransformNet(CGraphBuilder &builder, unsigned inputNode, unsigned knnNode) {
+  builder.SetScope("transform_net1");
+  unsigned net;
 
-  CTensorBasePtr net;
+  //----------------------------------------------------------------------------
   {
-    auto net1 = m_ptrPlatSelection->Conv2D(
-        GetTargetPlatform(),
-        edgeFeaturesTn,
-        m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-            GetTargetPlatform(),"transform_net1.tconv1.weights.npy"),
-        m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-            GetTargetPlatform(),"transform_net1.tconv1.biases.npy")
-    );
-
-    m_ptrPlatSelection->DumpToNumpyFile(PLATFORMS::CPU,"A01_tnet_conv.npy",net1);
-
-    auto net2 = BatchNormForward(
-        net1,
-        m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-            GetTargetPlatform(),"transform_net1.tconv1.bn.gamma.npy"),
-        m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-            GetTargetPlatform(),"transform_net1.tconv1.bn.beta.npy"),
-        m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-            GetTargetPlatform(),"transform_net1.tconv1.bn.transform_net1.tconv1.bn.moments.Squeeze.ExponentialMovingAverage.npy"),
-        m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-            GetTargetPlatform(),"transform_net1.tconv1.bn.transform_net1.tconv1.bn.moments.Squeeze_1.ExponentialMovingAverage.npy")
-    );
-
-    m_ptrPlatSelection->DumpToNumpyFile(PLATFORMS::CPU,"A02_tnet_bn.npy",net2);
-
-    auto net3 = m_ptrPlatSelection->ReLU(GetTargetPlatform(),net2);
-
-    m_ptrPlatSelection->DumpToNumpyFile(PLATFORMS::CPU,"A03_tnet_relu.npy",net3);
-
+    auto net1 = builder.EdgeConv(
+        inputNode,
+        knnNode,
+        builder.Weight(m_oWeights.tconv1.dense.weights),
+        builder.Weight(m_oWeights.tconv1.dense.biases));
+    builder.Dump(net1, "A01_tnet_conv.npy");
+    auto net2 = BatchNormForward(builder, net1, m_oWeights.tconv1.bn, 4);
+    builder.Dump(net2, "A02_tnet_bn.npy");
+    auto net3 = builder.ReLU(net2);
+    builder.Dump(net3, "A03_tnet_relu.npy");
     net = net3;
   }
 
   //----------------------------------------------------------------------------
   {
-    auto net1 = m_ptrPlatSelection->Conv2D(
-        GetTargetPlatform(),
+    auto net1 = builder.Conv2D(
         net,
-        m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-            GetTargetPlatform(),"transform_net1.tconv2.weights.npy"),
-        m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-            GetTargetPlatform(),"transform_net1.tconv2.biases.npy")
-    );
-
-    m_ptrPlatSelection->DumpToNumpyFile(PLATFORMS::CPU,"A04_tnet_conv.npy",net1);
-
-    auto net2 = BatchNormForward(
-        net1,
-        m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-            GetTargetPlatform(),"transform_net1.tconv2.bn.gamma.npy"),
-        m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-            GetTargetPlatform(),"transform_net1.tconv2.bn.beta.npy"),
-        m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-            GetTargetPlatform(),"transform_net1.tconv2.bn.transform_net1.tconv2.bn.moments.Squeeze.ExponentialMovingAverage.npy"),
-        m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-            GetTargetPlatform(),"transform_net1.tconv2.bn.transform_net1.tconv2.bn.moments.Squeeze_1.ExponentialMovingAverage.npy")
-    );
-
-    m_ptrPlatSelection->DumpToNumpyFile(PLATFORMS::CPU,"A05_tnet_bn.npy",net2);
-
-    auto net3 = m_ptrPlatSelection->ReLU(GetTargetPlatform(),net2);
-
-    m_ptrPlatSelection->DumpToNumpyFile(PLATFORMS::CPU,"A06_tnet_relu.npy",net3);
-
+        builder.Weight(m_oWeights.tconv2.dense.weights),
+        builder.Weight(m_oWeights.tconv2.dense.biases));
+    builder.Dump(net1, "A04_tnet_conv.npy");
+    auto net2 = BatchNormForward(builder, net1, m_oWeights.tconv2.bn, 4);
+    builder.Dump(net2, "A05_tnet_bn.npy");
+    auto net3 = builder.ReLU(net2);
+    builder.Dump(net3, "A06_tnet_relu.npy");
     net = net3;
   }
 
   //----------------------------------------------------------------------------
   {
-    ///TODO: CHECK THIS. REDUCE LAYER HAS BEEN CHANGED.
-    //auto net1 = m_ptrPlatSelection->ReduceMax(GetTargetPlatform(),net,2);
-    auto net1 = m_ptrPlatSelection->Reduce(GetTargetPlatform(),net,REDUCTION_OPS::MAX,1,{0,0,1,0});
-
-    net1->ExpandDims(2);
-    m_ptrPlatSelection->DumpToNumpyFile(PLATFORMS::CPU,"A07_tnet_pool.npy",net1);
+    auto net1 = builder.Reduce(net, REDUCTION_OPS::MAX, 1, {0,0,1,0});
+    net1 = builder.ExpandDims(net1, 2);
+    builder.Dump(net1, "A07_tnet_pool.npy");
     net = net1;
   }
 
   //----------------------------------------------------------------------------
   {
-    auto net1 = m_ptrPlatSelection->Conv2D(
-        GetTargetPlatform(),
+    auto net1 = builder.Conv2D(
         net,
-        m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-            GetTargetPlatform(),"transform_net1.tconv3.weights.npy"),
-        m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-            GetTargetPlatform(),"transform_net1.tconv3.biases.npy")
-    );
-
-    m_ptrPlatSelection->DumpToNumpyFile(PLATFORMS::CPU,"A08_tnet_conv.npy",net1);
-
-    auto net2 = BatchNormForward(
-        net1,
-        m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-            GetTargetPlatform(),"transform_net1.tconv3.bn.gamma.npy"),
-        m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-            GetTargetPlatform(),"transform_net1.tconv3.bn.beta.npy"),
-        m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-            GetTargetPlatform(),"transform_net1.tconv3.bn.transform_net1.tconv3.bn.moments.Squeeze.ExponentialMovingAverage.npy"),
-        m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-            GetTargetPlatform(),"transform_net1.tconv3.bn.transform_net1.tconv3.bn.moments.Squeeze_1.ExponentialMovingAverage.npy")
-    );
-
-    m_ptrPlatSelection->DumpToNumpyFile(PLATFORMS::CPU,"A09_tnet_bn.npy",net2);
-
-    auto net3 = m_ptrPlatSelection->ReLU(GetTargetPlatform(),net2);
-
-    m_ptrPlatSelection->DumpToNumpyFile(PLATFORMS::CPU,"A10_tnet_relu.npy",net3);
+        builder.Weight(m_oWeights.tconv3.dense.weights),
+        builder.Weight(m_oWeights.tconv3.dense.biases));
+    builder.Dump(net1, "A08_tnet_conv.npy");
+    auto net2 = BatchNormForward(builder, net1, m_oWeights.tconv3.bn, 4);
+    builder.Dump(net2, "A09_tnet_bn.npy");
+    auto net3 = builder.ReLU(net2);
+    builder.Dump(net3, "A10_tnet_relu.npy");
     net = net3;
   }
 
   //----------------------------------------------------------------------------
   {
-    ///TODO: CHECK THIS, REDUCE LAYER HAS BEEN CHANGED.
-    //auto net1 = m_ptrPlatSelection->ReduceMax(GetTargetPlatform(),net,1);
-    auto net1 = m_ptrPlatSelection->Reduce(GetTargetPlatform(),net,REDUCTION_OPS::MAX,1,{0,1,0,0});
-
-    net1->SqueezeDims();
-    m_ptrPlatSelection->DumpToNumpyFile(PLATFORMS::CPU,"A11_tnet_pool.npy",net1);
+    auto net1 = builder.Reduce(net, REDUCTION_OPS::MAX, 1, {0,1,0,0});
+    net1 = builder.SqueezeDims(net1);
+    builder.Dump(net1, "A11_tnet_pool.npy");
     net = net1;
   }
 
@@ -320,417 +292,237 @@ CTensorBasePtr CModel1::TransformNet(CTensorBasePtr edgeFeaturesTn) {
   //FC
   // net is Bx1024
   {
-    auto net1 = FullyConnectedForward(
-        net,
-        m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-            GetTargetPlatform(),"transform_net1.tfc1.weights.npy"),
-        m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-            GetTargetPlatform(),"transform_net1.tfc1.biases.npy")
-    );
-
-    m_ptrPlatSelection->DumpToNumpyFile(PLATFORMS::CPU,"A12_tnet_fc.npy",net1);
-
-    auto net2 = BatchNormForward(
-        net1,
-        m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-            GetTargetPlatform(),"transform_net1.tfc1.bn.gamma.npy"),
-        m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-            GetTargetPlatform(),"transform_net1.tfc1.bn.beta.npy"),
-        m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-            GetTargetPlatform(),"transform_net1.tfc1.bn.transform_net1.tfc1.bn.moments.Squeeze.ExponentialMovingAverage.npy"),
-        m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-            GetTargetPlatform(),"transform_net1.tfc1.bn.transform_net1.tfc1.bn.moments.Squeeze_1.ExponentialMovingAverage.npy")
-    );
-
-    m_ptrPlatSelection->DumpToNumpyFile(PLATFORMS::CPU,"A13_tnet_bn.npy",net2);
-
-    auto net3 = m_ptrPlatSelection->ReLU(GetTargetPlatform(),net2);
-
-    m_ptrPlatSelection->DumpToNumpyFile(PLATFORMS::CPU,"A13_tnet_relu.npy",net3);
-
+    auto net1 = FullyConnectedForward(builder, net, m_oWeights.tfc1.dense);
+    builder.Dump(net1, "A12_tnet_fc.npy");
+    auto net2 = BatchNormForward(builder, net1, m_oWeights.tfc1.bn, 2);
+    builder.Dump(net2, "A13_tnet_bn.npy");
+    auto net3 = builder.ReLU(net2);
+    builder.Dump(net3, "A13_tnet_relu.npy");
     net = net3;
   }
 
   //----------------------------------------------------------------------------
   //FC
-  // net is Bx1024
   {
-    auto net1 = FullyConnectedForward(
-        net,
-        m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-            GetTargetPlatform(),"transform_net1.tfc2.weights.npy"),
-        m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-            GetTargetPlatform(),"transform_net1.tfc2.biases.npy")
-    );
-
-    m_ptrPlatSelection->DumpToNumpyFile(PLATFORMS::CPU,"A14_tnet_fc.npy",net1);
-
-    auto net2 = BatchNormForward(
-        net1,
-        m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-            GetTargetPlatform(),"transform_net1.tfc2.bn.gamma.npy"),
-        m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-            GetTargetPlatform(),"transform_net1.tfc2.bn.beta.npy"),
-        m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-            GetTargetPlatform(),"transform_net1.tfc2.bn.transform_net1.tfc2.bn.moments.Squeeze.ExponentialMovingAverage.npy"),
-        m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-            GetTargetPlatform(),"transform_net1.tfc2.bn.transform_net1.tfc2.bn.moments.Squeeze_1.ExponentialMovingAverage.npy")
-    );
-
-    m_ptrPlatSelection->DumpToNumpyFile(PLATFORMS::CPU,"A15_tnet_bn.npy",net2);
-
-    auto net3 = m_ptrPlatSelection->ReLU(GetTargetPlatform(),net2);
-
-    m_ptrPlatSelection->DumpToNumpyFile(PLATFORMS::CPU,"A16_tnet_relu.npy",net3);
-
+    auto net1 = FullyConnectedForward(builder, net, m_oWeights.tfc2.dense);
+    builder.Dump(net1, "A14_tnet_fc.npy");
+    auto net2 = BatchNormForward(builder, net1, m_oWeights.tfc2.bn, 2);
+    builder.Dump(net2, "A15_tnet_bn.npy");
+    auto net3 = builder.ReLU(net2);
+    builder.Dump(net3, "A16_tnet_relu.npy");
     net = net3;
   }
 
   //----------------------------------------------------------------------------
   {
-    auto weights = m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-        GetTargetPlatform(),"transform_net1.transform_XYZ.weights.npy");
-    auto _biases = m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-        GetTargetPlatform(),"transform_net1.transform_XYZ.biases.npy");
+    auto weights = builder.Weight(m_oWeights.transformXYZ.weights);
+    auto _biases = builder.Weight(m_oWeights.transformXYZ.biases);
 
     float eyeData[] = {1,0,0,
                        0,1,0,
                        0,0,1};
-    CTensorBasePtr eye(new CTensor<float>({9}, eyeData));
-
-    auto biases = m_ptrPlatSelection->BasicOps(GetTargetPlatform(),_biases,eye, BASIC_OPS::ADD);
-    m_ptrPlatSelection->DumpToNumpyFile(PLATFORMS::CPU,"A17_biass_added.npy",biases);
+    auto eye = builder.Constant(CTensorBasePtr(new CTensor<float>({9}, eyeData)), "transform_net1.eye");
 
-    auto transformTn = m_ptrPlatSelection->MatMul(GetTargetPlatform(),net,weights);
-    m_ptrPlatSelection->DumpToNumpyFile(PLATFORMS::CPU,"A18_transform_batch.npy",transformTn);
+    auto biases = builder.BasicOps(_biases, eye, BASIC_OPS::ADD);
+    builder.Dump(biases, "A17_biass_added.npy");
 
+    auto transform = builder.MatMul(net, weights);
+    builder.Dump(transform, "A18_transform_batch.npy");
 
-    auto transformFinalTn = m_ptrPlatSelection->BasicOps(GetTargetPlatform(), transformTn, biases, BASIC_OPS::ADD);
-    m_ptrPlatSelection->DumpToNumpyFile(PLATFORMS::CPU,"A19_transform_batch_bias.npy",transformFinalTn);
+    auto transformFinal = builder.BasicOps(transform, biases, BASIC_OPS::ADD);
+    builder.Dump(transformFinal, "A19_transform_batch_bias.npy");
 
     // Forcibly use the CPU tensor. This will allow us to use reshape without worrying about the padded last dim policy.
-    return m_ptrPlatSelection->CrossThePlatformIfNeeded(PLATFORMS::CPU, transformFinalTn); // Force CPU
+    builder.SetScope("");
+    return builder.CrossThePlatform(transformFinal, PLATFORMS::CPU); // Force CPU
   }
 }
 
-CTensorBasePtr CModel1::Execute() {
-  CTensorBasePtr net;
-  CTensorBasePtr net_BxNx3;
+void CModel1::BuildGraph() {
+  SPDLOG_LOGGER_INFO(logger,"Building the graph of the model...");
+  m_ptrGraph = new CGraph();
+  CGraphBuilder builder(m_ptrGraph, m_ptrPlatSelection->GetClassPtrWeightLoader(), GetTargetPlatform());
 
-  CTensorBasePtr endpoint_0, endpoint_1, endpoint_2, endpoint_3;
-
-  //----------------------------------------------------------------------------------------
-  SPDLOG_LOGGER_INFO(logger,"Starting Process...");
-  SPDLOG_LOGGER_INFO(logger,"Batch Size: {}", m_uBatchSize);
-  SPDLOG_LOGGER_INFO(logger,"Point Count: {}", m_uPointsPerCloud);
+  unsigned net;
+  std::vector<unsigned> endpoints;
 
   //----------------------------------------------------------------------------------------
   // TransferNet(net_BxNx3 is this layer's input)
   {
-    net_BxNx3 = GetDataTn();
-    m_ptrPlatSelection->DumpToNumpyFile(PLATFORMS::CPU,"B00_input_pcl_BxNxD.npy",net_BxNx3);
-
-    auto adj_matrix = PairwiseDistance(net_BxNx3);
-    m_ptrPlatSelection->DumpToNumpyFile(PLATFORMS::CPU,"B01_tnet_adj_matrix.npy",adj_matrix);
+    auto net_BxNx3 = builder.Input("input_pcl_BxNxD");
+    builder.Dump(net_BxNx3, "B00_input_pcl_BxNxD.npy");
 
-    auto nn_idx = m_ptrPlatSelection->TopK(GetTargetPlatform(),adj_matrix,2,m_uKnnK);
-    m_ptrPlatSelection->DumpToNumpyFile(PLATFORMS::CPU,"B02_tnet_nn_idx.npy",nn_idx);
-    
-    auto edge_features = GetEdgeFeatures(net_BxNx3, nn_idx);
-    m_ptrPlatSelection->DumpToNumpyFile(PLATFORMS::CPU,"B03_tnet_edgef.npy",edge_features);
+    // KNN replaces the pairwise distance matrix + TopK(). On the CPU it is fused and the BxNxN matrix is not materialized.
+    auto nn_idx = builder.KNN(net_BxNx3, m_uKnnK);
+    builder.Dump(nn_idx, "B02_tnet_nn_idx.npy");
 
-    auto transform = TransformNet(edge_features);
-    transform->Reshape({m_uBatchSize,3,3});
-    m_ptrPlatSelection->DumpToNumpyFile(PLATFORMS::CPU,"B04_tnet_3x3.npy",transform);
+    auto transform = TransformNet(builder, net_BxNx3, nn_idx);
+    transform = builder.Reshape(transform, {m_uBatchSize,3,3});
+    builder.Dump(transform, "B04_tnet_3x3.npy");
 
-    net = m_ptrPlatSelection->MatMul(GetTargetPlatform(),  net_BxNx3, transform);
-    m_ptrPlatSelection->DumpToNumpyFile(PLATFORMS::CPU,"C01_pcl.npy",net);
+    net = builder.MatMul(net_BxNx3, transform);
+    builder.Dump(net, "C01_pcl.npy");
   }
 
   //----------------------------------------------------------------------------------------
-  // DGCNN Layer #0
-  SPDLOG_LOGGER_INFO(logger,"DGCCN0 Started...");
-  {
-    auto adj_matrix = PairwiseDistance(net);
-    auto nn_idx = m_ptrPlatSelection->TopK(GetTargetPlatform(),adj_matrix,2,m_uKnnK);
-    auto edge_features = GetEdgeFeatures(net,nn_idx);
-    auto net1 = m_ptrPlatSelection->Conv2D(GetTargetPlatform(),
-                                             edge_features,
-                                             m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                                 GetTargetPlatform(),"dgcnn1.weights.npy"),
-                                             m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                                 GetTargetPlatform(),"dgcnn1.biases.npy")
-    );
-    m_ptrPlatSelection->DumpToNumpyFile(PLATFORMS::CPU,"C02_dg1_conv.npy",net1);
-
-    auto net2 = BatchNormForward(net1,
-                                      m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                          GetTargetPlatform(),"dgcnn1.bn.gamma.npy"),
-                                      m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                          GetTargetPlatform(),"dgcnn1.bn.beta.npy"),
-                                      m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                          GetTargetPlatform(),"dgcnn1.bn.dgcnn1.bn.moments.Squeeze.ExponentialMovingAverage.npy"),
-                                      m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                          GetTargetPlatform(),"dgcnn1.bn.dgcnn1.bn.moments.Squeeze_1.ExponentialMovingAverage.npy")
-    );
-    m_ptrPlatSelection->DumpToNumpyFile(PLATFORMS::CPU,"C03_dg1_bn.npy",net2);
-
-    auto net3 = m_ptrPlatSelection->ReLU(GetTargetPlatform(),net2);
-
-    ///TODO: CHECK THIS! REDUCE LAYER HAS BEEN CHANGED!
-    //auto net4 = m_ptrPlatSelection->ReduceMax(GetTargetPlatform(),net3,2);
-    auto net4 = m_ptrPlatSelection->Reduce(GetTargetPlatform(),net3,REDUCTION_OPS::MAX,1,{0,0,1,0});
-
-    m_ptrPlatSelection->DumpToNumpyFile(PLATFORMS::CPU,"B05_dg1_pool.npy",net4);
+  // DGCNN Layers #0 to #3
+  const char *poolDumps[] = {"B05_dg1_pool.npy", "B06_dg2_pool.npy", "B07_dg3_pool.npy", "B08_dg4_pool.npy"};
+  for(unsigned i=0; i<4; i++){
+    const std::string layerName = "dgcnn"+std::to_string(i+1);
+    builder.SetScope(layerName);
 
-    net = net4;
-    endpoint_0 = net;
-  }
+    auto nn_idx = builder.KNN(net, m_uKnnK);
+    auto net1 = builder.EdgeConv(net, nn_idx, builder.Weight(m_oWeights.dgcnn[i].dense.weights), builder.Weight(m_oWeights.dgcnn[i].dense.biases));
+    if(i==0) builder.Dump(net1, "C02_dg1_conv.npy");
 
-  //----------------------------------------------------------------------------------------
-  // DGCNN Layer #1
-  SPDLOG_LOGGER_INFO(logger,"DGCCN1 Started...");
-  {
-    auto adj_matrix = PairwiseDistance(net);
-    auto nn_idx = m_ptrPlatSelection->TopK(GetTargetPlatform(),adj_matrix,2,m_uKnnK);
-    auto edge_features = GetEdgeFeatures(net,nn_idx);
-    auto net1 = m_ptrPlatSelection->Conv2D(GetTargetPlatform(),
-                                             edge_features,
-                                             m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                                 GetTargetPlatform(),"dgcnn2.weights.npy"),
-                                             m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                                 GetTargetPlatform(),"dgcnn2.biases.npy")
-    );
-
-    auto net2 = BatchNormForward(net1,
-                                      m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                          GetTargetPlatform(),"dgcnn2.bn.gamma.npy"),
-                                      m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                          GetTargetPlatform(),"dgcnn2.bn.beta.npy"),
-                                      m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                          GetTargetPlatform(),"dgcnn2.bn.dgcnn2.bn.moments.Squeeze.ExponentialMovingAverage.npy"),
-                                      m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                          GetTargetPlatform(),"dgcnn2.bn.dgcnn2.bn.moments.Squeeze_1.ExponentialMovingAverage.npy")
-    );
-
-    auto net3 = m_ptrPlatSelection->ReLU(GetTargetPlatform(),net2);
-
-    ///TODO: CHECK THIS, REDUCE LAYER HAS BEEN CHANGED!
-    //auto net4 = m_ptrPlatSelection->ReduceMax(GetTargetPlatform(),net3,2);
-    auto net4 = m_ptrPlatSelection->Reduce(GetTargetPlatform(),net3,REDUCTION_OPS::MAX,1,{0,0,1,0});
-
-    m_ptrPlatSelection->DumpToNumpyFile(PLATFORMS::CPU,"B06_dg2_pool.npy",net4);
+    auto net2 = BatchNormForward(builder, net1, m_oWeights.dgcnn[i].bn, 4);
+    if(i==0) builder.Dump(net2, "C03_dg1_bn.npy");
+
+    auto net3 = builder.ReLU(net2);
+    auto net4 = builder.Reduce(net3, REDUCTION_OPS::MAX, 1, {0,0,1,0});
+    builder.Dump(net4, poolDumps[i]);
 
     net = net4;
-    endpoint_1 = net;
+    endpoints.push_back(net);
   }
 
   //----------------------------------------------------------------------------------------
-  // DGCNN Layer #2
-  SPDLOG_LOGGER_INFO(logger,"DGCCN2 Started...");
+  builder.SetScope("agg");
   {
-    auto adj_matrix = PairwiseDistance(net);
-    auto nn_idx = m_ptrPlatSelection->TopK(GetTargetPlatform(), adj_matrix,2,m_uKnnK);
-    auto edge_features = GetEdgeFeatures(net,nn_idx);
-    auto net1 = m_ptrPlatSelection->Conv2D(GetTargetPlatform(),
-                                             edge_features,
-                                             m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                                 GetTargetPlatform(),"dgcnn3.weights.npy"),
-                                             m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                                 GetTargetPlatform(),"dgcnn3.biases.npy")
-    );
-
-    auto net2 = BatchNormForward(net1,
-                                      m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                          GetTargetPlatform(),"dgcnn3.bn.gamma.npy"),
-                                      m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                          GetTargetPlatform(),"dgcnn3.bn.beta.npy"),
-                                      m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                          GetTargetPlatform(),"dgcnn3.bn.dgcnn3.bn.moments.Squeeze.ExponentialMovingAverage.npy"),
-                                      m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                          GetTargetPlatform(),"dgcnn3.bn.dgcnn3.bn.moments.Squeeze_1.ExponentialMovingAverage.npy")
-    );
-
-    auto net3 = m_ptrPlatSelection->ReLU(GetTargetPlatform(),net2);
-
-    ///TODO: CHECK THIS, REDUCE LAYER HAS BEEN CHANGED!
-    //auto net4 = m_ptrPlatSelection->ReduceMax(GetTargetPlatform(),net3,2);
-    auto net4 = m_ptrPlatSelection->Reduce(GetTargetPlatform(),net3,REDUCTION_OPS::MAX,1,{0,0,1,0});
-
-    m_ptrPlatSelection->DumpToNumpyFile(PLATFORMS::CPU,"B07_dg3_pool.npy",net4);
+    for(auto &endpoint:endpoints){
+      endpoint = builder.ExpandDims(endpoint, 2);
+    }
+    auto concatA = builder.Concat2(endpoints[0], endpoints[1], 3);
+    auto concatB = builder.Concat2(concatA, endpoints[2], 3);
+    auto concatC = builder.Concat2(concatB, endpoints[3], 3);
+    builder.Dump(concatC, "B09_agg_concat.npy");
 
-    net = net4;
-    endpoint_2 = net;
+    // DIM2(m_uKnnK) of the concatenated tensor is ONE, NOT 'm_uKnnK'
+    auto net1 = builder.Conv2D(concatC, builder.Weight(m_oWeights.agg.dense.weights), builder.Weight(m_oWeights.agg.dense.biases));
+    builder.Dump(net1, "B10_agg_conv.npy");
+
+    auto net2 = BatchNormForward(builder, net1, m_oWeights.agg.bn, 4);
+    builder.Dump(net2, "B11_agg_bn.npy");
+    auto net3 = builder.ReLU(net2);
+
+    auto net4 = builder.Reduce(net3, REDUCTION_OPS::MAX, 1, {0,1,0,0});
+    builder.Dump(net4, "B12_agg_pool.npy");
+
+    //RESHAPING TO (Bx-1)
+    net = builder.SqueezeDims(net4);
   }
 
   //----------------------------------------------------------------------------------------
-  // DGCNN Layer #3
-  SPDLOG_LOGGER_INFO(logger,"DGCCN3 Started...");
-  {
-    auto adj_matrix = PairwiseDistance(net);
-    auto nn_idx = m_ptrPlatSelection->TopK(GetTargetPlatform(),adj_matrix,2,m_uKnnK);
-    auto edge_features = GetEdgeFeatures(net,nn_idx);
-    auto net1 = m_ptrPlatSelection->Conv2D(GetTargetPlatform(),
-                                             edge_features,
-                                             m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                                 GetTargetPlatform(),"dgcnn4.weights.npy"),
-                                             m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                                 GetTargetPlatform(),"dgcnn4.biases.npy")
-    );
-
-    auto net2 = BatchNormForward(net1,
-                                      m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                          GetTargetPlatform(),"dgcnn4.bn.gamma.npy"),
-                                      m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                          GetTargetPlatform(),"dgcnn4.bn.beta.npy"),
-                                      m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                          GetTargetPlatform(),"dgcnn4.bn.dgcnn4.bn.moments.Squeeze.ExponentialMovingAverage.npy"),
-                                      m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                          GetTargetPlatform(),"dgcnn4.bn.dgcnn4.bn.moments.Squeeze_1.ExponentialMovingAverage.npy")
-    );
-
-    auto net3 = m_ptrPlatSelection->ReLU(GetTargetPlatform(),net2);
-
-    ///TODO: CHECK THIS, REDUCE LAYER HAS BEEN CHANGED.
-    //auto net4 = m_ptrPlatSelection->ReduceMax(GetTargetPlatform(),net3,2);
-    auto net4 = m_ptrPlatSelection->Reduce(GetTargetPlatform(),net3,REDUCTION_OPS::MAX,1,{0,0,1,0});
-
-    m_ptrPlatSelection->DumpToNumpyFile(PLATFORMS::CPU,"B08_dg4_pool.npy",net4);
-
-    net = net4;
-    endpoint_3 = net;
+  //FC1 and FC2
+  //net is of shape Bx1024
+  const char *fcDumps[][2] = {{"B13_fc.npy", "B14_fc.npy"}, {"B15_fc.npy", "B16_fc.npy"}};
+  for(unsigned i=0; i<2; i++){
+    const std::string layerName = "fc"+std::to_string(i+1);
+    builder.SetScope(layerName);
+
+    auto net1 = FullyConnectedForward(builder, net, m_oWeights.fc[i].dense);
+    builder.Dump(net1, fcDumps[i][0]);
+    auto net2 = BatchNormForward(builder, net1, m_oWeights.fc[i].bn, 2);
+    builder.Dump(net2, fcDumps[i][1]);
+    net = builder.ReLU(net2);
   }
 
   //----------------------------------------------------------------------------------------
-  SPDLOG_LOGGER_INFO(logger,"Agg Layer Started...");
+  //FC3
+  //net is of shape Bx256
+  builder.SetScope("fc3");
   {
-    endpoint_0->ExpandDims(2);
-    endpoint_1->ExpandDims(2);
-    endpoint_2->ExpandDims(2);
-    endpoint_3->ExpandDims(2);
-    auto concatA = m_ptrPlatSelection->Concat2(GetTargetPlatform(), endpoint_0, endpoint_1, 3);
-    auto concatB = m_ptrPlatSelection->Concat2(GetTargetPlatform(), concatA, endpoint_2, 3);
-    auto concatC = m_ptrPlatSelection->Concat2(GetTargetPlatform(), concatB, endpoint_3, 3);
-    m_ptrPlatSelection->DumpToNumpyFile(PLATFORMS::CPU,"B09_agg_concat.npy",concatC);
+    net = FullyConnectedForward(builder, net, m_oWeights.fc3);
+    builder.Dump(net, "B17_fc.npy");
+  }
 
-    // DIM2(m_uKnnK) of the concatenated tensor is ONE, NOT 'm_uKnnK'
-    auto net1 = m_ptrPlatSelection->Conv2D(GetTargetPlatform(),
-                                             concatC,
-                                             m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                                 GetTargetPlatform(),"agg.weights.npy"),
-                                             m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                                 GetTargetPlatform(),"agg.biases.npy")
-    );
+  builder.Output(net);
+  m_ptrGraph->PrintSummary();
+  m_ptrGraphExecutor = new CGraphExecutor(m_ptrPlatSelection, m_ptrGraph);
+}
 
-    m_ptrPlatSelection->DumpToNumpyFile(PLATFORMS::CPU,"B10_agg_conv.npy",net1);
+const CGraph* CModel1::GetGraph() {
+  return m_ptrGraph;
+}
 
-    auto net2 = BatchNormForward(net1,
-                                      m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                          GetTargetPlatform(),"agg.bn.gamma.npy"),
-                                      m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                          GetTargetPlatform(),"agg.bn.beta.npy"),
-                                      m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                          GetTargetPlatform(),"agg.bn.agg.bn.moments.Squeeze.ExponentialMovingAverage.npy"),
-                                      m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                          GetTargetPlatform(),"agg.bn.agg.bn.moments.Squeeze_1.ExponentialMovingAverage.npy")
-    );
+CPlatformSelection* CModel1::GetPlatformSelection() {
+  return m_ptrPlatSelection;
+}
 
+CTensorBasePtr CModel1::Execute() {
+  if(m_ptrGraph==nullptr){
+    BuildGraph();
+  }
 
-    m_ptrPlatSelection->DumpToNumpyFile(PLATFORMS::CPU,"B11_agg_bn.npy",net2);
-    auto net3 = m_ptrPlatSelection->ReLU(GetTargetPlatform(),net2);
+  //----------------------------------------------------------------------------------------
+  SPDLOG_LOGGER_INFO(logger,"Starting Process...");
+  SPDLOG_LOGGER_INFO(logger,"Batch Size: {}", m_uBatchSize);
+  SPDLOG_LOGGER_INFO(logger,"Point Count: {}", m_uPointsPerCloud);
+  m_ptrPlatSelection->ResetMemoryPoolStats();
 
-    ///TODO: CHECK THIS, REDUCE LAYER HAS BEEN CHANGED.
-    //auto net4 = m_ptrPlatSelection->ReduceMax(GetTargetPlatform(),net3,1);
-    auto net4 = m_ptrPlatSelection->Reduce(GetTargetPlatform(),net3,REDUCTION_OPS::MAX,1,{0,1,0,0});
+  auto net = RunGraph(GetDataTn());
 
-    m_ptrPlatSelection->DumpToNumpyFile(PLATFORMS::CPU,"B12_agg_pool.npy",net4);
+  //----------------------------------------------------------------------------------------
+  //force output tensor platform to be CPU
+  auto outputTn = m_ptrPlatSelection->CrossThePlatformIfNeeded(PLATFORMS::CPU, net);
+  m_ptrPlatSelection->ReportMemoryPoolStats();
+  return outputTn;
+}
 
-    net = net4;
+CTensorBasePtr CModel1::RunGraph(CTensorBasePtr inputTn) {
+  auto *bankPlanner = m_ptrPlatSelection->GetClassPtrBankPlanner();
+  m_ptrPlatSelection->GetClassPtrMemoryPlanner()->BeginPass();
+  if(bankPlanner!=nullptr) bankPlanner->BeginPass();
+  auto net = m_ptrGraphExecutor->Execute({inputTn})[0];
+  m_ptrPlatSelection->GetClassPtrMemoryPlanner()->EndPass(net);
+  if(bankPlanner!=nullptr && bankPlanner->EndPass()){
+    // The weights are moved to their planned banks once, the uploads of the next passes use the plan by themselves.
+    m_ptrPlatSelection->GetClassPtrWeightLoader()->ApplyBankPlan();
   }
+  return net;
+}
 
-  //----------------------------------------------------------------------------------------
-  //RESHAPING TO (Bx-1)
-  {
-    net->SqueezeDims();
+/**
+ * @brief      Enqueues the forward pass of the batch at datasetOffset without reading its output back.
+ * The input point clouds are uploaded non-blocking and all of the device layers are only enqueued, so the host
+ * returns as soon as the forced CPU layers of the batch are done. Calling it again before CollectBatch() overlaps the
+ * upload and the first layers of the next batch with the tail of the current one (double-buffering).
+ *
+ * @param[in]  datasetOffset  The dataset offset of the batch
+ */
+void CModel1::EnqueueBatch(unsigned datasetOffset) {
+  if(m_ptrGraph==nullptr){
+    BuildGraph();
   }
+  SetDatasetOffset(datasetOffset);
 
-  //----------------------------------------------------------------------------------------
-  //FC1
-  //net is of shape Bx1x1x1024
-  SPDLOG_LOGGER_INFO(logger,"FC Layer1 Started...");
-  {
-    auto net1 = FullyConnectedForward(net,
-                                           m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                               GetTargetPlatform(),"fc1.weights.npy"),
-                                           m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                               GetTargetPlatform(),"fc1.biases.npy")
-    );
-    m_ptrPlatSelection->DumpToNumpyFile(PLATFORMS::CPU,"B13_fc.npy",net1);
-
-    //net1 is of shape Bx1x1x512
-    auto net2 = BatchNormForward(net1,
-                                      m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                          GetTargetPlatform(),"fc1.bn.gamma.npy"),
-                                      m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                          GetTargetPlatform(),"fc1.bn.beta.npy"),
-                                      m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                          GetTargetPlatform(),"fc1.bn.fc1.bn.moments.Squeeze.ExponentialMovingAverage.npy"),
-                                      m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                          GetTargetPlatform(),"fc1.bn.fc1.bn.moments.Squeeze_1.ExponentialMovingAverage.npy")
-    );
-    m_ptrPlatSelection->DumpToNumpyFile(PLATFORMS::CPU,"B14_fc.npy",net2);
-
-    auto net3 = m_ptrPlatSelection->ReLU(GetTargetPlatform(),net2);
-    net = net3;
+  auto inputTn = GetDataTn();
+  if(GetTargetPlatform()==PLATFORMS::XIL){
+    inputTn = m_ptrPlatSelection->UploadAsync(inputTn);
   }
 
-  //----------------------------------------------------------------------------------------
-  //FC2
-  //net is of shape Bx1x1x512
-  SPDLOG_LOGGER_INFO(logger,"FC Layer2 Started...");
-  {
-    auto net1 = FullyConnectedForward(net,
-                                           m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                               GetTargetPlatform(),"fc2.weights.npy"),
-                                           m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                               GetTargetPlatform(),"fc2.biases.npy")
-    );
-    m_ptrPlatSelection->DumpToNumpyFile(PLATFORMS::CPU,"B15_fc.npy",net1);
-
-    //net1 is of shape Bx1x1x512
-    auto net2 = BatchNormForward(net1,
-                                      m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                          GetTargetPlatform(),"fc2.bn.gamma.npy"),
-                                      m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                          GetTargetPlatform(),"fc2.bn.beta.npy"),
-                                      m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                          GetTargetPlatform(),"fc2.bn.fc2.bn.moments.Squeeze.ExponentialMovingAverage.npy"),
-                                      m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                          GetTargetPlatform(),"fc2.bn.fc2.bn.moments.Squeeze_1.ExponentialMovingAverage.npy")
-    );
-
-    m_ptrPlatSelection->DumpToNumpyFile(PLATFORMS::CPU,"B16_fc.npy",net2);
-
-    auto net3 = m_ptrPlatSelection->ReLU(GetTargetPlatform(),net2);
-    net = net3;
-  }
+  PendingBatch batch;
+  batch.datasetOffset = datasetOffset;
+  batch.labelsTn = GetLabelTn();
+  batch.outputTn = RunGraph(inputTn);
+  m_qPendingBatches.push_back(batch);
+}
 
-  //----------------------------------------------------------------------------------------
-  //FC3
-  //net is of shape Bx1x1x256
-  SPDLOG_LOGGER_INFO(logger,"FC Layer3 Started...");
-  {
-    auto net1 = FullyConnectedForward(net,
-                                           m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                               GetTargetPlatform(),"fc3.weights.npy"),
-                                           m_ptrPlatSelection->GetClassPtrWeightLoader()->AccessWeights(
-                                               GetTargetPlatform(),"fc3.biases.npy")
-    );
-    m_ptrPlatSelection->DumpToNumpyFile(PLATFORMS::CPU,"B17_fc.npy",net1);
-    net = net1;
-  }
+/**
+ * @brief      Reads back the output of the oldest enqueued batch. Only the commands of that batch are waited for.
+ *
+ * @param      labelsTn  The labels of the batch (output)
+ *
+ * @return     The class scores of the batch (CPU)
+ */
+CTensorBasePtr CModel1::CollectBatch(CTensorBasePtr &labelsTn) {
+  ConditionCheck(!m_qPendingBatches.empty(), "There is no enqueued batch to collect.");
+  PendingBatch batch = m_qPendingBatches.front();
+  m_qPendingBatches.pop_front();
+  labelsTn = batch.labelsTn;
+  return m_ptrPlatSelection->CrossThePlatformIfNeeded(PLATFORMS::CPU, batch.outputTn);
+}
 
-  //----------------------------------------------------------------------------------------
-  //force output tensor platform to be CPU
-  return m_ptrPlatSelection->CrossThePlatformIfNeeded(PLATFORMS::CPU, net);
+unsigned CModel1::GetPendingBatchCount() {
+  return m_qPendingBatches.size();
 }
@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "cpu/CGemmCpu.h"
+#include "cpu/CCpuRuntime.h"
+
+using namespace std;
+
+constexpr int kSeed = 5;
+
+template <typename Func>
+double MeasureMs(Func func, unsigned repeats){
+  double best = 1e30;
+  for(unsigned r=0; r<repeats; r++){
+    auto t0 = chrono::high_resolution_clock::now();
+    func();
+    auto t1 = chrono::high_resolution_clock::now();
+    best = min(best, chrono::duration<double, milli>(t1-t0).count());
+  }
+  return best;
+}
+
+int BenchGemm(
+    const string &benchName,
+    unsigned batchSize,
+    unsigned sizeM,
+    unsigned sizeK,
+    unsigned sizeN,
+    bool withBias,
+    unsigned threadCount){
+  cout<<"=================================================="<<endl;
+  cout<<"BenchName: "<<benchName<<endl;
+  cout<<"Shape: B="<<batchSize<<" M="<<sizeM<<" K="<<sizeK<<" N="<<sizeN<<(withBias?" (+bias)":"")<<endl;
+
+  vector<float> hostA((size_t)batchSize*sizeM*sizeK);
+  vector<float> hostB((size_t)batchSize*sizeK*sizeN);
+  vector<float> hostBias(sizeN);
+  vector<float> hostGold((size_t)batchSize*sizeM*sizeN);
+  vector<float> hostUDT((size_t)batchSize*sizeM*sizeN);
+
+  default_random_engine rng(kSeed);
+  uniform_real_distribution<float> dist(-1.0f, 1.0f);
+  for(auto &e:hostA) e = dist(rng);
+  for(auto &e:hostB) e = dist(rng);
+  for(auto &e:hostBias) e = dist(rng);
+  const float *ptrBias = withBias ? hostBias.data() : nullptr;
+
+  const double msNaive = MeasureMs([&](){
+    CGemmCpu::GemmNaive(hostA.data(), hostB.data(), hostGold.data(), batchSize, sizeM, sizeK, sizeN, ptrBias);
+  }, 1);
+  const double msBlocked = MeasureMs([&](){
+    CGemmCpu::Gemm(hostA.data(), hostB.data(), hostUDT.data(), batchSize, sizeM, sizeK, sizeN, ptrBias, threadCount);
+  }, 5);
+
+  float maxErr = 0;
+  for(size_t i=0; i<hostGold.size(); i++){
+    // relative to the magnitude of the dot product
+    maxErr = max(maxErr, fabs(hostGold[i]-hostUDT[i]) / max(1.0f, fabs(hostGold[i])));
+  }
+
+  const double gflop = 2.0*batchSize*sizeM*sizeN*sizeK*1e-9;
+  cout<<"Naive:   "<<msNaive<<" ms, "<<gflop/(msNaive*1e-3)<<" GFLOP/s"<<endl;
+  cout<<"Blocked: "<<msBlocked<<" ms, "<<gflop/(msBlocked*1e-3)<<" GFLOP/s"<<endl;
+  cout<<"Speedup: "<<msNaive/msBlocked<<"x"<<endl;
+  cout<<"Max Relative Error: "<<maxErr<<endl;
+
+  const bool rslt = maxErr < 1e-3f;
+  if(rslt){
+    cout<<"Bench \""<<benchName<<"\" is successfully verified."<<endl;
+  }
+  return rslt ? 0 : 1;
+}
+
+int main(int argc, char **argv) {
+  const unsigned threadCount = argc>1 ? (unsigned)atoi(argv[1]) : CCpuRuntime::GetDefaultThreadCount();
+  cout<<"ISA: "<<CCpuRuntime::GetIsaName()<<", Threads: "<<threadCount<<endl;
+
+  // The shapes of the MatMul layers of CModel1::PairwiseDistance (B x N x D) x (B x D x N), N=1024.
+  int rslt = BenchGemm("PairwiseDistance_D3",   5, 1024,   3, 1024, false, threadCount);
+  rslt += BenchGemm("PairwiseDistance_D64",     5, 1024,  64, 1024, false, threadCount);
+  rslt += BenchGemm("PairwiseDistance_D128",    5, 1024, 128, 1024, false, threadCount);
+  rslt += BenchGemm("Square_N1024",             1, 1024, 1024, 1024, false, threadCount);
+  // The 1x1 Conv2D layers of CModel1 as (B*N*K x D) x (D x ch_out) + bias, B=5, N=1024, K=20.
+  rslt += BenchGemm("Conv2D_dgcnn1",            1, 102400,   6,   64, true, threadCount);
+  rslt += BenchGemm("Conv2D_dgcnn2",            1, 102400, 128,   64, true, threadCount);
+  rslt += BenchGemm("Conv2D_dgcnn4",            1, 102400, 128,  128, true, threadCount);
+  rslt += BenchGemm("Conv2D_agg",               1,   5120, 320, 1024, true, threadCount);
+  // Odd shapes to cover the edge tiles.
+  rslt += BenchGemm("Odd_Shape",                3,   37,  300,   45, false, threadCount);
+  rslt += BenchGemm("Odd_Shape_Bias",           3,   37,  300,   45, true, threadCount);
+  return rslt;
+}
@@ -0,0 +1,201 @@
+#define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "spdlog/sinks/stdout_color_sinks.h"
+#include "rapidjson/prettywriter.h"
+#include "rapidjson/stringbuffer.h"
+#include "models/CModel1.h"
+#include "cpu/CCpuRuntime.h"
+
+using namespace std;
+
+constexpr unsigned kPointCount = 1024; // N of CModel1
+constexpr unsigned kKnnK = 20;         // K of CModel1
+
+struct BenchOptions{
+  string jsonPath;
+  vector<unsigned> batchSizes = {5, 16, 32}; // The squeezes of CModel1 need B>1.
+  vector<unsigned> threadCounts;  // Empty means {1, the hardware concurrency}.
+  unsigned passes = 5;            // The measured forward passes per configuration.
+  bool naiveKernels = false;
+  bool foldBatchNorms = false;
+};
+
+struct BenchResult{
+  unsigned batchSize;
+  unsigned threadCount;
+  double modelSeconds;   // The creation of the model (the platforms and the random weights).
+  double firstSeconds;   // The first forward pass (building the graph, the first allocations of the pools, ...).
+  double bestSeconds;
+  double medianSeconds;
+};
+
+vector<unsigned> ParseList(const string &str){
+  vector<unsigned> values;
+  stringstream stream(str);
+  string item;
+  while(getline(stream, item, ',')){
+    if(!item.empty()) values.push_back((unsigned)atoi(item.c_str()));
+  }
+  return values;
+}
+
+double SecondsSince(chrono::steady_clock::time_point start){
+  return chrono::duration<double>(chrono::steady_clock::now()-start).count();
+}
+
+BenchResult RunConfiguration(unsigned batchSize, unsigned threadCount, const BenchOptions &options){
+  BenchResult result;
+  result.batchSize = batchSize;
+  result.threadCount = threadCount;
+  globalCpuThreadCount = threadCount;
+  globalCpuNaiveKernels = options.naiveKernels;
+  globalBatchsize = batchSize;
+
+  auto timerStart = chrono::steady_clock::now();
+  CModel1 model(PLATFORMS::CPU, 0, batchSize, kPointCount, kKnnK, false, false, false, false, false, options.foldBatchNorms);
+  model.SetDatasetRandom(batchSize, CPlatformSelection::kSyntheticSeed);
+  result.modelSeconds = SecondsSince(timerStart);
+
+  timerStart = chrono::steady_clock::now();
+  model.Execute();
+  result.firstSeconds = SecondsSince(timerStart);
+
+  vector<double> samples;
+  for(unsigned pass=0; pass<options.passes; pass++){
+    timerStart = chrono::steady_clock::now();
+    auto scoresTn = model.Execute();
+    samples.push_back(SecondsSince(timerStart));
+  }
+  sort(samples.begin(), samples.end());
+  result.bestSeconds = samples.front();
+  result.medianSeconds = samples[samples.size()/2];
+  return result;
+}
+
+void WriteJson(const string &path, const vector<BenchResult> &results, const BenchOptions &options){
+  rapidjson::StringBuffer strBuffer;
+  rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(strBuffer);
+  writer.StartObject();
+  writer.Key("context");
+  writer.StartObject();
+  {
+    writer.Key("commit.host");
+    writer.String(REPO_HASH_MAIN);
+    writer.Key("isa");
+    writer.String(CCpuRuntime::GetIsaName().c_str());
+    writer.Key("kernels");
+    writer.String(options.naiveKernels?"naive":"optimized");
+    writer.Key("batchnorms");
+    writer.String(options.foldBatchNorms?"folded":"default");
+    writer.Key("points");
+    writer.Uint(kPointCount);
+    writer.Key("k");
+    writer.Uint(kKnnK);
+  }
+  writer.EndObject();
+  writer.Key("benchmarks");
+  writer.StartArray();
+  for(auto &r:results){
+    writer.StartObject();
+    writer.Key("B");
+    writer.Uint(r.batchSize);
+    writer.Key("threads");
+    writer.Uint(r.threadCount);
+    writer.Key("passes");
+    writer.Uint(options.passes);
+    writer.Key("s.model");
+    writer.Double(r.modelSeconds);
+    writer.Key("s.first");
+    writer.Double(r.firstSeconds);
+    writer.Key("s.best");
+    writer.Double(r.bestSeconds);
+    writer.Key("s.median");
+    writer.Double(r.medianSeconds);
+    writer.Key("pcl.per.s");
+    writer.Double(r.batchSize/r.medianSeconds);
+    writer.EndObject();
+  }
+  writer.EndArray();
+  writer.EndObject();
+
+  ofstream outFile(path);
+  outFile<<strBuffer.GetString()<<endl;
+  cout<<"The results are written to "<<path<<endl;
+}
+
+void PrintHelp(const char *name){
+  cout<<"Usage: "<<name<<" [--json <path>] [--batchsizes <b1,b2,...>] [--threads <t1,t2,...>] [--passes <count>]"
+      <<" [--naive] [--foldbn]"<<endl;
+}
+
+int main(int argc, char **argv) {
+  BenchOptions options;
+  for(int i=1; i<argc; i++){
+    const string arg = argv[i];
+    const bool hasValue = i+1<argc;
+    if(arg=="--json" && hasValue) options.jsonPath = argv[++i];
+    else if(arg=="--batchsizes" && hasValue) options.batchSizes = ParseList(argv[++i]);
+    else if(arg=="--threads" && hasValue) options.threadCounts = ParseList(argv[++i]);
+    else if(arg=="--passes" && hasValue) options.passes = max(1, atoi(argv[++i]));
+    else if(arg=="--naive") options.naiveKernels = true;
+    else if(arg=="--foldbn") options.foldBatchNorms = true;
+    else{
+      PrintHelp(argv[0]);
+      return 1;
+    }
+  }
+  if(options.batchSizes.empty() || *min_element(options.batchSizes.begin(), options.batchSizes.end())<2){
+    cerr<<"The batch-sizes should be greater than one."<<endl;
+    return 1;
+  }
+  if(options.threadCounts.empty()){
+    options.threadCounts = {1};
+    if(CCpuRuntime::GetDefaultThreadCount()>1) options.threadCounts.push_back(CCpuRuntime::GetDefaultThreadCount());
+  }
+
+  logger = new spdlog::logger("BenchCpuModel", std::make_shared<spdlog::sinks::stdout_color_sink_mt>());
+  logger->set_level(spdlog::level::warn);
+  // The CPU-only mode with the random weights and point clouds, no device and no data directory are needed.
+  globalCpuOnly = true;
+  globalSyntheticData = true;
+  globalProfileOclEnabled = false;
+  globalCpuUsageSamplingEnabled = false;
+  globalDumpTensors = false;
+
+  cout<<"ISA: "<<CCpuRuntime::GetIsaName()<<", Points: "<<kPointCount<<", K: "<<kKnnK
+      <<", Kernels: "<<(options.naiveKernels?"naive":"optimized")
+      <<", BatchNorms: "<<(options.foldBatchNorms?"folded":"default")<<endl;
+  cout<<right<<setw(6)<<"B"<<setw(10)<<"Threads"<<setw(12)<<"model(s)"<<setw(12)<<"first(s)"
+      <<setw(12)<<"best(s)"<<setw(12)<<"median(s)"<<setw(12)<<"pcl/s"<<endl;
+
+  vector<BenchResult> results;
+  for(auto threadCount:options.threadCounts){
+    for(auto batchSize:options.batchSizes){
+      results.push_back(RunConfiguration(batchSize, threadCount, options));
+      const auto &r = results.back();
+      cout<<right<<fixed<<setprecision(3)
+          <<setw(6)<<r.batchSize
+          <<setw(10)<<r.threadCount
+          <<setw(12)<<r.modelSeconds
+          <<setw(12)<<r.firstSeconds
+          <<setw(12)<<r.bestSeconds
+          <<setw(12)<<r.medianSeconds
+          <<setw(12)<<r.batchSize/r.medianSeconds<<endl;
+    }
+  }
+
+  if(!options.jsonPath.empty()){
+    WriteJson(options.jsonPath, results, options);
+  }
+  return 0;
+}
@@ -0,0 +1,357 @@
+#define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "spdlog/sinks/stdout_color_sinks.h"
+#include "rapidjson/prettywriter.h"
+#include "rapidjson/stringbuffer.h"
+#include "cpu/CImplementationCpu.h"
+#include "cpu/CCpuRuntime.h"
+
+using namespace std;
+
+constexpr int kSeed = 5;
+constexpr unsigned kPointCount = 1024; // N of CModel1
+constexpr unsigned kKnnK = 20;         // K of CModel1
+
+struct BenchOptions{
+  string jsonPath;
+  string filter;
+  unsigned threadCount = 0;
+  bool naiveKernels = false;
+  double minSeconds = 0.3;     // The minimum measured time per case.
+  unsigned minRepeats = 3;
+  unsigned maxRepeats = 50;
+  double maxFootprintMb = 2048; // The cases with larger inputs and outputs are skipped.
+};
+
+struct BenchCase{
+  string name;
+  string op;
+  unsigned batchSize;
+  unsigned depth;
+  vector<vector<unsigned>> shapes; // The input shapes.
+  double flop;                     // Per run.
+  double bytes;                    // Read and written per run.
+  double elements;                 // The output elements per run.
+  // Allocates the inputs and returns the run of the layer.
+  function<function<CTensorBasePtr()>()> setup;
+};
+
+struct BenchResult{
+  const BenchCase *benchCase;
+  unsigned repeats;
+  double nsBest;
+  double nsMedian;
+};
+
+double Len(const vector<unsigned> &shape){
+  double len = 1;
+  for(auto d:shape) len *= d;
+  return len;
+}
+
+CTensorBasePtr RandomTensor(const vector<unsigned> &shape, float low=-1.0f, float high=1.0f){
+  static default_random_engine rng(kSeed);
+  uniform_real_distribution<float> dist(low, high);
+  auto *tn = new CTensor<float>(shape);
+  float *buff = tn->Get();
+  for(size_t i=0; i<tn->GetLen(); i++) buff[i] = dist(rng);
+  return CTensorBasePtr(tn);
+}
+
+CTensorBasePtr RandomIndices(const vector<unsigned> &shape, unsigned range){
+  static default_random_engine rng(kSeed);
+  uniform_int_distribution<unsigned> dist(0, range-1);
+  auto *tn = new CTensor<unsigned>(shape);
+  unsigned *buff = tn->Get();
+  for(size_t i=0; i<tn->GetLen(); i++) buff[i] = dist(rng);
+  return CTensorBasePtr(tn);
+}
+
+string ShapeToString(const vector<unsigned> &shape){
+  string str;
+  for(size_t i=0; i<shape.size(); i++){
+    str += (i==0?"":"x") + to_string(shape[i]);
+  }
+  return str;
+}
+
+/**
+ * @brief      The cases of every layer of CImplementationBase over the shapes of CModel1: B in {1,5,32}, N=1024,
+ * K=20 and D in {3,64,128,1024}. The rank 4 (BxNxKxD) tensors are only formed for D<=128 (the edge features), as in
+ * the model, the D=1024 cases use BxNx1xD (the aggregation layer).
+ */
+vector<BenchCase> MakeCases(CImplementationCpu *impl){
+  vector<BenchCase> cases;
+  const unsigned N = kPointCount, K = kKnnK;
+  const double f = sizeof(float);
+
+  auto add = [&](const string &op, unsigned B, unsigned D, vector<vector<unsigned>> shapes, double flop, double bytes,
+                 double elements, function<function<CTensorBasePtr()>()> setup){
+    string name = op + "/B" + to_string(B);
+    for(auto &s:shapes) name += "/" + ShapeToString(s);
+    cases.push_back({name, op, B, D, shapes, flop, bytes, elements, setup});
+  };
+
+  for(unsigned B: {1u, 5u, 32u}){
+    for(unsigned D: {3u, 64u, 128u, 1024u}){
+      const unsigned K4 = D<=128 ? K : 1;
+      const vector<unsigned> s3 = {B, N, D}, s4 = {B, N, K4, D};
+      const double len3 = Len(s3), len4 = Len(s4);
+
+      add("Concat2", B, D, {s4, s4}, 0, f*4*len4, 2*len4, [=]{
+        auto a = RandomTensor(s4), b = RandomTensor(s4);
+        return [=]{ return impl->Concat2(a, b, 3); };
+      });
+      add("MatMul", B, D, {s3, {B, D, N}}, 2.0*B*N*N*D, f*(2*len3+(double)B*N*N), (double)B*N*N, [=]{
+        auto a = RandomTensor(s3), b = RandomTensor({B, D, N});
+        return [=]{ return impl->MatMul(a, b); };
+      });
+      add("ReLU", B, D, {s4}, len4, f*2*len4, len4, [=]{
+        auto a = RandomTensor(s4);
+        return [=]{ return impl->ReLU(a); };
+      });
+      add("Sqrt", B, D, {s4}, len4, f*2*len4, len4, [=]{
+        auto a = RandomTensor(s4, 0.0f, 1.0f);
+        return [=]{ return impl->Sqrt(a); };
+      });
+      add("Square", B, D, {s4}, len4, f*2*len4, len4, [=]{
+        auto a = RandomTensor(s4);
+        return [=]{ return impl->Square(a); };
+      });
+      add("BasicOps.Sub", B, D, {s4, s4}, len4, f*3*len4, len4, [=]{
+        auto a = RandomTensor(s4), b = RandomTensor(s4);
+        return [=]{ return impl->BasicOps(a, b, BASIC_OPS::SUB); };
+      });
+      add("BasicOps.AddBroadcast", B, D, {s4, {D}}, len4, f*(2*len4+D), len4, [=]{
+        auto a = RandomTensor(s4), b = RandomTensor({D});
+        return [=]{ return impl->BasicOps(a, b, BASIC_OPS::ADD); };
+      });
+      add("BasicOps.MulScalar", B, D, {s4}, len4, f*2*len4, len4, [=]{
+        auto a = RandomTensor(s4);
+        return [=]{ return impl->BasicOps(a, -2.0f, BASIC_OPS::MUL_ELEMENTWISE); };
+      });
+      add("Tile", B, D, {s3}, 0, f*(len3+len3*K), len3*K, [=]{
+        auto a = RandomTensor(s3);
+        return [=]{ return impl->Tile(a, 2, K); };
+      });
+      add("Transpose", B, D, {s3}, 0, f*2*len3, len3, [=]{
+        auto a = RandomTensor(s3);
+        return [=]{ return impl->Transpose(a); };
+      });
+      add("Gather", B, D, {s3, {B, N, K}}, 0, f*(len3+(double)B*N*K+len3*K), len3*K, [=]{
+        auto a = RandomTensor(s3);
+        auto idx = RandomIndices({B, N, K}, N);
+        return [=]{ return impl->Gather(a, idx, 1); };
+      });
+      add("Reduce.Sum", B, D, {s3}, len3, f*(len3+(double)B*N), (double)B*N, [=]{
+        auto a = RandomTensor(s3);
+        return [=]{ return impl->Reduce(a, REDUCTION_OPS::SUM, 1, {0,0,1}); };
+      });
+      add("Reduce.MaxK", B, D, {s4}, len4, f*(len4+len3), len3, [=]{
+        auto a = RandomTensor(s4);
+        return [=]{ return impl->Reduce(a, REDUCTION_OPS::MAX, 1, {0,0,1,0}); };
+      });
+      add("Reduce.MaxN", B, D, {s4}, len4, f*(len4+(double)B*K4*D), (double)B*K4*D, [=]{
+        auto a = RandomTensor(s4);
+        return [=]{ return impl->Reduce(a, REDUCTION_OPS::MAX, 1, {0,1,0,0}); };
+      });
+      add("Mean", B, D, {s4}, len4, f*(len4+D), D, [=]{
+        auto a = RandomTensor(s4);
+        return [=]{ return impl->Mean(a, {1,1,1,0}); };
+      });
+      add("Variance", B, D, {s4}, 3*len4, f*(len4+D), D, [=]{
+        auto a = RandomTensor(s4);
+        return [=]{ return impl->Variance(a, {1,1,1,0}); };
+      });
+      const unsigned padded = (D/CONFIG_M_AXI_WIDTH+1)*CONFIG_M_AXI_WIDTH;
+      const double lenPadded = (double)B*N*padded;
+      add("PadLastDim", B, D, {s3}, 0, f*(len3+lenPadded), lenPadded, [=]{
+        auto a = RandomTensor(s3);
+        return [=]{ return impl->PadLastDim(a, padded); };
+      });
+      add("UnpadLastDim", B, D, {{B, N, padded}}, 0, f*(len3+lenPadded), len3, [=]{
+        auto a = RandomTensor({B, N, padded});
+        return [=]{ return impl->UnpadLastDim(a, D); };
+      });
+      if(D<=128){
+        // Conv2D of the edge features, ch_out=64 as dgcnn1 to dgcnn3.
+        add("Conv2D", B, D, {s4, {1, 1, D, 64}}, 2.0*len4*64, f*(len4+D*64+len4/D*64), len4/D*64, [=]{
+          auto a = RandomTensor(s4), w = RandomTensor({1, 1, D, 64}), b = RandomTensor({64});
+          return [=]{ return impl->Conv2D(a, w, b); };
+        });
+        add("KNN", B, D, {s3}, 2.0*B*N*N*D+(double)B*N*N, f*(len3+(double)B*N*K), (double)B*N*K, [=]{
+          auto a = RandomTensor(s3);
+          return [=]{ return impl->KNN(a, K); };
+        });
+        add("EdgeConv", B, D, {s3, {B, N, K}, {2*D, 64}}, 2.0*B*N*K*2*D*64,
+            f*(len3+(double)B*N*K+2*D*64+(double)B*N*K*64), (double)B*N*K*64, [=]{
+          auto a = RandomTensor(s3), w = RandomTensor({2*D, 64}), b = RandomTensor({64});
+          auto idx = RandomIndices({B, N, K}, N);
+          return [=]{ return impl->EdgeConv(a, idx, w, b); };
+        });
+      }else{
+        // Conv2D of the aggregation layer, 320 to 1024 channels.
+        const vector<unsigned> sAgg = {B, N, 1, 320};
+        add("Conv2D", B, D, {sAgg, {1, 1, 320, D}}, 2.0*B*N*320*D, f*(Len(sAgg)+320.0*D+(double)B*N*D), (double)B*N*D, [=]{
+          auto a = RandomTensor(sAgg), w = RandomTensor({1, 1, 320, D}), b = RandomTensor({D});
+          return [=]{ return impl->Conv2D(a, w, b); };
+        });
+      }
+    }
+    add("TopK", B, N, {{B, N, N}}, (double)B*N*N, f*((double)B*N*N+(double)B*N*K), (double)B*N*K, [=]{
+      auto a = RandomTensor({B, N, N});
+      return [=]{ return impl->TopK(a, 2, K); };
+    });
+  }
+  return cases;
+}
+
+double FootprintMb(const BenchCase &benchCase){
+  double bytes = 0;
+  for(auto &s:benchCase.shapes) bytes += Len(s)*sizeof(float);
+  return (bytes + benchCase.elements*sizeof(float))/(1024.0*1024.0);
+}
+
+BenchResult RunCase(const BenchCase &benchCase, const BenchOptions &options){
+  auto run = benchCase.setup();
+  run(); // The warm-up, also fills the host memory pool.
+  vector<double> samples;
+  double total = 0;
+  while(samples.size()<options.maxRepeats && (samples.size()<options.minRepeats || total<options.minSeconds*1e9)){
+    auto t0 = chrono::steady_clock::now();
+    auto rslt = run();
+    auto t1 = chrono::steady_clock::now();
+    rslt.reset();
+    samples.push_back(chrono::duration<double, nano>(t1-t0).count());
+    total += samples.back();
+  }
+  sort(samples.begin(), samples.end());
+  return {&benchCase, (unsigned)samples.size(), samples.front(), samples[samples.size()/2]};
+}
+
+void WriteJson(const string &path, const vector<BenchResult> &results, const BenchOptions &options, unsigned threadCount){
+  rapidjson::StringBuffer strBuffer;
+  rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(strBuffer);
+  writer.StartObject();
+  writer.Key("context");
+  writer.StartObject();
+  {
+    writer.Key("commit.host");
+    writer.String(REPO_HASH_MAIN);
+    writer.Key("isa");
+    writer.String(CCpuRuntime::GetIsaName().c_str());
+    writer.Key("threads");
+    writer.Uint(threadCount);
+    writer.Key("kernels");
+    writer.String(options.naiveKernels?"naive":"optimized");
+  }
+  writer.EndObject();
+  writer.Key("benchmarks");
+  writer.StartArray();
+  for(auto &r:results){
+    const auto &c = *r.benchCase;
+    writer.StartObject();
+    writer.Key("name");
+    writer.String(c.name.c_str());
+    writer.Key("op");
+    writer.String(c.op.c_str());
+    writer.Key("B");
+    writer.Uint(c.batchSize);
+    writer.Key("D");
+    writer.Uint(c.depth);
+    writer.Key("shapes");
+    writer.StartArray();
+    for(auto &s:c.shapes){
+      writer.StartArray();
+      for(auto d:s) writer.Uint(d);
+      writer.EndArray();
+    }
+    writer.EndArray();
+    writer.Key("repeats");
+    writer.Uint(r.repeats);
+    writer.Key("ns.best");
+    writer.Double(r.nsBest);
+    writer.Key("ns.median");
+    writer.Double(r.nsMedian);
+    writer.Key("gflops");
+    writer.Double(c.flop/r.nsMedian);
+    writer.Key("gbps");
+    writer.Double(c.bytes/r.nsMedian);
+    writer.Key("ns.per.element");
+    writer.Double(r.nsMedian/c.elements);
+    writer.EndObject();
+  }
+  writer.EndArray();
+  writer.EndObject();
+
+  ofstream outFile(path);
+  outFile<<strBuffer.GetString()<<endl;
+  cout<<"The results are written to "<<path<<endl;
+}
+
+void PrintHelp(const char *name){
+  cout<<"Usage: "<<name<<" [--json <path>] [--filter <substring>] [--threads <count>] [--naive]"
+      <<" [--mintime <seconds>] [--maxmb <megabytes>]"<<endl;
+}
+
+int main(int argc, char **argv) {
+  BenchOptions options;
+  for(int i=1; i<argc; i++){
+    const string arg = argv[i];
+    const bool hasValue = i+1<argc;
+    if(arg=="--json" && hasValue) options.jsonPath = argv[++i];
+    else if(arg=="--filter" && hasValue) options.filter = argv[++i];
+    else if(arg=="--threads" && hasValue) options.threadCount = (unsigned)atoi(argv[++i]);
+    else if(arg=="--mintime" && hasValue) options.minSeconds = atof(argv[++i]);
+    else if(arg=="--maxmb" && hasValue) options.maxFootprintMb = atof(argv[++i]);
+    else if(arg=="--naive") options.naiveKernels = true;
+    else{
+      PrintHelp(argv[0]);
+      return 1;
+    }
+  }
+
+  logger = new spdlog::logger("BenchCpuOps", std::make_shared<spdlog::sinks::stdout_color_sink_mt>());
+  logger->set_level(spdlog::level::warn);
+  globalCpuThreadCount = options.threadCount;
+  CProfiler profiler(string(P_tmpdir)+"/BenchCpuOps.trace", false);
+  CImplementationCpu impl(&profiler, false);
+  impl.SetUseNaiveKernels(options.naiveKernels);
+  cout<<"ISA: "<<CCpuRuntime::GetIsaName()<<", Threads: "<<impl.GetThreadCount()
+      <<", Kernels: "<<(options.naiveKernels?"naive":"optimized")<<endl;
+
+  const auto cases = MakeCases(&impl);
+  vector<BenchResult> results;
+  cout<<left<<setw(52)<<"Case"<<right<<setw(14)<<"ms(median)"<<setw(12)<<"GFLOP/s"<<setw(10)<<"GB/s"
+      <<setw(12)<<"ns/elem"<<endl;
+  for(auto &c:cases){
+    if(!options.filter.empty() && c.name.find(options.filter)==string::npos) continue;
+    if(FootprintMb(c)>options.maxFootprintMb){
+      cout<<left<<setw(52)<<c.name<<" skipped (footprint "<<(unsigned)FootprintMb(c)<<" MB)"<<endl;
+      continue;
+    }
+    results.push_back(RunCase(c, options));
+    const auto &r = results.back();
+    cout<<left<<setw(52)<<c.name<<right<<fixed<<setprecision(3)
+        <<setw(14)<<r.nsMedian*1e-6
+        <<setw(12)<<c.flop/r.nsMedian
+        <<setw(10)<<c.bytes/r.nsMedian
+        <<setw(12)<<r.nsMedian/c.elements<<endl;
+  }
+
+  if(!options.jsonPath.empty()){
+    WriteJson(options.jsonPath, results, options, impl.GetThreadCount());
+  }
+  return 0;
+}
@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <type_traits>
+#include <vector>
+#include <string>
+#include <cassert>
+#include "Utility.h"
+#include "AxiHelper.h"
+#include "PaddingCpu.h"
+
+using namespace std;
+using namespace ConfigTaskReduce::Sum4D;
+
+extern "C"
+void task_reduce(
+        const MemoryPackF_t *inputTn,
+        MemoryPackF_t *outputTn,
+        const unsigned mode,
+        const unsigned pow_y,
+        const unsigned dim0,
+        const unsigned dim1,
+        const unsigned dim2,
+        const unsigned dim3);
+
+void GoldReduceMoments4D(
+        const CONFIG_DTYPE *inputTn,
+        CONFIG_DTYPE *meanTn,
+        CONFIG_DTYPE *varianceTn,
+        const unsigned dim0,
+        const unsigned dim1,
+        const unsigned dim2,
+        const unsigned dim3){
+    unsigned indxS;
+    const unsigned batchSize = dim0*dim1*dim2;
+    for (unsigned d3=0; d3 < dim3; d3++){
+        double sum=0;
+        for (unsigned b = 0; b < batchSize; b++) {
+            indxS = b*dim3 + d3;
+            sum += inputTn[indxS];
+        }
+        const double mean = sum / batchSize;
+
+        double sumSq=0;
+        for (unsigned b = 0; b < batchSize; b++) {
+            indxS = b*dim3 + d3;
+            const double delta = inputTn[indxS] - mean;
+            sumSq += delta * delta;
+        }
+        meanTn[d3] = (CONFIG_DTYPE)mean;
+        varianceTn[d3] = (CONFIG_DTYPE)(sumSq / batchSize);
+    }
+}
+
+template<unsigned vecSize>
+int TestReduceMoments4D(
+    const string& testName,
+    const std::vector<unsigned> shape,
+    const double offset){
+    const unsigned rank = shape.size();
+    assert(rank==4);
+
+    cout<<"=================================================="<<endl;
+    cout<<"TestName: "<< testName <<endl;
+
+    const unsigned dim0 = shape[0];
+    const unsigned dim1 = shape[1];
+    const unsigned dim2 = shape[2];
+    const unsigned dim3 = shape[3];
+    const unsigned dim3Padded = MakeDivisible<unsigned>(dim3, CONFIG_M_AXI_WIDTH);
+    const unsigned vecsPerSlice = dim3Padded/CONFIG_M_AXI_WIDTH;
+    // The variance row is placed after a gap, like the sub-buffer aligned rows of the host side.
+    const unsigned rowStride = vecsPerSlice + 1;
+
+    const unsigned lenInput = dim0*dim1*dim2*dim3;
+    const unsigned lenInputPadded = dim0*dim1*dim2*dim3Padded;
+    const unsigned lenOutputUdt = 2*rowStride*CONFIG_M_AXI_WIDTH;
+
+    std::vector<CONFIG_DTYPE> hostInputTn(lenInput);
+    std::vector<CONFIG_DTYPE> hostInputTnPadded(lenInputPadded);
+    std::vector<CONFIG_DTYPE> hostGoldMean(dim3);
+    std::vector<CONFIG_DTYPE> hostGoldVariance(dim3);
+    std::vector<CONFIG_DTYPE> hostUDT(lenOutputUdt);
+
+    std::default_random_engine rng(kSeed);
+    typename std::conditional<
+        std::is_integral<CONFIG_DTYPE>::value, std::uniform_int_distribution<unsigned long>,
+        std::uniform_real_distribution<double>>::type dist(1, 10);
+
+    // The offset emulates the activations with a large mean and a small variance.
+    std::for_each(hostInputTn.begin(), hostInputTn.end(),
+        [&dist, &rng, offset](CONFIG_DTYPE &in) { in = CONFIG_DTYPE(offset + dist(rng)); });
+
+    PadTensor<CONFIG_DTYPE>(hostInputTn, hostInputTnPadded, dim0*dim1*dim2, dim3, dim3Padded);
+
+    auto deviceInputTn = Pack<vecSize, CONFIG_DTYPE>(hostInputTnPadded);
+    auto deviceOutputTn = Pack<vecSize, CONFIG_DTYPE>(hostUDT);
+
+    task_reduce(
+        deviceInputTn.data(),
+        deviceOutputTn.data(),
+        4,
+        rowStride,
+        dim0, dim1, dim2, dim3);
+
+    GoldReduceMoments4D(
+        hostInputTn.data(),
+        hostGoldMean.data(),
+        hostGoldVariance.data(),
+        dim0, dim1, dim2, dim3);
+
+    hostUDT = Unpack<vecSize, CONFIG_DTYPE>(deviceOutputTn);
+    bool rslt = true;
+
+    for(unsigned i=0; i<dim3; i++){
+        // The kernel writes the rows with padding on the last dimension, the variance row starts at rowStride.
+        CONFIG_DTYPE rCpuMean = hostGoldMean[i];
+        CONFIG_DTYPE rUdtMean = hostUDT[i];
+        CONFIG_DTYPE rCpuVariance = hostGoldVariance[i];
+        CONFIG_DTYPE rUdtVariance = hostUDT[rowStride*CONFIG_M_AXI_WIDTH + i];
+        if(abs(rCpuMean - rUdtMean)>1e-02){
+            printf("Mean, Index(d3)= (%03d)\trCPU=%f,\t\t rUDT=%f\n", i, rCpuMean, rUdtMean);
+            rslt=false;
+        }
+        if(abs(rCpuVariance - rUdtVariance)>1e-02){
+            printf("Variance, Index(d3)= (%03d)\trCPU=%f,\t\t rUDT=%f\n", i, rCpuVariance, rUdtVariance);
+            rslt=false;
+        }
+    }
+
+    std::cout<<std::endl;
+
+    if(rslt){
+        std::cout<<"Test \""<<testName<<"\" is successfully verified."<<std::endl;
+    }
+
+    return (rslt)? 0 : 1;
+}
+
+int main(int argc, char **argv) {
+    int rslt0 = TestReduceMoments4D<16>("ReduceMoments4D_TTTF", {2,2,2,17}, 0);
+    rslt0 += TestReduceMoments4D<16>("ReduceMoments4D_TTTF", {2,2,2,64}, 0);
+    rslt0 += TestReduceMoments4D<16>("ReduceMoments4D_TTTF", {2,2,2,119}, 0);
+    rslt0 += TestReduceMoments4D<16>("ReduceMoments4D_TTTF", {2,64,4,17}, 1000);
+    return rslt0;
+}
@@ -91,4 +91,15 @@ CTensorPtr<T> GenerateTensor(float minVal, float maxVal, const std::vector<unsig
     buff[i] = (T)float_rand(minVal,maxVal);
   }
   return testTn;
-}
\ No newline at end of file
+}
+/**
+ * @brief      Runs a layer on both platforms and compares the output of XIL against the output of CPU (the gold).
+ *
+ * @param[in]  runLayer  Launches the layer on the given platform and returns its output.
+ */
+template <typename LayerFunc>
+bool CompareLayerCpuXil(LayerFunc runLayer){
+  auto goldTn = runLayer(PLATFORMS::CPU);
+  auto dstTn = runLayer(PLATFORMS::XIL);
+  return platSelection->CompareTensors(PLATFORMS::CPU, goldTn, dstTn);
+}
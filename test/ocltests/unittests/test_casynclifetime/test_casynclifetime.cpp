@@ -0,0 +1,82 @@
+#define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+
+#include "gtest/gtest.h"
+#include "cpu/CTensor.h"
+#include "fpga/xilinx/CAsyncLifetimeManager.h"
+#include "test_helpers.h"
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// The tensors are pinned until the release, the duplicates are counted once and the counters go back to zero.
+bool LifetimePinReleaseTest(){
+  CAsyncLifetimeManager manager(8);
+  auto tn1 = Convert2TnBasePtr(GenerateTensor<float>(0, {4,16}));
+  auto tn2 = Convert2TnBasePtr(GenerateTensor<float>(0, {2,32}));
+  auto *record = manager.Pin({tn1, tn1, tn2}, nullptr, 7, false);
+  bool pinned = tn1.use_count()==2 && tn2.use_count()==2 &&
+                manager.GetLiveTensors()==2 &&
+                manager.GetLiveDeviceBytes()==tn1->GetSizeBytes()+tn2->GetSizeBytes() &&
+                manager.GetInFlightLaunches()==1 &&
+                record->parentLayerId==7 && !record->profileKernel;
+  manager.Release(record);
+  bool released = tn1.use_count()==1 && tn2.use_count()==1 &&
+                  manager.GetLiveTensors()==0 && manager.GetLiveDeviceBytes()==0 && manager.GetInFlightLaunches()==0;
+  return pinned && released;
+}
+
+// More launches than records, released out of order from another thread as the OpenCL callbacks would.
+bool LifetimeRingRecycleTest(unsigned ringSize, unsigned launches){
+  CAsyncLifetimeManager manager(ringSize);
+  std::mutex mutex;
+  std::deque<CallbackData*> pending;
+  bool done = false;
+  std::thread completer([&]{
+    unsigned turn = 0;
+    while(true){
+      CallbackData *record = nullptr;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if(!pending.empty()){
+          // Every other launch completes before the older ones.
+          if(turn++%2==0){
+            record = pending.back();
+            pending.pop_back();
+          }else{
+            record = pending.front();
+            pending.pop_front();
+          }
+        }else if(done){
+          return;
+        }
+      }
+      if(record) manager.Release(record);
+      else std::this_thread::yield();
+    }
+  });
+
+  auto tn = Convert2TnBasePtr(GenerateTensor<float>(0, {16}));
+  for(unsigned i=0; i<launches; i++){
+    auto *record = manager.Pin({tn, Convert2TnBasePtr(GenerateTensor<float>(0, {16}))}, nullptr, i, false);
+    std::lock_guard<std::mutex> lock(mutex);
+    pending.push_back(record);
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    done = true;
+  }
+  manager.WaitForAll();
+  completer.join();
+  return manager.GetLiveTensors()==0 && manager.GetInFlightLaunches()==0 && tn.use_count()==1 &&
+         manager.GetPeakDeviceBytes()<=ringSize*2*tn->GetSizeBytes();
+}
+
+TEST(test_casynclifetime, PinRelease) {
+  EXPECT_TRUE(LifetimePinReleaseTest());
+}
+
+TEST(test_casynclifetime, RingRecycle) {
+  EXPECT_TRUE(LifetimeRingRecycleTest(4, 2000));
+  EXPECT_TRUE(LifetimeRingRecycleTest(1, 200));
+}
@@ -0,0 +1,111 @@
+#define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+
+#include "gtest/gtest.h"
+#include "fpga/xilinx/CBankPlanner.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// The first two enabled banks, the planning needs at least two of them.
+bool BankPlannerGetBanks(unsigned &bankA, unsigned &bankB){
+  std::vector<unsigned> banks;
+  for(unsigned b=0; b<4; b++){
+    if(CBankPlanner::IsBankEnabled(b)) banks.push_back(b);
+  }
+  if(banks.size()<2) return false;
+  bankA = banks[0];
+  bankB = banks[1];
+  return true;
+}
+
+// The weights cross once per bank, the uploads once per read and the outputs of the kernels are not planned.
+bool BankPlannerPlanTest(){
+  unsigned bankA, bankB;
+  if(!BankPlannerGetBanks(bankA, bankB)) return true;
+  CBankPlanner planner(true, "");
+
+  planner.BeginPass();
+  planner.RecordRead(CBankPlanner::GetWeightSite("w"), bankA, bankB, 100, true);
+  planner.RecordRead(CBankPlanner::GetWeightSite("w"), bankA, bankB, 100, true);
+  planner.RecordRead(CBankPlanner::GetWeightSite("balanced"), bankA, bankA, 10, true);
+  planner.RecordRead(CBankPlanner::GetWeightSite("balanced"), bankA, bankB, 10, true);
+  const std::string uploadSite = planner.NextUploadSite();
+  planner.RecordRead(uploadSite, bankA, bankB, 50, false);
+  planner.RecordRead(uploadSite, bankA, bankB, 50, false);
+  planner.RecordRead("", bankA, bankB, 30, false);
+  planner.RecordRead("", bankB, bankB, 30, false);
+  planner.RecordMove(100+10+50+50+30);
+  const bool isBuilt = planner.EndPass();
+
+  bool planned = isBuilt && planner.HasPlan() &&
+                 planner.GetPlannedBank(CBankPlanner::GetWeightSite("w"))==(int)bankB &&
+                 planner.GetPlannedBank(CBankPlanner::GetWeightSite("balanced"))==(int)bankA &&
+                 planner.GetPlannedBank(uploadSite)==(int)bankB &&
+                 planner.GetPlannedBank(CBankPlanner::GetWeightSite("unknown"))==-1 &&
+                 planner.GetRecordedBytes()==100+10+100+30 &&
+                 planner.GetPlannedBytes()==10+30 &&
+                 planner.GetFixedBytes()==30 &&
+                 planner.GetMeasuredBytes()==240;
+
+  // The plan is kept and the uploads of the next pass get the same sites.
+  planner.BeginPass();
+  const bool isUploadStable = planner.NextUploadSite()==uploadSite;
+  const bool isRebuilt = planner.EndPass();
+  return planned && isUploadStable && !isRebuilt && planner.GetPlannedBank(uploadSite)==(int)bankB;
+}
+
+// The plan is saved at the end of the first pass and loaded by the next planner.
+bool BankPlannerSaveLoadTest(){
+  unsigned bankA, bankB;
+  if(!BankPlannerGetBanks(bankA, bankB)) return true;
+  const std::string planPath = "test_cbankplanner.plan";
+  std::remove(planPath.c_str());
+  {
+    CBankPlanner planner(true, planPath);
+    planner.BeginPass();
+    planner.RecordRead(CBankPlanner::GetWeightSite("w"), bankA, bankB, 100, true);
+    planner.RecordRead(CBankPlanner::kInputUploadSite, bankA, bankB, 100, false);
+    planner.EndPass();
+  }
+  CBankPlanner loaded(true, planPath);
+  CBankPlanner disabled(false, planPath);
+  std::remove(planPath.c_str());
+  return loaded.HasPlan() && loaded.IsPlanLoaded() &&
+         loaded.GetPlannedBank(CBankPlanner::GetWeightSite("w"))==(int)bankB &&
+         loaded.GetPlannedBank(CBankPlanner::kInputUploadSite)==(int)bankB &&
+         !disabled.HasPlan() && disabled.GetPlannedBank(CBankPlanner::GetWeightSite("w"))==-1;
+}
+
+// The sites of the uploads of a node do not depend on the number of the uploads of the other nodes.
+bool BankPlannerUploadScopeTest(){
+  CBankPlanner planner(true, "");
+  planner.BeginPass();
+  planner.SetUploadScope("node1");
+  planner.NextUploadSite();
+  planner.SetUploadScope("node2");
+  const std::string siteA = planner.NextUploadSite();
+  planner.EndPass();
+
+  planner.BeginPass();
+  planner.SetUploadScope("node1");
+  planner.NextUploadSite();
+  planner.NextUploadSite();
+  planner.SetUploadScope("node2");
+  const std::string siteB = planner.NextUploadSite();
+  planner.SetUploadScope("");
+  const std::string siteC = planner.NextUploadSite();
+  planner.EndPass();
+  return siteA==siteB && siteA!=siteC && !planner.IsPlanLoaded();
+}
+
+TEST(test_cbankplanner, Plan) {
+  EXPECT_TRUE(BankPlannerPlanTest());
+}
+
+TEST(test_cbankplanner, SaveLoad) {
+  EXPECT_TRUE(BankPlannerSaveLoadTest());
+}
+
+TEST(test_cbankplanner, UploadScope) {
+  EXPECT_TRUE(BankPlannerUploadScopeTest());
+}
@@ -0,0 +1,134 @@
+#define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+
+#include "gtest/gtest.h"
+#include "CProfiler.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+// Reads the records of a trace file back, returns false if the header is not valid.
+bool ReadTraceRecords(const std::string &path, std::vector<CProfiler::TraceRecord> &records){
+  std::ifstream inFile(path, std::ios::binary);
+  if(!inFile.is_open()) return false;
+  std::vector<char> buff((std::istreambuf_iterator<char>(inFile)), std::istreambuf_iterator<char>());
+  std::remove(path.c_str());
+  if(buff.size()<sizeof(CProfiler::TraceFileHeader)) return false;
+
+  CProfiler::TraceFileHeader header;
+  std::memcpy(&header, buff.data(), sizeof(header));
+  if(std::memcmp(header.magic, CProfiler::kMagic, sizeof(CProfiler::kMagic))!=0) return false;
+  if(header.recordBytes!=sizeof(CProfiler::TraceRecord)) return false;
+  const size_t recordsOffset = sizeof(header) + header.infoBytes;
+  if(buff.size()<recordsOffset || (buff.size()-recordsOffset)%sizeof(CProfiler::TraceRecord)!=0) return false;
+  records.resize((buff.size()-recordsOffset)/sizeof(CProfiler::TraceRecord));
+  std::memcpy(records.data(), buff.data()+recordsOffset, records.size()*sizeof(CProfiler::TraceRecord));
+  return true;
+}
+
+// Writes the layers in a tight loop and reads the file back. With more layers than the ring holds, the records that
+// do not fit are dropped, but the written layers stay paired and keep the order of the calls.
+bool ProfilerTraceTest(unsigned layerCount, double &overheadNanoSeconds, uint64_t &droppedCount){
+  const std::string path = std::string(P_tmpdir) + "/test_cprofiler.trace";
+  const std::vector<unsigned> shape1 = {5,1024,20,64}, shape2 = {64};
+  {
+    CProfiler profiler(path, false);
+    for(unsigned i=0; i<layerCount; i++){
+      profiler.StartLayer(PLATFORMS::XIL, i, "Reduce", {{"shape",shape1},{"shape.w",shape2}}, {{"rank",4},{"axis",i%4}}, {{"scale",0.5f}});
+      profiler.StartKernel(PLATFORMS::XIL, i, "task_reduce", {10ul*i, 10ul*i+1, 10ul*i+2, 10ul*i+1002+i});
+      profiler.FinishKernel();
+      profiler.FinishLayer();
+    }
+    overheadNanoSeconds = profiler.GetOverheadPerLayerNanoSeconds();
+    droppedCount = profiler.GetDroppedRecordCount();
+  }
+
+  std::vector<CProfiler::TraceRecord> records;
+  if(!ReadTraceRecords(path, records)) return false;
+  if(records.size()+droppedCount!=(size_t)layerCount*3) return false;
+
+  int openLayer = -1, lastLayer = -1, lastKernel = -1;
+  unsigned layersWritten = 0;
+  for(auto &record:records){
+    if(record.type==CProfiler::RECORD_TYPE::LAYER_START){
+      const int i = (int)record.id;
+      if(openLayer>=0 || i<=lastLayer || std::strcmp(record.name, "Reduce")!=0) return false;
+      if(record.shapeCount!=2 || record.shapes[0].rank!=4 || record.shapes[0].dims[1]!=1024 || record.shapes[1].dims[0]!=64) return false;
+      if(record.intCount!=2 || record.ints[1].value!=i%4 || record.floatCount!=1 || record.floats[0].value!=0.5f) return false;
+      openLayer = lastLayer = i;
+    }else if(record.type==CProfiler::RECORD_TYPE::KERNEL){
+      const unsigned i = record.id;
+      if((int)i<=lastKernel || (openLayer>=0 && (int)i!=openLayer) || record.duration!=1000+i) return false;
+      if(record.deviceQueued!=10ul*i || record.deviceSubmit!=10ul*i+1 || record.deviceStart!=10ul*i+2) return false;
+      lastKernel = (int)i;
+    }else if(record.type==CProfiler::RECORD_TYPE::LAYER_STOP){
+      if(openLayer<0) return false;
+      openLayer = -1;
+      layersWritten++;
+    }else{
+      return false;
+    }
+  }
+  return openLayer<0 && (droppedCount>0 || layersWritten==layerCount);
+}
+
+TEST(test_cprofiler, trace1) {
+  double overheadNanoSeconds;
+  uint64_t droppedCount;
+  EXPECT_TRUE(ProfilerTraceTest(10, overheadNanoSeconds, droppedCount));
+  EXPECT_EQ(droppedCount, 0);
+  EXPECT_TRUE(ProfilerTraceTest(3*CProfiler::kRingCapacity, overheadNanoSeconds, droppedCount));
+}
+
+// The overhead is a wall-clock number that depends on the load of the host, so the minimum of several batches (each
+// with fewer records than the ring holds) is checked.
+TEST(test_cprofiler, overhead1) {
+  std::vector<double> overheads;
+  for(unsigned batch=0; batch<7; batch++){
+    double overheadNanoSeconds;
+    uint64_t droppedCount;
+    EXPECT_TRUE(ProfilerTraceTest(CProfiler::kRingCapacity/6, overheadNanoSeconds, droppedCount));
+    overheads.push_back(overheadNanoSeconds);
+  }
+  const double minOverheadNanoSeconds = *std::min_element(overheads.begin(), overheads.end());
+  SPDLOG_LOGGER_INFO(logger, "The profiler overhead per layer is {} ns (the minimum of {} batches).", minOverheadNanoSeconds, overheads.size());
+  EXPECT_LT(minOverheadNanoSeconds, 1000.0);
+}
+
+// The kernels are recorded from the callback threads of the runtime, concurrently with the layers. Every record is
+// either written or counted as dropped.
+TEST(test_cprofiler, callbackthreads1) {
+  const std::string path = std::string(P_tmpdir) + "/test_cprofiler_threads.trace";
+  const unsigned threadCount = 4, kernelsPerThread = CProfiler::kRingCapacity;
+  uint64_t droppedCount;
+  {
+    CProfiler profiler(path, false);
+    std::vector<std::thread> threads;
+    for(unsigned t=0; t<threadCount; t++){
+      threads.emplace_back([&profiler, t, kernelsPerThread](){
+        for(unsigned i=0; i<kernelsPerThread; i++){
+          profiler.StartKernel(PLATFORMS::XIL, t, "task_reduce", {0, 1, 2, 3});
+        }
+      });
+    }
+    for(unsigned i=0; i<kernelsPerThread/4; i++){
+      profiler.StartLayer(PLATFORMS::XIL, i, "Reduce");
+      profiler.FinishLayer();
+    }
+    for(auto &thread:threads) thread.join();
+    droppedCount = profiler.GetDroppedRecordCount();
+  }
+  std::vector<CProfiler::TraceRecord> records;
+  EXPECT_TRUE(ReadTraceRecords(path, records));
+  EXPECT_EQ(records.size()+droppedCount, (size_t)threadCount*kernelsPerThread + kernelsPerThread/2);
+  int depth = 0;
+  bool isPaired = true;
+  for(auto &record:records){
+    if(record.type==CProfiler::RECORD_TYPE::LAYER_START) depth++;
+    if(record.type==CProfiler::RECORD_TYPE::LAYER_STOP) depth--;
+    if(depth<0 || depth>1) isPaired = false;
+  }
+  EXPECT_TRUE(isPaired && depth==0);
+}
@@ -0,0 +1,92 @@
+#define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+
+#include "gtest/gtest.h"
+#include "cpu/CTensor.h"
+#include "cpu/CCpuThreadPool.h"
+#include "test_helpers.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <vector>
+
+// Every task runs exactly once, on a worker index below the requested bound. The tasks are uneven to trigger stealing.
+bool ThreadPoolCoverageTest(unsigned threadCount, unsigned taskCount, unsigned maxWorkers){
+  CCpuThreadPool pool(threadCount);
+  std::vector<std::atomic_uint> runs(taskCount);
+  for(auto &r:runs) r = 0;
+  std::atomic_bool badWorker(false);
+  const unsigned bound = std::min(taskCount, std::min(maxWorkers==0 ? threadCount : maxWorkers, threadCount));
+  for(unsigned iter=0; iter<20; iter++){
+    pool.ParallelFor(taskCount, maxWorkers, [&](unsigned task, unsigned worker){
+      if(worker>=bound) badWorker = true;
+      volatile float acc = 0;
+      for(unsigned i=0; i<(task%13)*200; i++) acc += i;
+      runs[task]++;
+    });
+  }
+  for(auto &r:runs){
+    if(r!=20) return false;
+  }
+  return !badWorker;
+}
+
+// The nested calls run serially and the first exception is rethrown on the calling thread.
+bool ThreadPoolNestedAndExceptionTest(){
+  CCpuThreadPool pool(4);
+  std::atomic_uint nestedRuns(0);
+  pool.ParallelFor(16, 0, [&](unsigned, unsigned){
+    pool.ParallelFor(8, 0, [&](unsigned, unsigned worker){
+      if(worker==0) nestedRuns++;
+    });
+  });
+  bool thrown = false;
+  try{
+    pool.ParallelFor(64, 0, [&](unsigned task, unsigned){
+      if(task==33) throw std::runtime_error("test");
+    });
+  }catch(std::runtime_error&){
+    thrown = true;
+  }
+  return nestedRuns==16*8 && thrown;
+}
+
+// The parallel rank 4 reduce sum against a serial loop. The order of the additions differs, so the tolerance is relative.
+bool ReduceSumParallelTest(const std::vector<unsigned> &shape){
+  auto srcTn = GenerateTensor<float>(0,shape);
+  auto rsltTn = std::dynamic_pointer_cast<CTensor<float>>(
+      platSelection->Reduce(PLATFORMS::CPU, Convert2TnBasePtr(srcTn), REDUCTION_OPS::SUM, 1, {1,1,1,0}));
+  const unsigned dim3 = shape[3];
+  const size_t rows = srcTn->GetLen()/dim3;
+  if(rsltTn->GetShape()!=std::vector<unsigned>({dim3})) return false;
+  for(unsigned d3=0; d3<dim3; d3++){
+    double sum = 0;
+    for(size_t row=0; row<rows; row++) sum += (*srcTn)[row*dim3+d3];
+    if(std::fabs((*rsltTn)[d3]-sum) > 1e-4*std::fabs(sum)+1e-3) return false;
+  }
+  return true;
+}
+
+TEST(test_cputhreadpool, parallel_for) {
+  std::vector<bool> results = {
+      ThreadPoolCoverageTest(1, 100, 0),
+      ThreadPoolCoverageTest(4, 3, 0),
+      ThreadPoolCoverageTest(4, 1000, 0),
+      ThreadPoolCoverageTest(8, 1000, 3),
+      ThreadPoolNestedAndExceptionTest(),
+  };
+
+  for(auto r:results){
+    EXPECT_TRUE(r);
+  }
+}
+
+TEST(test_cputhreadpool, layers) {
+  std::vector<bool> results = {
+      ReduceSumParallelTest({2,64,20,16}),
+      ReduceSumParallelTest({5,1024,20,64}),
+  };
+
+  for(auto r:results){
+    EXPECT_TRUE(r);
+  }
+}
@@ -1,6 +1,8 @@
 #include "gtest/gtest.h"
 #include "cpu/CTensor.h"
 #include "test_helpers.h"
+#include "cnpy.h"
+#include <cstdio>
 
 TEST(test_ctensor, subtest1) {
   const unsigned N=1024;
@@ -73,3 +75,81 @@ TEST(test_ctensor, expandsqueeze1) {
   EXPECT_EQ(1,  tn1.GetShape()[1]);
   EXPECT_EQ(5,  tn1.GetRank());
 }
+
+TEST(test_ctensor, mempool_reuse) {
+  if(!CHostMemoryPool::GetInstance().IsEnabled()) return; // --nomempool
+  const float *ptrBuff1, *ptrBuff2;
+  {
+    CTensor<float> tn1({5,1024,20,64});
+    ptrBuff1 = tn1.Get();
+  }
+  {
+    // The same size class, the buffer of the released tensor should be handed out again.
+    CTensor<float> tn2({5,1024,20,63});
+    ptrBuff2 = tn2.Get();
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(ptrBuff2)%4096, 0);
+  }
+  EXPECT_EQ(ptrBuff1, ptrBuff2);
+}
+
+TEST(test_ctensor, mempool_bounded) {
+  if(!CHostMemoryPool::GetInstance().IsEnabled()) return; // --nomempool
+  auto &pool = CHostMemoryPool::GetInstance();
+  const size_t oldMaxCachedBytes = pool.GetMaxCachedBytes();
+  const size_t maxCachedBytes = 8*1024*1024;
+  pool.SetMaxCachedBytes(maxCachedBytes);
+  EXPECT_LE(pool.GetCachedBytes(), maxCachedBytes);
+
+  // Every pass has a different batch size, so the size classes of the previous passes are never reused.
+  for(unsigned pass=1; pass<=8; pass++){
+    {
+      CTensor<float> tn1({pass,1024,64});
+      CTensor<float> tn2({pass,1024,20,3});
+      CTensor<float> tn3({pass,1024,128});
+    }
+    EXPECT_LE(pool.GetCachedBytes(), maxCachedBytes);
+  }
+  // A tensor larger than the cap is not cached.
+  {
+    CTensor<float> tn1({2*maxCachedBytes/sizeof(float)});
+  }
+  EXPECT_LE(pool.GetCachedBytes(), maxCachedBytes);
+  pool.SetMaxCachedBytes(oldMaxCachedBytes);
+}
+
+TEST(test_ctensor, borrowed_mmap) {
+  const unsigned N=1024;
+  std::vector<float> data(3*N);
+  for(unsigned i=0; i<data.size(); i++) data[i] = i*0.5f;
+  const std::string path = std::string(P_tmpdir) + "/test_ctensor_borrowed_mmap.npy";
+  cnpy::npy_save<float>(path, data.data(), {3, N});
+
+  auto npyRead = cnpy::npy_load(path, false);
+  auto npyMapped = cnpy::npy_load(path, true);
+  EXPECT_FALSE(npyRead.is_mapped);
+  EXPECT_TRUE(npyMapped.is_mapped);
+  EXPECT_EQ(npyMapped.shape, npyRead.shape);
+  EXPECT_EQ(npyMapped.num_bytes(), npyRead.num_bytes());
+
+  // The second row of the mapped file, borrowed without copying.
+  CTensorPtr<float> tn1(new CTensor<float>({N}, npyMapped.data<float>()+N, npyMapped.data_holder));
+  CTensorPtr<float> tn2(new CTensor<float>({N}, npyRead.data<float>()+N));
+  EXPECT_TRUE(tn1->IsBorrowed());
+  EXPECT_FALSE(tn2->IsBorrowed());
+  EXPECT_EQ(tn1->Get(), npyMapped.data<float>()+N);
+
+  // The tensor keeps the mapping alive after the numpy array is gone.
+  npyMapped = cnpy::NpyArray();
+  bool cmp = platSelection->CompareTensors(
+      PLATFORMS::CPU,
+      Convert2TnBasePtr(tn1),
+      Convert2TnBasePtr(tn2)
+  );
+  EXPECT_TRUE(cmp);
+
+  // A copy of a borrowed tensor owns its buffer.
+  CTensor<float> tn3(*tn1);
+  EXPECT_FALSE(tn3.IsBorrowed());
+  EXPECT_NE(tn3.Get(), tn1->Get());
+  std::remove(path.c_str());
+}
@@ -4,6 +4,8 @@
 #include "cpu/CTensor.h"
 #include "fpga/xilinx/CTensorXil.h"
 #include "test_helpers.h"
+#include "CWeightBundle.h"
+#include <cstdio>
 #include <vector>
 
 template <int N, int BANK, typename T>
@@ -275,3 +277,148 @@ TEST(test_ctensorxil, clonebanks1) {
     EXPECT_TRUE(r);
   }
 }
+
+// The crossings to a bank reuse the replica until the tensor is written again.
+template <int N, typename T>
+bool TensorXilTestBankReplicas(){
+  vector<unsigned> vBanks;
+#ifdef USEMEMORYBANK0
+  vBanks.push_back(0);
+#endif
+#ifdef USEMEMORYBANK1
+  vBanks.push_back(1);
+#endif
+#ifdef USEMEMORYBANK2
+  vBanks.push_back(2);
+#endif
+#ifdef USEMEMORYBANK3
+  vBanks.push_back(3);
+#endif
+  if(vBanks.size()<2) return true;
+  CXilinxInfo *xilInfo = platSelection->GetClassPtrImplementationXilinx()->GetXilInfo();
+  auto srcTn1 = GenerateTensor<T>(0,{N});
+  auto srcTn2 = GenerateTensor<T>(7,{N});
+  CTensorXilPtr<T> deviceSrcTn(new CTensorXil<T>(xilInfo,*srcTn1,vBanks[0]));
+  deviceSrcTn->EnableBankReplicaCache();
+
+  const auto launchesBefore = xilInfo->GetDatamoverLaunches();
+  auto replicaTn1 = deviceSrcTn->CloneIfNeededToBank(vBanks[1]);
+  auto replicaTn2 = deviceSrcTn->CloneIfNeededToBank(vBanks[1]);
+  bool ok = replicaTn1==replicaTn2 && xilInfo->GetDatamoverLaunches()==launchesBefore+1;
+  ok = ok && platSelection->CompareTensors(PLATFORMS::CPU, Convert2TnBasePtr(srcTn1), Convert2TnBasePtr(replicaTn2->TransferToHost()));
+
+  // A write drops the replicas.
+  CTensorXil<T> otherTn(xilInfo,*srcTn2,vBanks[0]);
+  *deviceSrcTn = otherTn;
+  auto replicaTn3 = deviceSrcTn->CloneIfNeededToBank(vBanks[1]);
+  ok = ok && replicaTn3!=replicaTn1 && xilInfo->GetDatamoverLaunches()==launchesBefore+2;
+  ok = ok && platSelection->CompareTensors(PLATFORMS::CPU, Convert2TnBasePtr(srcTn2), Convert2TnBasePtr(replicaTn3->TransferToHost()));
+  return ok;
+}
+
+TEST(test_ctensorxil, bankreplicas1) {
+  EXPECT_TRUE((TensorXilTestBankReplicas<63,float>()));
+  EXPECT_TRUE((TensorXilTestBankReplicas<1030,unsigned>()));
+}
+
+TEST(test_ctensorxil, bundleviews1) {
+  CXilinxInfo *xilInfo = platSelection->GetClassPtrImplementationXilinx()->GetXilInfo();
+  auto srcTn1 = GenerateTensor<float>(0,{5,17});
+  auto srcTn2 = GenerateTensor<float>(0,{33});
+  auto srcTn3 = GenerateTensor<float>(0,{2,3,64});
+  std::vector<CWeightBundle::Record> records(3);
+  records[0] = {"w1.npy", "tag1", 1, srcTn1->GetShape(), srcTn1->Get()};
+  records[1] = {"w2.npy", "tag2", 2, srcTn2->GetShape(), srcTn2->Get()};
+  records[2] = {"w3.npy", "tag3", 1, srcTn3->GetShape(), srcTn3->Get()};
+  const std::string path = std::string(P_tmpdir) + "/test_ctensorxil_bundleviews1.bundle";
+  const uint64_t sourceStamp = 42;
+  CWeightBundle::Write(path, records, CONFIG_M_AXI_WIDTH, false, sourceStamp);
+  EXPECT_TRUE(CWeightBundle::IsUpToDate(path, sourceStamp));
+  EXPECT_FALSE(CWeightBundle::IsUpToDate(path, sourceStamp+1));
+
+  CWeightBundle bundle(path);
+  EXPECT_EQ(bundle.GetEntryCount(), 3);
+  EXPECT_EQ(bundle.GetBankSectionCount(), 2);
+  std::vector<CTensorXilPtr<float>> bankTensors;
+  for(unsigned s=0; s<bundle.GetBankSectionCount(); s++){
+    const auto &section = bundle.GetBankSection(s);
+    const unsigned rows = section.bytes/(CONFIG_M_AXI_WIDTH*sizeof(float));
+    bankTensors.push_back(CTensorXilPtr<float>(new CTensorXil<float>(xilInfo, {rows, CONFIG_M_AXI_WIDTH}, bundle.GetBankSectionData(s), bundle.GetMapping(), section.bank)));
+  }
+  std::vector<CTensorPtr<float>> srcTensors = {srcTn1, srcTn2, srcTn3};
+  for(unsigned i=0; i<bundle.GetEntryCount(); i++){
+    const auto &entry = bundle.GetEntry(i);
+    CTensorPtr<float> hostTn(new CTensor<float>(bundle.GetShape(i), const_cast<float*>(bundle.GetHostData(i)), bundle.GetMapping()));
+    CTensorXilPtr<float> viewTn(new CTensorXil<float>(bankTensors[entry.bankSectionIndex], entry.deviceOffset, bundle.GetShape(i)));
+    EXPECT_EQ(viewTn->GetDramBank(), records[i].bank);
+    auto dstTn = viewTn->TransferToHost();
+    EXPECT_TRUE(platSelection->CompareTensors(PLATFORMS::CPU, Convert2TnBasePtr(srcTensors[i]), Convert2TnBasePtr(hostTn)));
+    EXPECT_TRUE(platSelection->CompareTensors(PLATFORMS::CPU, Convert2TnBasePtr(srcTensors[i]), Convert2TnBasePtr(dstTn)));
+  }
+  std::remove(path.c_str());
+}
+
+// The shape ops of the graph chain the views (CPlatformSelection::ShareBuffer()), the view of a view is a region of
+// the root buffer.
+TEST(test_ctensorxil, chainedviews1) {
+  auto srcTn = GenerateTensor<float>(0,{2,3,64});
+  auto deviceTn = platSelection->CrossThePlatformIfNeeded(PLATFORMS::XIL, Convert2TnBasePtr(srcTn));
+  auto viewTn1 = platSelection->ShareBuffer(deviceTn);
+  viewTn1->Reshape({6,64});
+  auto viewTn2 = platSelection->ShareBuffer(viewTn1);
+  viewTn2->ExpandDims(1);
+  auto viewTn3 = platSelection->ShareBuffer(viewTn2);
+  viewTn3->Reshape({2,3,64});
+  EXPECT_TRUE(platSelection->CompareTensors(PLATFORMS::CPU, Convert2TnBasePtr(srcTn), platSelection->CrossThePlatformIfNeeded(PLATFORMS::CPU, viewTn3)));
+
+  // The regions at an offset of a view, the rows are 4096 bytes apart.
+  CXilinxInfo *xilInfo = platSelection->GetClassPtrImplementationXilinx()->GetXilInfo();
+  const unsigned rowsPerPage = 4096/(CONFIG_M_AXI_WIDTH*sizeof(float));
+  auto pagesTn = GenerateTensor<float>(0,{3*rowsPerPage, CONFIG_M_AXI_WIDTH});
+  CTensorXilPtr<float> devicePagesTn(new CTensorXil<float>(xilInfo, *pagesTn));
+  CTensorXilPtr<float> lastPagesTn(new CTensorXil<float>(devicePagesTn, 4096, {2*rowsPerPage, CONFIG_M_AXI_WIDTH}));
+  CTensorXilPtr<float> lastPageTn(new CTensorXil<float>(lastPagesTn, 4096, {rowsPerPage, CONFIG_M_AXI_WIDTH}));
+  auto dstTn = lastPageTn->TransferToHost();
+  bool matches = true;
+  for(unsigned i=0; i<dstTn->GetLen(); i++){
+    if((*dstTn)[i]!=(*pagesTn)[2*rowsPerPage*CONFIG_M_AXI_WIDTH+i]) matches = false;
+  }
+  EXPECT_TRUE(matches);
+}
+
+TEST(test_ctensorxil, reshapepadded1) {
+  auto srcTn = GenerateTensor<float>(0,{2,9});
+  auto deviceTn = platSelection->CrossThePlatformIfNeeded(PLATFORMS::XIL, Convert2TnBasePtr(srcTn));
+  // 2x9 and 2x3x3 are padded to 2x16 and 2x3x16.
+  bool isThrown = false;
+  try{
+    deviceTn->Reshape({2,3,3});
+  }catch(std::runtime_error&){
+    isThrown = true;
+  }
+  EXPECT_TRUE(isThrown);
+  deviceTn->Reshape({1,2,9});
+  deviceTn->Reshape({2,9});
+  EXPECT_TRUE(platSelection->CompareTensors(PLATFORMS::CPU, Convert2TnBasePtr(srcTn), platSelection->CrossThePlatformIfNeeded(PLATFORMS::CPU, deviceTn)));
+}
+
+TEST(test_ctensorxil, mempoolbounded1) {
+  auto pool = platSelection->GetClassPtrImplementationXilinx()->GetXilInfo()->GetBufferPool();
+  const size_t oldMaxCachedBytes = pool->GetMaxCachedBytes();
+  const size_t maxCachedBytes = 4*1024*1024;
+  pool->SetMaxCachedBytes(maxCachedBytes);
+  EXPECT_LE(pool->GetCachedBytes(), maxCachedBytes);
+
+  // Every pass has a different batch size, so the size classes of the previous passes are never reused.
+  for(unsigned pass=1; pass<=8; pass++){
+    {
+      auto srcTn1 = GenerateTensor<float>(0,{pass,1024,64});
+      auto srcTn2 = GenerateTensor<float>(0,{pass,512,128});
+      auto deviceTn1 = platSelection->CrossThePlatformIfNeeded(PLATFORMS::XIL, Convert2TnBasePtr(srcTn1));
+      auto deviceTn2 = platSelection->CrossThePlatformIfNeeded(PLATFORMS::XIL, Convert2TnBasePtr(srcTn2));
+      EXPECT_TRUE(platSelection->CompareTensors(PLATFORMS::CPU, Convert2TnBasePtr(srcTn2), platSelection->CrossThePlatformIfNeeded(PLATFORMS::CPU, deviceTn2)));
+    }
+    EXPECT_LE(pool->GetCachedBytes(), maxCachedBytes);
+  }
+  pool->SetMaxCachedBytes(oldMaxCachedBytes);
+}
@@ -0,0 +1,42 @@
+#define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+
+#include "gtest/gtest.h"
+#include "cpu/CTensor.h"
+#include "test_helpers.h"
+#include <vector>
+
+template <typename T>
+bool EdgeConvTest(const std::vector<unsigned> &shapeInput, unsigned k, unsigned chOut){
+  const unsigned D = shapeInput[2];
+  auto inputTn = GenerateTensor<T>(0,shapeInput);
+  auto weightTn = GenerateTensor<T>(0,{1,1,2*D,chOut});
+  auto biasTn = GenerateTensor<T>(0,{chOut});
+  auto knnTn = platSelection->KNN(PLATFORMS::CPU, Convert2TnBasePtr(inputTn), k);
+  return CompareLayerCpuXil([&](PLATFORMS platform){
+    return platSelection->EdgeConv(platform,
+                                   Convert2TnBasePtr(inputTn),
+                                   knnTn,
+                                   Convert2TnBasePtr(weightTn),
+                                   Convert2TnBasePtr(biasTn));
+  });
+}
+
+TEST(test_layeredgeconv, edgeconv_d3) {
+  std::vector<bool> results = {
+      EdgeConvTest<float>({1,1024,3}, 20, 64),
+  };
+
+  for(auto r:results){
+    EXPECT_TRUE(r);
+  }
+}
+
+TEST(test_layeredgeconv, edgeconv_d64) {
+  std::vector<bool> results = {
+      EdgeConvTest<float>({2,1024,64}, 20, 64),
+  };
+
+  for(auto r:results){
+    EXPECT_TRUE(r);
+  }
+}
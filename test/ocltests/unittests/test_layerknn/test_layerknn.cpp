@@ -0,0 +1,97 @@
+#define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+
+#include "gtest/gtest.h"
+#include "cpu/CTensor.h"
+#include "cpu/CImplementationCpu.h"
+#include "test_helpers.h"
+#include <cmath>
+#include <vector>
+
+/**
+ * @brief      Compares the neighbours by their distances to the point, not by their indices: the implementations sum
+ *             the distances in different orders, so the neighbours at nearly equal distances could be swapped.
+ */
+bool CompareKnnDistances(CTensorPtr<float> srcTn, CTensorBasePtr knnTn1, CTensorBasePtr knnTn2, unsigned k){
+  auto pKnnTn1 = std::dynamic_pointer_cast<CTensor<unsigned>>(platSelection->CrossThePlatformIfNeeded(PLATFORMS::CPU, knnTn1));
+  auto pKnnTn2 = std::dynamic_pointer_cast<CTensor<unsigned>>(platSelection->CrossThePlatformIfNeeded(PLATFORMS::CPU, knnTn2));
+  const auto shape = srcTn->GetShape();
+  const unsigned B = shape[0], N = shape[1], D = shape[2];
+  if(pKnnTn1->GetShape()!=std::vector<unsigned>({B,N,k}) || pKnnTn2->GetShape()!=pKnnTn1->GetShape()) return false;
+
+  const float *ptrSrc = srcTn->Get();
+  auto distance = [&](unsigned b, unsigned i, unsigned j){
+    double sum = 0;
+    for(unsigned d=0; d<D; d++){
+      const double delta = (double)ptrSrc[(b*N+i)*D+d] - (double)ptrSrc[(b*N+j)*D+d];
+      sum += delta*delta;
+    }
+    return sum;
+  };
+  for(unsigned b=0; b<B; b++){
+    for(unsigned i=0; i<N; i++){
+      for(unsigned n=0; n<k; n++){
+        const size_t indx = ((size_t)b*N+i)*k+n;
+        const unsigned j1 = pKnnTn1->Get()[indx], j2 = pKnnTn2->Get()[indx];
+        if(j1>=N || j2>=N) return false;
+        // Both of the outputs are sorted by the distance, so the n-th neighbours are at the same distance.
+        const double d1 = distance(b, i, j1), d2 = distance(b, i, j2);
+        if(std::abs(d1-d2) > 1e-3*std::max(1.0, std::abs(d1))) return false;
+      }
+    }
+  }
+  return true;
+}
+
+template <typename T>
+bool KnnTest(const std::vector<unsigned> &shape, unsigned k){
+  auto srcTn = GenerateTensor<T>(0,shape);
+  auto goldTn = platSelection->KNN(PLATFORMS::CPU, Convert2TnBasePtr(srcTn), k);
+  auto dstTn = platSelection->KNN(PLATFORMS::XIL, Convert2TnBasePtr(srcTn), k);
+  return CompareKnnDistances(srcTn, goldTn, dstTn, k);
+}
+
+// The fused KNN of the CPU (CKnnCpu) against the pairwise distance and the top-k of --cpunaive.
+template <typename T>
+bool KnnFusedTest(const std::vector<unsigned> &shape, unsigned k){
+  auto *implCpu = platSelection->GetClassPtrImplementationCpu();
+  const bool wasNaive = implCpu->GetUseNaiveKernels();
+  auto srcTn = GenerateTensor<T>(0,shape);
+  implCpu->SetUseNaiveKernels(true);
+  auto goldTn = platSelection->KNN(PLATFORMS::CPU, Convert2TnBasePtr(srcTn), k);
+  implCpu->SetUseNaiveKernels(false);
+  auto dstTn = platSelection->KNN(PLATFORMS::CPU, Convert2TnBasePtr(srcTn), k);
+  implCpu->SetUseNaiveKernels(wasNaive);
+  return CompareKnnDistances(srcTn, goldTn, dstTn, k);
+}
+
+TEST(test_layerknn, knn_d3) {
+  std::vector<bool> results = {
+      KnnTest<float>({1,1024,3}, 20),
+  };
+
+  for(auto r:results){
+    EXPECT_TRUE(r);
+  }
+}
+
+TEST(test_layerknn, knn_d64) {
+  std::vector<bool> results = {
+      KnnTest<float>({2,1024,64}, 20),
+  };
+
+  for(auto r:results){
+    EXPECT_TRUE(r);
+  }
+}
+
+TEST(test_layerknn, knn_fused_naive) {
+  std::vector<bool> results = {
+      KnnFusedTest<float>({1,1024,3}, 20),
+      KnnFusedTest<float>({2,1024,64}, 20),
+      KnnFusedTest<float>({2,100,5}, 7),
+  };
+
+  for(auto r:results){
+    EXPECT_TRUE(r);
+  }
+}
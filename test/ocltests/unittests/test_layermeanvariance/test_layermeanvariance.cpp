@@ -0,0 +1,51 @@
+#define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+
+#include "gtest/gtest.h"
+#include "cpu/CTensor.h"
+#include "test_helpers.h"
+#include <vector>
+
+// The single pass layers against the separate Mean and Variance layers of the CPU.
+template <typename T>
+bool MeanVarianceTest(const std::vector<unsigned> &shape, const std::vector<unsigned> &combination){
+  auto srcTn = GenerateTensor<T>(0,shape);
+  auto goldMeanTn = platSelection->Mean(PLATFORMS::CPU, Convert2TnBasePtr(srcTn), combination);
+  auto goldVarianceTn = platSelection->Variance(PLATFORMS::CPU, Convert2TnBasePtr(srcTn), combination);
+  auto cpuTns = platSelection->MeanVariance(PLATFORMS::CPU, Convert2TnBasePtr(srcTn), combination);
+  auto xilTns = platSelection->MeanVariance(PLATFORMS::XIL, Convert2TnBasePtr(srcTn), combination);
+
+  return platSelection->CompareTensors(PLATFORMS::CPU, goldMeanTn, cpuTns[0]) &&
+         platSelection->CompareTensors(PLATFORMS::CPU, goldVarianceTn, cpuTns[1]) &&
+         platSelection->CompareTensors(PLATFORMS::CPU, goldMeanTn, xilTns[0]) &&
+         platSelection->CompareTensors(PLATFORMS::CPU, goldVarianceTn, xilTns[1]);
+}
+
+TEST(test_layermeanvariance, meanvariance4_TTTF1) {
+  std::vector<bool> results = {
+      MeanVarianceTest<float>({2,2,2,5},{1,1,1,0}),
+  };
+
+  for(auto r:results){
+    EXPECT_TRUE(r);
+  }
+}
+
+TEST(test_layermeanvariance, meanvariance4_TTTF2) {
+  std::vector<bool> results = {
+      MeanVarianceTest<float>({2,64,4,17},{1,1,1,0}),
+  };
+
+  for(auto r:results){
+    EXPECT_TRUE(r);
+  }
+}
+
+TEST(test_layermeanvariance, meanvariance2_TF1) {
+  std::vector<bool> results = {
+      MeanVarianceTest<float>({2,17},{1,0}),
+  };
+
+  for(auto r:results){
+    EXPECT_TRUE(r);
+  }
+}
@@ -0,0 +1,194 @@
+#define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+
+#include "gtest/gtest.h"
+#include "cpu/CTensor.h"
+#include "test_helpers.h"
+#include <vector>
+
+// tn1 is read by the fourth layer, so ReLU could not run in-place. Square, BasicOps and Sqrt could.
+CTensorBasePtr MemoryPlannerGraph(CTensorBasePtr inputTn){
+  auto tn1 = platSelection->BasicOps(PLATFORMS::CPU, inputTn, 2.0f, BASIC_OPS::MUL_ELEMENTWISE);
+  auto tn2 = platSelection->ReLU(PLATFORMS::CPU, tn1);
+  auto tn3 = platSelection->Square(PLATFORMS::CPU, tn2);
+  auto tn4 = platSelection->BasicOps(PLATFORMS::CPU, tn3, tn1, BASIC_OPS::ADD);
+  auto tn5 = platSelection->Sqrt(PLATFORMS::CPU, tn4);
+  return tn5;
+}
+
+bool MemoryPlannerTest(const std::vector<unsigned> &shape){
+  auto srcTn = Convert2TnBasePtr(GenerateTensor<float>(0,shape));
+  auto planner = platSelection->GetClassPtrMemoryPlanner();
+  const bool wasEnabled = planner->IsEnabled();
+
+  planner->SetEnabled(false);
+  auto goldTn = MemoryPlannerGraph(srcTn);
+
+  planner->SetEnabled(true);
+  planner->BeginPass();
+  auto recordedTn = MemoryPlannerGraph(srcTn);
+  planner->EndPass(recordedTn);
+  const bool planned = planner->HasPlan() &&
+                       planner->GetInPlaceLayerCount()==3 &&
+                       planner->GetLifetimePeakBytes()<planner->GetRecordedPeakBytes();
+
+  planner->BeginPass();
+  auto replayedTn = MemoryPlannerGraph(srcTn);
+  planner->EndPass(replayedTn);
+  // The in-place layers of the replayed pass do not allocate their outputs.
+  const bool reduced = planner->GetMeasuredPeakBytes()<planner->GetRecordedPeakBytes();
+  planner->SetEnabled(wasEnabled);
+
+  return planned && reduced &&
+         platSelection->CompareTensors(PLATFORMS::CPU, goldTn, recordedTn) &&
+         platSelection->CompareTensors(PLATFORMS::CPU, goldTn, replayedTn);
+}
+
+TEST(test_memoryplanner, inplace_elementwise) {
+  std::vector<bool> results = {
+      MemoryPlannerTest({2,1024,64}),
+      MemoryPlannerTest({5,1024,20,64}),
+  };
+
+  for(auto r:results){
+    EXPECT_TRUE(r);
+  }
+}
+
+// tn1 is read again through its reshaped alias, so ReLU could not run in-place. Square of the alias could.
+CTensorBasePtr MemoryPlannerAliasGraph(CTensorBasePtr inputTn, bool &shapeIsKept){
+  auto tn1 = platSelection->BasicOps(PLATFORMS::CPU, inputTn, 2.0f, BASIC_OPS::MUL_ELEMENTWISE);
+  auto aliasTn = platSelection->ShareBuffer(tn1);
+  aliasTn->Reshape({(unsigned)tn1->GetLen()});
+  auto tn2 = platSelection->ReLU(PLATFORMS::CPU, tn1);
+  auto tn3 = platSelection->Square(PLATFORMS::CPU, aliasTn);
+  shapeIsKept = tn1->GetShape()==inputTn->GetShape();
+  return tn3;
+}
+
+bool MemoryPlannerAliasTest(const std::vector<unsigned> &shape){
+  auto srcTn = Convert2TnBasePtr(GenerateTensor<float>(-1.0f, 1.0f, shape));
+  auto planner = platSelection->GetClassPtrMemoryPlanner();
+  const bool wasEnabled = planner->IsEnabled();
+  bool goldShapeIsKept, recordedShapeIsKept, replayedShapeIsKept;
+
+  planner->SetEnabled(false);
+  auto goldTn = MemoryPlannerAliasGraph(srcTn, goldShapeIsKept);
+
+  planner->SetEnabled(true);
+  planner->BeginPass();
+  auto recordedTn = MemoryPlannerAliasGraph(srcTn, recordedShapeIsKept);
+  planner->EndPass(recordedTn);
+  const bool planned = planner->HasPlan() && planner->GetInPlaceLayerCount()==1;
+
+  planner->BeginPass();
+  auto replayedTn = MemoryPlannerAliasGraph(srcTn, replayedShapeIsKept);
+  planner->EndPass(replayedTn);
+  planner->SetEnabled(wasEnabled);
+
+  return planned && goldShapeIsKept && recordedShapeIsKept && replayedShapeIsKept &&
+         platSelection->CompareTensors(PLATFORMS::CPU, goldTn, recordedTn) &&
+         platSelection->CompareTensors(PLATFORMS::CPU, goldTn, replayedTn);
+}
+
+TEST(test_memoryplanner, shared_buffer_alias) {
+  std::vector<bool> results = {
+      MemoryPlannerAliasTest({2,1024,64}),
+      MemoryPlannerAliasTest({5,1024,20,64}),
+  };
+
+  for(auto r:results){
+    EXPECT_TRUE(r);
+  }
+}
+
+// Both of the outputs of MeanVariance are tracked, so Sqrt could run in-place on the variance and BasicOps on the
+// output of Sqrt.
+CTensorBasePtr MemoryPlannerMomentsGraph(CTensorBasePtr inputTn){
+  auto momentsTns = platSelection->MeanVariance(PLATFORMS::CPU, inputTn, {1,0});
+  auto tn1 = platSelection->Sqrt(PLATFORMS::CPU, momentsTns[1]);
+  auto tn2 = platSelection->BasicOps(PLATFORMS::CPU, tn1, momentsTns[0], BASIC_OPS::ADD);
+  return tn2;
+}
+
+bool MemoryPlannerMomentsTest(const std::vector<unsigned> &shape){
+  auto srcTn = Convert2TnBasePtr(GenerateTensor<float>(0,shape));
+  auto planner = platSelection->GetClassPtrMemoryPlanner();
+  const bool wasEnabled = planner->IsEnabled();
+
+  planner->SetEnabled(false);
+  auto goldTn = MemoryPlannerMomentsGraph(srcTn);
+
+  planner->SetEnabled(true);
+  planner->BeginPass();
+  auto recordedTn = MemoryPlannerMomentsGraph(srcTn);
+  planner->EndPass(recordedTn);
+  const bool planned = planner->HasPlan() && planner->GetInPlaceLayerCount()==2;
+
+  planner->BeginPass();
+  auto replayedTn = MemoryPlannerMomentsGraph(srcTn);
+  planner->EndPass(replayedTn);
+  planner->SetEnabled(wasEnabled);
+
+  return planned &&
+         platSelection->CompareTensors(PLATFORMS::CPU, goldTn, recordedTn) &&
+         platSelection->CompareTensors(PLATFORMS::CPU, goldTn, replayedTn);
+}
+
+TEST(test_memoryplanner, multiple_outputs) {
+  std::vector<bool> results = {
+      MemoryPlannerMomentsTest({1024,64}),
+  };
+
+  for(auto r:results){
+    EXPECT_TRUE(r);
+  }
+}
+
+// The second input of BasicOps is an alias of the first one, so the buffer of tn1 is read by the layer and BasicOps
+// could not run in-place. ReLU could. An unrelated CPU layer after a replayed in-place layer allocates its output.
+CTensorBasePtr MemoryPlannerSelfReadGraph(CTensorBasePtr inputTn, bool &isNotInPlace){
+  auto tn1 = platSelection->BasicOps(PLATFORMS::CPU, inputTn, 2.0f, BASIC_OPS::MUL_ELEMENTWISE);
+  auto aliasTn = platSelection->ShareBuffer(tn1);
+  auto tn2 = platSelection->BasicOps(PLATFORMS::CPU, tn1, aliasTn, BASIC_OPS::ADD);
+  auto tn3 = platSelection->ReLU(PLATFORMS::CPU, tn2);
+  auto tn4 = platSelection->Square(PLATFORMS::CPU, inputTn);
+  isNotInPlace = tn2!=tn1 && tn4!=inputTn;
+  return platSelection->BasicOps(PLATFORMS::CPU, tn3, tn4, BASIC_OPS::ADD);
+}
+
+bool MemoryPlannerSelfReadTest(const std::vector<unsigned> &shape){
+  auto srcTn = Convert2TnBasePtr(GenerateTensor<float>(-1.0f, 1.0f, shape));
+  auto planner = platSelection->GetClassPtrMemoryPlanner();
+  const bool wasEnabled = planner->IsEnabled();
+  bool goldIsNotInPlace, recordedIsNotInPlace, replayedIsNotInPlace;
+
+  planner->SetEnabled(false);
+  auto goldTn = MemoryPlannerSelfReadGraph(srcTn, goldIsNotInPlace);
+
+  planner->SetEnabled(true);
+  planner->BeginPass();
+  auto recordedTn = MemoryPlannerSelfReadGraph(srcTn, recordedIsNotInPlace);
+  planner->EndPass(recordedTn);
+  // ReLU and the last BasicOps.
+  const bool planned = planner->HasPlan() && planner->GetInPlaceLayerCount()==2;
+
+  planner->BeginPass();
+  auto replayedTn = MemoryPlannerSelfReadGraph(srcTn, replayedIsNotInPlace);
+  planner->EndPass(replayedTn);
+  planner->SetEnabled(wasEnabled);
+
+  return planned && goldIsNotInPlace && recordedIsNotInPlace && replayedIsNotInPlace &&
+         platSelection->CompareTensors(PLATFORMS::CPU, goldTn, recordedTn) &&
+         platSelection->CompareTensors(PLATFORMS::CPU, goldTn, replayedTn);
+}
+
+TEST(test_memoryplanner, self_read_alias) {
+  std::vector<bool> results = {
+      MemoryPlannerSelfReadTest({2,1024,64}),
+      MemoryPlannerSelfReadTest({5,1024,20,64}),
+  };
+
+  for(auto r:results){
+    EXPECT_TRUE(r);
+  }
+}